@@ -63,6 +63,11 @@ static const uint MAX_RACK_PLUGINS = 16;
  */
 static const uint MAX_PATCHBAY_PLUGINS = 255;
 
+/*!
+ * Maximum number of parallel lanes in rack mode.
+ */
+static const uint MAX_RACK_LANES = 8;
+
 /*!
  * Maximum default number of parameters allowed.
  * @see ENGINE_OPTION_MAX_PARAMETERS
@@ -948,7 +953,27 @@ typedef enum {
     /*!
      * The engine has crashed or malfunctioned and will no longer work.
      */
-    ENGINE_CALLBACK_QUIT = 39
+    ENGINE_CALLBACK_QUIT = 39,
+
+    /*!
+     * A plugin's DSP load has been updated, sent about once per second.
+     * @a pluginId Plugin Id
+     * @a value1   99th percentile of the process time, in microseconds
+     * @a value2   Number of blocks that took longer than the buffer period
+     * @a value3   Average process time as a percentage of the buffer period
+     * @see carla_get_plugin_dsp_load()
+     */
+    ENGINE_CALLBACK_PLUGIN_DSP_LOAD = 40,
+
+    /*!
+     * A plugin from the project being loaded has been added, or has failed to load.
+     * @a pluginId Plugin Id, 0 if the plugin failed to load
+     * @a value1   Number of plugins handled so far
+     * @a value2   Total number of plugins in the project
+     * @a valueStr Plugin name
+     * @see ENGINE_OPTION_MAX_LOAD_THREADS
+     */
+    ENGINE_CALLBACK_PROJECT_LOAD_PROGRESS = 41
 
 } EngineCallbackOpcode;
 
@@ -1038,6 +1063,7 @@ typedef enum {
 
     /*!
      * Audio device (within a driver).
+     * For the "Dummy" driver this is the output file path, optionally prefixed by an input file path and '|'.
      * Default unset.
      */
     ENGINE_OPTION_AUDIO_DEVICE = 12,
@@ -1072,7 +1098,61 @@ typedef enum {
     /*!
      * Set frontend winId, used to define as parent window for plugin UIs.
      */
-    ENGINE_OPTION_FRONTEND_WIN_ID = 17
+    ENGINE_OPTION_FRONTEND_WIN_ID = 17,
+
+    /*!
+     * Number of extra audio threads used to process independent plugins in parallel.
+     * Default is 0, which processes everything in the engine's audio thread.
+     * @note Only used in rack and patchbay processing modes, cannot be changed while the engine is running
+     */
+    ENGINE_OPTION_PROCESS_THREADS = 18,
+
+    /*!
+     * Compute 4x oversampled true-peak values for the plugin meters, as in ITU-R BS.1770.
+     * Default is false, which only measures sample peaks and RMS.
+     */
+    ENGINE_OPTION_TRUE_PEAK_METERS = 19,
+
+    /*!
+     * Run plugin bridges one block behind the engine, so they process in parallel with the rest of the audio thread.
+     * Each bridged plugin then reports one block of latency.
+     * Default is false.
+     * @note Only applies to bridges started after this option is set
+     */
+    ENGINE_OPTION_PIPELINED_BRIDGES = 20,
+
+    /*!
+     * Let plugin bridges use their shared memory audio pool as the engine port buffers, avoiding a copy on each side.
+     * Default is false.
+     * @note Only used in patchbay processing mode, cannot be changed while the engine is running
+     * @see ENGINE_OPTION_PROCESS_THREADS
+     */
+    ENGINE_OPTION_SHARED_BRIDGE_BUFFERS = 21,
+
+    /*!
+     * Host bridged plugins of the same binary type in a single bridge process, processed together with one round trip per block.
+     * Value is a bitmask of binary types, as (1 << BinaryType). Binary types not in the mask keep one process per plugin,
+     * so a crashing plugin only takes down its own group.
+     * Grouped bridges always run pipelined, see ENGINE_OPTION_PIPELINED_BRIDGES.
+     * Default is 0.
+     * @note Only applies to bridges started after this option is set
+     */
+    ENGINE_OPTION_GROUPED_BRIDGES = 22,
+
+    /*!
+     * Maximum rate of the engine idle thread, in Hz.
+     * The thread runs when the audio thread has new plugin events, but never more often than this.
+     * It also polls at this rate while plugin UIs or OSC clients need parameter output updates.
+     * Default is 40.
+     */
+    ENGINE_OPTION_MAX_IDLE_RATE = 23,
+
+    /*!
+     * Maximum number of threads used to create plugins and restore their state while loading a project.
+     * Plugins are still added to the engine in project order. Only LADSPA, DSSI, LV2 and bridged plugins are created outside of the main thread.
+     * Default is 0, which uses one thread per CPU core (up to 8). Set to 1 to load plugins one by one.
+     */
+    ENGINE_OPTION_MAX_LOAD_THREADS = 24
 
 } EngineOption;
 
@@ -73,7 +73,12 @@ enum EngineType {
     /*!
      * Bridge engine type, used in BridgePlugin class.
      */
-    kEngineTypeBridge = 5
+    kEngineTypeBridge = 5,
+
+    /*!
+     * Dummy engine type, renders offline from and to audio files.
+     */
+    kEngineTypeDummy = 6
 };
 
 /*!
@@ -253,6 +258,14 @@ struct CARLA_API EngineOptions {
     bool preventBadBehaviour;
     uintptr_t frontendWinId;
 
+    uint processThreads;
+    bool truePeakMeters;
+    bool pipelinedBridges;
+    bool sharedBridgeBuffers;
+    uint groupedBridges;
+    uint maxIdleRate;
+    uint maxLoadThreads;
+
 #ifndef DOXYGEN
     EngineOptions() noexcept;
     ~EngineOptions() noexcept;
@@ -306,6 +319,42 @@ struct CARLA_API EngineTimeInfo {
 #endif
 };
 
+/*!
+ * Engine meter values of a single audio channel, for the last processed block.
+ */
+struct CARLA_API EngineMeterValue {
+    float peak;     //!< absolute sample peak
+    float rms;      //!< root mean square
+    float truePeak; //!< 4x oversampled peak, 0.0 unless ENGINE_OPTION_TRUE_PEAK_METERS is set
+};
+
+/*!
+ * Engine DSP load of a single plugin, measured around its process() call.
+ */
+struct CARLA_API EngineDspLoad {
+    float lastUsecs;     //!< time used by the last processed block, in microseconds
+    float averageUsecs;  //!< smoothed average time per block, in microseconds
+    float p99Usecs;      //!< 99th percentile of the recent blocks, in microseconds
+    float periodPercent; //!< average time as a percentage of the buffer period
+    uint32_t overruns;   //!< number of blocks that took longer than the buffer period
+
+    // plugins without a worker keep these at 0
+    uint32_t workerQueueDepth;    //!< worker requests waiting or being worked on
+    uint32_t workerMaxQueueDepth; //!< largest worker queue depth seen
+    float workerMaxLatencyUsecs;  //!< longest time from scheduling some work to the end of it, in microseconds
+    uint32_t workerDropped;       //!< worker requests rejected because the queue was full
+};
+
+/*!
+ * Engine MIDI input timing, for drivers that timestamp incoming MIDI events.
+ */
+struct CARLA_API EngineMidiInputJitter {
+    float averageUsecs;  //!< average delivery delay removed by timestamp correction, in microseconds
+    float maxUsecs;      //!< largest delivery delay seen, in microseconds
+    uint32_t events;     //!< number of events received
+    uint32_t lateEvents; //!< events that arrived too late to be placed at their exact frame
+};
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -539,8 +588,12 @@ public:
 #ifndef DOXYGEN
 protected:
     EngineEvent* fBuffer;
+    ushort fWriteIndex; // output ports only, next free event (or lower, if shared with other ports)
     const EngineProcessMode kProcessMode;
     friend class CarlaPluginInstance;
+    friend struct RackGraph;
+
+    ushort _getWriteIndex() noexcept;
 
     CARLA_DECLARE_NON_COPY_CLASS(CarlaEngineEventPort)
 #endif
@@ -910,15 +963,40 @@ public:
     // Information (peaks)
 
     /*!
-     * TODO.
+     * Get a plugin's input peak value, left or right channel.
+     * This is the true-peak when ENGINE_OPTION_TRUE_PEAK_METERS is set.
+     * @note Meters are only processed while someone keeps reading them
      */
     float getInputPeak(const uint pluginId, const bool isLeft) const noexcept;
 
     /*!
-     * TODO.
+     * Get a plugin's output peak value, left or right channel.
+     * This is the true-peak when ENGINE_OPTION_TRUE_PEAK_METERS is set.
+     * @note Meters are only processed while someone keeps reading them
      */
     float getOutputPeak(const uint pluginId, const bool isLeft) const noexcept;
 
+    /*!
+     * Get all meter values of a plugin's input channel.
+     */
+    EngineMeterValue getInputMeter(const uint pluginId, const uint channel) const noexcept;
+
+    /*!
+     * Get all meter values of a plugin's output channel.
+     */
+    EngineMeterValue getOutputMeter(const uint pluginId, const uint channel) const noexcept;
+
+    /*!
+     * Get a plugin's DSP load, measured in every engine process cycle.
+     */
+    EngineDspLoad getPluginDspLoad(const uint pluginId) const noexcept;
+
+    /*!
+     * Get the timing of incoming MIDI events.
+     * Values are all zero if the current driver does not timestamp MIDI input.
+     */
+    virtual EngineMidiInputJitter getMidiInputJitter() const noexcept;
+
     // -------------------------------------------------------------------
     // Callback
 
@@ -1007,6 +1085,12 @@ public:
      */
     void setAboutToClose() noexcept;
 
+    /*!
+     * Check if the caller is one of the threads loading plugins for a project.
+     * Plugins there are not part of the engine yet, so they must not idle it.
+     */
+    bool isPluginLoaderThread() const noexcept;
+
     // -------------------------------------------------------------------
     // Options
 
@@ -1015,6 +1099,13 @@ public:
      */
     void setOption(const EngineOption option, const int value, const char* const valueStr) noexcept;
 
+#ifdef BUILD_BRIDGE
+    /*!
+     * Set the engine options passed by the bridge server as ENGINE_OPTION_* environment variables.
+     */
+    void setOptionsFromEnvironment();
+#endif
+
     // -------------------------------------------------------------------
     // OSC Stuff
 
@@ -1049,6 +1140,12 @@ public:
      */
     EngineEvent* getInternalEventBuffer(const bool isInput) const noexcept;
 
+    /*!
+     * Wake up the engine thread, so it handles new plugin events right away instead of on its next timeout.
+     * @note RT call
+     */
+    void wakeIdleThread() const noexcept;
+
 #ifndef BUILD_BRIDGE
     /*!
      * Virtual functions for handling external graph ports.
@@ -1069,9 +1166,11 @@ protected:
     /*!
      * Some internal classes read directly from pData or call protected functions.
      */
+    friend class CarlaEngineLoader;
     friend class CarlaPluginInstance;
     friend class EngineInternalGraph;
     friend class PendingRtEventsRunner;
+    friend class RackParallelLanes;
     friend class ScopedActionLock;
     friend class ScopedEngineEnvironmentLocker;
     friend struct PatchbayGraph;
@@ -1080,6 +1179,19 @@ protected:
     // -------------------------------------------------------------------
     // Internal stuff
 
+    /*!
+     * Create a plugin with id @a id, without adding it to the engine.
+     * Returns null and sets the last error on failure.
+     */
+    CarlaPlugin* createPlugin(const uint id, const BinaryType btype, const PluginType ptype,
+                              const char* const filename, const char* const name, const char* const label, const int64_t uniqueId,
+                              const void* const extra, const uint options);
+
+    /*!
+     * Add a plugin made by createPlugin() to the end of the plugin list, activating it if requested.
+     */
+    void appendPlugin(CarlaPlugin* const plugin, const bool activate);
+
     /*!
      * Report to all plugins about buffer size change.
      */
@@ -1096,12 +1208,6 @@ protected:
      */
     void offlineModeChanged(const bool isOffline);
 
-    /*!
-     * Set a plugin (stereo) peak values.
-     * @note RT call
-     */
-    void setPluginPeaks(const uint pluginId, float const inPeaks[2], float const outPeaks[2]) noexcept;
-
     /*!
      * Common save project function for main engine and plugin.
      */
@@ -1155,6 +1261,9 @@ public:
     // Bridge
     static CarlaEngine*       newBridge(const char* const audioPoolBaseName, const char* const rtClientBaseName, const char* const nonRtClientBaseName, const char* const nonRtServerBaseName);
 #else
+    // Dummy
+    static CarlaEngine*       newDummy();
+
 # if defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN)
     // Juce
     static CarlaEngine*       newJuce(const AudioApi api);
@@ -1200,12 +1309,44 @@ public:
     void oscSend_control_note_on(const uint pluginId, const uint8_t channel, const uint8_t note, const uint8_t velo) const noexcept;
     void oscSend_control_note_off(const uint pluginId, const uint8_t channel, const uint8_t note) const noexcept;
     void oscSend_control_set_peaks(const uint pluginId) const noexcept;
+    void oscSend_control_set_dsp_load(const uint pluginId) const noexcept;
     void oscSend_control_exit() const noexcept;
 #endif
 
     CARLA_DECLARE_NON_COPY_CLASS(CarlaEngine)
 };
 
+#ifdef BUILD_BRIDGE
+// -----------------------------------------------------------------------
+
+/*!
+ * Several bridged plugins sharing one process.
+ * The server adds and removes plugins through a shared control ring, each plugin runs in its own bridge engine
+ * and all of them are processed from the same thread, one semaphore round trip per block.
+ */
+class CARLA_API CarlaEngineBridgeGroup
+{
+public:
+    /*!
+     * The destructor.
+     * Closes all remaining plugins.
+     */
+    virtual ~CarlaEngineBridgeGroup() {}
+
+    /*!
+     * Handle server messages and idle all plugins.
+     * Returns false once the group is no longer needed and the process can quit.
+     */
+    virtual bool idle() noexcept = 0;
+
+    /*!
+     * Create a group attached to the shared memory @a groupBaseName.
+     * Returns nullptr if the shared memory could not be used.
+     */
+    static CarlaEngineBridgeGroup* newGroup(const char* const groupBaseName);
+};
+#endif
+
 /**@}*/
 
 // -----------------------------------------------------------------------
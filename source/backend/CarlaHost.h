@@ -268,6 +268,85 @@ typedef struct _CarlaTransportInfo {
 
 } CarlaTransportInfo;
 
+/*!
+ * Plugin DSP load information, measured around its process() call.
+ * @see carla_get_plugin_dsp_load()
+ */
+typedef struct _CarlaDspLoadInfo {
+    /*!
+     * Time used by the last processed block, in microseconds.
+     */
+    float lastUsecs;
+
+    /*!
+     * Smoothed average time per block, in microseconds.
+     */
+    float averageUsecs;
+
+    /*!
+     * 99th percentile of the recent blocks, in microseconds.
+     */
+    float p99Usecs;
+
+    /*!
+     * Average time as a percentage of the buffer period.
+     */
+    float periodPercent;
+
+    /*!
+     * Number of blocks that took longer than the buffer period.
+     */
+    uint32_t overruns;
+
+    /*!
+     * Worker requests waiting or being worked on, for plugins with a worker (LV2 only).
+     */
+    uint32_t workerQueueDepth;
+
+    /*!
+     * Largest worker queue depth seen.
+     */
+    uint32_t workerMaxQueueDepth;
+
+    /*!
+     * Longest time from scheduling some work to the end of it, in microseconds.
+     */
+    float workerMaxLatencyUsecs;
+
+    /*!
+     * Worker requests rejected because the queue was full.
+     */
+    uint32_t workerDropped;
+
+} CarlaDspLoadInfo;
+
+/*!
+ * Engine MIDI input timing information.
+ * @see carla_get_midi_input_jitter()
+ */
+typedef struct _CarlaMidiJitterInfo {
+    /*!
+     * Average delivery delay removed by timestamp correction, in microseconds.
+     */
+    float averageUsecs;
+
+    /*!
+     * Largest delivery delay seen, in microseconds.
+     */
+    float maxUsecs;
+
+    /*!
+     * Number of events received.
+     */
+    uint32_t events;
+
+    /*!
+     * Events that arrived too late to be placed at their exact frame.
+     */
+    uint32_t lateEvents;
+
+} CarlaMidiJitterInfo;
+
 /* ------------------------------------------------------------------------------------------------------------
  * Carla Host API (C functions) */
 
@@ -708,6 +787,19 @@ CARLA_EXPORT float carla_get_input_peak_value(uint pluginId, bool isLeft);
  */
 CARLA_EXPORT float carla_get_output_peak_value(uint pluginId, bool isLeft);
 
+/*!
+ * Get a plugin's DSP load.
+ * Use this to find which plugin is using most of the audio period.
+ * @param pluginId Plugin
+ */
+CARLA_EXPORT const CarlaDspLoadInfo* carla_get_plugin_dsp_load(uint pluginId);
+
+/*!
+ * Get the timing of incoming MIDI events.
+ * Only the RtAudio drivers timestamp MIDI input, other drivers report zeros.
+ */
+CARLA_EXPORT const CarlaMidiJitterInfo* carla_get_midi_input_jitter();
+
 /*!
  * Enable or disable a plugin.
  * @param pluginId Plugin
@@ -758,6 +850,14 @@ CARLA_EXPORT void carla_set_panning(uint pluginId, float value);
  */
 CARLA_EXPORT void carla_set_ctrl_channel(uint pluginId, int8_t channel);
 
+/*!
+ * Change a plugin's rack lane.
+ * Plugins in different lanes are processed in parallel, see ENGINE_OPTION_PROCESS_THREADS.
+ * @param pluginId Plugin
+ * @param lane     New lane, lower than MAX_RACK_LANES
+ */
+CARLA_EXPORT void carla_set_rack_lane(uint pluginId, uint lane);
+
 /*!
  * Enable a plugin's option.
  * @param pluginId Plugin
@@ -769,6 +869,8 @@ CARLA_EXPORT void carla_set_option(uint pluginId, uint option, bool yesNo);
 
 /*!
  * Change a plugin's parameter value.
+ * While the engine is running the change is applied at the start of the next processed block,
+ * carla_get_current_parameter_value() returns the previous value until then.
  * @param pluginId    Plugin
  * @param parameterId Parameter index
  * @param value       New value
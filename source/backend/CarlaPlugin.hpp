@@ -48,6 +48,7 @@ class CarlaEngineAudioPort;
 class CarlaEngineCVPort;
 class CarlaEngineEventPort;
 struct CarlaStateSave;
+struct EngineDspLoad;
 
 // -----------------------------------------------------------------------
 
@@ -156,6 +157,12 @@ public:
      */
     virtual uint32_t getLatencyInFrames() const noexcept;
 
+    /*!
+     * Fill in the worker fields of @a load, for plugins that run some of their work outside the audio thread.
+     * Leaves them untouched otherwise.
+     */
+    virtual void getWorkerLoad(EngineDspLoad& load) const noexcept;
+
     // -------------------------------------------------------------------
     // Information (count)
 
@@ -284,6 +291,7 @@ public:
 
     /*!
      * Get the current parameter value of @a parameterId.
+     * A change from queueParameterValue() only shows here after the next processed block.
      */
     virtual float getParameterValue(const uint32_t parameterId) const noexcept;
 
@@ -547,6 +555,15 @@ public:
      */
     void setParameterValueByRealIndex(const int32_t rindex, const float value, const bool sendGui, const bool sendOsc, const bool sendCallback) noexcept;
 
+    /*!
+     * Queue a plugin's parameter value change from a control thread (UI, OSC, host API).
+     * The audio thread applies it at the start of the next processed block, repeated changes to the
+     * same parameter in between are coalesced. Sends the messages right away, like setParameterValue().
+     * Until then getParameterValue() still returns the previous value, as the plugin has not seen the new one yet.
+     * Falls back to setParameterValue() while the plugin is not processing, where the change is immediate.
+     */
+    void queueParameterValue(const uint32_t parameterId, const float value, const bool sendGui, const bool sendOsc, const bool sendCallback) noexcept;
+
     /*!
      * Set parameter's @a parameterId MIDI channel to @a channel.
      * @a channel must be between 0 and 15.
@@ -694,6 +711,13 @@ public:
      */
     virtual void clearBuffers() noexcept;
 
+    /*!
+     * Get the buffer the plugin uses internally for one of its audio ports, or null if there is none (the default).
+     * If the engine passes this same buffer to process(), the plugin can use it in place instead of copying.
+     * @note RT call, only valid while the plugin is locked, may change when the buffer size changes
+     */
+    virtual float* getAudioPortBuffer(const bool isInput, const uint32_t index) const noexcept;
+
     // -------------------------------------------------------------------
     // OSC stuff
 
@@ -855,6 +879,25 @@ public:
      */
     void setPatchbayNodeId(const uint32_t nodeId) noexcept;
 
+    /*!
+     * Get the plugin's rack lane.
+     * @see setRackLane()
+     */
+    uint getRackLane() const noexcept;
+
+    /*!
+     * Set the plugin's rack lane.
+     * Plugins in different lanes are processed in parallel, if the engine has extra process threads.
+     * @see getRackLane()
+     */
+    void setRackLane(const uint lane) noexcept;
+
+    /*!
+     * Check if the plugin has event ports besides the default ones.
+     * Such plugins can't have their events redirected, so they are never processed in parallel.
+     */
+    bool hasExtraEventPorts() const noexcept;
+
     // -------------------------------------------------------------------
     // Plugin initializers
 
@@ -914,6 +957,12 @@ protected:
     struct ProtectedData;
     ProtectedData* const pData;
 
+    /*!
+     * Apply parameter changes queued by queueParameterValue().
+     * @note RT call, every subclass must use it at the start of process(), or queued changes never apply
+     */
+    void processParameterQueue() noexcept;
+
     // -------------------------------------------------------------------
     // Helper classes
 
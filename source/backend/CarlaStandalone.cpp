@@ -144,68 +144,7 @@ static void carla_engine_init_common()
     gStandalone.engine->setFileCallback(gStandalone.fileCallback, gStandalone.fileCallbackPtr);
 
 #ifdef BUILD_BRIDGE
-    using juce::File;
-    File juceBinaryDir(File::getSpecialLocation(File::currentExecutableFile).getParentDirectory());
-
-    /*
-    if (const char* const uisAlwaysOnTop = std::getenv("ENGINE_OPTION_FORCE_STEREO"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_FORCE_STEREO, (std::strcmp(uisAlwaysOnTop, "true") == 0) ? 1 : 0, nullptr);
-
-    if (const char* const uisAlwaysOnTop = std::getenv("ENGINE_OPTION_PREFER_PLUGIN_BRIDGES"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PREFER_PLUGIN_BRIDGES, (std::strcmp(uisAlwaysOnTop, "true") == 0) ? 1 : 0, nullptr);
-
-    if (const char* const uisAlwaysOnTop = std::getenv("ENGINE_OPTION_PREFER_UI_BRIDGES"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PREFER_UI_BRIDGES, (std::strcmp(uisAlwaysOnTop, "true") == 0) ? 1 : 0, nullptr);
-    */
-
-    if (const char* const uisAlwaysOnTop = std::getenv("ENGINE_OPTION_UIS_ALWAYS_ON_TOP"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_UIS_ALWAYS_ON_TOP, (std::strcmp(uisAlwaysOnTop, "true") == 0) ? 1 : 0, nullptr);
-
-    if (const char* const maxParameters = std::getenv("ENGINE_OPTION_MAX_PARAMETERS"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_MAX_PARAMETERS,     std::atoi(maxParameters), nullptr);
-
-    if (const char* const uiBridgesTimeout = std::getenv("ENGINE_OPTION_UI_BRIDGES_TIMEOUT"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_UI_BRIDGES_TIMEOUT, std::atoi(uiBridgesTimeout), nullptr);
-
-    if (const char* const pathLADSPA = std::getenv("ENGINE_OPTION_PLUGIN_PATH_LADSPA"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PLUGIN_PATH, CB::PLUGIN_LADSPA, pathLADSPA);
-
-    if (const char* const pathDSSI = std::getenv("ENGINE_OPTION_PLUGIN_PATH_DSSI"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PLUGIN_PATH, CB::PLUGIN_DSSI, pathDSSI);
-
-    if (const char* const pathLV2 = std::getenv("ENGINE_OPTION_PLUGIN_PATH_LV2"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PLUGIN_PATH, CB::PLUGIN_LV2, pathLV2);
-
-    if (const char* const pathVST2 = std::getenv("ENGINE_OPTION_PLUGIN_PATH_VST2"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PLUGIN_PATH, CB::PLUGIN_VST2, pathVST2);
-
-    if (const char* const pathVST3 = std::getenv("ENGINE_OPTION_PLUGIN_PATH_VST3"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PLUGIN_PATH, CB::PLUGIN_VST3, pathVST3);
-
-    if (const char* const pathGIG = std::getenv("ENGINE_OPTION_PLUGIN_PATH_GIG"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PLUGIN_PATH, CB::PLUGIN_GIG, pathGIG);
-
-    if (const char* const pathSF2 = std::getenv("ENGINE_OPTION_PLUGIN_PATH_SF2"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PLUGIN_PATH, CB::PLUGIN_SF2, pathSF2);
-
-    if (const char* const pathSFZ = std::getenv("ENGINE_OPTION_PLUGIN_PATH_SFZ"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PLUGIN_PATH, CB::PLUGIN_SFZ, pathSFZ);
-
-    if (const char* const binaryDir = std::getenv("ENGINE_OPTION_PATH_BINARIES"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PATH_BINARIES,   0, binaryDir);
-    else
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PATH_BINARIES,   0, juceBinaryDir.getFullPathName().toRawUTF8());
-
-    if (const char* const resourceDir = std::getenv("ENGINE_OPTION_PATH_RESOURCES"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PATH_RESOURCES,  0, resourceDir);
-    else
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PATH_RESOURCES,  0, juceBinaryDir.getChildFile("resources").getFullPathName().toRawUTF8());
-
-    if (const char* const preventBadBehaviour = std::getenv("ENGINE_OPTION_PREVENT_BAD_BEHAVIOUR"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_PREVENT_BAD_BEHAVIOUR, (std::strcmp(preventBadBehaviour, "true") == 0) ? 1 : 0, nullptr);
-
-    if (const char* const frontendWinId = std::getenv("ENGINE_OPTION_FRONTEND_WIN_ID"))
-        gStandalone.engine->setOption(CB::ENGINE_OPTION_FRONTEND_WIN_ID, 0, frontendWinId);
+    gStandalone.engine->setOptionsFromEnvironment();
 #else
     gStandalone.engine->setOption(CB::ENGINE_OPTION_FORCE_STEREO,          gStandalone.engineOptions.forceStereo         ? 1 : 0,        nullptr);
     gStandalone.engine->setOption(CB::ENGINE_OPTION_PREFER_PLUGIN_BRIDGES, gStandalone.engineOptions.preferPluginBridges ? 1 : 0,        nullptr);
@@ -216,6 +155,13 @@ static void carla_engine_init_common()
     gStandalone.engine->setOption(CB::ENGINE_OPTION_AUDIO_NUM_PERIODS,     static_cast<int>(gStandalone.engineOptions.audioNumPeriods),  nullptr);
     gStandalone.engine->setOption(CB::ENGINE_OPTION_AUDIO_BUFFER_SIZE,     static_cast<int>(gStandalone.engineOptions.audioBufferSize),  nullptr);
     gStandalone.engine->setOption(CB::ENGINE_OPTION_AUDIO_SAMPLE_RATE,     static_cast<int>(gStandalone.engineOptions.audioSampleRate),  nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_PROCESS_THREADS,       static_cast<int>(gStandalone.engineOptions.processThreads),   nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_TRUE_PEAK_METERS,      gStandalone.engineOptions.truePeakMeters      ? 1 : 0,        nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_PIPELINED_BRIDGES,     gStandalone.engineOptions.pipelinedBridges    ? 1 : 0,        nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_SHARED_BRIDGE_BUFFERS, gStandalone.engineOptions.sharedBridgeBuffers ? 1 : 0,        nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_GROUPED_BRIDGES,       static_cast<int>(gStandalone.engineOptions.groupedBridges),   nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_MAX_IDLE_RATE,         static_cast<int>(gStandalone.engineOptions.maxIdleRate),      nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_MAX_LOAD_THREADS,      static_cast<int>(gStandalone.engineOptions.maxLoadThreads),   nullptr);
 
     if (gStandalone.engineOptions.audioDevice != nullptr)
         gStandalone.engine->setOption(CB::ENGINE_OPTION_AUDIO_DEVICE,      0, gStandalone.engineOptions.audioDevice);
@@ -584,11 +530,46 @@ void carla_set_engine_option(EngineOption option, int value, const char* valueSt
         gStandalone.engineOptions.preventBadBehaviour = (value != 0);
         break;
 
-    case CB::ENGINE_OPTION_FRONTEND_WIN_ID:
+    case CB::ENGINE_OPTION_FRONTEND_WIN_ID: {
         CARLA_SAFE_ASSERT_RETURN(valueStr != nullptr && valueStr[0] != '\0',);
         const long long winId(std::strtoll(valueStr, nullptr, 16));
         CARLA_SAFE_ASSERT_RETURN(winId >= 0,);
         gStandalone.engineOptions.frontendWinId = static_cast<uintptr_t>(winId);
+    }   break;
+
+    case CB::ENGINE_OPTION_PROCESS_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 64,);
+        gStandalone.engineOptions.processThreads = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_TRUE_PEAK_METERS:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        gStandalone.engineOptions.truePeakMeters = (value != 0);
+        break;
+
+    case CB::ENGINE_OPTION_PIPELINED_BRIDGES:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        gStandalone.engineOptions.pipelinedBridges = (value != 0);
+        break;
+
+    case CB::ENGINE_OPTION_SHARED_BRIDGE_BUFFERS:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        gStandalone.engineOptions.sharedBridgeBuffers = (value != 0);
+        break;
+
+    case CB::ENGINE_OPTION_GROUPED_BRIDGES:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        gStandalone.engineOptions.groupedBridges = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_MAX_IDLE_RATE:
+        CARLA_SAFE_ASSERT_RETURN(value >= 1 && value <= 1000,);
+        gStandalone.engineOptions.maxIdleRate = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_MAX_LOAD_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 64,);
+        gStandalone.engineOptions.maxLoadThreads = static_cast<uint>(value);
         break;
     }
 
@@ -1550,6 +1531,58 @@ float carla_get_output_peak_value(uint pluginId, bool isLeft)
     return gStandalone.engine->getOutputPeak(pluginId, isLeft);
 }
 
+const CarlaDspLoadInfo* carla_get_plugin_dsp_load(uint pluginId)
+{
+    static CarlaDspLoadInfo info;
+
+    // reset
+    info.lastUsecs     = 0.0f;
+    info.averageUsecs  = 0.0f;
+    info.p99Usecs      = 0.0f;
+    info.periodPercent = 0.0f;
+    info.overruns      = 0;
+    info.workerQueueDepth      = 0;
+    info.workerMaxQueueDepth   = 0;
+    info.workerMaxLatencyUsecs = 0.0f;
+    info.workerDropped         = 0;
+
+    CARLA_SAFE_ASSERT_RETURN(gStandalone.engine != nullptr, &info);
+
+    const CB::EngineDspLoad load(gStandalone.engine->getPluginDspLoad(pluginId));
+
+    info.lastUsecs     = load.lastUsecs;
+    info.averageUsecs  = load.averageUsecs;
+    info.p99Usecs      = load.p99Usecs;
+    info.periodPercent = load.periodPercent;
+    info.overruns      = load.overruns;
+    info.workerQueueDepth      = load.workerQueueDepth;
+    info.workerMaxQueueDepth   = load.workerMaxQueueDepth;
+    info.workerMaxLatencyUsecs = load.workerMaxLatencyUsecs;
+    info.workerDropped         = load.workerDropped;
+    return &info;
+}
+
+const CarlaMidiJitterInfo* carla_get_midi_input_jitter()
+{
+    static CarlaMidiJitterInfo info;
+
+    // reset
+    info.averageUsecs = 0.0f;
+    info.maxUsecs     = 0.0f;
+    info.events       = 0;
+    info.lateEvents   = 0;
+
+    CARLA_SAFE_ASSERT_RETURN(gStandalone.engine != nullptr, &info);
+
+    const CB::EngineMidiInputJitter jitter(gStandalone.engine->getMidiInputJitter());
+
+    info.averageUsecs = jitter.averageUsecs;
+    info.maxUsecs     = jitter.maxUsecs;
+    info.events       = jitter.events;
+    info.lateEvents   = jitter.lateEvents;
+    return &info;
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 void carla_set_active(uint pluginId, bool onOff)
@@ -1631,6 +1664,18 @@ void carla_set_ctrl_channel(uint pluginId, int8_t channel)
     carla_stderr2("carla_set_ctrl_channel(%i, %i) - could not find plugin", pluginId, channel);
 }
 
+void carla_set_rack_lane(uint pluginId, uint lane)
+{
+    CARLA_SAFE_ASSERT_RETURN(gStandalone.engine != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(lane < CB::MAX_RACK_LANES,);
+    carla_debug("carla_set_rack_lane(%i, %i)", pluginId, lane);
+
+    if (CarlaPlugin* const plugin = gStandalone.engine->getPlugin(pluginId))
+        return plugin->setRackLane(lane);
+
+    carla_stderr2("carla_set_rack_lane(%i, %i) - could not find plugin", pluginId, lane);
+}
+
 void carla_set_option(uint pluginId, uint option, bool yesNo)
 {
     CARLA_SAFE_ASSERT_RETURN(gStandalone.engine != nullptr,);
@@ -1653,7 +1698,7 @@ void carla_set_parameter_value(uint pluginId, uint32_t parameterId, float value)
     if (CarlaPlugin* const plugin = gStandalone.engine->getPlugin(pluginId))
     {
         if (parameterId < plugin->getParameterCount())
-            return plugin->setParameterValue(parameterId, value, true, true, false);
+            return plugin->queueParameterValue(parameterId, value, true, true, false);
 
         carla_stderr2("carla_set_parameter_value(%i, %i, %f) - parameterId out of bounds", pluginId, parameterId, value);
         return;
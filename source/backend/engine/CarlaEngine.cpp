@@ -81,6 +81,7 @@ uint CarlaEngine::getDriverCount()
 # else
     count += getRtAudioApiCount();
 # endif
+    count += 1;
 #endif
 
     return count;
@@ -111,6 +112,9 @@ const char* CarlaEngine::getDriverName(const uint index2)
         index -= count;
     }
 # endif
+
+    if (index-- == 0)
+        return "Dummy";
 #endif
 
     carla_stderr("CarlaEngine::getDriverName(%i) - invalid index", index2);
@@ -145,6 +149,13 @@ const char* const* CarlaEngine::getDriverDeviceNames(const uint index2)
         index -= count;
     }
 # endif
+
+    if (index-- == 0)
+    {
+        // device is a file path, nothing to list
+        static const char* ret[1] = { nullptr };
+        return ret;
+    }
 #endif
 
     carla_stderr("CarlaEngine::getDriverDeviceNames(%i) - invalid index", index2);
@@ -183,6 +194,17 @@ const EngineDriverDeviceInfo* CarlaEngine::getDriverDeviceInfo(const uint index2
         index -= count;
     }
 # endif
+
+    if (index-- == 0)
+    {
+        static uint32_t bufSizes[11] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 0 };
+        static double   sampleRates[9] = { 22050.0, 32000.0, 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0, 0.0 };
+        static EngineDriverDeviceInfo devInfo;
+        devInfo.hints       = 0x0;
+        devInfo.bufferSizes = bufSizes;
+        devInfo.sampleRates = sampleRates;
+        return &devInfo;
+    }
 #endif
 
     carla_stderr("CarlaEngine::getDriverDeviceNames(%i, \"%s\") - invalid index", index2, deviceName);
@@ -229,6 +251,12 @@ CarlaEngine* CarlaEngine::newDriverByName(const char* const driverName)
     if (std::strcmp(driverName, "PulseAudio") == 0)
         return newRtAudio(AUDIO_API_PULSE);
 # endif
+
+    // -------------------------------------------------------------------
+    // offline
+
+    if (std::strcmp(driverName, "Dummy") == 0)
+        return newDummy();
 #endif
 
     carla_stderr("CarlaEngine::newDriverByName(\"%s\") - invalid driver name", driverName);
@@ -315,9 +343,105 @@ CarlaEngineClient* CarlaEngine::addClient(CarlaPlugin* const)
     return new CarlaEngineClient(*this);
 }
 
+#ifndef BRIDGE_PLUGIN
+// -----------------------------------------------------------------------
+// Plugin bridges
+
+// full path to the bridge for @a btype, empty if not available
+static CarlaString findBridgeBinary(const char* const binaryDir, const BinaryType btype)
+{
+    CarlaString bridgeBinary(binaryDir);
+
+    if (bridgeBinary.isNotEmpty())
+    {
+        if (btype == BINARY_NATIVE)
+        {
+#ifdef CARLA_OS_WIN
+            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-native.exe";
+#else
+            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-native";
+#endif
+        }
+        else
+        {
+            switch (btype)
+            {
+            case BINARY_POSIX32:
+                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-posix32";
+                break;
+            case BINARY_POSIX64:
+                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-posix64";
+                break;
+            case BINARY_WIN32:
+                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-win32.exe";
+                break;
+            case BINARY_WIN64:
+                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-win64.exe";
+                break;
+            default:
+                bridgeBinary.clear();
+                break;
+            }
+        }
+
+        if (! File(bridgeBinary.buffer()).existsAsFile())
+            bridgeBinary.clear();
+    }
+
+    return bridgeBinary;
+}
+#endif
+
 // -----------------------------------------------------------------------
 // Plugin management
 
+// next candidate for a name that is already taken, "name" -> "name (2)" -> "name (3)" ...
+static void bumpUniquePluginName(CarlaString& sname)
+{
+    const std::size_t len(sname.length());
+
+    // 1 digit, ex: " (2)"
+    if (sname[len-4] == ' ' && sname[len-3] == '(' && sname.isDigit(len-2) && sname[len-1] == ')')
+    {
+        const int number = sname[len-2] - '0';
+
+        if (number == 9)
+        {
+            // next number is 10, 2 digits
+            sname.truncate(len-4);
+            sname += " (10)";
+            //sname.replace(" (9)", " (10)");
+        }
+        else
+            sname[len-2] = char('0' + number + 1);
+
+        return;
+    }
+
+    // 2 digits, ex: " (11)"
+    if (sname[len-5] == ' ' && sname[len-4] == '(' && sname.isDigit(len-3) && sname.isDigit(len-2) && sname[len-1] == ')')
+    {
+        char n2 = sname[len-2];
+        char n3 = sname[len-3];
+
+        if (n2 == '9')
+        {
+            n2 = '0';
+            n3 = static_cast<char>(n3 + 1);
+        }
+        else
+            n2 = static_cast<char>(n2 + 1);
+
+        sname[len-2] = n2;
+        sname[len-3] = n3;
+
+        return;
+    }
+
+    // Modify string if not
+    sname += " (2)";
+}
+
 bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
                             const char* const filename, const char* const name, const char* const label, const int64_t uniqueId,
                             const void* const extra, const uint options)
@@ -359,6 +483,58 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
         CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins[id].plugin == nullptr, "Invalid engine internal data");
     }
 
+    CarlaPlugin* const plugin(createPlugin(id, btype, ptype, filename, name, label, uniqueId, extra, options));
+
+    if (plugin == nullptr)
+        return false;
+
+#ifndef BUILD_BRIDGE
+    if (oldPlugin != nullptr)
+    {
+# ifdef HAVE_LIBLO
+        plugin->registerToOscClient();
+# endif
+
+        EnginePluginData& pluginData(pData->plugins[id]);
+        pluginData.plugin = plugin;
+        pluginData.clearStats();
+
+        // the engine thread might be reading from the old plugin
+        pData->thread.stopThread(500);
+        pData->thread.startThread();
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.replacePlugin(oldPlugin, plugin);
+
+        const bool  wasActive = oldPlugin->getInternalParameterValue(PARAMETER_ACTIVE) >= 0.5f;
+        const float oldDryWet = oldPlugin->getInternalParameterValue(PARAMETER_DRYWET);
+        const float oldVolume = oldPlugin->getInternalParameterValue(PARAMETER_VOLUME);
+
+        delete oldPlugin;
+
+        if (plugin->getHints() & PLUGIN_CAN_DRYWET)
+            plugin->setDryWet(oldDryWet, true, true);
+
+        if (plugin->getHints() & PLUGIN_CAN_VOLUME)
+            plugin->setVolume(oldVolume, true, true);
+
+        plugin->setActive(wasActive, true, true);
+
+        callback(ENGINE_CALLBACK_RELOAD_ALL, id, 0, 0, 0.0f, nullptr);
+    }
+    else
+#endif
+    {
+        appendPlugin(plugin, true);
+    }
+
+    return true;
+}
+
+CarlaPlugin* CarlaEngine::createPlugin(const uint id, const BinaryType btype, const PluginType ptype,
+                                       const char* const filename, const char* const name, const char* const label, const int64_t uniqueId,
+                                       const void* const extra, const uint options)
+{
     CarlaPlugin::Initializer initializer = {
         this,
         id,
@@ -372,43 +548,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
     CarlaPlugin* plugin = nullptr;
 
 #ifndef BRIDGE_PLUGIN
-    CarlaString bridgeBinary(pData->options.binaryDir);
-
-    if (bridgeBinary.isNotEmpty())
-    {
-        if (btype == BINARY_NATIVE)
-        {
-#ifdef CARLA_OS_WIN
-            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-native.exe";
-#else
-            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-native";
-#endif
-        }
-        else
-        {
-            switch (btype)
-            {
-            case BINARY_POSIX32:
-                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-posix32";
-                break;
-            case BINARY_POSIX64:
-                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-posix64";
-                break;
-            case BINARY_WIN32:
-                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-win32.exe";
-                break;
-            case BINARY_WIN64:
-                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-win64.exe";
-                break;
-            default:
-                bridgeBinary.clear();
-                break;
-            }
-        }
-
-        if (! File(bridgeBinary.buffer()).existsAsFile())
-            bridgeBinary.clear();
-    }
+    const CarlaString bridgeBinary(findBridgeBinary(pData->options.binaryDir, btype));
 
     if (ptype != PLUGIN_INTERNAL && (btype != BINARY_NATIVE || (pData->options.preferPluginBridges && bridgeBinary.isNotEmpty())))
     {
@@ -444,7 +584,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
         else
         {
             setLastError("This Carla build cannot handle this binary");
-            return false;
+            return nullptr;
         }
     }
     else
@@ -523,7 +663,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
     }
 
     if (plugin == nullptr)
-        return false;
+        return nullptr;
 
     plugin->reload();
 
@@ -559,61 +699,42 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
     if (! canRun)
     {
         delete plugin;
-        return false;
+        return nullptr;
     }
 
+    return plugin;
+}
+
+void CarlaEngine::appendPlugin(CarlaPlugin* const plugin, const bool activate)
+{
+    CARLA_SAFE_ASSERT_RETURN(plugin != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(plugin->getId() == pData->curPluginCount,);
+    CARLA_SAFE_ASSERT_RETURN(pData->curPluginCount < pData->maxPluginNumber,);
+
+    const uint id(pData->curPluginCount);
+
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
     plugin->registerToOscClient();
 #endif
 
     EnginePluginData& pluginData(pData->plugins[id]);
-    pluginData.plugin      = plugin;
-    pluginData.insPeak[0]  = 0.0f;
-    pluginData.insPeak[1]  = 0.0f;
-    pluginData.outsPeak[0] = 0.0f;
-    pluginData.outsPeak[1] = 0.0f;
+    pluginData.plugin = plugin;
+    pluginData.clearStats();
 
-#ifndef BUILD_BRIDGE
-    if (oldPlugin != nullptr)
-    {
-        // the engine thread might be reading from the old plugin
-        pData->thread.stopThread(500);
-        pData->thread.startThread();
-
-        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
-            pData->graph.replacePlugin(oldPlugin, plugin);
-
-        const bool  wasActive = oldPlugin->getInternalParameterValue(PARAMETER_ACTIVE) >= 0.5f;
-        const float oldDryWet = oldPlugin->getInternalParameterValue(PARAMETER_DRYWET);
-        const float oldVolume = oldPlugin->getInternalParameterValue(PARAMETER_VOLUME);
-
-        delete oldPlugin;
-
-        if (plugin->getHints() & PLUGIN_CAN_DRYWET)
-            plugin->setDryWet(oldDryWet, true, true);
-
-        if (plugin->getHints() & PLUGIN_CAN_VOLUME)
-            plugin->setVolume(oldVolume, true, true);
-
-        plugin->setActive(wasActive, true, true);
-
-        callback(ENGINE_CALLBACK_RELOAD_ALL, id, 0, 0, 0.0f, nullptr);
-    }
-    else
-#endif
-    {
+    if (activate)
         plugin->setActive(true, true, false);
 
+    {
+        // plugins being loaded in other threads look at the added ones for a unique name
+        const CarlaMutexLocker cml(pData->loader.getNameMutex());
         ++pData->curPluginCount;
-        callback(ENGINE_CALLBACK_PLUGIN_ADDED, id, 0, 0, 0.0f, plugin->getName());
+    }
+    callback(ENGINE_CALLBACK_PLUGIN_ADDED, id, 0, 0, 0.0f, plugin->getName());
 
 #ifndef BUILD_BRIDGE
-        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
-            pData->graph.addPlugin(plugin);
+    if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+        pData->graph.addPlugin(plugin);
 #endif
-    }
-
-    return true;
 }
 
 bool CarlaEngine::addPlugin(const PluginType ptype, const char* const filename, const char* const name, const char* const label, const int64_t uniqueId, const void* const extra)
@@ -714,10 +835,7 @@ bool CarlaEngine::removeAllPlugins()
             pluginData.plugin = nullptr;
         }
 
-        pluginData.insPeak[0]  = 0.0f;
-        pluginData.insPeak[1]  = 0.0f;
-        pluginData.outsPeak[0] = 0.0f;
-        pluginData.outsPeak[1] = 0.0f;
+        pluginData.clearStats();
 
         callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
     }
@@ -903,64 +1021,36 @@ const char* CarlaEngine::getUniquePluginName(const char* const name) const
     sname.truncate(maxNameSize);
     sname.replace(':', '.'); // ':' is used in JACK1 to split client/port names
 
-    for (uint i=0; i < pData->curPluginCount; ++i)
-    {
-        CARLA_SAFE_ASSERT_BREAK(pData->plugins[i].plugin != nullptr);
+    // plugins being loaded in other threads pick their names at the same time
+    const CarlaMutexLocker cml(pData->loader.getNameMutex());
 
-        // Check if unique name doesn't exist
-        if (const char* const pluginName = pData->plugins[i].plugin->getName())
-        {
-            if (sname != pluginName)
-                continue;
-        }
+    for (bool isUnique = false; ! isUnique;)
+    {
+        isUnique = true;
 
-        // Check if string has already been modified
+        for (uint i=0; i < pData->curPluginCount; ++i)
         {
-            const std::size_t len(sname.length());
+            CARLA_SAFE_ASSERT_BREAK(pData->plugins[i].plugin != nullptr);
 
-            // 1 digit, ex: " (2)"
-            if (sname[len-4] == ' ' && sname[len-3] == '(' && sname.isDigit(len-2) && sname[len-1] == ')')
+            if (const char* const pluginName = pData->plugins[i].plugin->getName())
             {
-                const int number = sname[len-2] - '0';
-
-                if (number == 9)
-                {
-                    // next number is 10, 2 digits
-                    sname.truncate(len-4);
-                    sname += " (10)";
-                    //sname.replace(" (9)", " (10)");
-                }
-                else
-                    sname[len-2] = char('0' + number + 1);
-
-                continue;
+                if (sname != pluginName)
+                    continue;
             }
 
-            // 2 digits, ex: " (11)"
-            if (sname[len-5] == ' ' && sname[len-4] == '(' && sname.isDigit(len-3) && sname.isDigit(len-2) && sname[len-1] == ')')
-            {
-                char n2 = sname[len-2];
-                char n3 = sname[len-3];
-
-                if (n2 == '9')
-                {
-                    n2 = '0';
-                    n3 = static_cast<char>(n3 + 1);
-                }
-                else
-                    n2 = static_cast<char>(n2 + 1);
-
-                sname[len-2] = n2;
-                sname[len-3] = n3;
-
-                continue;
-            }
+            bumpUniquePluginName(sname);
+            isUnique = false;
         }
 
-        // Modify string if not
-        sname += " (2)";
+        if (pData->loader.isNameReserved(sname))
+        {
+            bumpUniquePluginName(sname);
+            isUnique = false;
+        }
     }
 
+    pData->loader.reserveName(sname);
+
     return sname.dup();
 }
 
@@ -1134,18 +1224,67 @@ const EngineTimeInfo& CarlaEngine::getTimeInfo() const noexcept
 // -----------------------------------------------------------------------
 // Information (peaks)
 
-float CarlaEngine::getInputPeak(const uint pluginId, const bool isLeft) const noexcept
+static inline
+float getMeterPeak(const EngineMeterValue& value) noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, 0.0f);
+    return carla_maxLimited<float>(value.peak, value.truePeak, 1.0f);
+}
 
-    return pData->plugins[pluginId].insPeak[isLeft ? 0 : 1];
+float CarlaEngine::getInputPeak(const uint pluginId, const bool isLeft) const noexcept
+{
+    return getMeterPeak(getInputMeter(pluginId, isLeft ? 0 : 1));
 }
 
 float CarlaEngine::getOutputPeak(const uint pluginId, const bool isLeft) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, 0.0f);
+    return getMeterPeak(getOutputMeter(pluginId, isLeft ? 0 : 1));
+}
+
+EngineMeterValue CarlaEngine::getInputMeter(const uint pluginId, const uint channel) const noexcept
+{
+    EngineMeterValue value;
+    carla_zeroStruct(value);
 
-    return pData->plugins[pluginId].outsPeak[isLeft ? 0 : 1];
+    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, value);
+
+    pData->meterReaders.touch();
+    return pData->plugins[pluginId].insMeter.get(channel);
+}
+
+EngineMeterValue CarlaEngine::getOutputMeter(const uint pluginId, const uint channel) const noexcept
+{
+    EngineMeterValue value;
+    carla_zeroStruct(value);
+
+    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, value);
+
+    pData->meterReaders.touch();
+    return pData->plugins[pluginId].outsMeter.get(channel);
+}
+
+EngineDspLoad CarlaEngine::getPluginDspLoad(const uint pluginId) const noexcept
+{
+    EngineDspLoad load;
+    carla_zeroStruct(load);
+
+    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount, load);
+    CARLA_SAFE_ASSERT_RETURN(pData->sampleRate > 0.0, load);
+
+    const uint32_t periodUsecs(static_cast<uint32_t>(static_cast<double>(pData->bufferSize) * 1000000.0 / pData->sampleRate));
+
+    load = pData->plugins[pluginId].dspLoad.get(periodUsecs);
+
+    if (CarlaPlugin* const plugin = pData->plugins[pluginId].plugin)
+        plugin->getWorkerLoad(load);
+
+    return load;
+}
+
+EngineMidiInputJitter CarlaEngine::getMidiInputJitter() const noexcept
+{
+    EngineMidiInputJitter jitter;
+    carla_zeroStruct(jitter);
+    return jitter;
 }
 
 // -----------------------------------------------------------------------
@@ -1154,10 +1293,14 @@ float CarlaEngine::getOutputPeak(const uint pluginId, const bool isLeft) const n
 void CarlaEngine::callback(const EngineCallbackOpcode action, const uint pluginId, const int value1, const int value2, const float value3, const char* const valueStr) noexcept
 {
 #ifdef DEBUG
-    if (action != ENGINE_CALLBACK_IDLE)
+    if (action != ENGINE_CALLBACK_IDLE && action != ENGINE_CALLBACK_PLUGIN_DSP_LOAD)
         carla_debug("CarlaEngine::callback(%i:%s, %i, %i, %i, %f, \"%s\")", action, EngineCallbackOpcode2Str(action), pluginId, value1, value2, value3, valueStr);
 #endif
 
+    // plugins being loaded are not known to the host yet, loader threads must not idle it either
+    if (pData->loader.getCurrentJob() != nullptr && (action != ENGINE_CALLBACK_IDLE || pData->loader.isLoaderThread()))
+        return;
+
 #ifdef BUILD_BRIDGE
     if (pData->isIdling)
 #else
@@ -1246,7 +1389,11 @@ const char* CarlaEngine::getLastError() const noexcept
 
 void CarlaEngine::setLastError(const char* const error) const noexcept
 {
-    pData->lastError = error;
+    // keep errors of plugins being loaded separate, they might be on other threads
+    if (EngineLoaderJob* const job = pData->loader.getCurrentJob())
+        job->error = error;
+    else
+        pData->lastError = error;
 }
 
 void CarlaEngine::setAboutToClose() noexcept
@@ -1256,6 +1403,11 @@ void CarlaEngine::setAboutToClose() noexcept
     pData->aboutToClose = true;
 }
 
+bool CarlaEngine::isPluginLoaderThread() const noexcept
+{
+    return pData->loader.isLoaderThread();
+}
+
 // -----------------------------------------------------------------------
 // Global options
 
@@ -1263,7 +1415,7 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
 {
     carla_debug("CarlaEngine::setOption(%i:%s, %i, \"%s\")", option, EngineOption2Str(option), value, valueStr);
 
-    if (isRunning() && (option == ENGINE_OPTION_PROCESS_MODE || option == ENGINE_OPTION_AUDIO_NUM_PERIODS || option == ENGINE_OPTION_AUDIO_DEVICE))
+    if (isRunning() && (option == ENGINE_OPTION_PROCESS_MODE || option == ENGINE_OPTION_AUDIO_NUM_PERIODS || option == ENGINE_OPTION_AUDIO_DEVICE || option == ENGINE_OPTION_PROCESS_THREADS))
         return carla_stderr("CarlaEngine::setOption(%i:%s, %i, \"%s\") - Cannot set this option while engine is running!", option, EngineOption2Str(option), value, valueStr);
 
     // do not un-force stereo for rack mode
@@ -1452,11 +1604,46 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
 #endif
         break;
 
-    case ENGINE_OPTION_FRONTEND_WIN_ID:
+    case ENGINE_OPTION_FRONTEND_WIN_ID: {
         CARLA_SAFE_ASSERT_RETURN(valueStr != nullptr && valueStr[0] != '\0',);
         const long long winId(std::strtoll(valueStr, nullptr, 16));
         CARLA_SAFE_ASSERT_RETURN(winId >= 0,);
         pData->options.frontendWinId = static_cast<uintptr_t>(winId);
+    }   break;
+
+    case ENGINE_OPTION_PROCESS_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 64,);
+        pData->options.processThreads = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_TRUE_PEAK_METERS:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.truePeakMeters = (value != 0);
+        break;
+
+    case ENGINE_OPTION_PIPELINED_BRIDGES:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.pipelinedBridges = (value != 0);
+        break;
+
+    case ENGINE_OPTION_SHARED_BRIDGE_BUFFERS:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.sharedBridgeBuffers = (value != 0);
+        break;
+
+    case ENGINE_OPTION_GROUPED_BRIDGES:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.groupedBridges = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_MAX_IDLE_RATE:
+        CARLA_SAFE_ASSERT_RETURN(value >= 1 && value <= 1000,);
+        pData->options.maxIdleRate = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_MAX_LOAD_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 64,);
+        pData->options.maxLoadThreads = static_cast<uint>(value);
         break;
     }
 }
@@ -1468,6 +1655,10 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
 # ifndef BUILD_BRIDGE
 bool CarlaEngine::isOscControlRegistered() const noexcept
 {
+    // plugins being loaded register themselves once added
+    if (pData->loader.getCurrentJob() != nullptr)
+        return false;
+
     return pData->osc.isControlRegistered();
 }
 # endif
@@ -1496,6 +1687,11 @@ EngineEvent* CarlaEngine::getInternalEventBuffer(const bool isInput) const noexc
     return isInput ? pData->events.in : pData->events.out;
 }
 
+void CarlaEngine::wakeIdleThread() const noexcept
+{
+    pData->thread.wake();
+}
+
 // -----------------------------------------------------------------------
 // Internal stuff
 
@@ -1566,16 +1762,6 @@ void CarlaEngine::offlineModeChanged(const bool isOfflineNow)
     }
 }
 
-void CarlaEngine::setPluginPeaks(const uint pluginId, float const inPeaks[2], float const outPeaks[2]) noexcept
-{
-    EnginePluginData& pluginData(pData->plugins[pluginId]);
-
-    pluginData.insPeak[0]  = inPeaks[0];
-    pluginData.insPeak[1]  = inPeaks[1];
-    pluginData.outsPeak[0] = outPeaks[0];
-    pluginData.outsPeak[1] = outPeaks[1];
-}
-
 void CarlaEngine::saveProjectInternal(juce::MemoryOutputStream& outStream) const
 {
     // send initial prepareForSave first, giving time for bridges to act
@@ -1743,6 +1929,20 @@ void CarlaEngine::saveProjectInternal(juce::MemoryOutputStream& outStream) const
     outStream << "</CARLA-PROJECT>\n";
 }
 
+// check if using GIG or SF2 16outs
+static const char* getExtraStuffFromStateSave(const CarlaStateSave& stateSave, const PluginType ptype)
+{
+    static const char kUse16OutsSuffix[] = " (16 outs)";
+
+    if (ptype == PLUGIN_GIG || ptype == PLUGIN_SF2)
+    {
+        if (CarlaString(stateSave.label).endsWith(kUse16OutsSuffix))
+            return "true";
+    }
+
+    return nullptr;
+}
+
 bool CarlaEngine::loadProjectInternal(juce::XmlDocument& xmlDoc)
 {
     ScopedPointer<XmlElement> xmlElement(xmlDoc.getDocumentElement(true));
@@ -1874,54 +2074,126 @@ bool CarlaEngine::loadProjectInternal(juce::XmlDocument& xmlDoc)
     }
 
     // handle plugins first
-    for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    if (isPreset)
     {
-        const String& tagName(elem->getTagName());
+        CarlaStateSave stateSave;
+        stateSave.fillFromXmlElement(xmlElement.get());
 
-        if (isPreset || tagName.equalsIgnoreCase("plugin"))
+        callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
+
+        CARLA_SAFE_ASSERT_RETURN(stateSave.type != nullptr, true);
+
+        const BinaryType btype(getBinaryTypeFromFile(stateSave.binary));
+        const PluginType ptype(getPluginTypeFromString(stateSave.type));
+
+        if (addPlugin(btype, ptype, stateSave.binary, stateSave.name, stateSave.label, stateSave.uniqueId,
+                      getExtraStuffFromStateSave(stateSave, ptype), stateSave.options))
         {
-            CarlaStateSave stateSave;
-            stateSave.fillFromXmlElement(isPreset ? xmlElement.get() : elem);
+            if (CarlaPlugin* const plugin = getPlugin(pData->curPluginCount-1))
+                plugin->loadStateSave(stateSave);
+        }
+        else
+            carla_stderr2("Failed to load a plugin, error was:\n%s", getLastError());
 
-            callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
+        return true;
+    }
 
-            CARLA_SAFE_ASSERT_CONTINUE(stateSave.type != nullptr);
+    uint jobCount = 0;
 
-            const void* extraStuff = nullptr;
+    for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    {
+        if (elem->getTagName().equalsIgnoreCase("plugin"))
+            ++jobCount;
+    }
 
-            // check if using GIG or SF2 16outs
-            static const char kUse16OutsSuffix[] = " (16 outs)";
+    if (jobCount > 0)
+    {
+        EngineLoaderJob* const jobs(new EngineLoaderJob[jobCount]);
+        jobCount = 0;
 
-            const BinaryType btype(getBinaryTypeFromFile(stateSave.binary));
-            const PluginType ptype(getPluginTypeFromString(stateSave.type));
+        for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+        {
+            if (! elem->getTagName().equalsIgnoreCase("plugin"))
+                continue;
+
+            EngineLoaderJob& job(jobs[jobCount]);
+
+            const CarlaStateSave& stateSave(job.stateSave);
+            job.stateSave.fillFromXmlElement(elem);
+
+            CARLA_SAFE_ASSERT_CONTINUE(stateSave.type != nullptr);
 
-            if (CarlaString(stateSave.label).endsWith(kUse16OutsSuffix))
+            if (pData->curPluginCount + jobCount == pData->maxPluginNumber)
             {
-                if (ptype == PLUGIN_GIG || ptype == PLUGIN_SF2)
-                    extraStuff = "true";
+                setLastError("Maximum number of plugins reached");
+                carla_stderr2("Failed to load a plugin, error was:\n%s", getLastError());
+                continue;
             }
 
             // TODO - proper find&load plugins
 
-            if (addPlugin(btype, ptype, stateSave.binary, stateSave.name, stateSave.label, stateSave.uniqueId, extraStuff, stateSave.options))
-            {
-                if (CarlaPlugin* const plugin = getPlugin(pData->curPluginCount-1))
-                {
-#ifndef BUILD_BRIDGE
-                    // deactivate bridge client-side ping check, since some plugins block during load
-                    if ((plugin->getHints() & PLUGIN_IS_BRIDGE) != 0 && ! isPreset)
-                        plugin->setCustomData(CUSTOM_DATA_TYPE_STRING, "__CarlaPingOnOff__", "false", false);
+            job.btype = getBinaryTypeFromFile(stateSave.binary);
+            job.ptype = getPluginTypeFromString(stateSave.type);
+            job.extra = getExtraStuffFromStateSave(stateSave, job.ptype);
+            job.id    = pData->curPluginCount + jobCount;
+
+            // bridges and plugin types without UI or host callbacks during instantiation can be created in other threads,
+            // except grouped bridges, which look for their group among the plugins already added
+            bool usesBridge = false;
+#ifndef BRIDGE_PLUGIN
+            if (job.ptype != PLUGIN_INTERNAL && (job.btype != BINARY_NATIVE || pData->options.preferPluginBridges))
+                usesBridge = (pData->options.groupedBridges & (1U << job.btype)) == 0 &&
+                             findBridgeBinary(pData->options.binaryDir, job.btype).isNotEmpty();
 #endif
+            job.inMainThread = ! (usesBridge || (job.btype == BINARY_NATIVE && (job.ptype == PLUGIN_LADSPA ||
+                                                                                 job.ptype == PLUGIN_DSSI   ||
+                                                                                 job.ptype == PLUGIN_LV2)));
+            ++jobCount;
+        }
 
-                    plugin->loadStateSave(stateSave);
-                }
+        // 0 means automatic, 1 loads plugins one by one in the main thread
+        uint numThreads(pData->options.maxLoadThreads);
+
+        if (numThreads == 0)
+            numThreads = static_cast<uint>(juce::jmin(juce::SystemStats::getNumCpus(), 8));
+
+        if (jobCount > 0)
+            pData->loader.start(jobs, jobCount, numThreads > 1 ? numThreads : 0);
+
+        // add plugins in project order, as they finish loading
+        for (uint i=0; i < jobCount; ++i)
+        {
+            EngineLoaderJob& job(jobs[i]);
+
+            callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
+
+            pData->loader.finishJob(job);
+
+            if (CarlaPlugin* const plugin = job.plugin)
+            {
+                job.plugin = nullptr;
+
+                // plugins before this one might have failed to load
+                if (plugin->getId() != pData->curPluginCount)
+                    plugin->setId(pData->curPluginCount);
+
+                appendPlugin(plugin, false);
+
+                callback(ENGINE_CALLBACK_PROJECT_LOAD_PROGRESS, plugin->getId(), static_cast<int>(i+1), static_cast<int>(jobCount), 0.0f, plugin->getName());
             }
             else
+            {
+                setLastError(job.error);
                 carla_stderr2("Failed to load a plugin, error was:\n%s", getLastError());
+
+                callback(ENGINE_CALLBACK_PROJECT_LOAD_PROGRESS, 0, static_cast<int>(i+1), static_cast<int>(jobCount), 0.0f, job.stateSave.name);
+            }
         }
 
-        if (isPreset)
-            return true;
+        if (jobCount > 0)
+            pData->loader.stop();
+
+        delete[] jobs;
     }
 
 #ifndef BUILD_BRIDGE
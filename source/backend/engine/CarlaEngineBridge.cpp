@@ -23,12 +23,13 @@
 #include "CarlaPlugin.hpp"
 
 #include "CarlaBackendUtils.hpp"
-#include "CarlaBase64Utils.hpp"
 #include "CarlaBridgeUtils.hpp"
 #include "CarlaMIDI.h"
+#include "LinkedList.hpp"
 
 #include "jackbridge/JackBridge.hpp"
 
+using juce::CharPointer_UTF8;
 using juce::File;
 using juce::MemoryBlock;
 using juce::String;
@@ -97,6 +98,48 @@ struct BridgeAudioPool {
 
 // -------------------------------------------------------------------
 
+// the server resizes the chunk pool, so we only keep it mapped during a single transfer
+struct BridgeChunkPool {
+    CarlaString filename;
+    char shm[64];
+
+    BridgeChunkPool() noexcept
+        : filename()
+    {
+        carla_zeroChar(shm, 64);
+        jackbridge_shm_init(shm);
+    }
+
+    uint8_t* map(const std::size_t size) noexcept
+    {
+        // must be invalid right now
+        CARLA_SAFE_ASSERT_RETURN(! jackbridge_shm_is_valid(shm), nullptr);
+
+        jackbridge_shm_attach(shm, filename);
+        CARLA_SAFE_ASSERT_RETURN(jackbridge_shm_is_valid(shm), nullptr);
+
+        if (void* const ptr = jackbridge_shm_map(shm, size))
+            return (uint8_t*)ptr;
+
+        jackbridge_shm_close(shm);
+        jackbridge_shm_init(shm);
+        return nullptr;
+    }
+
+    void unmap(uint8_t* const ptr) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(ptr != nullptr,);
+
+        jackbridge_shm_unmap(shm, ptr);
+        jackbridge_shm_close(shm);
+        jackbridge_shm_init(shm);
+    }
+
+    CARLA_DECLARE_NON_COPY_STRUCT(BridgeChunkPool)
+};
+
+// -------------------------------------------------------------------
+
 struct BridgeRtClientControl : public CarlaRingBufferControl<SmallStackBuffer> {
     CarlaString filename;
     BridgeRtClientData* data;
@@ -362,20 +405,129 @@ struct BridgeNonRtServerControl : public CarlaRingBufferControl<HugeStackBuffer>
 
 // -------------------------------------------------------------------
 
+struct BridgeGroupControl : public CarlaRingBufferControl<SmallStackBuffer> {
+    CarlaString filename;
+    BridgeGroupData* data;
+    char shm[64];
+
+    BridgeGroupControl() noexcept
+        : filename(),
+          data(nullptr)
+    {
+        carla_zeroChar(shm, 64);
+        jackbridge_shm_init(shm);
+    }
+
+    ~BridgeGroupControl() noexcept override
+    {
+        // should be cleared by now
+        CARLA_SAFE_ASSERT(data == nullptr);
+
+        clear();
+    }
+
+    void clear() noexcept
+    {
+        filename.clear();
+
+        if (data != nullptr)
+            unmapData();
+
+        if (! jackbridge_shm_is_valid(shm))
+            return;
+
+        jackbridge_shm_close(shm);
+        jackbridge_shm_init(shm);
+    }
+
+    bool attach() noexcept
+    {
+        // must be invalid right now
+        CARLA_SAFE_ASSERT_RETURN(! jackbridge_shm_is_valid(shm), false);
+
+        jackbridge_shm_attach(shm, filename);
+
+        return jackbridge_shm_is_valid(shm);
+    }
+
+    bool mapData() noexcept
+    {
+        CARLA_SAFE_ASSERT(data == nullptr);
+
+        if (jackbridge_shm_map2<BridgeGroupData>(shm, data))
+        {
+            setRingBuffer(&data->ringBuffer, false);
+            return true;
+        }
+
+        return false;
+    }
+
+    void unmapData() noexcept
+    {
+        data = nullptr;
+        setRingBuffer(nullptr, false);
+    }
+
+    bool postClient() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+
+        return jackbridge_sem_post(&data->sem.client);
+    }
+
+    bool waitForServer(const uint secs, bool* const timedOut) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+
+        return jackbridge_sem_timedwait(&data->sem.server, secs, timedOut);
+    }
+
+    PluginBridgeGroupOpcode readOpcode() noexcept
+    {
+        return static_cast<PluginBridgeGroupOpcode>(readUInt());
+    }
+
+    void readString(CarlaString& str) noexcept
+    {
+        const uint32_t size(readUInt());
+
+        if (size == 0)
+        {
+            str.clear();
+            return;
+        }
+
+        char buf[size+1];
+        carla_zeroChar(buf, size+1);
+        readCustomData(buf, size);
+        str = buf;
+    }
+
+    CARLA_DECLARE_NON_COPY_STRUCT(BridgeGroupControl)
+};
+
+// -------------------------------------------------------------------
+
 class CarlaEngineBridge : public CarlaEngine,
                           public CarlaThread
 {
 public:
-    CarlaEngineBridge(const char* const audioPoolBaseName, const char* const rtClientBaseName, const char* const nonRtClientBaseName, const char* const nonRtServerBaseName)
+    CarlaEngineBridge(const char* const audioPoolBaseName, const char* const rtClientBaseName, const char* const nonRtClientBaseName, const char* const nonRtServerBaseName,
+                      const bool grouped = false)
         : CarlaEngine(),
           CarlaThread("CarlaEngineBridge"),
+          kGrouped(grouped),
           fShmAudioPool(),
           fShmRtClientControl(),
           fShmNonRtClientControl(),
           fShmNonRtServerControl(),
+          fShmChunkPool(),
           fIsOffline(false),
           fFirstIdle(true),
           fLastPingTime(-1),
+          fQuitRequested(false),
+          fServerTimedOut(false),
           leakDetector_CarlaEngineBridge()
     {
         carla_stdout("CarlaEngineBridge::CarlaEngineBridge(\"%s\", \"%s\", \"%s\", \"%s\")", audioPoolBaseName, rtClientBaseName, nonRtClientBaseName, nonRtServerBaseName);
@@ -391,6 +543,9 @@ public:
 
         fShmNonRtServerControl.filename  = PLUGIN_BRIDGE_NAMEPREFIX_NON_RT_SERVER;
         fShmNonRtServerControl.filename += nonRtServerBaseName;
+
+        fShmChunkPool.filename  = PLUGIN_BRIDGE_NAMEPREFIX_CHUNK_POOL;
+        fShmChunkPool.filename += audioPoolBaseName;
     }
 
     ~CarlaEngineBridge() noexcept override
@@ -501,7 +656,9 @@ public:
             fShmNonRtServerControl.commitWrite();
         }
 
-        startThread();
+        // grouped bridges are processed by the group thread
+        if (! kGrouped)
+            startThread();
 
         return true;
     }
@@ -521,6 +678,9 @@ public:
 
     bool isRunning() const noexcept override
     {
+        if (kGrouped)
+            return fShmRtClientControl.data != nullptr;
+
         return isThreadRunning() || ! fFirstIdle;
     }
 
@@ -797,7 +957,12 @@ public:
         if (fLastPingTime > 0 && Time::currentTimeMillis() > fLastPingTime + 30000 && ! wasFirstIdle)
         {
             carla_stderr("Did not receive ping message from server for 30 secs, closing...");
-            callback(ENGINE_CALLBACK_QUIT, 0, 0, 0, 0.0f, nullptr);
+            fServerTimedOut = true;
+
+            if (kGrouped)
+                fQuitRequested = true;
+            else
+                callback(ENGINE_CALLBACK_QUIT, 0, 0, 0, 0.0f, nullptr);
         }
     }
 
@@ -947,7 +1112,7 @@ public:
                 const float    value(fShmNonRtClientControl.readFloat());
 
                 if (plugin != nullptr && plugin->isEnabled())
-                    plugin->setParameterValue(index, value, false, false, false);
+                    plugin->queueParameterValue(index, value, false, false, false);
                 break;
             }
 
@@ -1009,39 +1174,23 @@ public:
                 break;
             }
 
-            case kPluginBridgeNonRtClientSetChunkDataFile: {
-                const uint32_t size(fShmNonRtClientControl.readUInt());
-                CARLA_SAFE_ASSERT_BREAK(size > 0);
-
-                char chunkFilePathTry[size+1];
-                carla_zeroChar(chunkFilePathTry, size+1);
-                fShmNonRtClientControl.readCustomData(chunkFilePathTry, size);
-
-                CARLA_SAFE_ASSERT_BREAK(chunkFilePathTry[0] != '\0');
-                if (plugin == nullptr || ! plugin->isEnabled()) break;
-
-                carla_stdout("Carla bridge client side setChunkData 001");
-
-                String chunkFilePath(chunkFilePathTry);
-
-#ifdef CARLA_OS_WIN
-                // check if running under Wine
-                if (chunkFilePath.startsWith("/"))
-                    chunkFilePath = chunkFilePath.replaceSection(0, 1, "Z:\\").replace("/", "\\");
-#endif
+            case kPluginBridgeNonRtClientSetChunkData: {
+                const uint64_t size(fShmNonRtClientControl.readULong());
+                BridgeChunkPoolState& chunkPool(fShmNonRtClientControl.data->chunkPool);
 
-                File chunkFile(chunkFilePath);
-                CARLA_SAFE_ASSERT_BREAK(chunkFile.existsAsFile());
+                CARLA_SAFE_ASSERT(size > 0 && size <= chunkPool.size);
 
-                String chunkDataBase64(chunkFile.loadFileAsString());
-                chunkFile.deleteFile();
-                CARLA_SAFE_ASSERT_BREAK(chunkDataBase64.isNotEmpty());
-
-                std::vector<uint8_t> chunk(carla_getChunkFromBase64String(chunkDataBase64.toRawUTF8()));
-                carla_stdout("Carla bridge client side setChunkData 002");
+                if (size > 0 && size <= chunkPool.size && plugin != nullptr && plugin->isEnabled())
+                {
+                    if (uint8_t* const data = fShmChunkPool.map(static_cast<std::size_t>(size)))
+                    {
+                        plugin->setChunkData(data, static_cast<std::size_t>(size));
+                        fShmChunkPool.unmap(data);
+                    }
+                }
 
-                plugin->setChunkData(chunk.data(), chunk.size());
-                carla_stdout("Carla bridge client side setChunkData done");
+                // let the server reuse the pool
+                carla_chunk_pool_release(chunkPool);
                 break;
             }
 
@@ -1105,26 +1254,7 @@ public:
                     {
                         CARLA_SAFE_ASSERT_BREAK(data != nullptr);
 
-                        CarlaString dataBase64 = CarlaString::asBase64(data, dataSize);
-                        CARLA_SAFE_ASSERT_BREAK(dataBase64.length() > 0);
-
-                        String filePath(File::getSpecialLocation(File::tempDirectory).getFullPathName());
-
-                        filePath += CARLA_OS_SEP_STR;
-                        filePath += ".CarlaChunk_";
-                        filePath += fShmNonRtClientControl.filename.buffer() + 24;
-
-                        if (File(filePath).replaceWithText(dataBase64.buffer()))
-                        {
-                            const uint32_t ulength(static_cast<uint32_t>(filePath.length()));
-
-                            const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
-
-                            fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerSetChunkDataFile);
-                            fShmNonRtServerControl.writeUInt(ulength);
-                            fShmNonRtServerControl.writeCustomData(filePath.toRawUTF8(), ulength);
-                            fShmNonRtServerControl.commitWrite();
-                        }
+                        sendChunkData((const uint8_t*)data, dataSize);
                     }
                 }
 
@@ -1192,6 +1322,11 @@ public:
             }
 
             case kPluginBridgeNonRtClientQuit:
+                if (kGrouped)
+                {
+                    fQuitRequested = true;
+                    break;
+                }
                 signalThreadShouldExit();
                 callback(ENGINE_CALLBACK_QUIT, 0, 0, 0, 0.0f, nullptr);
                 break;
@@ -1224,338 +1359,764 @@ protected:
                 break;
             }
 
-            for (; fShmRtClientControl.isDataAvailableForReading();)
+            if (! handleRtData())
             {
-                const PluginBridgeRtClientOpcode opcode(fShmRtClientControl.readOpcode());
-                CarlaPlugin* const plugin(pData->plugins[0].plugin);
+                quitReceived = true;
+                signalThreadShouldExit();
+            }
+
+            if (! fShmRtClientControl.postClient())
+                carla_stderr2("Could not post to client rt semaphore");
+        }
+
+        callback(ENGINE_CALLBACK_ENGINE_STOPPED, 0, 0, 0, 0.0f, nullptr);
+
+        if (! quitReceived)
+        {
+            const char* const message("Plugin bridge error, process thread has stopped");
+            const std::size_t messageSize(std::strlen(message));
+
+            const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+            fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerError);
+            fShmNonRtServerControl.writeUInt(messageSize);
+            fShmNonRtServerControl.writeCustomData(message, messageSize);
+            fShmNonRtServerControl.commitWrite();
+        }
+    }
+
+    // reads and handles everything the server sent for this block.
+    // returns false if the server asked us to quit.
+    bool handleRtData()
+    {
+        bool quitReceived = false;
+
+        for (; fShmRtClientControl.isDataAvailableForReading();)
+        {
+            const PluginBridgeRtClientOpcode opcode(fShmRtClientControl.readOpcode());
+            CarlaPlugin* const plugin(pData->plugins[0].plugin);
 
 #ifdef DEBUG
-                if (opcode != kPluginBridgeRtClientProcess && opcode != kPluginBridgeRtClientMidiEvent) {
-                    carla_debug("CarlaEngineBridgeRtThread::run() - got opcode: %s", PluginBridgeRtClientOpcode2str(opcode));
-                }
+            if (opcode != kPluginBridgeRtClientProcess && opcode != kPluginBridgeRtClientEventBlock && opcode != kPluginBridgeRtClientMidiEvent) {
+                carla_debug("CarlaEngineBridgeRtThread::run() - got opcode: %s", PluginBridgeRtClientOpcode2str(opcode));
+            }
 #endif
 
-                switch (opcode)
-                {
-                case kPluginBridgeRtClientNull:
-                    break;
+            switch (opcode)
+            {
+            case kPluginBridgeRtClientNull:
+                break;
 
-                case kPluginBridgeRtClientSetAudioPool: {
-                    const uint64_t poolSize(fShmRtClientControl.readULong());
-                    CARLA_SAFE_ASSERT_BREAK(poolSize > 0);
-                    fShmAudioPool.data = (float*)jackbridge_shm_map(fShmAudioPool.shm, static_cast<size_t>(poolSize));
-                    break;
-                }
+            case kPluginBridgeRtClientSetAudioPool: {
+                const uint64_t poolSize(fShmRtClientControl.readULong());
+                CARLA_SAFE_ASSERT_BREAK(poolSize > 0);
+                fShmAudioPool.data = (float*)jackbridge_shm_map(fShmAudioPool.shm, static_cast<size_t>(poolSize));
+                break;
+            }
 
-                case kPluginBridgeRtClientControlEventParameter: {
-                    const uint32_t time(fShmRtClientControl.readUInt());
-                    const uint8_t  channel(fShmRtClientControl.readByte());
-                    const uint16_t param(fShmRtClientControl.readUShort());
-                    const float    value(fShmRtClientControl.readFloat());
+            case kPluginBridgeRtClientEventBlock: {
+                const uint32_t count(fShmRtClientControl.readUInt());
+                CARLA_SAFE_ASSERT_BREAK(count > 0 && count <= kBridgeRtEventBlockSize);
 
-                    if (EngineEvent* const event = getNextFreeInputEvent())
-                    {
-                        event->type    = kEngineEventTypeControl;
-                        event->time    = time;
-                        event->channel = channel;
-                        event->ctrl.type  = kEngineControlEventTypeParameter;
-                        event->ctrl.param = param;
-                        event->ctrl.value = value;
-                    }
-                    break;
-                }
+                BridgeRtEvent bridgeEvents[kBridgeRtEventBlockSize];
+                fShmRtClientControl.readCustomData(bridgeEvents, static_cast<uint32_t>(count * sizeof(BridgeRtEvent)));
 
-                case kPluginBridgeRtClientControlEventMidiBank: {
-                    const uint32_t time(fShmRtClientControl.readUInt());
-                    const uint8_t  channel(fShmRtClientControl.readByte());
-                    const uint16_t index(fShmRtClientControl.readUShort());
+                for (uint32_t i=0; i < count; ++i)
+                    handleRtEvent(bridgeEvents[i]);
+                break;
+            }
+
+            case kPluginBridgeRtClientMidiEvent: {
+                const uint32_t time(fShmRtClientControl.readUInt());
+                const uint8_t  port(fShmRtClientControl.readByte());
+                const uint8_t  size(fShmRtClientControl.readByte());
+                CARLA_SAFE_ASSERT_BREAK(size > 0);
+
+                uint8_t data[size];
+
+                for (uint8_t i=0; i<size; ++i)
+                    data[i] = fShmRtClientControl.readByte();
+
+                if (EngineEvent* const event = getNextFreeInputEvent())
+                {
+                    event->type    = kEngineEventTypeMidi;
+                    event->time    = time;
+                    event->channel = MIDI_GET_CHANNEL_FROM_DATA(data);
+
+                    event->midi.port = port;
+                    event->midi.size = size;
 
-                    if (EngineEvent* const event = getNextFreeInputEvent())
+                    if (size > EngineMidiEvent::kDataSize)
                     {
-                        event->type    = kEngineEventTypeControl;
-                        event->time    = time;
-                        event->channel = channel;
-                        event->ctrl.type  = kEngineControlEventTypeMidiBank;
-                        event->ctrl.param = index;
-                        event->ctrl.value = 0.0f;
+                        event->midi.dataExt = data;
+                        std::memset(event->midi.data, 0, sizeof(uint8_t)*EngineMidiEvent::kDataSize);
                     }
-                    break;
-                }
+                    else
+                    {
+                        event->midi.data[0] = MIDI_GET_STATUS_FROM_DATA(data);
 
-                case kPluginBridgeRtClientControlEventMidiProgram: {
-                    const uint32_t time(fShmRtClientControl.readUInt());
-                    const uint8_t  channel(fShmRtClientControl.readByte());
-                    const uint16_t index(fShmRtClientControl.readUShort());
+                        uint8_t i=1;
+                        for (; i < size; ++i)
+                            event->midi.data[i] = data[i];
+                        for (; i < EngineMidiEvent::kDataSize; ++i)
+                            event->midi.data[i] = 0;
 
-                    if (EngineEvent* const event = getNextFreeInputEvent())
-                    {
-                        event->type    = kEngineEventTypeControl;
-                        event->time    = time;
-                        event->channel = channel;
-                        event->ctrl.type  = kEngineControlEventTypeMidiProgram;
-                        event->ctrl.param = index;
-                        event->ctrl.value = 0.0f;
+                        event->midi.dataExt = nullptr;
                     }
-                    break;
                 }
+                break;
+            }
 
-                case kPluginBridgeRtClientControlEventAllSoundOff: {
-                    const uint32_t time(fShmRtClientControl.readUInt());
-                    const uint8_t  channel(fShmRtClientControl.readByte());
+            case kPluginBridgeRtClientProcess: {
+                CARLA_SAFE_ASSERT_BREAK(fShmAudioPool.data != nullptr);
 
-                    if (EngineEvent* const event = getNextFreeInputEvent())
-                    {
-                        event->type    = kEngineEventTypeControl;
-                        event->time    = time;
-                        event->channel = channel;
-                        event->ctrl.type  = kEngineControlEventTypeAllSoundOff;
-                        event->ctrl.param = 0;
-                        event->ctrl.value = 0.0f;
-                    }
-                }   break;
+                if (plugin != nullptr && plugin->isEnabled() && plugin->tryLock(false))
+                {
+                    const BridgeTimeInfo& bridgeTimeInfo(fShmRtClientControl.data->timeInfo);
 
-                case kPluginBridgeRtClientControlEventAllNotesOff: {
-                    const uint32_t time(fShmRtClientControl.readUInt());
-                    const uint8_t  channel(fShmRtClientControl.readByte());
+                    const uint32_t audioInCount(plugin->getAudioInCount());
+                    const uint32_t audioOutCount(plugin->getAudioOutCount());
+                    const uint32_t cvInCount(plugin->getCVInCount());
+                    const uint32_t cvOutCount(plugin->getCVOutCount());
 
-                    if (EngineEvent* const event = getNextFreeInputEvent())
-                    {
-                        event->type    = kEngineEventTypeControl;
-                        event->time    = time;
-                        event->channel = channel;
-                        event->ctrl.type  = kEngineControlEventTypeAllNotesOff;
-                        event->ctrl.param = 0;
-                        event->ctrl.value = 0.0f;
-                    }
-                }   break;
+                    const float* audioIn[audioInCount];
+                    /* */ float* audioOut[audioOutCount];
+                    const float* cvIn[cvInCount];
+                    /* */ float* cvOut[cvOutCount];
 
-                case kPluginBridgeRtClientMidiEvent: {
-                    const uint32_t time(fShmRtClientControl.readUInt());
-                    const uint8_t  port(fShmRtClientControl.readByte());
-                    const uint8_t  size(fShmRtClientControl.readByte());
-                    CARLA_SAFE_ASSERT_BREAK(size > 0);
+                    float* fdata = fShmAudioPool.data;
 
-                    uint8_t data[size];
+                    for (uint32_t i=0; i < audioInCount; ++i, fdata += pData->bufferSize)
+                        audioIn[i] = fdata;
+                    for (uint32_t i=0; i < audioOutCount; ++i, fdata += pData->bufferSize)
+                        audioOut[i] = fdata;
 
-                    for (uint8_t i=0; i<size; ++i)
-                        data[i] = fShmRtClientControl.readByte();
+                    for (uint32_t i=0; i < cvInCount; ++i, fdata += pData->bufferSize)
+                        cvIn[i] = fdata;
+                    for (uint32_t i=0; i < cvOutCount; ++i, fdata += pData->bufferSize)
+                        cvOut[i] = fdata;
 
-                    if (EngineEvent* const event = getNextFreeInputEvent())
-                    {
-                        event->type    = kEngineEventTypeMidi;
-                        event->time    = time;
-                        event->channel = MIDI_GET_CHANNEL_FROM_DATA(data);
+                    EngineTimeInfo& timeInfo(pData->timeInfo);
 
-                        event->midi.port = port;
-                        event->midi.size = size;
+                    timeInfo.playing = bridgeTimeInfo.playing;
+                    timeInfo.frame   = bridgeTimeInfo.frame;
+                    timeInfo.usecs   = bridgeTimeInfo.usecs;
+                    timeInfo.valid   = bridgeTimeInfo.valid;
 
-                        if (size > EngineMidiEvent::kDataSize)
-                        {
-                            event->midi.dataExt = data;
-                            std::memset(event->midi.data, 0, sizeof(uint8_t)*EngineMidiEvent::kDataSize);
-                        }
-                        else
-                        {
-                            event->midi.data[0] = MIDI_GET_STATUS_FROM_DATA(data);
+                    if (timeInfo.valid & EngineTimeInfo::kValidBBT)
+                    {
+                        timeInfo.bbt.bar  = bridgeTimeInfo.bar;
+                        timeInfo.bbt.beat = bridgeTimeInfo.beat;
+                        timeInfo.bbt.tick = bridgeTimeInfo.tick;
 
-                            uint8_t i=1;
-                            for (; i < size; ++i)
-                                event->midi.data[i] = data[i];
-                            for (; i < EngineMidiEvent::kDataSize; ++i)
-                                event->midi.data[i] = 0;
+                        timeInfo.bbt.beatsPerBar = bridgeTimeInfo.beatsPerBar;
+                        timeInfo.bbt.beatType    = bridgeTimeInfo.beatType;
 
-                            event->midi.dataExt = nullptr;
-                        }
+                        timeInfo.bbt.ticksPerBeat   = bridgeTimeInfo.ticksPerBeat;
+                        timeInfo.bbt.beatsPerMinute = bridgeTimeInfo.beatsPerMinute;
+                        timeInfo.bbt.barStartTick   = bridgeTimeInfo.barStartTick;
                     }
-                    break;
+
+                    plugin->initBuffers();
+                    plugin->process(audioIn, audioOut, cvIn, cvOut, pData->bufferSize);
+                    plugin->unlock();
                 }
 
-                case kPluginBridgeRtClientProcess: {
-                    CARLA_SAFE_ASSERT_BREAK(fShmAudioPool.data != nullptr);
+                uint8_t* midiData(fShmRtClientControl.data->midiOut);
+                carla_zeroBytes(midiData, kBridgeRtClientDataMidiOutSize);
+                std::size_t curMidiDataPos = 0;
 
-                    if (plugin != nullptr && plugin->isEnabled() && plugin->tryLock(false))
-                    {
-                        const BridgeTimeInfo& bridgeTimeInfo(fShmRtClientControl.data->timeInfo);
+                clearEngineEvents(pData->events.in);
 
-                        const uint32_t audioInCount(plugin->getAudioInCount());
-                        const uint32_t audioOutCount(plugin->getAudioOutCount());
-                        const uint32_t cvInCount(plugin->getCVInCount());
-                        const uint32_t cvOutCount(plugin->getCVOutCount());
+                if (pData->events.out[0].type != kEngineEventTypeNull)
+                {
+                    for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+                    {
+                        const EngineEvent& event(pData->events.out[i]);
 
-                        const float* audioIn[audioInCount];
-                        /* */ float* audioOut[audioOutCount];
-                        const float* cvIn[cvInCount];
-                        /* */ float* cvOut[cvOutCount];
+                        if (event.type == kEngineEventTypeNull)
+                            break;
 
-                        float* fdata = fShmAudioPool.data;
+                        if (event.type == kEngineEventTypeControl)
+                        {
+                            uint8_t size;
+                            uint8_t data[3];
+                            event.ctrl.convertToMidiData(event.channel, size, data);
+                            CARLA_SAFE_ASSERT_CONTINUE(size > 0 && size <= 3);
 
-                        for (uint32_t i=0; i < audioInCount; ++i, fdata += pData->bufferSize)
-                            audioIn[i] = fdata;
-                        for (uint32_t i=0; i < audioOutCount; ++i, fdata += pData->bufferSize)
-                            audioOut[i] = fdata;
+                            if (curMidiDataPos + 1U /* size*/ + 4U /* time */ + size >= kBridgeRtClientDataMidiOutSize)
+                                break;
 
-                        for (uint32_t i=0; i < cvInCount; ++i, fdata += pData->bufferSize)
-                            cvIn[i] = fdata;
-                        for (uint32_t i=0; i < cvOutCount; ++i, fdata += pData->bufferSize)
-                            cvOut[i] = fdata;
+                            // set size
+                            *midiData++ = size;
 
-                        EngineTimeInfo& timeInfo(pData->timeInfo);
+                            // set time
+                            *(uint32_t*)midiData = event.time;
+                            midiData = midiData + 4;
 
-                        timeInfo.playing = bridgeTimeInfo.playing;
-                        timeInfo.frame   = bridgeTimeInfo.frame;
-                        timeInfo.usecs   = bridgeTimeInfo.usecs;
-                        timeInfo.valid   = bridgeTimeInfo.valid;
+                            // set data
+                            for (uint8_t j=0; j<size; ++j)
+                                *midiData++ = data[j];
 
-                        if (timeInfo.valid & EngineTimeInfo::kValidBBT)
+                            curMidiDataPos += 1U /* size*/ + 4U /* time */ + size;
+                        }
+                        else if (event.type == kEngineEventTypeMidi)
                         {
-                            timeInfo.bbt.bar  = bridgeTimeInfo.bar;
-                            timeInfo.bbt.beat = bridgeTimeInfo.beat;
-                            timeInfo.bbt.tick = bridgeTimeInfo.tick;
+                            const EngineMidiEvent& _midiEvent(event.midi);
 
-                            timeInfo.bbt.beatsPerBar = bridgeTimeInfo.beatsPerBar;
-                            timeInfo.bbt.beatType    = bridgeTimeInfo.beatType;
+                            if (curMidiDataPos + 1 /* size*/ + 4 /* time */ + _midiEvent.size >= kBridgeRtClientDataMidiOutSize)
+                                break;
 
-                            timeInfo.bbt.ticksPerBeat   = bridgeTimeInfo.ticksPerBeat;
-                            timeInfo.bbt.beatsPerMinute = bridgeTimeInfo.beatsPerMinute;
-                            timeInfo.bbt.barStartTick   = bridgeTimeInfo.barStartTick;
-                        }
+                            const uint8_t* const _midiData(_midiEvent.dataExt != nullptr ? _midiEvent.dataExt : _midiEvent.data);
+
+                            // set size
+                            *midiData++ = _midiEvent.size;
+
+                            // set time
+                            *(uint32_t*)midiData = event.time;
+                            midiData = midiData + 4;
 
-                        plugin->initBuffers();
-                        plugin->process(audioIn, audioOut, cvIn, cvOut, pData->bufferSize);
-                        plugin->unlock();
+                            // set data
+                            *midiData++ = uint8_t(_midiData[0] | (event.channel & MIDI_CHANNEL_BIT));
+
+                            for (uint8_t j=1; j<_midiEvent.size; ++j)
+                                *midiData++ = _midiData[j];
+
+                            curMidiDataPos += 1U /* size*/ + 4U /* time */ + _midiEvent.size;
+                        }
                     }
 
-                    uint8_t* midiData(fShmRtClientControl.data->midiOut);
-                    carla_zeroBytes(midiData, kBridgeRtClientDataMidiOutSize);
-                    std::size_t curMidiDataPos = 0;
+                    clearEngineEvents(pData->events.out);
+                }
 
-                    if (pData->events.in[0].type != kEngineEventTypeNull)
-                        carla_zeroStruct<EngineEvent>(pData->events.in,  kMaxEngineEventInternalCount);
+            }   break;
 
-                    if (pData->events.out[0].type != kEngineEventTypeNull)
-                    {
-                        for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
-                        {
-                            const EngineEvent& event(pData->events.out[i]);
+            case kPluginBridgeRtClientQuit:
+                quitReceived = true;
+                break;
+            }
+        }
 
-                            if (event.type == kEngineEventTypeNull)
-                                break;
+        if (quitReceived && kGrouped)
+            fQuitRequested = true;
 
-                            if (event.type == kEngineEventTypeControl)
-                            {
-                                uint8_t size;
-                                uint8_t data[3];
-                                event.ctrl.convertToMidiData(event.channel, size, data);
-                                CARLA_SAFE_ASSERT_CONTINUE(size > 0 && size <= 3);
+        return ! quitReceived;
+    }
 
-                                if (curMidiDataPos + 1U /* size*/ + 4U /* time */ + size >= kBridgeRtClientDataMidiOutSize)
-                                    break;
+    // called from process thread above
+    EngineEvent* getNextFreeInputEvent() const noexcept
+    {
+        const ushort i(getEngineEventCount(pData->events.in));
 
-                                // set size
-                                *midiData++ = size;
+        if (i >= kMaxEngineEventInternalCount)
+            return nullptr;
 
-                                // set time
-                                *(uint32_t*)midiData = event.time;
-                                midiData = midiData + 4;
+        terminateEngineEvents(pData->events.in, static_cast<ushort>(i+1));
+        return &pData->events.in[i];
+    }
 
-                                // set data
-                                for (uint8_t j=0; j<size; ++j)
-                                    *midiData++ = data[j];
+    // called from process thread above, converts an event from a kPluginBridgeRtClientEventBlock
+    void handleRtEvent(const BridgeRtEvent& bridgeEvent) const noexcept
+    {
+        // not an engine event, applied by the plugin right before it processes
+        if (bridgeEvent.type == kPluginBridgeRtEventParameterValue)
+        {
+            CarlaPlugin* const plugin(pData->plugins[0].plugin);
 
-                                curMidiDataPos += 1U /* size*/ + 4U /* time */ + size;
-                            }
-                            else if (event.type == kEngineEventTypeMidi)
-                            {
-                                const EngineMidiEvent& _midiEvent(event.midi);
+            if (plugin != nullptr && plugin->isEnabled())
+                plugin->queueParameterValue(bridgeEvent.param, bridgeEvent.value, false, false, false);
+            return;
+        }
 
-                                if (curMidiDataPos + 1 /* size*/ + 4 /* time */ + _midiEvent.size >= kBridgeRtClientDataMidiOutSize)
-                                    break;
+        EngineEvent* const event(getNextFreeInputEvent());
 
-                                const uint8_t* const _midiData(_midiEvent.dataExt != nullptr ? _midiEvent.dataExt : _midiEvent.data);
+        if (event == nullptr)
+            return;
 
-                                // set size
-                                *midiData++ = _midiEvent.size;
+        event->time    = bridgeEvent.time;
+        event->channel = bridgeEvent.channel;
 
-                                // set time
-                                *(uint32_t*)midiData = event.time;
-                                midiData = midiData + 4;
+        switch (static_cast<PluginBridgeRtEventType>(bridgeEvent.type))
+        {
+        case kPluginBridgeRtEventNull:
+            event->type = kEngineEventTypeNull;
+            break;
 
-                                // set data
-                                *midiData++ = uint8_t(_midiData[0] | (event.channel & MIDI_CHANNEL_BIT));
+        case kPluginBridgeRtEventParameter:
+            event->type = kEngineEventTypeControl;
+            event->ctrl.type  = kEngineControlEventTypeParameter;
+            event->ctrl.param = bridgeEvent.param;
+            event->ctrl.value = bridgeEvent.value;
+            break;
 
-                                for (uint8_t j=1; j<_midiEvent.size; ++j)
-                                    *midiData++ = _midiData[j];
+        case kPluginBridgeRtEventMidiBank:
+            event->type = kEngineEventTypeControl;
+            event->ctrl.type  = kEngineControlEventTypeMidiBank;
+            event->ctrl.param = bridgeEvent.param;
+            event->ctrl.value = 0.0f;
+            break;
 
-                                curMidiDataPos += 1U /* size*/ + 4U /* time */ + _midiEvent.size;
-                            }
-                        }
+        case kPluginBridgeRtEventMidiProgram:
+            event->type = kEngineEventTypeControl;
+            event->ctrl.type  = kEngineControlEventTypeMidiProgram;
+            event->ctrl.param = bridgeEvent.param;
+            event->ctrl.value = 0.0f;
+            break;
 
-                        carla_zeroStruct<EngineEvent>(pData->events.out, kMaxEngineEventInternalCount);
-                    }
+        case kPluginBridgeRtEventAllSoundOff:
+            event->type = kEngineEventTypeControl;
+            event->ctrl.type  = kEngineControlEventTypeAllSoundOff;
+            event->ctrl.param = 0;
+            event->ctrl.value = 0.0f;
+            break;
 
-                }   break;
+        case kPluginBridgeRtEventAllNotesOff:
+            event->type = kEngineEventTypeControl;
+            event->ctrl.type  = kEngineControlEventTypeAllNotesOff;
+            event->ctrl.param = 0;
+            event->ctrl.value = 0.0f;
+            break;
 
-                case kPluginBridgeRtClientQuit: {
-                    quitReceived = true;
-                    signalThreadShouldExit();
-                }   break;
-                }
+        case kPluginBridgeRtEventMidi: {
+            const uint8_t size(static_cast<uint8_t>(bridgeEvent.param));
+
+            if (size == 0 || size > sizeof(bridgeEvent.midi))
+            {
+                event->type = kEngineEventTypeNull;
+                break;
             }
 
-            if (! fShmRtClientControl.postClient())
-                carla_stderr2("Could not post to client rt semaphore");
+            event->type    = kEngineEventTypeMidi;
+            event->channel = MIDI_GET_CHANNEL_FROM_DATA(bridgeEvent.midi);
+
+            event->midi.port = bridgeEvent.channel;
+            event->midi.size = size;
+            event->midi.data[0] = MIDI_GET_STATUS_FROM_DATA(bridgeEvent.midi);
+
+            uint8_t i=1;
+            for (; i < size; ++i)
+                event->midi.data[i] = bridgeEvent.midi[i];
+            for (; i < EngineMidiEvent::kDataSize; ++i)
+                event->midi.data[i] = 0;
+
+            event->midi.dataExt = nullptr;
+        }   break;
+
+        case kPluginBridgeRtEventParameterValue:
+            event->type = kEngineEventTypeNull;
+            break;
         }
+    }
 
-        callback(ENGINE_CALLBACK_ENGINE_STOPPED, 0, 0, 0, 0.0f, nullptr);
+    // sends a plugin chunk through the chunk pool, reporting progress for each piece.
+    // the pool might be smaller than the chunk, the server grows it after reading the first piece.
+    void sendChunkData(const uint8_t* const data, const std::size_t dataSize) noexcept
+    {
+        BridgeChunkPoolState& chunkPool(fShmNonRtClientControl.data->chunkPool);
 
-        if (! quitReceived)
+        for (std::size_t offset=0; offset < dataSize;)
         {
-            const char* const message("Plugin bridge error, process thread has stopped");
-            const std::size_t messageSize(std::strlen(message));
+            if (! claimChunkPool())
+                return;
 
-            const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
-            fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerError);
-            fShmNonRtServerControl.writeUInt(messageSize);
-            fShmNonRtServerControl.writeCustomData(message, messageSize);
-            fShmNonRtServerControl.commitWrite();
+            const std::size_t size(std::min(dataSize - offset, static_cast<std::size_t>(chunkPool.size)));
+            uint8_t* const pool(size > 0 ? fShmChunkPool.map(size) : nullptr);
+
+            if (pool == nullptr)
+            {
+                carla_stderr("sendChunkData() - failed to map chunk pool");
+                carla_chunk_pool_release(chunkPool);
+                return;
+            }
+
+            std::memcpy(pool, data + offset, size);
+            fShmChunkPool.unmap(pool);
+
+            {
+                const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+
+                fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerSetChunkData);
+                fShmNonRtServerControl.writeULong(static_cast<uint64_t>(dataSize));
+                fShmNonRtServerControl.writeULong(static_cast<uint64_t>(offset));
+                fShmNonRtServerControl.writeULong(static_cast<uint64_t>(size));
+                fShmNonRtServerControl.commitWrite();
+            }
+
+            offset += size;
         }
     }
 
-    // called from process thread above
-    EngineEvent* getNextFreeInputEvent() const noexcept
+    // waits for the server to read the last piece we sent, or finish sending us one, then takes the pool
+    bool claimChunkPool() noexcept
     {
-        for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
-        {
-            EngineEvent* const event(&pData->events.in[i]);
+        BridgeChunkPoolState& chunkPool(fShmNonRtClientControl.data->chunkPool);
 
-            if (event->type == kEngineEventTypeNull)
-                return event;
+        for (int i=2000; --i >= 0;)
+        {
+            if (carla_chunk_pool_claim(chunkPool))
+                return true;
+            carla_msleep(5);
         }
-        return nullptr;
+
+        carla_stderr("claimChunkPool() - timeout while waiting for server");
+        return false;
     }
 
     // -------------------------------------------------------------------
 
 private:
+    const bool kGrouped;
+
     BridgeAudioPool          fShmAudioPool;
     BridgeRtClientControl    fShmRtClientControl;
     BridgeNonRtClientControl fShmNonRtClientControl;
     BridgeNonRtServerControl fShmNonRtServerControl;
+    BridgeChunkPool          fShmChunkPool;
 
     bool fIsOffline;
     bool fFirstIdle;
     int64_t fLastPingTime;
 
+    // grouped mode, the group closes this engine once the server is done with it
+    volatile bool fQuitRequested;
+    bool fServerTimedOut;
+
+    friend class CarlaEngineBridgeGroupHost;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineBridge)
 };
 
 // -----------------------------------------------------------------------
 
+class CarlaEngineBridgeGroupHost : public CarlaEngineBridgeGroup,
+                                   public CarlaThread
+{
+public:
+    CarlaEngineBridgeGroupHost(const char* const groupBaseName)
+        : CarlaEngineBridgeGroup(),
+          CarlaThread("CarlaEngineBridgeGroup"),
+          fControl(),
+          fMembersMutex(),
+          fMembers(),
+          fServerLost(false),
+          leakDetector_CarlaEngineBridgeGroupHost()
+    {
+        carla_stdout("CarlaEngineBridgeGroupHost::CarlaEngineBridgeGroupHost(\"%s\")", groupBaseName);
+
+        fControl.filename  = PLUGIN_BRIDGE_NAMEPREFIX_GROUP;
+        fControl.filename += groupBaseName;
+    }
+
+    ~CarlaEngineBridgeGroupHost() override
+    {
+        carla_debug("CarlaEngineBridgeGroupHost::~CarlaEngineBridgeGroupHost()");
+
+        stopThread(5000);
+
+        for (LinkedList<CarlaEngineBridge*>::Itenerator it = fMembers.begin(); it.valid(); it.next())
+            closeMember(it.getValue(nullptr));
+
+        fMembers.clear();
+        fControl.clear();
+    }
+
+    bool init()
+    {
+        if (! fControl.attach())
+        {
+            carla_stdout("Failed to attach to group control shared memory");
+            return false;
+        }
+
+        if (! fControl.mapData())
+        {
+            fControl.clear();
+            carla_stdout("Failed to map group control shared memory");
+            return false;
+        }
+
+        startThread();
+        return true;
+    }
+
+    bool idle() noexcept override
+    {
+        try {
+            if (! handleGroupData())
+                return false;
+        } CARLA_SAFE_EXCEPTION_RETURN("handleGroupData", false);
+
+        bool serverTimedOut = false;
+
+        for (LinkedList<CarlaEngineBridge*>::Itenerator it = fMembers.begin(); it.valid(); it.next())
+        {
+            CarlaEngineBridge* const engine(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(engine != nullptr);
+
+            if (! engine->fQuitRequested)
+                engine->idle();
+
+            if (! engine->fQuitRequested)
+                continue;
+
+            serverTimedOut = serverTimedOut || engine->fServerTimedOut;
+
+            {
+                const CarlaMutexLocker _cml(fMembersMutex);
+                fMembers.remove(it);
+            }
+
+            closeMember(engine);
+        }
+
+        if (fServerLost || ! isThreadRunning())
+            return false;
+
+        // the server is gone, nothing else will come
+        if (serverTimedOut && fMembers.isEmpty())
+            return false;
+
+        return true;
+    }
+
+protected:
+    void run() override
+    {
+        bool timedOut;
+
+        for (; ! shouldThreadExit();)
+        {
+            if (! fControl.waitForServer(5, &timedOut))
+            {
+                // same as single bridges, only stop on errors
+                if (timedOut) continue;
+
+                carla_stderr2("Bridge group timed-out, final post...");
+                fControl.postClient();
+                fServerLost = true;
+                break;
+            }
+
+            {
+                const CarlaMutexLocker _cml(fMembersMutex);
+
+                for (LinkedList<CarlaEngineBridge*>::Itenerator it = fMembers.begin(); it.valid(); it.next())
+                {
+                    CarlaEngineBridge* const engine(it.getValue(nullptr));
+                    CARLA_SAFE_ASSERT_CONTINUE(engine != nullptr);
+
+                    engine->handleRtData();
+                }
+            }
+
+            if (! fControl.postClient())
+                carla_stderr2("Could not post to group semaphore");
+        }
+    }
+
+private:
+    BridgeGroupControl fControl;
+
+    // taken by the process thread for every block, and by idle when adding or removing members
+    CarlaMutex fMembersMutex;
+    LinkedList<CarlaEngineBridge*> fMembers;
+
+    volatile bool fServerLost;
+
+    // returns false if the server asked us to quit
+    bool handleGroupData()
+    {
+        for (; fControl.isDataAvailableForReading();)
+        {
+            const PluginBridgeGroupOpcode opcode(fControl.readOpcode());
+
+            carla_debug("CarlaEngineBridgeGroupHost::handleGroupData() - got opcode: %s", PluginBridgeGroupOpcode2str(opcode));
+
+            switch (opcode)
+            {
+            case kPluginBridgeGroupNull:
+                break;
+
+            case kPluginBridgeGroupAddMember: {
+                CarlaString shmIds, filename, name, label;
+
+                fControl.readString(shmIds);
+                const PluginType ptype(static_cast<PluginType>(fControl.readUInt()));
+                fControl.readString(filename);
+                fControl.readString(name);
+                fControl.readString(label);
+                const int64_t uniqueId(fControl.readLong());
+
+                addMember(shmIds, ptype, filename, name, label, uniqueId);
+                break;
+            }
+
+            case kPluginBridgeGroupQuit:
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // same steps as the standalone bridge, but each plugin gets its own engine
+    void addMember(const CarlaString& shmIds, const PluginType ptype,
+                   const CarlaString& filename, const CarlaString& name, const CarlaString& label, const int64_t uniqueId)
+    {
+        CARLA_SAFE_ASSERT_RETURN(shmIds.length() == 6*4,);
+
+        char baseNames[4][6+1];
+
+        for (int i=0; i<4; ++i)
+        {
+            std::strncpy(baseNames[i], shmIds.buffer()+6*i, 6);
+            baseNames[i][6] = '\0';
+        }
+
+        CarlaString clientName(name.isNotEmpty() ? name : label);
+
+        if (clientName.isEmpty())
+            clientName = File(String(CharPointer_UTF8(filename.buffer()))).getFileNameWithoutExtension().toRawUTF8();
+
+        const void* extraStuff = nullptr;
+
+        if ((ptype == PLUGIN_GIG || ptype == PLUGIN_SF2) && std::strstr(label.isNotEmpty() ? label.buffer() : clientName.buffer(), " (16 outs)") != nullptr)
+            extraStuff = "true";
+
+        CarlaEngineBridge* const engine(new CarlaEngineBridge(baseNames[0], baseNames[1], baseNames[2], baseNames[3], true));
+
+        engine->setOptionsFromEnvironment();
+        engine->setOption(ENGINE_OPTION_PROCESS_MODE,   ENGINE_PROCESS_MODE_BRIDGE,   nullptr);
+        engine->setOption(ENGINE_OPTION_TRANSPORT_MODE, ENGINE_TRANSPORT_MODE_BRIDGE, nullptr);
+
+        if (! engine->init(clientName))
+        {
+            carla_stderr("Failed to init group member engine, error was:\n%s", engine->getLastError());
+            delete engine;
+            return;
+        }
+
+        if (! engine->addPlugin(ptype, filename.isNotEmpty() ? filename.buffer() : nullptr,
+                                name.isNotEmpty() ? name.buffer() : nullptr,
+                                label.isNotEmpty() ? label.buffer() : clientName.buffer(), uniqueId, extraStuff))
+        {
+            const char* const lastError(engine->getLastError());
+            const uint32_t lastErrorSize(static_cast<uint32_t>(std::strlen(lastError)));
+            carla_stderr("Plugin failed to load, error was:\n%s", lastError);
+
+            {
+                const CarlaMutexLocker _cml(engine->fShmNonRtServerControl.mutex);
+                engine->fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerError);
+                engine->fShmNonRtServerControl.writeUInt(lastErrorSize);
+                engine->fShmNonRtServerControl.writeCustomData(lastError, lastErrorSize);
+                engine->fShmNonRtServerControl.commitWrite();
+            }
+
+            closeMember(engine);
+            return;
+        }
+
+        const CarlaMutexLocker _cml(fMembersMutex);
+        fMembers.append(engine);
+    }
+
+    static void closeMember(CarlaEngineBridge* const engine)
+    {
+        CARLA_SAFE_ASSERT_RETURN(engine != nullptr,);
+
+        engine->setAboutToClose();
+        engine->removeAllPlugins();
+        engine->close();
+        delete engine;
+    }
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineBridgeGroupHost)
+};
+
+// -----------------------------------------------------------------------
+
+void CarlaEngine::setOptionsFromEnvironment()
+{
+    File juceBinaryDir(File::getSpecialLocation(File::currentExecutableFile).getParentDirectory());
+
+    /*
+    if (const char* const uisAlwaysOnTop = std::getenv("ENGINE_OPTION_FORCE_STEREO"))
+        setOption(ENGINE_OPTION_FORCE_STEREO, (std::strcmp(uisAlwaysOnTop, "true") == 0) ? 1 : 0, nullptr);
+
+    if (const char* const uisAlwaysOnTop = std::getenv("ENGINE_OPTION_PREFER_PLUGIN_BRIDGES"))
+        setOption(ENGINE_OPTION_PREFER_PLUGIN_BRIDGES, (std::strcmp(uisAlwaysOnTop, "true") == 0) ? 1 : 0, nullptr);
+
+    if (const char* const uisAlwaysOnTop = std::getenv("ENGINE_OPTION_PREFER_UI_BRIDGES"))
+        setOption(ENGINE_OPTION_PREFER_UI_BRIDGES, (std::strcmp(uisAlwaysOnTop, "true") == 0) ? 1 : 0, nullptr);
+    */
+
+    if (const char* const uisAlwaysOnTop = std::getenv("ENGINE_OPTION_UIS_ALWAYS_ON_TOP"))
+        setOption(ENGINE_OPTION_UIS_ALWAYS_ON_TOP, (std::strcmp(uisAlwaysOnTop, "true") == 0) ? 1 : 0, nullptr);
+
+    if (const char* const maxParameters = std::getenv("ENGINE_OPTION_MAX_PARAMETERS"))
+        setOption(ENGINE_OPTION_MAX_PARAMETERS,     std::atoi(maxParameters), nullptr);
+
+    if (const char* const uiBridgesTimeout = std::getenv("ENGINE_OPTION_UI_BRIDGES_TIMEOUT"))
+        setOption(ENGINE_OPTION_UI_BRIDGES_TIMEOUT, std::atoi(uiBridgesTimeout), nullptr);
+
+    if (const char* const pathLADSPA = std::getenv("ENGINE_OPTION_PLUGIN_PATH_LADSPA"))
+        setOption(ENGINE_OPTION_PLUGIN_PATH, PLUGIN_LADSPA, pathLADSPA);
+
+    if (const char* const pathDSSI = std::getenv("ENGINE_OPTION_PLUGIN_PATH_DSSI"))
+        setOption(ENGINE_OPTION_PLUGIN_PATH, PLUGIN_DSSI, pathDSSI);
+
+    if (const char* const pathLV2 = std::getenv("ENGINE_OPTION_PLUGIN_PATH_LV2"))
+        setOption(ENGINE_OPTION_PLUGIN_PATH, PLUGIN_LV2, pathLV2);
+
+    if (const char* const pathVST2 = std::getenv("ENGINE_OPTION_PLUGIN_PATH_VST2"))
+        setOption(ENGINE_OPTION_PLUGIN_PATH, PLUGIN_VST2, pathVST2);
+
+    if (const char* const pathVST3 = std::getenv("ENGINE_OPTION_PLUGIN_PATH_VST3"))
+        setOption(ENGINE_OPTION_PLUGIN_PATH, PLUGIN_VST3, pathVST3);
+
+    if (const char* const pathGIG = std::getenv("ENGINE_OPTION_PLUGIN_PATH_GIG"))
+        setOption(ENGINE_OPTION_PLUGIN_PATH, PLUGIN_GIG, pathGIG);
+
+    if (const char* const pathSF2 = std::getenv("ENGINE_OPTION_PLUGIN_PATH_SF2"))
+        setOption(ENGINE_OPTION_PLUGIN_PATH, PLUGIN_SF2, pathSF2);
+
+    if (const char* const pathSFZ = std::getenv("ENGINE_OPTION_PLUGIN_PATH_SFZ"))
+        setOption(ENGINE_OPTION_PLUGIN_PATH, PLUGIN_SFZ, pathSFZ);
+
+    if (const char* const binaryDir = std::getenv("ENGINE_OPTION_PATH_BINARIES"))
+        setOption(ENGINE_OPTION_PATH_BINARIES,   0, binaryDir);
+    else
+        setOption(ENGINE_OPTION_PATH_BINARIES,   0, juceBinaryDir.getFullPathName().toRawUTF8());
+
+    if (const char* const resourceDir = std::getenv("ENGINE_OPTION_PATH_RESOURCES"))
+        setOption(ENGINE_OPTION_PATH_RESOURCES,  0, resourceDir);
+    else
+        setOption(ENGINE_OPTION_PATH_RESOURCES,  0, juceBinaryDir.getChildFile("resources").getFullPathName().toRawUTF8());
+
+    if (const char* const preventBadBehaviour = std::getenv("ENGINE_OPTION_PREVENT_BAD_BEHAVIOUR"))
+        setOption(ENGINE_OPTION_PREVENT_BAD_BEHAVIOUR, (std::strcmp(preventBadBehaviour, "true") == 0) ? 1 : 0, nullptr);
+
+    if (const char* const frontendWinId = std::getenv("ENGINE_OPTION_FRONTEND_WIN_ID"))
+        setOption(ENGINE_OPTION_FRONTEND_WIN_ID, 0, frontendWinId);
+}
+
+// -----------------------------------------------------------------------
+
 CarlaEngine* CarlaEngine::newBridge(const char* const audioPoolBaseName, const char* const rtClientBaseName, const char* const nonRtClientBaseName, const char* const nonRtServerBaseName)
 {
     return new CarlaEngineBridge(audioPoolBaseName, rtClientBaseName, nonRtClientBaseName, nonRtServerBaseName);
 }
 
+CarlaEngineBridgeGroup* CarlaEngineBridgeGroup::newGroup(const char* const groupBaseName)
+{
+    CarlaEngineBridgeGroupHost* const group(new CarlaEngineBridgeGroupHost(groupBaseName));
+
+    if (group->init())
+        return group;
+
+    delete group;
+    return nullptr;
+}
+
 // -----------------------------------------------------------------------
 
 #ifdef BRIDGE_PLUGIN
@@ -215,7 +215,14 @@ EngineOptions::EngineOptions() noexcept
       binaryDir(nullptr),
       resourceDir(nullptr),
       preventBadBehaviour(false),
-      frontendWinId(0) {}
+      frontendWinId(0),
+      processThreads(0),
+      truePeakMeters(false),
+      pipelinedBridges(false),
+      sharedBridgeBuffers(false),
+      groupedBridges(0),
+      maxIdleRate(40),
+      maxLoadThreads(0) {}
 
 EngineOptions::~EngineOptions() noexcept
 {
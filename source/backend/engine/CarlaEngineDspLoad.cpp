@@ -0,0 +1,149 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineDspLoad.hpp"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// EngineDspLoadStats
+
+// weight of the last block in the average
+static const float kEngineDspLoadAverageWeight = 0.05f;
+
+EngineDspLoadStats::EngineDspLoadStats() noexcept
+    : fLast(0),
+      fAverage(0.0f),
+      fOverruns(0),
+      fCount(0) {}
+
+uint EngineDspLoadStats::getBin(const uint32_t usecs) noexcept
+{
+    if (usecs < 8)
+        return usecs;
+
+    uint msb = 3;
+    while ((usecs >> (msb+1)) != 0)
+        ++msb;
+
+    const uint bin((msb-2)*8 + ((usecs >> (msb-3)) & 7));
+    return bin < kEngineDspLoadBins ? bin : kEngineDspLoadBins-1;
+}
+
+uint32_t EngineDspLoadStats::getBinLimit(const uint bin) noexcept
+{
+    // first value of the next bin
+    const uint next(bin+1);
+
+    if (next < 8)
+        return next;
+
+    return (8 + (next % 8)) << (next/8 - 1);
+}
+
+void EngineDspLoadStats::process(const uint32_t usecs, const uint32_t periodUsecs) noexcept
+{
+    fLast.set(usecs);
+    fAverage.set(fAverage.get() + (static_cast<float>(usecs) - fAverage.get()) * kEngineDspLoadAverageWeight);
+
+    if (usecs > periodUsecs)
+        ++fOverruns;
+
+    ++fBins[getBin(usecs)];
+
+    if (++fCount < kEngineDspLoadWindow)
+        return;
+
+    fCount = 0;
+
+    for (uint i=0; i < kEngineDspLoadBins; ++i)
+    {
+        if (const uint32_t count = fBins[i].get())
+            fBins[i].set(count/2);
+    }
+}
+
+void EngineDspLoadStats::clear() noexcept
+{
+    fLast.set(0);
+    fAverage.set(0.0f);
+    fOverruns.set(0);
+    fCount = 0;
+
+    for (uint i=0; i < kEngineDspLoadBins; ++i)
+        fBins[i].set(0);
+}
+
+EngineDspLoad EngineDspLoadStats::get(const uint32_t periodUsecs) const noexcept
+{
+    EngineDspLoad load;
+    load.lastUsecs     = static_cast<float>(fLast.get());
+    load.averageUsecs  = fAverage.get();
+    load.p99Usecs      = 0.0f;
+    load.periodPercent = periodUsecs > 0 ? load.averageUsecs / static_cast<float>(periodUsecs) * 100.0f : 0.0f;
+    load.overruns      = fOverruns.get();
+
+    load.workerQueueDepth      = 0;
+    load.workerMaxQueueDepth   = 0;
+    load.workerMaxLatencyUsecs = 0.0f;
+    load.workerDropped         = 0;
+
+    uint32_t bins[kEngineDspLoadBins];
+    uint32_t total = 0;
+
+    for (uint i=0; i < kEngineDspLoadBins; ++i)
+        total += (bins[i] = fBins[i].get());
+
+    if (total == 0)
+        return load;
+
+    // upper limit of the bin that holds the 99th percentile
+    const uint32_t target(total - total/100);
+    uint32_t count = 0;
+
+    for (uint i=0; i < kEngineDspLoadBins; ++i)
+    {
+        count += bins[i];
+
+        if (count >= target)
+        {
+            load.p99Usecs = static_cast<float>(getBinLimit(i));
+            break;
+        }
+    }
+
+    return load;
+}
+
+// -----------------------------------------------------------------------
+// EngineDspLoadTimer
+
+EngineDspLoadTimer::EngineDspLoadTimer(EngineDspLoadStats& stats, const uint32_t frames, const double sampleRate) noexcept
+    : fStats(stats),
+      fPeriodUsecs(sampleRate > 0.0 ? static_cast<uint32_t>(static_cast<double>(frames) * 1000000.0 / sampleRate) : 0),
+      fStart(juce::Time::getHighResolutionTicks()) {}
+
+EngineDspLoadTimer::~EngineDspLoadTimer() noexcept
+{
+    const double secs(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - fStart));
+
+    fStats.process(static_cast<uint32_t>(secs * 1000000.0), fPeriodUsecs);
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
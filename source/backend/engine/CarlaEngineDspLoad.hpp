@@ -0,0 +1,90 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_DSP_LOAD_HPP_INCLUDED
+#define CARLA_ENGINE_DSP_LOAD_HPP_INCLUDED
+
+#include "CarlaEngine.hpp"
+
+#include "juce_core.h"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// Histogram bins, exact up to 8us, then 8 bins per power of 2 (12.5% resolution)
+
+const uint kEngineDspLoadBins = 128;
+
+// Histogram is halved after this many blocks, so old values fade out
+const uint32_t kEngineDspLoadWindow = 1024;
+
+// -----------------------------------------------------------------------
+// Process time statistics of a single plugin.
+// Written by the audio thread, can be read from any thread without locking.
+
+class EngineDspLoadStats
+{
+public:
+    EngineDspLoadStats() noexcept;
+
+    // RT, single writer
+    void process(const uint32_t usecs, const uint32_t periodUsecs) noexcept;
+
+    // resets all values, must not run at the same time as process()
+    void clear() noexcept;
+
+    // any thread
+    EngineDspLoad get(const uint32_t periodUsecs) const noexcept;
+
+    static uint     getBin(const uint32_t usecs) noexcept;
+    static uint32_t getBinLimit(const uint bin) noexcept;
+
+private:
+    juce::Atomic<uint32_t> fLast;
+    juce::Atomic<float>    fAverage;
+    juce::Atomic<uint32_t> fOverruns;
+    juce::Atomic<uint32_t> fBins[kEngineDspLoadBins];
+
+    // only touched by the audio thread
+    uint32_t fCount;
+
+    CARLA_DECLARE_NON_COPY_CLASS(EngineDspLoadStats)
+};
+
+// -----------------------------------------------------------------------
+// Times its own scope with a monotonic clock, and adds the result to @a stats.
+
+class EngineDspLoadTimer
+{
+public:
+    EngineDspLoadTimer(EngineDspLoadStats& stats, const uint32_t frames, const double sampleRate) noexcept;
+    ~EngineDspLoadTimer() noexcept;
+
+private:
+    EngineDspLoadStats& fStats;
+    const uint32_t fPeriodUsecs;
+    const juce::int64 fStart;
+
+    CARLA_PREVENT_HEAP_ALLOCATION
+    CARLA_DECLARE_NON_COPY_CLASS(EngineDspLoadTimer)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_DSP_LOAD_HPP_INCLUDED
@@ -0,0 +1,344 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineGraph.hpp"
+#include "CarlaEngineInternal.hpp"
+#include "CarlaBackendUtils.hpp"
+#include "CarlaEngineUtils.hpp"
+#include "CarlaThread.hpp"
+
+#include "juce_audio_formats.h"
+
+#include <cmath>
+
+using juce::AudioFormatManager;
+using juce::AudioFormatReader;
+using juce::AudioFormatWriter;
+using juce::AudioSampleBuffer;
+using juce::File;
+using juce::FileOutputStream;
+using juce::ScopedPointer;
+using juce::String;
+using juce::StringPairArray;
+using juce::WavAudioFormat;
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// Dummy engine, renders blocks as fast as possible, from and to audio files
+
+// the dummy engine always uses stereo, like the rack
+static const uint kDummyChannelCount = 2;
+
+// used for BBT when no tempo was set
+static const double kDummyBeatsPerMinute = 120.0;
+static const float  kDummyBeatsPerBar    = 4.0f;
+static const double kDummyTicksPerBeat   = 1920.0;
+
+class CarlaEngineDummy : public CarlaEngine,
+                         public CarlaThread
+{
+public:
+    CarlaEngineDummy()
+        : CarlaEngine(),
+          CarlaThread("CarlaEngineDummy"),
+          fReader(),
+          fWriter(),
+          fInBuffer(),
+          fOutBuffer(),
+          fInputEnded(),
+          leakDetector_CarlaEngineDummy()
+    {
+        carla_debug("CarlaEngineDummy::CarlaEngineDummy()");
+
+        // just to make sure
+        pData->options.transportMode = ENGINE_TRANSPORT_MODE_INTERNAL;
+    }
+
+    ~CarlaEngineDummy() override
+    {
+        carla_debug("CarlaEngineDummy::~CarlaEngineDummy()");
+    }
+
+    // -------------------------------------
+
+    bool init(const char* const clientName) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(clientName != nullptr && clientName[0] != '\0', false);
+        carla_debug("CarlaEngineDummy::init(\"%s\")", clientName);
+
+        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK && pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
+        {
+            setLastError("Invalid process mode");
+            return false;
+        }
+
+        // audio device is "[input-file|]output-file"
+        if (pData->options.audioDevice == nullptr || pData->options.audioDevice[0] == '\0')
+        {
+            setLastError("No output file set");
+            return false;
+        }
+
+        const String device(pData->options.audioDevice);
+        const bool   hasInput(device.containsChar('|'));
+        const String inFilename(hasInput ? device.upToFirstOccurrenceOf("|", false, false) : String());
+        const String outFilename(hasInput ? device.fromFirstOccurrenceOf("|", false, false) : device);
+
+        if (outFilename.isEmpty())
+        {
+            setLastError("No output file set");
+            return false;
+        }
+
+        const double sampleRate(pData->options.audioSampleRate);
+        const uint32_t bufferSize(pData->options.audioBufferSize);
+
+        if (inFilename.isNotEmpty())
+        {
+            AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+
+            fReader = formatManager.createReaderFor(File(inFilename));
+
+            if (fReader == nullptr)
+            {
+                setLastError("Failed to open input file");
+                return false;
+            }
+
+            if (! carla_compareFloats(fReader->sampleRate, sampleRate))
+                carla_stderr("CarlaEngineDummy::init() - input file sample rate %g does not match engine, will not be resampled", fReader->sampleRate);
+        }
+
+        const File outFile(outFilename);
+        outFile.deleteFile();
+
+        FileOutputStream* const outStream(outFile.createOutputStream());
+
+        if (outStream == nullptr)
+        {
+            fReader = nullptr;
+            setLastError("Failed to create output file");
+            return false;
+        }
+
+        WavAudioFormat wavFormat;
+        fWriter = wavFormat.createWriterFor(outStream, sampleRate, kDummyChannelCount, 32, StringPairArray(), 0);
+
+        if (fWriter == nullptr)
+        {
+            delete outStream;
+            fReader = nullptr;
+            setLastError("Failed to create output file writer");
+            return false;
+        }
+
+        if (! pData->init(clientName))
+        {
+            // nothing else was started yet, so don't close() the engine
+            fWriter = nullptr;
+            fReader = nullptr;
+            setLastError("Failed to init internal data");
+            return false;
+        }
+
+        pData->bufferSize = bufferSize;
+        pData->sampleRate = sampleRate;
+
+        fInBuffer.setSize(static_cast<int>(kDummyChannelCount), static_cast<int>(bufferSize));
+        fOutBuffer.setSize(static_cast<int>(kDummyChannelCount), static_cast<int>(bufferSize));
+        fInBuffer.clear();
+        fInputEnded.set(0);
+
+        pData->graph.create(kDummyChannelCount, kDummyChannelCount);
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            patchbayRefresh(false);
+
+        startThread();
+
+        callback(ENGINE_CALLBACK_ENGINE_STARTED, 0, pData->options.processMode, pData->options.transportMode, 0.0f, getCurrentDriverName());
+        return true;
+    }
+
+    bool close() override
+    {
+        carla_debug("CarlaEngineDummy::close()");
+
+        // stop rendering first
+        stopThread(-1);
+
+        // clear engine data
+        CarlaEngine::close();
+
+        if (pData->graph.isReady())
+            pData->graph.destroy();
+
+        // writer finishes the file header on delete
+        fWriter = nullptr;
+        fReader = nullptr;
+
+        return true;
+    }
+
+    void idle() noexcept override
+    {
+        CarlaEngine::idle();
+
+        // let the frontend know the render is done, from the main thread
+        if (fInputEnded.compareAndSetBool(0, 1))
+            callback(ENGINE_CALLBACK_INFO, 0, 0, 0, 0.0f, "Input file ended, transport was stopped");
+    }
+
+    bool isRunning() const noexcept override
+    {
+        // the engine thread starts before the render thread, and must see us running
+        return fWriter != nullptr;
+    }
+
+    bool isOffline() const noexcept override
+    {
+        return true;
+    }
+
+    EngineType getType() const noexcept override
+    {
+        return kEngineTypeDummy;
+    }
+
+    const char* getCurrentDriverName() const noexcept override
+    {
+        return "Dummy";
+    }
+
+    // -------------------------------------------------------------------
+
+protected:
+    void run() override
+    {
+        for (; ! shouldThreadExit();)
+        {
+            // only render while the transport is rolling, pending actions still need to run
+            if (! pData->time.playing)
+            {
+                pData->timeInfo.playing = false;
+                pData->timeInfo.frame   = pData->time.frame;
+                pData->doNextPluginAction(true);
+                carla_msleep(10);
+                continue;
+            }
+
+            if (fReader != nullptr && pData->time.frame >= static_cast<uint64_t>(fReader->lengthInSamples))
+            {
+                carla_stdout("CarlaEngineDummy::run() - input file ended, stopping transport");
+                transportPause();
+                fInputEnded.set(1);
+                continue;
+            }
+
+            processBlock();
+        }
+    }
+
+    void processBlock()
+    {
+        const PendingRtEventsRunner prt(this);
+
+        const uint32_t frames(pData->bufferSize);
+
+        fillTimeInfo();
+
+        // read input, missing samples are zero
+        if (fReader != nullptr)
+            fReader->read(&fInBuffer, 0, static_cast<int>(frames), static_cast<juce::int64>(pData->time.frame), true, true);
+
+        fOutBuffer.clear();
+
+        const float* inBuf[kDummyChannelCount];
+        /* */ float* outBuf[kDummyChannelCount];
+
+        for (uint i=0; i < kDummyChannelCount; ++i)
+        {
+            inBuf[i]  = fInBuffer.getReadPointer(static_cast<int>(i));
+            outBuf[i] = fOutBuffer.getWritePointer(static_cast<int>(i));
+        }
+
+        // no event inputs
+        clearEngineEvents(pData->events.in);
+        clearEngineEvents(pData->events.out);
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+            pData->graph.processRack(pData, inBuf, outBuf, frames);
+        else
+            pData->graph.process(pData, inBuf, outBuf, frames);
+
+        fWriter->writeFromAudioSampleBuffer(fOutBuffer, 0, static_cast<int>(frames));
+    }
+
+    // transport is always internal, so fill in BBT from the current frame
+    void fillTimeInfo() noexcept
+    {
+        EngineTimeInfo& timeInfo(pData->timeInfo);
+        EngineTimeInfoBBT& bbt(timeInfo.bbt);
+
+        if (bbt.beatsPerMinute <= 0.0)
+        {
+            bbt.beatsPerMinute = kDummyBeatsPerMinute;
+            bbt.beatsPerBar    = kDummyBeatsPerBar;
+            bbt.beatType       = 4.0f;
+            bbt.ticksPerBeat   = kDummyTicksPerBeat;
+        }
+
+        const double beatsPerBar(static_cast<double>(bbt.beatsPerBar));
+        const double absBeats(static_cast<double>(timeInfo.frame) / pData->sampleRate * bbt.beatsPerMinute / 60.0);
+        const double bars(std::floor(absBeats / beatsPerBar));
+
+        bbt.bar  = static_cast<int32_t>(bars) + 1;
+        bbt.beat = static_cast<int32_t>(absBeats - bars * beatsPerBar) + 1;
+        bbt.tick = static_cast<int32_t>((absBeats - std::floor(absBeats)) * bbt.ticksPerBeat);
+        bbt.barStartTick = bars * beatsPerBar * bbt.ticksPerBeat;
+
+        timeInfo.usecs  = static_cast<uint64_t>(static_cast<double>(timeInfo.frame) / pData->sampleRate * 1000000.0);
+        timeInfo.valid |= EngineTimeInfo::kValidBBT;
+    }
+
+    // -------------------------------------------------------------------
+
+private:
+    ScopedPointer<AudioFormatReader> fReader;
+    ScopedPointer<AudioFormatWriter> fWriter;
+
+    AudioSampleBuffer fInBuffer;
+    AudioSampleBuffer fOutBuffer;
+
+    // set by the render thread, reported in idle()
+    juce::Atomic<int> fInputEnded;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineDummy)
+};
+
+// -----------------------------------------------------------------------
+
+CarlaEngine* CarlaEngine::newDummy()
+{
+    return new CarlaEngineDummy();
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -643,6 +643,186 @@ void RackGraph::Buffers::setBufferSize(const uint32_t bufferSize, const bool cre
     }
 }
 
+// -----------------------------------------------------------------------
+// RackGraph parallel lanes
+// Each lane gets a copy of the rack inputs, lane outputs are summed at the end.
+// The dry input that passes through plugins without audio inputs is added once, in the sum.
+
+class RackParallelLanes : public EngineWorkerJob
+{
+public:
+    RackParallelLanes(RackGraph* const rack) noexcept
+        : fSchedule(),
+          fData(nullptr),
+          fInBuf(nullptr),
+          fFrames(0),
+          kRack(rack),
+          leakDetector_RackParallelLanes()
+    {
+        carla_zeroStruct<Lane>(fLanes, MAX_RACK_LANES);
+    }
+
+    ~RackParallelLanes() noexcept
+    {
+        for (uint i=0; i < MAX_RACK_LANES; ++i)
+        {
+            Lane& lane(fLanes[i]);
+
+            if (lane.outBuf[0]  != nullptr) { delete[] lane.outBuf[0];  lane.outBuf[0]  = nullptr; }
+            if (lane.outBuf[1]  != nullptr) { delete[] lane.outBuf[1];  lane.outBuf[1]  = nullptr; }
+            if (lane.eventsIn   != nullptr) { delete[] lane.eventsIn;   lane.eventsIn   = nullptr; }
+            if (lane.eventsOut  != nullptr) { delete[] lane.eventsOut;  lane.eventsOut  = nullptr; }
+            if (lane.eventsTmp  != nullptr) { delete[] lane.eventsTmp;  lane.eventsTmp  = nullptr; }
+        }
+    }
+
+    // non-RT
+    bool init(const uint32_t bufferSize) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(bufferSize > 0, false);
+
+        if (! fSchedule.init(MAX_RACK_LANES))
+            return false;
+        if (! fSchedule.finalize())
+            return false;
+
+        try {
+            for (uint i=0; i < MAX_RACK_LANES; ++i)
+            {
+                Lane& lane(fLanes[i]);
+
+                lane.outBuf[0] = new float[bufferSize];
+                lane.outBuf[1] = new float[bufferSize];
+                lane.eventsIn  = new EngineEvent[kMaxEngineEventInternalCount];
+                lane.eventsOut = new EngineEvent[kMaxEngineEventInternalCount];
+                lane.eventsTmp = new EngineEvent[kMaxEngineEventInternalCount];
+            }
+        } CARLA_SAFE_EXCEPTION_RETURN("RackParallelLanes::init", false);
+
+        return true;
+    }
+
+    // RT, returns false if there is nothing to run in parallel
+    bool process(CarlaEngineWorkerPool& workers, CarlaEngine::ProtectedData* const data,
+                 const float* inBufReal[2], float* outBuf[2], const uint32_t frames) noexcept
+    {
+        uint usedCount = 0;
+
+        for (uint i=0; i < MAX_RACK_LANES; ++i)
+            fLanes[i].used = false;
+
+        for (uint i=0; i < data->curPluginCount; ++i)
+        {
+            CarlaPlugin* const plugin = data->plugins[i].plugin;
+
+            if (plugin == nullptr || ! plugin->isEnabled())
+                continue;
+
+            // extra event ports always use the engine buffers, run everything in series
+            if (plugin->hasExtraEventPorts())
+                return false;
+
+            Lane& lane(fLanes[plugin->getRackLane()]);
+
+            if (! lane.used)
+            {
+                lane.used = true;
+                ++usedCount;
+            }
+        }
+
+        if (usedCount <= 1)
+            return false;
+
+        for (uint i=0; i < MAX_RACK_LANES; ++i)
+        {
+            if (fLanes[i].used)
+                copyEngineEvents(fLanes[i].eventsIn, data->events.in);
+        }
+
+        fData   = data;
+        fInBuf  = inBufReal;
+        fFrames = frames;
+
+        workers.run(*this, fSchedule);
+
+        fData  = nullptr;
+        fInBuf = nullptr;
+
+        // sum audio
+        const int iframes(static_cast<int>(frames));
+        bool needsDryInput = false;
+
+        FloatVectorOperations::clear(outBuf[0], iframes);
+        FloatVectorOperations::clear(outBuf[1], iframes);
+
+        for (uint i=0; i < MAX_RACK_LANES; ++i)
+        {
+            const Lane& lane(fLanes[i]);
+
+            if (! lane.used)
+                continue;
+
+            FloatVectorOperations::add(outBuf[0], lane.outBuf[0], iframes);
+            FloatVectorOperations::add(outBuf[1], lane.outBuf[1], iframes);
+
+            if (lane.needsDryInput)
+                needsDryInput = true;
+        }
+
+        if (needsDryInput)
+        {
+            FloatVectorOperations::add(outBuf[0], inBufReal[0], iframes);
+            FloatVectorOperations::add(outBuf[1], inBufReal[1], iframes);
+        }
+
+        // merge events, sorted by time, lower lanes first when time is the same
+        const EngineEvent* srcEvents[MAX_RACK_LANES];
+
+        for (uint i=0; i < MAX_RACK_LANES; ++i)
+            srcEvents[i] = fLanes[i].used ? fLanes[i].eventsOut : nullptr;
+
+        mergeEngineEvents(data->events.out, srcEvents, MAX_RACK_LANES);
+
+        return true;
+    }
+
+    void runTask(const uint taskId) noexcept override
+    {
+        Lane& lane(fLanes[taskId]);
+
+        if (! lane.used)
+            return;
+
+        lane.needsDryInput = false;
+
+        try {
+            lane.needsDryInput = kRack->processLane(fData, taskId, lane.eventsIn, lane.eventsOut, lane.eventsTmp, fInBuf, lane.outBuf, fFrames);
+        } CARLA_SAFE_EXCEPTION("RackParallelLanes::runTask");
+    }
+
+private:
+    struct Lane {
+        bool used;
+        bool needsDryInput; // output does not include the dry input yet
+        float* outBuf[2];
+        EngineEvent* eventsIn;
+        EngineEvent* eventsOut;
+        EngineEvent* eventsTmp; // for merging events between plugins
+    };
+
+    Lane fLanes[MAX_RACK_LANES];
+    EngineWorkerSchedule fSchedule;
+
+    CarlaEngine::ProtectedData* fData;
+    const float* const* fInBuf;
+    uint32_t fFrames;
+
+    RackGraph* const kRack;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RackParallelLanes)
+};
+
 // -----------------------------------------------------------------------
 // RackGraph
 
@@ -652,19 +832,73 @@ RackGraph::RackGraph(CarlaEngine* const engine, const uint32_t ins, const uint32
       outputs(outs),
       isOffline(false),
       audioBuffers(),
+      mergeEvents(nullptr),
+      lanesMutex(),
+      lanes(nullptr),
+      workers(),
       kEngine(engine)
 {
+    try {
+        mergeEvents = new EngineEvent[kMaxEngineEventInternalCount];
+    } CARLA_SAFE_EXCEPTION("RackGraph mergeEvents");
+
+    if (const uint processThreads = engine->getOptions().processThreads)
+    {
+        try {
+            workers.start(processThreads);
+        } CARLA_SAFE_EXCEPTION("RackGraph workers start");
+    }
+
     setBufferSize(engine->getBufferSize());
 }
 
 RackGraph::~RackGraph() noexcept
 {
+    {
+        const CarlaMutexLocker cml(lanesMutex);
+
+        if (lanes != nullptr)
+        {
+            delete lanes;
+            lanes = nullptr;
+        }
+    }
+
+    workers.stop();
     extGraph.clear();
+
+    if (mergeEvents != nullptr)
+    {
+        delete[] mergeEvents;
+        mergeEvents = nullptr;
+    }
 }
 
 void RackGraph::setBufferSize(const uint32_t bufferSize) noexcept
 {
     audioBuffers.setBufferSize(bufferSize, (inputs > 0 || outputs > 0));
+
+    if (workers.getThreadCount() == 0)
+        return;
+
+    RackParallelLanes* newLanes(nullptr);
+
+    try {
+        newLanes = new RackParallelLanes(this);
+    } CARLA_SAFE_EXCEPTION("RackParallelLanes create");
+
+    if (newLanes != nullptr && ! newLanes->init(bufferSize))
+    {
+        delete newLanes;
+        newLanes = nullptr;
+    }
+
+    {
+        const CarlaMutexLocker cml(lanesMutex);
+        std::swap(lanes, newLanes);
+    }
+
+    delete newLanes;
 }
 
 void RackGraph::setOffline(const bool offline) noexcept
@@ -772,7 +1006,24 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(data->events.in != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(data->events.out != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(mergeEvents != nullptr,);
+
+    // try parallel lanes first, they might be reallocating
+    if (lanes != nullptr)
+    {
+        const CarlaMutexTryLocker cmtl(lanesMutex);
+
+        if (cmtl.wasLocked() && lanes != nullptr && lanes->process(workers, data, inBufReal, outBuf, frames))
+            return;
+    }
+
+    processLane(data, MAX_RACK_LANES, data->events.in, data->events.out, mergeEvents, inBufReal, outBuf, frames);
+}
 
+bool RackGraph::processLane(CarlaEngine::ProtectedData* const data, const uint lane,
+                            EngineEvent* const eventsIn, EngineEvent* const eventsOut, EngineEvent* const eventsTmp,
+                            const float* const inBufReal[2], float* outBuf[2], const uint32_t frames)
+{
     const int iframes(static_cast<int>(frames));
 
     // safe copy
@@ -789,20 +1040,26 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     FloatVectorOperations::clear(outBuf[1], iframes);
 
     // initialize event outputs (zero)
-    carla_zeroStruct<EngineEvent>(data->events.out, kMaxEngineEventInternalCount);
+    clearEngineEvents(eventsOut);
 
     uint32_t oldAudioInCount  = 0;
     uint32_t oldAudioOutCount = 0;
     uint32_t oldMidiOutCount  = 0;
     bool processed = false;
-    juce::Range<float> range;
+
+    // lanes leave the dry input out while only plugins without audio inputs ran, it is added once to the sum
+    bool needsDryInput = false;
 
     // process plugins
     for (uint i=0; i < data->curPluginCount; ++i)
     {
         CarlaPlugin* const plugin = data->plugins[i].plugin;
 
-        if (plugin == nullptr || ! plugin->isEnabled() || ! plugin->tryLock(isOffline))
+        if (plugin == nullptr || ! plugin->isEnabled())
+            continue;
+        if (lane != MAX_RACK_LANES && plugin->getRackLane() != lane)
+            continue;
+        if (! plugin->tryLock(isOffline))
             continue;
 
         if (processed)
@@ -816,21 +1073,28 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
             FloatVectorOperations::clear(outBuf[1], iframes);
 
             // if plugin has no midi out, add previous events
-            if (oldMidiOutCount == 0 && data->events.in[0].type != kEngineEventTypeNull)
+            if (oldMidiOutCount == 0 && eventsIn[0].type != kEngineEventTypeNull)
             {
-                if (data->events.out[0].type != kEngineEventTypeNull)
+                if (eventsOut[0].type != kEngineEventTypeNull)
                 {
-                    // TODO: carefully add to input, sorted events
+                    // add to input, sorted by time
+                    const EngineEvent* const srcEvents[2] = { eventsIn, eventsOut };
+
+                    mergeEngineEvents(eventsTmp, srcEvents, 2);
+                    copyEngineEvents(eventsIn, eventsTmp);
+
+                    // initialize event outputs (zero)
+                    clearEngineEvents(eventsOut);
                 }
                 // else nothing needed
             }
             else
             {
                 // initialize event inputs from previous outputs
-                carla_copyStruct<EngineEvent>(data->events.in, data->events.out, kMaxEngineEventInternalCount);
+                copyEngineEvents(eventsIn, eventsOut);
 
                 // initialize event outputs (zero)
-                carla_zeroStruct<EngineEvent>(data->events.out, kMaxEngineEventInternalCount);
+                clearEngineEvents(eventsOut);
             }
         }
 
@@ -838,16 +1102,49 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
         oldAudioOutCount = plugin->getAudioOutCount();
         oldMidiOutCount  = plugin->getMidiOutCount();
 
+        // plugin takes audio, give it the dry input that was left out so far
+        if (needsDryInput && oldAudioInCount > 0)
+        {
+            FloatVectorOperations::add(inBuf0, inBufReal[0], iframes);
+            FloatVectorOperations::add(inBuf1, inBufReal[1], iframes);
+            needsDryInput = false;
+        }
+
         // process
         plugin->initBuffers();
-        plugin->process(inBuf, outBuf, nullptr, nullptr, frames);
+
+        // lanes use their own event buffers instead of the engine ones
+        if (lane != MAX_RACK_LANES)
+        {
+            if (CarlaEngineEventPort* const port = plugin->getDefaultEventInPort())
+                port->fBuffer = eventsIn;
+            if (CarlaEngineEventPort* const port = plugin->getDefaultEventOutPort())
+            {
+                port->fBuffer     = eventsOut;
+                port->fWriteIndex = 0;
+            }
+        }
+
+        {
+            const EngineDspLoadTimer dlt(data->plugins[i].dspLoad, frames, data->sampleRate);
+            plugin->process(inBuf, outBuf, nullptr, nullptr, frames);
+        }
+
         plugin->unlock();
 
         // if plugin has no audio inputs, add input buffer
         if (oldAudioInCount == 0)
         {
-            FloatVectorOperations::add(outBuf[0], inBuf0, iframes);
-            FloatVectorOperations::add(outBuf[1], inBuf1, iframes);
+            if (lane != MAX_RACK_LANES && ! processed)
+            {
+                // first plugin of the lane, its input is the dry one
+                needsDryInput = true;
+            }
+            else
+            {
+                FloatVectorOperations::add(outBuf[0], inBuf0, iframes);
+                FloatVectorOperations::add(outBuf[1], inBuf1, iframes);
+            }
         }
 
         // if plugin only has 1 output, copy it to the 2nd
@@ -856,41 +1153,20 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
             FloatVectorOperations::copy(outBuf[1], outBuf[0], iframes);
         }
 
-        // set peaks
+        // set meters
+        if (data->meterReaders.isActive())
         {
             EnginePluginData& pluginData(data->plugins[i]);
+            const float* const inBufs[2] = { inBuf0, inBuf1 };
 
-            if (oldAudioInCount > 0)
-            {
-                range = FloatVectorOperations::findMinAndMax(inBuf0, iframes);
-                pluginData.insPeak[0] = carla_maxLimited<float>(std::abs(range.getStart()), std::abs(range.getEnd()), 1.0f);
-
-                range = FloatVectorOperations::findMinAndMax(inBuf1, iframes);
-                pluginData.insPeak[1] = carla_maxLimited<float>(std::abs(range.getStart()), std::abs(range.getEnd()), 1.0f);
-            }
-            else
-            {
-                pluginData.insPeak[0] = 0.0f;
-                pluginData.insPeak[1] = 0.0f;
-            }
-
-            if (oldAudioOutCount > 0)
-            {
-                range = FloatVectorOperations::findMinAndMax(outBuf[0], iframes);
-                pluginData.outsPeak[0] = carla_maxLimited<float>(std::abs(range.getStart()), std::abs(range.getEnd()), 1.0f);
-
-                range = FloatVectorOperations::findMinAndMax(outBuf[1], iframes);
-                pluginData.outsPeak[1] = carla_maxLimited<float>(std::abs(range.getStart()), std::abs(range.getEnd()), 1.0f);
-            }
-            else
-            {
-                pluginData.outsPeak[0] = 0.0f;
-                pluginData.outsPeak[1] = 0.0f;
-            }
+            pluginData.insMeter.process(inBufs, oldAudioInCount > 0 ? 2 : 0, frames, data->options.truePeakMeters);
+            pluginData.outsMeter.process(outBuf, oldAudioOutCount > 0 ? 2 : 0, frames, data->options.truePeakMeters);
         }
 
         processed = true;
     }
+
+    return needsDryInput;
 }
 
 void RackGraph::processHelper(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
@@ -1217,63 +1493,86 @@ public:
             EngineEvent* const engineEvents(port->fBuffer);
             CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr,);
 
-            carla_zeroStruct<EngineEvent>(engineEvents, kMaxEngineEventInternalCount);
+            clearEngineEvents(engineEvents);
             fillEngineEventsFromJuceMidiBuffer(engineEvents, midi);
         }
 
         midi.clear();
 
-        // TODO - CV support
+        processAudio(audio);
 
-        const int numSamples(audio.getNumSamples());
+        midi.clear();
 
-        if (const int numChan = audio.getNumChannels())
+        if (CarlaEngineEventPort* const port = fPlugin->getDefaultEventOutPort())
         {
-            if (fPlugin->getAudioInCount() == 0)
-                audio.clear();
+            /*const*/ EngineEvent* const engineEvents(port->fBuffer);
+            CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr,);
 
-            float* audioBuffers[numChan];
+            fillJuceMidiBufferFromEngineEvents(midi, engineEvents);
+            clearEngineEvents(engineEvents);
+        }
 
-            for (int i=0; i<numChan; ++i)
-                audioBuffers[i] = audio.getWritePointer(i);
+        fPlugin->unlock();
+    }
+
+    // Same as processBlock(), split in two and using separate input and output buffers.
+    // Locks the plugin, returns false if it can't run now. Otherwise renderBlock() must follow.
+    // With @a useOwnBuffers, buffer pointers are replaced by the plugin's own port buffers, if it has them.
+    bool prepareToRender(float** const ins, const int numIns, float** const outs, const int numOuts, const bool useOwnBuffers) noexcept
+    {
+        if (fPlugin == nullptr || ! fPlugin->isEnabled())
+            return false;
 
-            float inPeaks[2] = { 0.0f };
-            float outPeaks[2] = { 0.0f };
-            juce::Range<float> range;
+        if (! fPlugin->tryLock(kEngine->isOffline()))
+            return false;
 
-            for (int i=jmin(fPlugin->getAudioInCount(), 2U); --i>=0;)
+        if (useOwnBuffers)
+        {
+            for (int i=0; i < numIns; ++i)
             {
-                range = FloatVectorOperations::findMinAndMax(audioBuffers[i], numSamples);
-                inPeaks[i] = carla_maxLimited<float>(std::abs(range.getStart()), std::abs(range.getEnd()), 1.0f);
+                if (float* const buffer = fPlugin->getAudioPortBuffer(true, static_cast<uint32_t>(i)))
+                    ins[i] = buffer;
             }
 
-            fPlugin->process(const_cast<const float**>(audioBuffers), audioBuffers, nullptr, nullptr, static_cast<uint32_t>(numSamples));
-
-            for (int i=jmin(fPlugin->getAudioOutCount(), 2U); --i>=0;)
+            for (int i=0; i < numOuts; ++i)
             {
-                range = FloatVectorOperations::findMinAndMax(audioBuffers[i], numSamples);
-                outPeaks[i] = carla_maxLimited<float>(std::abs(range.getStart()), std::abs(range.getEnd()), 1.0f);
+                if (float* const buffer = fPlugin->getAudioPortBuffer(false, static_cast<uint32_t>(i)))
+                    outs[i] = buffer;
             }
+        }
 
-            kEngine->setPluginPeaks(fPlugin->getId(), inPeaks, outPeaks);
+        return true;
+    }
+
+    // Passes engine events directly instead of using juce buffers.
+    // Input events are merged by time, returns the output events or null if there are none.
+    const EngineEvent* renderBlock(float** const ins, const int numIns, float** const outs, const int numOuts, const int frames,
+                                   const EngineEvent* const inEvents[], const uint inEventsCount)
+    {
+        fPlugin->initBuffers();
+
+        if (CarlaEngineEventPort* const port = fPlugin->getDefaultEventInPort())
+        {
+            if (port->fBuffer != nullptr)
+                mergeEngineEvents(port->fBuffer, inEvents, inEventsCount);
         }
-        else
+
+        if (numIns == 0)
         {
-            fPlugin->process(nullptr, nullptr, nullptr, nullptr, static_cast<uint32_t>(numSamples));
+            for (int i=0; i < numOuts; ++i)
+                FloatVectorOperations::clear(outs[i], frames);
         }
 
-        midi.clear();
+        processAudio(ins, static_cast<uint32_t>(numIns), outs, static_cast<uint32_t>(numOuts), static_cast<uint32_t>(frames));
 
-        if (CarlaEngineEventPort* const port = fPlugin->getDefaultEventOutPort())
-        {
-            /*const*/ EngineEvent* const engineEvents(port->fBuffer);
-            CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr,);
+        // valid until the next initBuffers() call
+        const EngineEvent* outEvents(nullptr);
 
-            fillJuceMidiBufferFromEngineEvents(midi, engineEvents);
-            carla_zeroStruct<EngineEvent>(engineEvents, kMaxEngineEventInternalCount);
-        }
+        if (CarlaEngineEventPort* const port = fPlugin->getDefaultEventOutPort())
+            outEvents = port->fBuffer;
 
         fPlugin->unlock();
+        return outEvents;
     }
 
     const String getInputChannelName(int i)  const override
@@ -1329,9 +1628,358 @@ private:
     CarlaEngine* const kEngine;
     CarlaPlugin* fPlugin;
 
+    // TODO - CV support
+    void processAudio(AudioSampleBuffer& audio)
+    {
+        const int numSamples(audio.getNumSamples());
+
+        if (const int numChan = audio.getNumChannels())
+        {
+            if (fPlugin->getAudioInCount() == 0)
+                audio.clear();
+
+            float* audioBuffers[numChan];
+
+            for (int i=0; i<numChan; ++i)
+                audioBuffers[i] = audio.getWritePointer(i);
+
+            processAudio(audioBuffers, jmin(fPlugin->getAudioInCount(), static_cast<uint>(numChan)),
+                         audioBuffers, jmin(fPlugin->getAudioOutCount(), static_cast<uint>(numChan)),
+                         static_cast<uint32_t>(numSamples));
+        }
+        else
+        {
+            processAudio(nullptr, 0, nullptr, 0, static_cast<uint32_t>(numSamples));
+        }
+    }
+
+    // @a ins and @a outs can be the same buffers, for in-place processing
+    void processAudio(float** const ins, const uint32_t numIns, float** const outs, const uint32_t numOuts, const uint32_t frames)
+    {
+        CarlaEngine::ProtectedData* const data(kEngine->pData);
+        EnginePluginData& pluginData(data->plugins[fPlugin->getId()]);
+
+        const bool metering(data->meterReaders.isActive() && (numIns > 0 || numOuts > 0));
+
+        if (metering)
+            pluginData.insMeter.process(ins, numIns, frames, data->options.truePeakMeters);
+
+        {
+            const EngineDspLoadTimer dlt(pluginData.dspLoad, frames, data->sampleRate);
+            fPlugin->process(const_cast<const float**>(ins), outs, nullptr, nullptr, frames);
+        }
+
+        if (metering)
+            pluginData.outsMeter.process(outs, numOuts, frames, data->options.truePeakMeters);
+    }
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginInstance)
 };
 
+// -----------------------------------------------------------------------
+// Patchbay parallel renderer
+// Each graph node is a task with its own buffers, dependencies come from the graph connections.
+// Node inputs are summed in connection order, so output does not depend on thread timing.
+// MIDI is passed between nodes as engine events, merged by time when a node has several inputs.
+// Without worker threads all tasks run in series in the audio thread.
+
+class PatchbayParallelRenderer : public EngineWorkerJob
+{
+public:
+    PatchbayParallelRenderer(const uint32_t ins, const uint32_t outs, const bool usePluginBuffers) noexcept
+        : fNodes(),
+          fSchedule(),
+          fInBuf(nullptr),
+          fEventsIn(nullptr),
+          fEventsOut(nullptr),
+          fFrames(0),
+          fBufferSize(0),
+          fAudioOutNode(-1),
+          fMidiOutNode(-1),
+          kInputs(ins),
+          kOutputs(outs),
+          kUsePluginBuffers(usePluginBuffers),
+          leakDetector_PatchbayParallelRenderer() {}
+
+    // non-RT, returns false if the graph cannot be processed in parallel
+    bool build(const AudioProcessorGraph& graph, const int bufferSize)
+    {
+        CARLA_SAFE_ASSERT_RETURN(bufferSize > 0, false);
+
+        const int numNodes(graph.getNumNodes());
+        CARLA_SAFE_ASSERT_RETURN(numNodes > 0, false);
+
+        fBufferSize = bufferSize;
+
+        for (int i=0; i < numNodes; ++i)
+        {
+            AudioProcessorGraph::Node* const node(graph.getNode(i));
+            CARLA_SAFE_ASSERT_RETURN(node != nullptr, false);
+
+            AudioProcessor* const proc(node->getProcessor());
+            CARLA_SAFE_ASSERT_RETURN(proc != nullptr, false);
+
+            RenderNode* const renderNode(new RenderNode(node->nodeId, proc));
+            fNodes.add(renderNode);
+
+            if (AudioProcessorGraph::AudioGraphIOProcessor* const ioProc = dynamic_cast<AudioProcessorGraph::AudioGraphIOProcessor*>(proc))
+            {
+                renderNode->ioType = ioProc->getType();
+
+                switch (renderNode->ioType)
+                {
+                case AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode:
+                    renderNode->numOuts = static_cast<int>(kInputs);
+                    break;
+                case AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode:
+                    renderNode->numIns = static_cast<int>(kOutputs);
+                    fAudioOutNode = i;
+                    break;
+                case AudioProcessorGraph::AudioGraphIOProcessor::midiOutputNode:
+                    fMidiOutNode = i;
+                    break;
+                }
+            }
+            else if (CarlaPluginInstance* const pluginProc = dynamic_cast<CarlaPluginInstance*>(proc))
+            {
+                renderNode->plugin  = pluginProc;
+                renderNode->numIns  = proc->getNumInputChannels();
+                renderNode->numOuts = proc->getNumOutputChannels();
+            }
+            else
+            {
+                carla_stderr("PatchbayParallelRenderer::build() - unknown graph node");
+                return false;
+            }
+
+            renderNode->audio.setSize(jmax(renderNode->numIns, renderNode->numOuts), bufferSize);
+            renderNode->audio.clear();
+            renderNode->ins.calloc(static_cast<size_t>(jmax(renderNode->numIns, 1)));
+            renderNode->outs.calloc(static_cast<size_t>(jmax(renderNode->numOuts, 1)));
+        }
+
+        if (! fSchedule.init(static_cast<uint>(numNodes)))
+            return false;
+
+        for (int i=0, count=graph.getNumConnections(); i < count; ++i)
+        {
+            const AudioProcessorGraph::Connection* const conn(graph.getConnection(i));
+            CARLA_SAFE_ASSERT_CONTINUE(conn != nullptr);
+
+            const int srcNode(getNodeIndex(conn->sourceNodeId));
+            const int dstNode(getNodeIndex(conn->destNodeId));
+            CARLA_SAFE_ASSERT_CONTINUE(srcNode >= 0 && dstNode >= 0);
+
+            RenderNode* const dst(fNodes.getUnchecked(dstNode));
+
+            if (conn->sourceChannelIndex == AudioProcessorGraph::midiChannelIndex)
+            {
+                dst->midiInputs.add(srcNode);
+            }
+            else
+            {
+                CARLA_SAFE_ASSERT_CONTINUE(conn->sourceChannelIndex < fNodes.getUnchecked(srcNode)->numOuts);
+                CARLA_SAFE_ASSERT_CONTINUE(conn->destChannelIndex < dst->numIns);
+
+                const AudioConnection audioConn = { srcNode, conn->sourceChannelIndex, conn->destChannelIndex };
+                dst->audioInputs.add(audioConn);
+            }
+
+            fSchedule.addDependency(static_cast<uint>(dstNode), static_cast<uint>(srcNode));
+        }
+
+        return fSchedule.finalize();
+    }
+
+    // RT, returns false if the block was not processed
+    bool process(CarlaEngineWorkerPool& workers, const float* const* const inBuf, float* const* const outBuf,
+                 const EngineEvent* const eventsIn, EngineEvent* const eventsOut, const int frames) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(frames <= fBufferSize, false);
+
+        fInBuf     = inBuf;
+        fEventsIn  = eventsIn;
+        fEventsOut = eventsOut;
+        fFrames    = frames;
+
+        if (fMidiOutNode < 0)
+            clearEngineEvents(eventsOut);
+
+        workers.run(*this, fSchedule);
+
+        if (fAudioOutNode >= 0)
+        {
+            const AudioSampleBuffer& audio(fNodes.getUnchecked(fAudioOutNode)->audio);
+
+            for (uint32_t i=0; i < kOutputs; ++i)
+                FloatVectorOperations::copy(outBuf[i], audio.getReadPointer(static_cast<int>(i)), frames);
+        }
+        else
+        {
+            for (uint32_t i=0; i < kOutputs; ++i)
+                FloatVectorOperations::clear(outBuf[i], frames);
+        }
+
+        fInBuf     = nullptr;
+        fEventsIn  = nullptr;
+        fEventsOut = nullptr;
+        return true;
+    }
+
+    void runTask(const uint taskId) noexcept override
+    {
+        RenderNode& node(*fNodes.getUnchecked(static_cast<int>(taskId)));
+        const int frames(fFrames);
+
+        // node buffers are in-place, plugins may replace them with their own
+        for (int i=0; i < node.numIns; ++i)
+            node.ins[i] = node.audio.getWritePointer(i);
+        for (int i=0; i < node.numOuts; ++i)
+            node.outs[i] = node.audio.getWritePointer(i);
+
+        node.events = nullptr;
+
+        // plugin stays locked until its block is done
+        if (node.plugin != nullptr && ! node.plugin->prepareToRender(node.ins, node.numIns, node.outs, node.numOuts, kUsePluginBuffers))
+        {
+            node.audio.clear(0, frames);
+            return;
+        }
+
+        // audio inputs
+        if (node.numIns > 0)
+        {
+            bool connected[node.numIns];
+            carla_zeroStruct<bool>(connected, static_cast<std::size_t>(node.numIns));
+
+            for (int i=0, count=node.audioInputs.size(); i < count; ++i)
+            {
+                const AudioConnection& conn(node.audioInputs.getReference(i));
+
+                const float* const src(fNodes.getUnchecked(conn.srcNode)->outs[conn.srcChannel]);
+                float*       const dst(node.ins[conn.dstChannel]);
+
+                if (connected[conn.dstChannel])
+                {
+                    FloatVectorOperations::add(dst, src, frames);
+                }
+                else
+                {
+                    FloatVectorOperations::copy(dst, src, frames);
+                    connected[conn.dstChannel] = true;
+                }
+            }
+
+            for (int i=0; i < node.numIns; ++i)
+            {
+                if (! connected[i])
+                    FloatVectorOperations::clear(node.ins[i], frames);
+            }
+        }
+
+        // midi inputs, in connection order
+        const uint midiInputCount(static_cast<uint>(node.midiInputs.size()));
+        const EngineEvent* midiInputs[midiInputCount+1];
+
+        for (uint i=0; i < midiInputCount; ++i)
+            midiInputs[i] = fNodes.getUnchecked(node.midiInputs.getUnchecked(static_cast<int>(i)))->events;
+
+        switch (node.ioType)
+        {
+        case AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode:
+            for (uint32_t i=0; i < kInputs; ++i)
+                FloatVectorOperations::copy(node.outs[i], fInBuf[i], frames);
+            break;
+
+        case AudioProcessorGraph::AudioGraphIOProcessor::midiInputNode:
+            node.events = fEventsIn;
+            break;
+
+        case AudioProcessorGraph::AudioGraphIOProcessor::midiOutputNode:
+            mergeEngineEvents(fEventsOut, midiInputs, midiInputCount);
+            break;
+
+        case AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode:
+            // read back in process()
+            break;
+
+        default: {
+            CARLA_SAFE_ASSERT_BREAK(node.plugin != nullptr);
+
+            try {
+                node.events = node.plugin->renderBlock(node.ins, node.numIns, node.outs, node.numOuts, frames, midiInputs, midiInputCount);
+            } CARLA_SAFE_EXCEPTION("PatchbayParallelRenderer::runTask");
+        }   break;
+        }
+    }
+
+private:
+    struct AudioConnection {
+        int srcNode;
+        int srcChannel;
+        int dstChannel;
+    };
+
+    struct RenderNode {
+        const uint32_t nodeId;
+        AudioProcessor* const proc;
+        CarlaPluginInstance* plugin;
+        int ioType;
+        int numIns;
+        int numOuts;
+        AudioSampleBuffer audio;
+        juce::HeapBlock<float*> ins;  // buffers used in the current block, point to
+        juce::HeapBlock<float*> outs; // the channels of 'audio' or to the plugin's own buffers
+        const EngineEvent* events; // output events of the current block
+        juce::Array<AudioConnection> audioInputs;
+        juce::Array<int> midiInputs;
+
+        RenderNode(const uint32_t id, AudioProcessor* const p)
+            : nodeId(id),
+              proc(p),
+              plugin(nullptr),
+              ioType(-1),
+              numIns(0),
+              numOuts(0),
+              audio(),
+              ins(),
+              outs(),
+              events(nullptr),
+              audioInputs(),
+              midiInputs() {}
+
+        CARLA_DECLARE_NON_COPY_STRUCT(RenderNode)
+    };
+
+    juce::OwnedArray<RenderNode> fNodes;
+    EngineWorkerSchedule fSchedule;
+
+    const float* const* fInBuf;
+    const EngineEvent*  fEventsIn;
+    EngineEvent*        fEventsOut;
+    int fFrames;
+    int fBufferSize;
+    int fAudioOutNode;
+    int fMidiOutNode;
+
+    const uint32_t kInputs;
+    const uint32_t kOutputs;
+    const bool kUsePluginBuffers;
+
+    int getNodeIndex(const uint32_t nodeId) const noexcept
+    {
+        for (int i=0, count=fNodes.size(); i < count; ++i)
+        {
+            if (fNodes.getUnchecked(i)->nodeId == nodeId)
+                return i;
+        }
+
+        return -1;
+    }
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchbayParallelRenderer)
+};
+
 // -----------------------------------------------------------------------
 // Patchbay Graph
 
@@ -1345,6 +1993,9 @@ PatchbayGraph::PatchbayGraph(CarlaEngine* const engine, const uint32_t ins, cons
       retCon(),
       usingExternal(false),
       extGraph(engine),
+      parallelMutex(),
+      parallelRenderer(nullptr),
+      workers(),
       kEngine(engine)
 {
     const int    bufferSize(static_cast<int>(engine->getBufferSize()));
@@ -1401,10 +2052,17 @@ PatchbayGraph::PatchbayGraph(CarlaEngine* const engine, const uint32_t ins, cons
         node->properties.set("isMIDI", true);
         node->properties.set("isOSC", false);
     }
+
+    // without process threads the renderer runs all nodes in the audio thread
+    workers.start(engine->getOptions().processThreads);
+    rebuildParallelRenderer();
 }
 
 PatchbayGraph::~PatchbayGraph()
 {
+    clearParallelRenderer();
+    workers.stop();
+
     connections.clear();
     extGraph.clear();
 
@@ -1420,6 +2078,8 @@ void PatchbayGraph::setBufferSize(const uint32_t bufferSize)
     graph.releaseResources();
     graph.prepareToPlay(kEngine->getSampleRate(), bufferSizei);
     audioBuffer.setSize(audioBuffer.getNumChannels(), bufferSizei);
+
+    rebuildParallelRenderer();
 }
 
 void PatchbayGraph::setSampleRate(const double sampleRate)
@@ -1449,6 +2109,8 @@ void PatchbayGraph::addPlugin(CarlaPlugin* const plugin)
 
     if (! usingExternal)
         addNodeToPatchbay(plugin->getEngine(), node->nodeId, static_cast<int>(plugin->getId()), instance);
+
+    rebuildParallelRenderer();
 }
 
 void PatchbayGraph::replacePlugin(CarlaPlugin* const oldPlugin, CarlaPlugin* const newPlugin)
@@ -1461,6 +2123,8 @@ void PatchbayGraph::replacePlugin(CarlaPlugin* const oldPlugin, CarlaPlugin* con
     AudioProcessorGraph::Node* const oldNode(graph.getNodeForId(oldPlugin->getPatchbayNodeId()));
     CARLA_SAFE_ASSERT_RETURN(oldNode != nullptr,);
 
+    clearParallelRenderer();
+
     if (! usingExternal)
     {
         disconnectInternalGroup(oldNode->nodeId);
@@ -1482,6 +2146,8 @@ void PatchbayGraph::replacePlugin(CarlaPlugin* const oldPlugin, CarlaPlugin* con
 
     if (! usingExternal)
         addNodeToPatchbay(newPlugin->getEngine(), node->nodeId, static_cast<int>(newPlugin->getId()), instance);
+
+    rebuildParallelRenderer();
 }
 
 void PatchbayGraph::removePlugin(CarlaPlugin* const plugin)
@@ -1492,6 +2158,8 @@ void PatchbayGraph::removePlugin(CarlaPlugin* const plugin)
     AudioProcessorGraph::Node* const node(graph.getNodeForId(plugin->getPatchbayNodeId()));
     CARLA_SAFE_ASSERT_RETURN(node != nullptr,);
 
+    clearParallelRenderer();
+
     if (! usingExternal)
     {
         disconnectInternalGroup(node->nodeId);
@@ -1514,12 +2182,16 @@ void PatchbayGraph::removePlugin(CarlaPlugin* const plugin)
     }
 
     CARLA_SAFE_ASSERT_RETURN(graph.removeNode(node->nodeId),);
+
+    rebuildParallelRenderer();
 }
 
 void PatchbayGraph::removeAllPlugins()
 {
     carla_debug("PatchbayGraph::removeAllPlugins()");
 
+    clearParallelRenderer();
+
     for (uint i=0, count=kEngine->getCurrentPluginCount(); i<count; ++i)
     {
         CarlaPlugin* const plugin(kEngine->getPlugin(i));
@@ -1538,6 +2210,8 @@ void PatchbayGraph::removeAllPlugins()
 
         graph.removeNode(node->nodeId);
     }
+
+    rebuildParallelRenderer();
 }
 
 bool PatchbayGraph::connect(const bool external, const uint groupA, const uint portA, const uint groupB, const uint portB, const bool sendCallback)
@@ -1559,6 +2233,8 @@ bool PatchbayGraph::connect(const bool external, const uint groupA, const uint p
         return false;
     }
 
+    rebuildParallelRenderer();
+
     ConnectionToId connectionToId;
     connectionToId.setData(++connections.lastId, groupA, portA, groupB, portB);
 
@@ -1600,6 +2276,8 @@ bool PatchbayGraph::disconnect(const uint connectionId)
                                      connectionToId.groupB, static_cast<int>(adjustedPortB)))
             return false;
 
+        rebuildParallelRenderer();
+
         kEngine->callback(ENGINE_CALLBACK_PATCHBAY_CONNECTION_REMOVED, connectionToId.id, 0, 0, 0.0f, nullptr);
 
         connections.list.remove(it);
@@ -1653,6 +2331,7 @@ void PatchbayGraph::refresh(const char* const deviceName)
 
     connections.clear();
     graph.removeIllegalConnections();
+    rebuildParallelRenderer();
 
     for (int i=0, count=graph.getNumNodes(); i<count; ++i)
     {
@@ -1817,6 +2496,16 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data, const float*
     CARLA_SAFE_ASSERT_RETURN(data->events.out != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(frames > 0,);
 
+    // use our own renderer, it passes engine events between nodes without juce midi buffers.
+    // the juce graph is only a fallback, while the renderer is rebuilding or if it failed to build
+    if (parallelRenderer != nullptr)
+    {
+        const CarlaMutexTryLocker cmtl(parallelMutex);
+
+        if (cmtl.wasLocked() && parallelRenderer != nullptr && parallelRenderer->process(workers, inBuf, outBuf, data->events.in, data->events.out, frames))
+            return;
+    }
+
     // put events in juce buffer
     {
         midiBuffer.clear();
@@ -1845,12 +2534,44 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data, const float*
 
     // put juce events in carla buffer
     {
-        carla_zeroStruct<EngineEvent>(data->events.out, kMaxEngineEventInternalCount);
+        clearEngineEvents(data->events.out);
         fillEngineEventsFromJuceMidiBuffer(data->events.out, midiBuffer);
         midiBuffer.clear();
     }
 }
 
+void PatchbayGraph::rebuildParallelRenderer()
+{
+    PatchbayParallelRenderer* renderer(new PatchbayParallelRenderer(inputs, outputs, kEngine->getOptions().sharedBridgeBuffers));
+
+    if (! renderer->build(graph, static_cast<int>(kEngine->getBufferSize())))
+    {
+        carla_stderr("PatchbayGraph::rebuildParallelRenderer() - failed, using the juce graph");
+        delete renderer;
+        renderer = nullptr;
+    }
+
+    {
+        const CarlaMutexLocker cml(parallelMutex);
+        std::swap(parallelRenderer, renderer);
+    }
+
+    delete renderer;
+}
+
+void PatchbayGraph::clearParallelRenderer() noexcept
+{
+    PatchbayParallelRenderer* renderer;
+
+    {
+        const CarlaMutexLocker cml(parallelMutex);
+        renderer = parallelRenderer;
+        parallelRenderer = nullptr;
+    }
+
+    delete renderer;
+}
+
 // -----------------------------------------------------------------------
 // InternalGraph
 
@@ -19,6 +19,7 @@
 #define CARLA_ENGINE_GRAPH_HPP_INCLUDED
 
 #include "CarlaEngine.hpp"
+#include "CarlaEngineWorkers.hpp"
 #include "CarlaMutex.hpp"
 #include "CarlaPatchbayUtils.hpp"
 #include "CarlaStringList.hpp"
@@ -96,6 +97,8 @@ struct ExternalGraph {
 // -----------------------------------------------------------------------
 // RackGraph
 
+class RackParallelLanes;
+
 struct RackGraph {
     ExternalGraph extGraph;
     const uint32_t inputs;
@@ -118,6 +121,14 @@ struct RackGraph {
         CARLA_DECLARE_NON_COPY_CLASS(Buffers)
     } audioBuffers;
 
+    // for merging events between plugins, when running in series
+    EngineEvent* mergeEvents;
+
+    // parallel lanes, only used if the engine has extra process threads
+    CarlaMutex lanesMutex;
+    RackParallelLanes* lanes;
+    CarlaEngineWorkerPool workers;
+
     RackGraph(CarlaEngine* const engine, const uint32_t inputs, const uint32_t outputs) noexcept;
     ~RackGraph() noexcept;
 
@@ -134,6 +145,12 @@ struct RackGraph {
     // the base, where plugins run
     void process(CarlaEngine::ProtectedData* const data, const float* inBufReal[2], float* outBuf[2], const uint32_t frames);
 
+    // runs the plugins of a single lane in series, or all plugins if lane is MAX_RACK_LANES
+    // returns true if a lane output still needs the dry input added, which happens once for all lanes
+    bool processLane(CarlaEngine::ProtectedData* const data, const uint lane,
+                     EngineEvent* const eventsIn, EngineEvent* const eventsOut, EngineEvent* const eventsTmp,
+                     const float* const inBufReal[2], float* outBuf[2], const uint32_t frames);
+
     // extended, will call process() in the middle
     void processHelper(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames);
 
@@ -144,6 +161,8 @@ struct RackGraph {
 // -----------------------------------------------------------------------
 // PatchbayGraph
 
+class PatchbayParallelRenderer;
+
 struct PatchbayGraph {
     PatchbayConnectionList connections;
     AudioProcessorGraph graph;
@@ -156,6 +175,11 @@ struct PatchbayGraph {
 
     ExternalGraph extGraph;
 
+    // own graph renderer, runs nodes on the engine process threads, or in series if there are none
+    CarlaMutex parallelMutex;
+    PatchbayParallelRenderer* parallelRenderer;
+    CarlaEngineWorkerPool workers;
+
     PatchbayGraph(CarlaEngine* const engine, const uint32_t inputs, const uint32_t outputs);
     ~PatchbayGraph();
 
@@ -178,6 +202,10 @@ struct PatchbayGraph {
 
     void process(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const int frames);
 
+    // needs to be called after any change to graph nodes or connections
+    void rebuildParallelRenderer();
+    void clearParallelRenderer() noexcept;
+
     CarlaEngine* const kEngine;
     CARLA_DECLARE_NON_COPY_CLASS(PatchbayGraph)
 };
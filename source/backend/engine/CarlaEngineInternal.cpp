@@ -124,12 +124,9 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine) noexcept
       graph(engine),
 #endif
       time(),
-      nextAction()
-{
-#ifdef BUILD_BRIDGE
-    carla_zeroStruct(plugins, 1);
-#endif
-}
+      nextAction(),
+      meterReaders(),
+      loader(engine) {}
 
 CarlaEngine::ProtectedData::~ProtectedData() noexcept
 {
@@ -185,6 +182,8 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
     case ENGINE_PROCESS_MODE_BRIDGE:
         events.in  = new EngineEvent[kMaxEngineEventInternalCount];
         events.out = new EngineEvent[kMaxEngineEventInternalCount];
+        carla_zeroStruct<EngineEvent>(events.in,  kMaxEngineEventInternalCount);
+        carla_zeroStruct<EngineEvent>(events.out, kMaxEngineEventInternalCount);
         break;
     default:
         break;
@@ -206,7 +205,6 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
 
 #ifndef BUILD_BRIDGE
     plugins = new EnginePluginData[maxPluginNumber];
-    carla_zeroStruct(plugins, maxPluginNumber);
 #endif
 
     nextAction.ready();
@@ -267,21 +265,15 @@ void CarlaEngine::ProtectedData::doPluginRemove() noexcept
 
         plugin->setId(i);
 
-        plugins[i].plugin      = plugin;
-        plugins[i].insPeak[0]  = 0.0f;
-        plugins[i].insPeak[1]  = 0.0f;
-        plugins[i].outsPeak[0] = 0.0f;
-        plugins[i].outsPeak[1] = 0.0f;
+        plugins[i].plugin = plugin;
+        plugins[i].clearStats();
     }
 
     const uint id(curPluginCount);
 
     // reset last plugin (now removed)
-    plugins[id].plugin      = nullptr;
-    plugins[id].insPeak[0]  = 0.0f;
-    plugins[id].insPeak[1]  = 0.0f;
-    plugins[id].outsPeak[0] = 0.0f;
-    plugins[id].outsPeak[1] = 0.0f;
+    plugins[id].plugin = nullptr;
+    plugins[id].clearStats();
 }
 
 void CarlaEngine::ProtectedData::doPluginsSwitch() noexcept
@@ -341,7 +333,10 @@ void CarlaEngine::ProtectedData::doNextPluginAction(const bool unlock) noexcept
 // PendingRtEventsRunner
 
 PendingRtEventsRunner::PendingRtEventsRunner(CarlaEngine* const engine) noexcept
-    : pData(engine->pData) {}
+    : pData(engine->pData)
+{
+    pData->meterReaders.cycle();
+}
 
 PendingRtEventsRunner::~PendingRtEventsRunner() noexcept
 {
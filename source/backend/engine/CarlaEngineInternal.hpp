@@ -18,6 +18,9 @@
 #ifndef CARLA_ENGINE_INTERNAL_HPP_INCLUDED
 #define CARLA_ENGINE_INTERNAL_HPP_INCLUDED
 
+#include "CarlaEngineDspLoad.hpp"
+#include "CarlaEngineLoader.hpp"
+#include "CarlaEngineMeters.hpp"
 #include "CarlaEngineOsc.hpp"
 #include "CarlaEngineThread.hpp"
 #include "CarlaEngineUtils.hpp"
@@ -148,8 +151,24 @@ struct EngineNextAction {
 
 struct EnginePluginData {
     CarlaPlugin* plugin;
-    float insPeak[2];
-    float outsPeak[2];
+    EngineMeterSet insMeter;
+    EngineMeterSet outsMeter;
+    EngineDspLoadStats dspLoad;
+
+    EnginePluginData() noexcept
+        : plugin(nullptr),
+          insMeter(),
+          outsMeter(),
+          dspLoad() {}
+
+    void clearStats() noexcept
+    {
+        insMeter.clear();
+        outsMeter.clear();
+        dspLoad.clear();
+    }
+
+    CARLA_DECLARE_NON_COPY_STRUCT(EnginePluginData)
 };
 
 // -----------------------------------------------------------------------
@@ -201,6 +220,8 @@ struct CarlaEngine::ProtectedData {
 #endif
     EngineInternalTime   time;
     EngineNextAction     nextAction;
+    EngineMeterReaders   meterReaders;
+    CarlaEngineLoader    loader;
 
     // -------------------------------------------------------------------
 
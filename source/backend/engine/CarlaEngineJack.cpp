@@ -1434,8 +1434,8 @@ protected:
             /**/  float* outBuf[2] = { audioOut1, audioOut2 };
 
             // initialize events
-            carla_zeroStruct<EngineEvent>(pData->events.in,  kMaxEngineEventInternalCount);
-            carla_zeroStruct<EngineEvent>(pData->events.out, kMaxEngineEventInternalCount);
+            clearEngineEvents(pData->events.in);
+            clearEngineEvents(pData->events.out);
 
             {
                 ushort engineEventIndex = 0;
@@ -1458,6 +1458,8 @@ protected:
                     if (engineEventIndex >= kMaxEngineEventInternalCount)
                         break;
                 }
+
+                terminateEngineEvents(pData->events.in, engineEventIndex);
             }
 
             if (pData->options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
@@ -2036,34 +2038,19 @@ private:
             cvOut[i] = port->getBuffer();
         }
 
-        float inPeaks[2] = { 0.0f };
-        float outPeaks[2] = { 0.0f };
-
-        for (uint32_t i=0; i < audioInCount && i < 2; ++i)
-        {
-            for (uint32_t j=0; j < nframes; ++j)
-            {
-                const float absV(std::abs(audioIn[i][j]));
-
-                if (absV > inPeaks[i])
-                    inPeaks[i] = absV;
-            }
-        }
+        EnginePluginData& pluginData(pData->plugins[plugin->getId()]);
+        const bool metering(pData->meterReaders.isActive());
 
-        plugin->process(audioIn, audioOut, cvIn, cvOut, nframes);
+        if (metering)
+            pluginData.insMeter.process(audioIn, audioInCount, nframes, pData->options.truePeakMeters);
 
-        for (uint32_t i=0; i < audioOutCount && i < 2; ++i)
         {
-            for (uint32_t j=0; j < nframes; ++j)
-            {
-                const float absV(std::abs(audioOut[i][j]));
-
-                if (absV > outPeaks[i])
-                    outPeaks[i] = absV;
-            }
+            const EngineDspLoadTimer dlt(pluginData.dspLoad, nframes, pData->sampleRate);
+            plugin->process(audioIn, audioOut, cvIn, cvOut, nframes);
         }
 
-        setPluginPeaks(plugin->getId(), inPeaks, outPeaks);
+        if (metering)
+            pluginData.outsMeter.process(audioOut, audioOutCount, nframes, pData->options.truePeakMeters);
     }
 
     // -------------------------------------------------------------------
@@ -430,8 +430,8 @@ protected:
             FloatVectorOperations::clear(outputChannelData[i], numSamples);
 
         // initialize events
-        carla_zeroStruct<EngineEvent>(pData->events.in,  kMaxEngineEventInternalCount);
-        carla_zeroStruct<EngineEvent>(pData->events.out, kMaxEngineEventInternalCount);
+        clearEngineEvents(pData->events.in);
+        clearEngineEvents(pData->events.out);
 
         if (fMidiInEvents.mutex.tryLock())
         {
@@ -461,6 +461,8 @@ protected:
                     break;
             }
 
+            terminateEngineEvents(pData->events.in, static_cast<ushort>(engineEventIndex));
+
             fMidiInEvents.data.clear();
             fMidiInEvents.mutex.unlock();
         }
@@ -0,0 +1,361 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineLoader.hpp"
+#include "CarlaEngine.hpp"
+#include "CarlaPlugin.hpp"
+
+#include <algorithm>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static const int kJobPending = 0;
+static const int kJobRunning = 1;
+static const int kJobDone    = 2;
+
+// -----------------------------------------------------------------------
+// EngineLoaderJob
+
+EngineLoaderJob::EngineLoaderJob() noexcept
+    : stateSave(),
+      btype(BINARY_NONE),
+      ptype(PLUGIN_NONE),
+      extra(nullptr),
+      id(0),
+      inMainThread(false),
+      plugin(nullptr),
+      error(),
+      name(),
+      state(kJobPending) {}
+
+EngineLoaderJob::~EngineLoaderJob() noexcept
+{
+    // plugins are owned by the engine once added
+    CARLA_SAFE_ASSERT(plugin == nullptr);
+}
+
+// -----------------------------------------------------------------------
+// CarlaEngineLoader::LoaderThread
+
+class CarlaEngineLoader::LoaderThread : public CarlaThread
+{
+public:
+    LoaderThread(CarlaEngineLoader* const loader) noexcept
+        : CarlaThread("CarlaEngineLoader"),
+          kLoader(loader),
+          fCurrentJob(nullptr) {}
+
+    EngineLoaderJob* getCurrentJob() const noexcept
+    {
+        return isCurrentThread() ? fCurrentJob : nullptr;
+    }
+
+protected:
+    void run() noexcept override
+    {
+        for (; ! shouldThreadExit();)
+        {
+            EngineLoaderJob* const job(kLoader->takeNextJob());
+
+            if (job == nullptr)
+                break;
+
+            fCurrentJob = job;
+
+            try {
+                kLoader->runJob(*job);
+            } CARLA_SAFE_EXCEPTION("CarlaEngineLoader job");
+
+            fCurrentJob = nullptr;
+
+            job->state.set(kJobDone);
+            carla_sem_post(kLoader->fSem);
+        }
+    }
+
+private:
+    CarlaEngineLoader* const kLoader;
+    EngineLoaderJob* volatile fCurrentJob;
+
+    CARLA_DECLARE_NON_COPY_CLASS(LoaderThread)
+};
+
+// -----------------------------------------------------------------------
+// CarlaEngineLoader
+
+CarlaEngineLoader::CarlaEngineLoader(CarlaEngine* const engine) noexcept
+    : kEngine(engine),
+      fThreadCount(0),
+      fSem(nullptr),
+      fMutex(),
+      fJobs(nullptr),
+      fJobCount(0),
+      fNextJob(0),
+      fNameMutex(),
+      fMainThread(),
+      fMainThreadJob(nullptr)
+{
+    carla_zeroPointers(fThreads, kMaxThreads);
+}
+
+CarlaEngineLoader::~CarlaEngineLoader() noexcept
+{
+    CARLA_SAFE_ASSERT(fJobs == nullptr);
+
+    for (uint i=0; i < kMaxThreads && fThreads[i] != nullptr; ++i)
+    {
+        fThreads[i]->stopThread(-1);
+        delete fThreads[i];
+        fThreads[i] = nullptr;
+    }
+
+    if (fSem != nullptr)
+    {
+        carla_sem_destroy(fSem);
+        fSem = nullptr;
+    }
+}
+
+void CarlaEngineLoader::start(EngineLoaderJob* const jobs, const uint jobCount, const uint numThreads)
+{
+    CARLA_SAFE_ASSERT_RETURN(fJobs == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(jobs != nullptr && jobCount > 0,);
+    carla_debug("CarlaEngineLoader::start(%p, %u, %u)", jobs, jobCount, numThreads);
+
+    fMainThread = pthread_self();
+
+    // no need for more threads than there are jobs to run in them
+    uint threadJobCount = 0;
+
+    for (uint i=0; i < jobCount; ++i)
+    {
+        if (! jobs[i].inMainThread && jobs[i].state.get() == kJobPending)
+            ++threadJobCount;
+    }
+
+    uint threadCount(std::min(numThreads, threadJobCount));
+
+    if (threadCount > kMaxThreads)
+        threadCount = kMaxThreads;
+
+    // hold back the threads until all of them are started, so they can recognize themselves
+    const CarlaMutexLocker cml(fMutex);
+
+    fJobs     = jobs;
+    fJobCount = jobCount;
+    fNextJob  = 0;
+
+    if (threadCount == 0)
+        return;
+
+    if (fSem == nullptr)
+    {
+        fSem = carla_sem_create();
+        CARLA_SAFE_ASSERT_RETURN(fSem != nullptr,);
+    }
+
+    // other threads may look at fThreads at any time, publish each one complete
+    for (uint i=0; i < threadCount; ++i)
+    {
+        if (fThreads[i] == nullptr)
+            __atomic_store_n(&fThreads[i], new LoaderThread(this), __ATOMIC_RELEASE);
+    }
+
+    for (uint i=0; i < threadCount; ++i)
+    {
+        if (! fThreads[i]->startThread())
+        {
+            carla_stderr("CarlaEngineLoader::start() - failed to start loader thread %u", i);
+            break;
+        }
+
+        ++fThreadCount;
+    }
+}
+
+void CarlaEngineLoader::stop() noexcept
+{
+    carla_debug("CarlaEngineLoader::stop()");
+
+    for (uint i=0; i < fThreadCount; ++i)
+        fThreads[i]->signalThreadShouldExit();
+
+    // threads might still be running a job, which references our data
+    for (uint i=0; i < fThreadCount; ++i)
+        fThreads[i]->stopThread(-1);
+
+    const CarlaMutexLocker cml(fMutex);
+
+    fThreadCount = 0;
+    fJobs        = nullptr;
+    fJobCount    = 0;
+    fNextJob     = 0;
+}
+
+void CarlaEngineLoader::finishJob(EngineLoaderJob& job)
+{
+    bool runHere = false;
+
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        if (job.state.get() == kJobPending)
+        {
+            job.state.set(kJobRunning);
+            runHere = true;
+        }
+    }
+
+    if (runHere)
+    {
+        __atomic_store_n(&fMainThreadJob, &job, __ATOMIC_RELEASE);
+        runJob(job);
+        __atomic_store_n(&fMainThreadJob, static_cast<EngineLoaderJob*>(nullptr), __ATOMIC_RELEASE);
+
+        job.state.set(kJobDone);
+        return;
+    }
+
+    // keep the host responsive, like when waiting for a bridge to start
+    const bool needsEngineIdle(kEngine->getType() != kEngineTypePlugin);
+
+    for (; job.state.get() != kJobDone;)
+    {
+        kEngine->callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
+
+        if (needsEngineIdle)
+            kEngine->idle();
+
+        carla_sem_timedwait_msecs(fSem, 20);
+    }
+}
+
+bool CarlaEngineLoader::isLoaderThread() const noexcept
+{
+    for (uint i=0; i < kMaxThreads; ++i)
+    {
+        const LoaderThread* const thread(__atomic_load_n(&fThreads[i], __ATOMIC_ACQUIRE));
+
+        if (thread == nullptr)
+            break;
+        if (thread->isCurrentThread())
+            return true;
+    }
+
+    return false;
+}
+
+EngineLoaderJob* CarlaEngineLoader::getCurrentJob() const noexcept
+{
+    // fMainThread is set before fMainThreadJob
+    if (EngineLoaderJob* const mainThreadJob = __atomic_load_n(&fMainThreadJob, __ATOMIC_ACQUIRE))
+    {
+        if (pthread_equal(fMainThread, pthread_self()))
+            return mainThreadJob;
+    }
+
+    for (uint i=0; i < kMaxThreads; ++i)
+    {
+        const LoaderThread* const thread(__atomic_load_n(&fThreads[i], __ATOMIC_ACQUIRE));
+
+        if (thread == nullptr)
+            break;
+        if (EngineLoaderJob* const job = thread->getCurrentJob())
+            return job;
+    }
+
+    return nullptr;
+}
+
+const CarlaMutex& CarlaEngineLoader::getNameMutex() const noexcept
+{
+    return fNameMutex;
+}
+
+bool CarlaEngineLoader::isNameReserved(const char* const name) const noexcept
+{
+    const EngineLoaderJob* const currentJob(getCurrentJob());
+
+    for (uint i=0; i < fJobCount; ++i)
+    {
+        const EngineLoaderJob& job(fJobs[i]);
+
+        if (&job != currentJob && job.name == name)
+            return true;
+    }
+
+    return false;
+}
+
+void CarlaEngineLoader::reserveName(const char* const name) noexcept
+{
+    if (EngineLoaderJob* const job = getCurrentJob())
+        job->name = name;
+}
+
+EngineLoaderJob* CarlaEngineLoader::takeNextJob() noexcept
+{
+    const CarlaMutexLocker cml(fMutex);
+
+    for (; fNextJob < fJobCount;)
+    {
+        EngineLoaderJob& job(fJobs[fNextJob++]);
+
+        if (job.inMainThread || job.state.get() != kJobPending)
+            continue;
+
+        job.state.set(kJobRunning);
+        return &job;
+    }
+
+    return nullptr;
+}
+
+void CarlaEngineLoader::runJob(EngineLoaderJob& job)
+{
+    const CarlaStateSave& stateSave(job.stateSave);
+
+    CarlaPlugin* const plugin(kEngine->createPlugin(job.id, job.btype, job.ptype, stateSave.binary, stateSave.name, stateSave.label,
+                                                    stateSave.uniqueId, job.extra, stateSave.options));
+
+    // error is already set, via CarlaEngine::setLastError()
+    if (plugin == nullptr)
+    {
+        // the name is free again for the jobs after this one
+        const CarlaMutexLocker cml(fNameMutex);
+        job.name.clear();
+        return;
+    }
+
+    plugin->setActive(true, true, false);
+
+#ifndef BUILD_BRIDGE
+    // deactivate bridge client-side ping check, since some plugins block during load
+    if ((plugin->getHints() & PLUGIN_IS_BRIDGE) != 0)
+        plugin->setCustomData(CUSTOM_DATA_TYPE_STRING, "__CarlaPingOnOff__", "false", false);
+#endif
+
+    plugin->loadStateSave(stateSave);
+
+    job.plugin = plugin;
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,119 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_LOADER_HPP_INCLUDED
+#define CARLA_ENGINE_LOADER_HPP_INCLUDED
+
+#include "CarlaBackend.h"
+#include "CarlaSemUtils.hpp"
+#include "CarlaStateUtils.hpp"
+#include "CarlaThread.hpp"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// A plugin from a project file, created and restored before it's added to the engine
+
+struct EngineLoaderJob {
+    CarlaStateSave stateSave;
+    BinaryType  btype;
+    PluginType  ptype;
+    const char* extra;
+    uint id;           // provisional, plugins before this one might still fail to load
+    bool inMainThread; // plugin type must be created in the main thread
+
+    // result, plugin is null on failure
+    CarlaPlugin* plugin;
+    CarlaString  error;
+
+    // unique name the plugin picked during init, other jobs must not take it
+    CarlaString name;
+
+    juce::Atomic<int> state;
+
+    EngineLoaderJob() noexcept;
+    ~EngineLoaderJob() noexcept;
+
+    CARLA_DECLARE_NON_COPY_STRUCT(EngineLoaderJob)
+};
+
+// -----------------------------------------------------------------------
+// Threads that run project loading jobs ahead of the main thread.
+// The main thread adds the resulting plugins to the engine in order, as each job finishes.
+
+class CarlaEngineLoader
+{
+public:
+    CarlaEngineLoader(CarlaEngine* const engine) noexcept;
+    ~CarlaEngineLoader() noexcept;
+
+    // main thread, starts up to @a numThreads threads for the jobs that can run outside of it
+    void start(EngineLoaderJob* const jobs, const uint jobCount, const uint numThreads);
+
+    // main thread, call after all jobs are finished
+    void stop() noexcept;
+
+    // main thread, makes sure @a job is done, running it here if no thread picked it up
+    void finishJob(EngineLoaderJob& job);
+
+    // true if the caller is one of the loader threads
+    bool isLoaderThread() const noexcept;
+
+    // job the caller is running, if any
+    EngineLoaderJob* getCurrentJob() const noexcept;
+
+    // held while picking a unique plugin name, and while adding plugins to the engine
+    const CarlaMutex& getNameMutex() const noexcept;
+
+    // true if a job other than the caller's picked @a name, requires the name mutex
+    bool isNameReserved(const char* const name) const noexcept;
+
+    // the caller's job picked @a name, requires the name mutex
+    void reserveName(const char* const name) noexcept;
+
+private:
+    class LoaderThread;
+
+    static const uint kMaxThreads = 64;
+
+    CarlaEngine* const kEngine;
+
+    LoaderThread* fThreads[kMaxThreads]; // created on demand, kept until destruction, accessed atomically
+    uint          fThreadCount;          // started in the current load
+    sem_t*        fSem;                  // posted when a thread finishes a job
+
+    CarlaMutex       fMutex; // protects fNextJob and job state changes
+    EngineLoaderJob* fJobs;
+    uint             fJobCount;
+    uint             fNextJob;
+
+    CarlaMutex       fNameMutex; // protects job names
+
+    pthread_t        fMainThread;
+    EngineLoaderJob* fMainThreadJob; // accessed atomically
+
+    EngineLoaderJob* takeNextJob() noexcept;
+    void runJob(EngineLoaderJob& job);
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaEngineLoader)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_LOADER_HPP_INCLUDED
@@ -0,0 +1,281 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineMeters.hpp"
+#include "CarlaMathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE2_MATH__
+# include <xmmintrin.h>
+#endif
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// 4x oversampling polyphase filter from ITU-R BS.1770-3, annex 2.
+// Stored by tap, so each row gives the 4 interpolated phases for one input sample.
+
+static const uint kTruePeakTaps = kEngineMeterHistorySize + 1;
+
+#ifdef __SSE2_MATH__
+__attribute__((aligned(16)))
+#endif
+static const float kTruePeakCoeffs[kTruePeakTaps][4] = {
+    {  0.0017089843750f, -0.0291748046875f, -0.0189208984375f, -0.0083007812500f },
+    {  0.0109863281250f,  0.0292968750000f,  0.0330810546875f,  0.0148925781250f },
+    { -0.0196533203125f, -0.0517578125000f, -0.0582275390625f, -0.0266113281250f },
+    {  0.0332031250000f,  0.0891113281250f,  0.1015625000000f,  0.0476074218750f },
+    { -0.0594482421875f, -0.1665039062500f, -0.2003173828125f, -0.1022949218750f },
+    {  0.1373291015625f,  0.4650878906250f,  0.7797851562500f,  0.9721679687500f },
+    {  0.9721679687500f,  0.7797851562500f,  0.4650878906250f,  0.1373291015625f },
+    { -0.1022949218750f, -0.2003173828125f, -0.1665039062500f, -0.0594482421875f },
+    {  0.0476074218750f,  0.1015625000000f,  0.0891113281250f,  0.0332031250000f },
+    { -0.0266113281250f, -0.0582275390625f, -0.0517578125000f, -0.0196533203125f },
+    {  0.0148925781250f,  0.0330810546875f,  0.0292968750000f,  0.0109863281250f },
+    { -0.0083007812500f, -0.0189208984375f, -0.0291748046875f,  0.0017089843750f }
+};
+
+// -----------------------------------------------------------------------
+// carla_engine_meter_process
+
+#ifdef __SSE2_MATH__
+static inline
+__m128 _carla_sse_abs(const __m128 v) noexcept
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+// all 4 phases at once, @a x points to the current sample and must have kEngineMeterHistorySize samples before it
+static inline
+__m128 _carla_true_peak_phases(const float* const x) noexcept
+{
+    __m128 acc(_mm_mul_ps(_mm_load_ps(kTruePeakCoeffs[0]), _mm_set1_ps(x[0])));
+
+    for (uint k=1; k < kTruePeakTaps; ++k)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(kTruePeakCoeffs[k]), _mm_set1_ps(x[-static_cast<int>(k)])));
+
+    return _carla_sse_abs(acc);
+}
+
+static inline
+float _carla_sse_hmax(const __m128 v) noexcept
+{
+    __m128 tmp(_mm_max_ps(v, _mm_movehl_ps(v, v)));
+    tmp = _mm_max_ss(tmp, _mm_shuffle_ps(tmp, tmp, 1));
+    return _mm_cvtss_f32(tmp);
+}
+
+static inline
+float _carla_sse_hsum(const __m128 v) noexcept
+{
+    __m128 tmp(_mm_add_ps(v, _mm_movehl_ps(v, v)));
+    tmp = _mm_add_ss(tmp, _mm_shuffle_ps(tmp, tmp, 1));
+    return _mm_cvtss_f32(tmp);
+}
+#else
+static inline
+float _carla_true_peak_phases(const float* const x) noexcept
+{
+    float peak = 0.0f;
+
+    for (uint p=0; p < 4; ++p)
+    {
+        float acc = 0.0f;
+
+        for (uint k=0; k < kTruePeakTaps; ++k)
+            acc += kTruePeakCoeffs[k][p] * x[-static_cast<int>(k)];
+
+        peak = std::max(peak, std::abs(acc));
+    }
+
+    return peak;
+}
+#endif
+
+void carla_engine_meter_process(const float* const buffer, const uint32_t frames, float history[kEngineMeterHistorySize],
+                                const bool truePeak, EngineMeterValue& value) noexcept
+{
+    value.peak = value.rms = value.truePeak = 0.0f;
+
+    if (frames == 0)
+        return;
+
+    // first samples need the previous block, they get a contiguous copy
+    const uint32_t headFrames(frames < kEngineMeterHistorySize ? frames : kEngineMeterHistorySize);
+    float head[kEngineMeterHistorySize*2];
+
+    if (truePeak)
+    {
+        carla_copyFloat(head, history, kEngineMeterHistorySize);
+        carla_copyFloat(head + kEngineMeterHistorySize, buffer, headFrames);
+    }
+
+    uint32_t i = 0;
+
+#ifdef __SSE2_MATH__
+    __m128 peak(_mm_setzero_ps());
+    __m128 sum(_mm_setzero_ps());
+    __m128 tpeak(_mm_setzero_ps());
+
+    for (; i+4 <= frames; i += 4)
+    {
+        const __m128 x(_mm_loadu_ps(buffer + i));
+
+        peak = _mm_max_ps(peak, _carla_sse_abs(x));
+        sum  = _mm_add_ps(sum, _mm_mul_ps(x, x));
+
+        if (! truePeak)
+            continue;
+
+        for (uint32_t j=i; j < i+4; ++j)
+        {
+            if (j < headFrames)
+                tpeak = _mm_max_ps(tpeak, _carla_true_peak_phases(head + kEngineMeterHistorySize + j));
+            else
+                tpeak = _mm_max_ps(tpeak, _carla_true_peak_phases(buffer + j));
+        }
+    }
+
+    value.peak     = _carla_sse_hmax(peak);
+    value.rms      = _carla_sse_hsum(sum);
+    value.truePeak = _carla_sse_hmax(tpeak);
+#endif
+
+    for (; i < frames; ++i)
+    {
+        const float x(buffer[i]);
+
+        value.peak = std::max(value.peak, std::abs(x));
+        value.rms += x*x;
+
+        if (! truePeak)
+            continue;
+
+#ifdef __SSE2_MATH__
+        const __m128 phases(_carla_true_peak_phases(i < headFrames ? head + kEngineMeterHistorySize + i : buffer + i));
+        value.truePeak = std::max(value.truePeak, _carla_sse_hmax(phases));
+#else
+        value.truePeak = std::max(value.truePeak, _carla_true_peak_phases(i < headFrames ? head + kEngineMeterHistorySize + i : buffer + i));
+#endif
+    }
+
+    value.rms = std::sqrt(value.rms / static_cast<float>(frames));
+
+    if (! truePeak)
+        return;
+
+    // keep the last samples for the next block
+    if (frames >= kEngineMeterHistorySize)
+        carla_copyFloat(history, buffer + (frames - kEngineMeterHistorySize), kEngineMeterHistorySize);
+    else
+        carla_copyFloat(history, head + frames, kEngineMeterHistorySize);
+}
+
+// -----------------------------------------------------------------------
+// EngineMeterSet
+
+EngineMeterSet::EngineMeterSet() noexcept
+    : fSequence(0),
+      fChannels(0)
+{
+    carla_zeroStruct<EngineMeterValue>(fValues, kMaxEngineMeterChannels);
+    carla_zeroFloat(fHistory[0], kMaxEngineMeterChannels*kEngineMeterHistorySize);
+}
+
+void EngineMeterSet::process(const float* const* const buffers, const uint channels, const uint32_t frames, const bool truePeak) noexcept
+{
+    const uint count(channels < kMaxEngineMeterChannels ? channels : kMaxEngineMeterChannels);
+
+    // compute first, so the values are only locked while copying
+    EngineMeterValue values[kMaxEngineMeterChannels];
+
+    for (uint i=0; i < count; ++i)
+        carla_engine_meter_process(buffers[i], frames, fHistory[i], truePeak, values[i]);
+
+    ++fSequence;
+    fChannels = count;
+
+    if (count > 0)
+        carla_copyStruct<EngineMeterValue>(fValues, values, count);
+
+    ++fSequence;
+}
+
+void EngineMeterSet::clear() noexcept
+{
+    ++fSequence;
+    fChannels = 0;
+    carla_zeroStruct<EngineMeterValue>(fValues, kMaxEngineMeterChannels);
+    ++fSequence;
+
+    carla_zeroFloat(fHistory[0], kMaxEngineMeterChannels*kEngineMeterHistorySize);
+}
+
+EngineMeterValue EngineMeterSet::get(const uint channel) const noexcept
+{
+    EngineMeterValue value;
+    carla_zeroStruct(value);
+
+    CARLA_SAFE_ASSERT_RETURN(channel < kMaxEngineMeterChannels, value);
+
+    // the writer only holds the sequence for a few copies, give up after a few tries.
+    // a read that overlapped a write is never returned, the meter shows silence instead
+    for (int i=0; i < 16; ++i)
+    {
+        const int seq(fSequence.get());
+
+        if (seq % 2 != 0)
+            continue;
+
+        if (channel < fChannels)
+            value = fValues[channel];
+        else
+            carla_zeroStruct(value);
+
+        if (fSequence.get() == seq)
+            return value;
+    }
+
+    carla_zeroStruct(value);
+    return value;
+}
+
+// -----------------------------------------------------------------------
+// EngineMeterReaders
+
+// meters keep running for this long after the last read
+static const uint32_t kEngineMeterReadTimeout = 2000;
+
+EngineMeterReaders::EngineMeterReaders() noexcept
+    : fLastRead(0),
+      fActive(false) {}
+
+void EngineMeterReaders::touch() noexcept
+{
+    fLastRead.set(juce::Time::getMillisecondCounter());
+}
+
+void EngineMeterReaders::cycle() noexcept
+{
+    fActive = (juce::Time::getMillisecondCounter() - fLastRead.get() < kEngineMeterReadTimeout);
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,104 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_METERS_HPP_INCLUDED
+#define CARLA_ENGINE_METERS_HPP_INCLUDED
+
+#include "CarlaEngine.hpp"
+
+#include "juce_core.h"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// Maximum number of channels metered per plugin side, extra channels are ignored
+
+const uint kMaxEngineMeterChannels = 16;
+
+// Number of past samples needed by the true-peak interpolation filter
+const uint kEngineMeterHistorySize = 11;
+
+// -----------------------------------------------------------------------
+// Computes peak, RMS and optional true-peak values in a single pass.
+// @a history holds the last kEngineMeterHistorySize samples of the previous block, and is updated.
+
+void carla_engine_meter_process(const float* const buffer, const uint32_t frames, float history[kEngineMeterHistorySize],
+                                const bool truePeak, EngineMeterValue& value) noexcept;
+
+// -----------------------------------------------------------------------
+// Meter values of one side (inputs or outputs) of a plugin.
+// Written by the audio thread, can be read from any thread without locking.
+
+class EngineMeterSet
+{
+public:
+    EngineMeterSet() noexcept;
+
+    // RT, single writer
+    void process(const float* const* const buffers, const uint channels, const uint32_t frames, const bool truePeak) noexcept;
+
+    // resets values and filter history, must not run at the same time as process()
+    void clear() noexcept;
+
+    // any thread
+    EngineMeterValue get(const uint channel) const noexcept;
+
+private:
+    // odd while the audio thread is writing
+    juce::Atomic<int> fSequence;
+
+    uint fChannels;
+    EngineMeterValue fValues[kMaxEngineMeterChannels];
+
+    // only touched by the audio thread
+    float fHistory[kMaxEngineMeterChannels][kEngineMeterHistorySize];
+
+    CARLA_DECLARE_NON_COPY_CLASS(EngineMeterSet)
+};
+
+// -----------------------------------------------------------------------
+// Keeps track of meter reads, so the audio thread can skip metering when nobody looks at them.
+
+class EngineMeterReaders
+{
+public:
+    EngineMeterReaders() noexcept;
+
+    // any thread, called by meter readers
+    void touch() noexcept;
+
+    // RT, called once per engine cycle
+    void cycle() noexcept;
+
+    // RT, valid for the current cycle
+    bool isActive() const noexcept
+    {
+        return fActive;
+    }
+
+private:
+    juce::Atomic<uint32_t> fLastRead;
+    bool fActive;
+
+    CARLA_DECLARE_NON_COPY_CLASS(EngineMeterReaders)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_METERS_HPP_INCLUDED
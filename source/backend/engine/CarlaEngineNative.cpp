@@ -384,6 +384,17 @@ protected:
             if (CarlaPlugin* const plugin = fEngine->getPlugin(pluginId))
                 plugin->setCtrlChannel(int8_t(channel), true, false);
         }
+        else if (std::strcmp(msg, "set_rack_lane") == 0)
+        {
+            uint32_t pluginId, lane;
+
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(pluginId), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(lane), true);
+            CARLA_SAFE_ASSERT_RETURN(lane < MAX_RACK_LANES, true);
+
+            if (CarlaPlugin* const plugin = fEngine->getPlugin(pluginId))
+                plugin->setRackLane(lane);
+        }
         else if (std::strcmp(msg, "set_parameter_value") == 0)
         {
             uint32_t pluginId, parameterId;
@@ -394,7 +405,7 @@ protected:
             CARLA_SAFE_ASSERT_RETURN(readNextLineAsFloat(value), true);
 
             if (CarlaPlugin* const plugin = fEngine->getPlugin(pluginId))
-                plugin->setParameterValue(parameterId, value, true, true, false);
+                plugin->queueParameterValue(parameterId, value, true, true, false);
         }
         else if (std::strcmp(msg, "set_parameter_midi_channel") == 0)
         {
@@ -1359,8 +1370,8 @@ protected:
         // ---------------------------------------------------------------
         // initialize events
 
-        carla_zeroStruct<EngineEvent>(pData->events.in,  kMaxEngineEventInternalCount);
-        carla_zeroStruct<EngineEvent>(pData->events.out, kMaxEngineEventInternalCount);
+        clearEngineEvents(pData->events.in);
+        clearEngineEvents(pData->events.out);
 
         // ---------------------------------------------------------------
         // events input (before processing)
@@ -1379,6 +1390,8 @@ protected:
                 if (engineEventIndex >= kMaxEngineEventInternalCount)
                     break;
             }
+
+            terminateEngineEvents(pData->events.in, static_cast<ushort>(engineEventIndex));
         }
 
         if (kIsPatchbay)
@@ -1405,7 +1418,7 @@ protected:
         // ---------------------------------------------------------------
         // events output (after processing)
 
-        carla_zeroStruct<EngineEvent>(pData->events.in, kMaxEngineEventInternalCount);
+        clearEngineEvents(pData->events.in);
 
         {
             NativeMidiEvent midiEvent;
@@ -1571,13 +1584,12 @@ protected:
             // send peaks and param outputs for all plugins
             for (uint i=0; i < pData->curPluginCount; ++i)
             {
-                const EnginePluginData& plugData(pData->plugins[i]);
                 const CarlaPlugin* const plugin(pData->plugins[i].plugin);
 
                 std::sprintf(fTmpBuf, "PEAKS_%i\n", i);
                 fUiServer.writeMessage(fTmpBuf);
 
-                std::sprintf(fTmpBuf, "%f:%f:%f:%f\n", plugData.insPeak[0], plugData.insPeak[1], plugData.outsPeak[0], plugData.outsPeak[1]);
+                std::sprintf(fTmpBuf, "%f:%f:%f:%f\n", getInputPeak(i, true), getInputPeak(i, false), getOutputPeak(i, true), getOutputPeak(i, false));
                 fUiServer.writeMessage(fTmpBuf);
                 fUiServer.flushMessages();
 
@@ -459,7 +459,7 @@ int CarlaEngineOsc::handleMsgSetParameterValue(CARLA_ENGINE_OSC_HANDLE_ARGS)
 
     CARLA_SAFE_ASSERT_RETURN(index >= 0, 0);
 
-    plugin->setParameterValue(static_cast<uint32_t>(index), value, true, false, true);
+    plugin->queueParameterValue(static_cast<uint32_t>(index), value, true, false, true);
     return 0;
 }
 
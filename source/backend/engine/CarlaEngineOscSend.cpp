@@ -379,13 +379,27 @@ void CarlaEngine::oscSend_control_set_peaks(const uint pluginId) const noexcept
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount,);
 
-    // TODO - try and see if we can get peaks[4] ref
-    const EnginePluginData& epData(pData->plugins[pluginId]);
-
     char targetPath[std::strlen(pData->oscData->path)+11];
     std::strcpy(targetPath, pData->oscData->path);
     std::strcat(targetPath, "/set_peaks");
-    try_lo_send(pData->oscData->target, targetPath, "iffff", static_cast<int32_t>(pluginId), epData.insPeak[0], epData.insPeak[1], epData.outsPeak[0], epData.outsPeak[1]);
+    try_lo_send(pData->oscData->target, targetPath, "iffff", static_cast<int32_t>(pluginId),
+                getInputPeak(pluginId, true), getInputPeak(pluginId, false), getOutputPeak(pluginId, true), getOutputPeak(pluginId, false));
+}
+
+void CarlaEngine::oscSend_control_set_dsp_load(const uint pluginId) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
+    CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount,);
+
+    const EngineDspLoad load(getPluginDspLoad(pluginId));
+
+    char targetPath[std::strlen(pData->oscData->path)+14];
+    std::strcpy(targetPath, pData->oscData->path);
+    std::strcat(targetPath, "/set_dsp_load");
+    try_lo_send(pData->oscData->target, targetPath, "iffffi", static_cast<int32_t>(pluginId),
+                load.lastUsecs, load.averageUsecs, load.p99Usecs, load.periodPercent, static_cast<int32_t>(load.overruns));
 }
 
 void CarlaEngine::oscSend_control_exit() const noexcept
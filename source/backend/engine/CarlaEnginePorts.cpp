@@ -86,12 +86,16 @@ void CarlaEngineCVPort::initBuffer() noexcept
 CarlaEngineEventPort::CarlaEngineEventPort(const CarlaEngineClient& client, const bool isInputPort, const uint32_t indexOffset) noexcept
     : CarlaEnginePort(client, isInputPort, indexOffset),
       fBuffer(nullptr),
+      fWriteIndex(0),
       kProcessMode(client.getEngine().getProccessMode())
 {
     carla_debug("CarlaEngineEventPort::CarlaEngineEventPort(%s)", bool2str(isInputPort));
 
     if (kProcessMode == ENGINE_PROCESS_MODE_PATCHBAY)
+    {
         fBuffer = new EngineEvent[kMaxEngineEventInternalCount];
+        carla_zeroStruct<EngineEvent>(fBuffer, kMaxEngineEventInternalCount);
+    }
 }
 
 CarlaEngineEventPort::~CarlaEngineEventPort() noexcept
@@ -112,16 +116,15 @@ void CarlaEngineEventPort::initBuffer() noexcept
     if (kProcessMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK || kProcessMode == ENGINE_PROCESS_MODE_BRIDGE)
         fBuffer = kClient.getEngine().getInternalEventBuffer(kIsInput);
     else if (kProcessMode == ENGINE_PROCESS_MODE_PATCHBAY && ! kIsInput)
-        carla_zeroStruct<EngineEvent>(fBuffer, kMaxEngineEventInternalCount);
+        clearEngineEvents(fBuffer);
+
+    fWriteIndex = 0;
 }
 
-uint32_t CarlaEngineEventPort::getEventCount() const noexcept
+ushort CarlaEngineEventPort::_getWriteIndex() noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(kIsInput, 0);
-    CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, 0);
-    CARLA_SAFE_ASSERT_RETURN(kProcessMode != ENGINE_PROCESS_MODE_SINGLE_CLIENT && kProcessMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS, 0);
-
-    uint32_t i=0;
+    // the buffer might be shared with other ports (in rack mode), skip over their events
+    ushort i(fWriteIndex);
 
     for (; i < kMaxEngineEventInternalCount; ++i)
     {
@@ -132,6 +135,15 @@ uint32_t CarlaEngineEventPort::getEventCount() const noexcept
     return i;
 }
 
+uint32_t CarlaEngineEventPort::getEventCount() const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(kIsInput, 0);
+    CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(kProcessMode != ENGINE_PROCESS_MODE_SINGLE_CLIENT && kProcessMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS, 0);
+
+    return getEngineEventCount(fBuffer);
+}
+
 const EngineEvent& CarlaEngineEventPort::getEvent(const uint32_t index) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(kIsInput, kFallbackEngineEvent);
@@ -165,12 +177,13 @@ bool CarlaEngineEventPort::writeControlEvent(const uint32_t time, const uint8_t
         CARLA_SAFE_ASSERT(! MIDI_IS_CONTROL_BANK_SELECT(param));
     }
 
-    for (uint32_t i=0; i < kMaxEngineEventInternalCount; ++i)
+    const ushort i(_getWriteIndex());
+
+    if (i < kMaxEngineEventInternalCount)
     {
         EngineEvent& event(fBuffer[i]);
-
-        if (event.type != kEngineEventTypeNull)
-            continue;
+        terminateEngineEvents(fBuffer, static_cast<ushort>(i+1));
+        fWriteIndex = static_cast<ushort>(i+1);
 
         event.type    = kEngineEventTypeControl;
         event.time    = time;
@@ -207,12 +220,13 @@ bool CarlaEngineEventPort::writeMidiEvent(const uint32_t time, const uint8_t cha
     CARLA_SAFE_ASSERT_RETURN(size > 0 && size <= EngineMidiEvent::kDataSize, false);
     CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
 
-    for (uint32_t i=0; i < kMaxEngineEventInternalCount; ++i)
+    const ushort i(_getWriteIndex());
+
+    if (i < kMaxEngineEventInternalCount)
     {
         EngineEvent& event(fBuffer[i]);
-
-        if (event.type != kEngineEventTypeNull)
-            continue;
+        terminateEngineEvents(fBuffer, static_cast<ushort>(i+1));
+        fWriteIndex = static_cast<ushort>(i+1);
 
         event.time    = time;
         event.channel = channel;
@@ -262,6 +276,7 @@ bool CarlaEngineEventPort::writeMidiEvent(const uint32_t time, const uint8_t cha
 
         event.type      = kEngineEventTypeMidi;
         event.midi.size = size;
+        event.midi.dataExt = nullptr;
 
         if (kIndexOffset < 0xFF /* uint8_t max */)
         {
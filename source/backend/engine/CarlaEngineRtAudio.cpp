@@ -17,11 +17,13 @@
 
 #include "CarlaEngineGraph.hpp"
 #include "CarlaEngineInternal.hpp"
+#include "CarlaEngineRtClock.hpp"
 #include "CarlaBackendUtils.hpp"
 #include "CarlaMathUtils.hpp"
+#include "CarlaRingBuffer.hpp"
 #include "CarlaStringList.hpp"
 
-#include "RtLinkedList.hpp"
+#include "LinkedList.hpp"
 
 #include "jackbridge/JackBridge.hpp"
 #include "juce_audio_basics.h"
@@ -32,6 +34,7 @@
 using juce::jmax;
 using juce::AudioSampleBuffer;
 using juce::FloatVectorOperations;
+using juce::Time;
 
 CARLA_BACKEND_START_NAMESPACE
 
@@ -152,6 +155,14 @@ static RtMidi::Api getMatchedAudioMidiAPI(const RtAudio::Api rtApi) noexcept
     return RtMidi::UNSPECIFIED;
 }
 
+// -------------------------------------------------------------------------------------------------------------------
+// System clock used for correlation, see RtClockCorrelation
+
+static double carla_rtaudio_get_system_time() noexcept
+{
+    return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks());
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 // RtAudio Engine
 
@@ -164,12 +175,15 @@ public:
           fAudioInterleaved(false),
           fAudioInCount(0),
           fAudioOutCount(0),
-          fLastEventTime(0),
           fDeviceName(),
           fAudioIntBufIn(),
           fAudioIntBufOut(),
+          fStreamClock(),
           fMidiIns(),
-          fMidiInEvents(),
+          fMidiInMutex(),
+          fMidiInLateEvents(0),
+          fMidiInJitterSequence(0),
+          fMidiInJitter(),
           fMidiOuts(),
           fMidiOutMutex(),
           fMidiOutVector(3),
@@ -179,13 +193,14 @@ public:
 
         // just to make sure
         pData->options.transportMode = ENGINE_TRANSPORT_MODE_INTERNAL;
+
+        carla_zeroStruct(fMidiInJitter);
     }
 
     ~CarlaEngineRtAudio() override
     {
         CARLA_SAFE_ASSERT(fAudioInCount == 0);
         CARLA_SAFE_ASSERT(fAudioOutCount == 0);
-        CARLA_SAFE_ASSERT(fLastEventTime == 0);
         carla_debug("CarlaEngineRtAudio::~CarlaEngineRtAudio()");
     }
 
@@ -195,7 +210,6 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(fAudioInCount == 0, false);
         CARLA_SAFE_ASSERT_RETURN(fAudioOutCount == 0, false);
-        CARLA_SAFE_ASSERT_RETURN(fLastEventTime == 0, false);
         CARLA_SAFE_ASSERT_RETURN(clientName != nullptr && clientName[0] != '\0', false);
         carla_debug("CarlaEngineRtAudio::init(\"%s\")", clientName);
 
@@ -288,7 +302,14 @@ public:
 
         fAudioInCount  = iParams.nChannels;
         fAudioOutCount = oParams.nChannels;
-        fLastEventTime = 0;
+
+        fStreamClock.reset();
+        fMidiInLateEvents.set(0);
+
+        // the stream is not running yet
+        ++fMidiInJitterSequence;
+        carla_zeroStruct(fMidiInJitter);
+        ++fMidiInJitterSequence;
 
         fAudioIntBufIn.setSize(static_cast<int>(fAudioInCount), static_cast<int>(bufferFrames));
         fAudioIntBufOut.setSize(static_cast<int>(fAudioOutCount), static_cast<int>(bufferFrames));
@@ -339,20 +360,18 @@ public:
 
         pData->graph.destroy();
 
-        for (LinkedList<MidiInPort>::Itenerator it = fMidiIns.begin(); it.valid(); it.next())
-        {
-            static MidiInPort fallback = { nullptr, { '\0' } };
+        fMidiInMutex.lock();
 
-            MidiInPort& inPort(it.getValue(fallback));
-            CARLA_SAFE_ASSERT_CONTINUE(inPort.port != nullptr);
+        for (LinkedList<MidiInPort*>::Itenerator it = fMidiIns.begin(); it.valid(); it.next())
+        {
+            MidiInPort* const inPort(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(inPort != nullptr);
 
-            inPort.port->cancelCallback();
-            inPort.port->closePort();
-            delete inPort.port;
+            delete inPort;
         }
 
         fMidiIns.clear();
-        fMidiInEvents.clear();
+        fMidiInMutex.unlock();
 
         fMidiOutMutex.lock();
 
@@ -372,7 +391,6 @@ public:
 
         fAudioInCount  = 0;
         fAudioOutCount = 0;
-        fLastEventTime = 0;
         fDeviceName.clear();
 
         // close stream
@@ -402,6 +420,32 @@ public:
         return CarlaBackend::getRtAudioApiName(fAudio.getCurrentApi());
     }
 
+    EngineMidiInputJitter getMidiInputJitter() const noexcept override
+    {
+        EngineMidiInputJitter jitter;
+        carla_zeroStruct(jitter);
+
+        // never locks the port list, the audio thread only tries to.
+        // it holds the sequence for a single copy, give up after a few tries and report nothing
+        for (int i=0; i < 16; ++i)
+        {
+            const int seq(fMidiInJitterSequence.get());
+
+            if (seq % 2 != 0)
+                continue;
+
+            jitter = fMidiInJitter;
+
+            if (fMidiInJitterSequence.get() == seq)
+                break;
+
+            carla_zeroStruct(jitter);
+        }
+
+        jitter.lateEvents = fMidiInLateEvents.get();
+        return jitter;
+    }
+
     // -------------------------------------------------------------------
     // Patchbay
 
@@ -480,14 +524,14 @@ public:
         // ---------------------------------------------------------------
         // add midi connections
 
-        for (LinkedList<MidiInPort>::Itenerator it=fMidiIns.begin(); it.valid(); it.next())
-        {
-            static const MidiInPort fallback = { nullptr, { '\0' } };
+        fMidiInMutex.lock();
 
-            const MidiInPort& inPort(it.getValue(fallback));
-            CARLA_SAFE_ASSERT_CONTINUE(inPort.port != nullptr);
+        for (LinkedList<MidiInPort*>::Itenerator it=fMidiIns.begin(); it.valid(); it.next())
+        {
+            const MidiInPort* const inPort(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(inPort != nullptr);
 
-            const uint portId(extGraph.midiPorts.getPortId(true, inPort.name));
+            const uint portId(extGraph.midiPorts.getPortId(true, inPort->name));
             CARLA_SAFE_ASSERT_CONTINUE(portId < extGraph.midiPorts.ins.count());
 
             ConnectionToId connectionToId;
@@ -501,6 +545,8 @@ public:
                 callback(ENGINE_CALLBACK_PATCHBAY_CONNECTION_ADDED, connectionToId.id, 0, 0, 0.0f, strBuf);
         }
 
+        fMidiInMutex.unlock();
+
         fMidiOutMutex.lock();
 
         for (LinkedList<MidiOutPort>::Itenerator it=fMidiOuts.begin(); it.valid(); it.next())
@@ -601,50 +647,86 @@ protected:
         }
 
         // initialize events
-        carla_zeroStruct<EngineEvent>(pData->events.in,  kMaxEngineEventInternalCount);
-        carla_zeroStruct<EngineEvent>(pData->events.out, kMaxEngineEventInternalCount);
+        clearEngineEvents(pData->events.in);
+        clearEngineEvents(pData->events.out);
+
+        // when this block would have started if the callback was never late, in system time
+        const double blockSecs(static_cast<double>(nframes) / pData->sampleRate);
+        const double blockStart(fStreamClock.process(streamTime, carla_rtaudio_get_system_time()));
 
-        if (fMidiInEvents.mutex.tryLock())
+        // the port list only changes when connecting or disconnecting, events stay queued until then
+        if (fMidiInMutex.tryLock())
         {
-            uint32_t engineEventIndex = 0;
-            fMidiInEvents.splice();
+            ushort engineEventCount = 0;
 
-            for (LinkedList<RtMidiEvent>::Itenerator it = fMidiInEvents.data.begin(); it.valid(); it.next())
+            for (LinkedList<MidiInPort*>::Itenerator it = fMidiIns.begin(); it.valid(); it.next())
             {
-                static const RtMidiEvent fallback = { 0, 0, { 0 } };
+                MidiInPort* const inPort(it.getValue(nullptr));
+                CARLA_SAFE_ASSERT_CONTINUE(inPort != nullptr);
 
-                const RtMidiEvent& midiEvent(it.getValue(fallback));
-                CARLA_SAFE_ASSERT_CONTINUE(midiEvent.size > 0);
+                RtMidiEvent& midiEvent(inPort->nextEvent);
 
-                EngineEvent& engineEvent(pData->events.in[engineEventIndex++]);
-
-                if (midiEvent.time < pData->timeInfo.frame)
-                {
-                    engineEvent.time = 0;
-                }
-                else if (midiEvent.time >= pData->timeInfo.frame + nframes)
+                for (; inPort->hasNextEvent || inPort->events.isDataAvailableForReading(); inPort->hasNextEvent = false)
                 {
-                    carla_stderr("MIDI Event in the future!, %i vs %i", engineEvent.time, pData->timeInfo.frame);
-                    engineEvent.time = static_cast<uint32_t>(pData->timeInfo.frame) + nframes - 1;
-                }
-                else
-                    engineEvent.time = static_cast<uint32_t>(midiEvent.time - pData->timeInfo.frame);
+                    if (! inPort->hasNextEvent)
+                        inPort->events.readCustomType(midiEvent);
 
-                engineEvent.fillFromMidiData(midiEvent.size, midiEvent.data, 0);
+                    CARLA_SAFE_ASSERT_CONTINUE(midiEvent.size > 0 && midiEvent.size <= EngineMidiEvent::kDataSize);
 
-                if (engineEventIndex >= kMaxEngineEventInternalCount)
-                    break;
+                    if (engineEventCount >= kMaxEngineEventInternalCount)
+                        continue;
+
+                    // events are played one block late, at the offset they had inside the previous block
+                    const double frame((midiEvent.time - (blockStart - blockSecs)) * pData->sampleRate);
+
+                    uint32_t time;
+
+                    if (frame < 0.0)
+                    {
+                        // too late for its exact place
+                        time = 0;
+                        fMidiInLateEvents.set(fMidiInLateEvents.get() + 1);
+                    }
+                    else if (frame == 0.0)
+                        time = 0;
+                    else if (frame < static_cast<double>(nframes))
+                        time = static_cast<uint32_t>(frame);
+                    else if (frame < pData->sampleRate)
+                    {
+                        // belongs to a later block, keep it and the newer events of this port until then
+                        inPort->hasNextEvent = true;
+                        break;
+                    }
+                    else
+                    {
+                        // a whole second ahead, only possible if the clocks jumped
+                        time = nframes - 1;
+                    }
+
+                    // keep events sorted, ports are read one after the other
+                    ushort i = engineEventCount++;
+
+                    for (; i > 0 && pData->events.in[i-1].time > time; --i)
+                        pData->events.in[i] = pData->events.in[i-1];
+
+                    EngineEvent& engineEvent(pData->events.in[i]);
+                    engineEvent.time = time;
+                    engineEvent.fillFromMidiData(midiEvent.size, midiEvent.data, 0);
+                }
             }
 
-            fMidiInEvents.data.clear();
-            fMidiInEvents.mutex.unlock();
+            publishMidiInputJitter();
+
+            terminateEngineEvents(pData->events.in, engineEventCount);
+            fMidiInMutex.unlock();
         }
 
         pData->graph.process(pData, inBuf, outBuf, nframes);
 
-        fMidiOutMutex.lock();
+        // same as above, output events are only lost while connecting or disconnecting
+        const bool midiOutLocked(fMidiOutMutex.tryLock());
 
-        if (fMidiOuts.count() > 0)
+        if (midiOutLocked && fMidiOuts.count() > 0)
         {
             uint8_t        size    = 0;
             uint8_t        data[3] = { 0, 0, 0 };
@@ -703,43 +785,39 @@ protected:
                     outsPtr[i*fAudioOutCount+j] = outBuf[j][i];
         }
 
-        fMidiOutMutex.unlock();
+        if (midiOutLocked)
+            fMidiOutMutex.unlock();
 
         return; // unused
-        (void)streamTime; (void)status;
+        (void)status;
     }
 
-    void handleMidiCallback(double timeStamp, std::vector<uchar>* const message)
+    // RT, must have fMidiInMutex
+    void publishMidiInputJitter() noexcept
     {
-        const size_t messageSize(message->size());
-
-        if (messageSize == 0 || messageSize > EngineMidiEvent::kDataSize)
-            return;
+        EngineMidiInputJitter jitter;
+        carla_zeroStruct(jitter);
 
-        timeStamp /= 2;
-
-        if (timeStamp > 0.95)
-            timeStamp = 0.95;
-        else if (timeStamp < 0.0)
-            timeStamp = 0.0;
-
-        RtMidiEvent midiEvent;
-        midiEvent.time = pData->timeInfo.frame + uint64_t(timeStamp * (double)pData->bufferSize);
+        for (LinkedList<MidiInPort*>::Itenerator it = fMidiIns.begin(); it.valid(); it.next())
+        {
+            const MidiInPort* const inPort(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(inPort != nullptr);
 
-        if (midiEvent.time < fLastEventTime)
-            midiEvent.time = fLastEventTime;
-        else
-            fLastEventTime = midiEvent.time;
+            const uint32_t eventCount(inPort->eventCount.get());
 
-        midiEvent.size = static_cast<uint8_t>(messageSize);
+            if (eventCount == 0)
+                continue;
 
-        size_t i=0;
-        for (; i < messageSize; ++i)
-            midiEvent.data[i] = message->at(i);
-        for (; i < EngineMidiEvent::kDataSize; ++i)
-            midiEvent.data[i] = 0;
+            // weighted by event count, so quiet ports do not hide busy ones
+            jitter.averageUsecs = (jitter.averageUsecs * static_cast<float>(jitter.events) + inPort->jitterAverage.get() * static_cast<float>(eventCount))
+                                  / static_cast<float>(jitter.events + eventCount);
+            jitter.maxUsecs = jmax(jitter.maxUsecs, inPort->jitterMax.get());
+            jitter.events  += eventCount;
+        }
 
-        fMidiInEvents.append(midiEvent);
+        ++fMidiInJitterSequence;
+        fMidiInJitter = jitter;
+        ++fMidiInJitterSequence;
     }
 
     // -------------------------------------------------------------------
@@ -765,7 +843,6 @@ protected:
 
             RtMidiIn* const rtMidiIn(new RtMidiIn(getMatchedAudioMidiAPI(fAudio.getCurrentApi()), newRtMidiPortName.buffer(), 512));
             rtMidiIn->ignoreTypes();
-            rtMidiIn->setCallback(carla_rtmidi_callback, this);
 
             bool found = false;
             uint rtMidiPortIndex;
@@ -794,11 +871,12 @@ protected:
                 return false;
             };
 
-            MidiInPort midiPort;
-            midiPort.port = rtMidiIn;
+            MidiInPort* const midiPort(new MidiInPort(rtMidiIn, portName));
 
-            std::strncpy(midiPort.name, portName, STR_MAX);
-            midiPort.name[STR_MAX] = '\0';
+            // only called from the RtMidi thread from now on
+            rtMidiIn->setCallback(carla_rtmidi_callback, midiPort);
+
+            const CarlaMutexLocker cml(fMidiInMutex);
 
             fMidiIns.append(midiPort);
             return true;
@@ -868,25 +946,23 @@ protected:
         case kExternalGraphConnectionAudioOut2:
             return CarlaEngine::disconnectExternalGraphPort(connectionType, portId, portName);
 
-        case kExternalGraphConnectionMidiInput:
-            for (LinkedList<MidiInPort>::Itenerator it=fMidiIns.begin(); it.valid(); it.next())
-            {
-                static MidiInPort fallback = { nullptr, { '\0' } };
+        case kExternalGraphConnectionMidiInput: {
+            const CarlaMutexLocker cml(fMidiInMutex);
 
-                MidiInPort& inPort(it.getValue(fallback));
-                CARLA_SAFE_ASSERT_CONTINUE(inPort.port != nullptr);
+            for (LinkedList<MidiInPort*>::Itenerator it=fMidiIns.begin(); it.valid(); it.next())
+            {
+                MidiInPort* const inPort(it.getValue(nullptr));
+                CARLA_SAFE_ASSERT_CONTINUE(inPort != nullptr);
 
-                if (std::strncmp(inPort.name, portName, STR_MAX) != 0)
+                if (std::strncmp(inPort->name, portName, STR_MAX) != 0)
                     continue;
 
-                inPort.port->cancelCallback();
-                inPort.port->closePort();
-                delete inPort.port;
+                delete inPort;
 
                 fMidiIns.remove(it);
                 return true;
             }
-            break;
+        }   break;
 
         case kExternalGraphConnectionMidiOutput: {
             const CarlaMutexLocker cml(fMidiOutMutex);
@@ -922,7 +998,6 @@ private:
     bool fAudioInterleaved;
     uint fAudioInCount;
     uint fAudioOutCount;
-    uint64_t fLastEventTime;
 
     // current device name
     CarlaString fDeviceName;
@@ -931,63 +1006,113 @@ private:
     AudioSampleBuffer fAudioIntBufIn;
     AudioSampleBuffer fAudioIntBufOut;
 
-    struct MidiInPort {
-        RtMidiIn* port;
-        char name[STR_MAX+1];
-    };
-
-    struct MidiOutPort {
-        RtMidiOut* port;
-        char name[STR_MAX+1];
-    };
-
     struct RtMidiEvent {
-        uint64_t time; // needs to compare to internal time
-        uint8_t  size;
-        uint8_t  data[EngineMidiEvent::kDataSize];
+        double  time; // in system time, corrected from the RtMidi timestamps
+        uint8_t size;
+        uint8_t data[EngineMidiEvent::kDataSize];
     };
 
-    struct RtMidiEvents {
-        CarlaMutex mutex;
-        RtLinkedList<RtMidiEvent>::Pool dataPool;
-        RtLinkedList<RtMidiEvent> data;
-        RtLinkedList<RtMidiEvent> dataPending;
-
-        RtMidiEvents()
-            : mutex(),
-              dataPool(512, 512),
-              data(dataPool),
-              dataPending(dataPool) {}
+    // each port has its own queue, written by its RtMidi thread and read by the audio thread
+    struct MidiInPort {
+        RtMidiIn* port;
+        CarlaHeapRingBuffer events;
+        char name[STR_MAX+1];
 
-        ~RtMidiEvents()
+        // only touched by the RtMidi thread
+        RtClockCorrelation clock;
+        double portTime;
+
+        // only touched by the audio thread, the first event of a later block
+        RtMidiEvent nextEvent;
+        bool hasNextEvent;
+
+        // delivery delay of each event, removed by the timestamp correction
+        juce::Atomic<float>    jitterAverage;
+        juce::Atomic<float>    jitterMax;
+        juce::Atomic<uint32_t> eventCount;
+
+        MidiInPort(RtMidiIn* const p, const char* const n) noexcept
+            : port(p),
+              events(),
+              clock(),
+              portTime(0.0),
+              nextEvent(),
+              hasNextEvent(false),
+              jitterAverage(0.0f),
+              jitterMax(0.0f),
+              eventCount(0)
         {
-            clear();
-        }
+            events.createBuffer(512 * sizeof(RtMidiEvent));
 
-        void append(const RtMidiEvent& event)
-        {
-            mutex.lock();
-            dataPending.append(event);
-            mutex.unlock();
+            std::strncpy(name, n, STR_MAX);
+            name[STR_MAX] = '\0';
         }
 
-        void clear()
+        ~MidiInPort()
         {
-            mutex.lock();
-            data.clear();
-            dataPending.clear();
-            mutex.unlock();
+            port->cancelCallback();
+            port->closePort();
+            delete port;
         }
 
-        void splice()
+        // deltaTime is the time since the previous message of this port, taken by the MIDI driver
+        void handleMessage(const double deltaTime, const std::vector<uchar>* const message) noexcept
         {
-            if (dataPending.count() > 0)
-                dataPending.moveTo(data, true /* append */);
+            const double systemTime(carla_rtaudio_get_system_time());
+
+            portTime += deltaTime;
+
+            // always keep the clock going, even for messages we skip
+            const double eventTime(clock.process(portTime, systemTime));
+
+            const std::size_t messageSize(message->size());
+
+            if (messageSize == 0 || messageSize > EngineMidiEvent::kDataSize)
+                return;
+
+            const float jitter(static_cast<float>((systemTime - eventTime) * 1000000.0));
+
+            jitterAverage.set(jitterAverage.get() + (jitter - jitterAverage.get()) * 0.05f);
+
+            if (jitter > jitterMax.get())
+                jitterMax.set(jitter);
+
+            ++eventCount;
+
+            RtMidiEvent midiEvent;
+            midiEvent.time = eventTime;
+            midiEvent.size = static_cast<uint8_t>(messageSize);
+
+            std::size_t i=0;
+            for (; i < messageSize; ++i)
+                midiEvent.data[i] = (*message)[i];
+            for (; i < EngineMidiEvent::kDataSize; ++i)
+                midiEvent.data[i] = 0;
+
+            // if the audio thread stops reading, newer events are dropped
+            events.writeCustomType(midiEvent);
+            events.commitWrite();
         }
+
+        CARLA_DECLARE_NON_COPY_STRUCT(MidiInPort)
+    };
+
+    struct MidiOutPort {
+        RtMidiOut* port;
+        char name[STR_MAX+1];
     };
 
-    LinkedList<MidiInPort> fMidiIns;
-    RtMidiEvents           fMidiInEvents;
+    // audio thread only
+    RtClockCorrelation fStreamClock;
+
+    LinkedList<MidiInPort*> fMidiIns;
+    CarlaMutex              fMidiInMutex;
+    juce::Atomic<uint32_t>  fMidiInLateEvents;
+
+    // stats of all input ports, written by the audio thread while it has the port list.
+    // the sequence is odd while writing
+    juce::Atomic<int>     fMidiInJitterSequence;
+    EngineMidiInputJitter fMidiInJitter;
 
     LinkedList<MidiOutPort> fMidiOuts;
     CarlaMutex              fMidiOutMutex;
@@ -1003,7 +1128,7 @@ private:
 
     static void carla_rtmidi_callback(double timeStamp, std::vector<uchar>* message, void* userData)
     {
-        handlePtr->handleMidiCallback(timeStamp, message);
+        ((MidiInPort*)userData)->handleMessage(timeStamp, message);
     }
 
     #undef handlePtr
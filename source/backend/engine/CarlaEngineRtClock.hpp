@@ -0,0 +1,68 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_RT_CLOCK_HPP_INCLUDED
+#define CARLA_ENGINE_RT_CLOCK_HPP_INCLUDED
+
+#include "CarlaEngine.hpp"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// Correlates a device clock (MIDI event or audio stream time) with the system clock.
+// Each sample is "system time when received - device time", which is the clock offset plus however late we got it.
+// The smallest sample is the closest to the real offset, so we follow new minimums right away and
+// everything else very slowly, enough to track drift between the two clocks.
+
+struct RtClockCorrelation {
+    double offset;
+    bool valid;
+
+    RtClockCorrelation() noexcept
+        : offset(0.0),
+          valid(false) {}
+
+    void reset() noexcept
+    {
+        valid = false;
+    }
+
+    // returns the device time converted to system time
+    double process(const double deviceTime, const double systemTime) noexcept
+    {
+        const double sample(systemTime - deviceTime);
+
+        // first value, or the device clock jumped (port reopened, xrun, etc)
+        if (! valid || sample < offset || sample > offset + 1.0)
+        {
+            offset = sample;
+            valid  = true;
+        }
+        else
+        {
+            offset += (sample - offset) * 0.001;
+        }
+
+        return deviceTime + offset;
+    }
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_RT_CLOCK_HPP_INCLUDED
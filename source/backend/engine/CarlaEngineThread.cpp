@@ -19,22 +19,115 @@
 #include "CarlaEngineThread.hpp"
 #include "CarlaPlugin.hpp"
 
+#include "CarlaMathUtils.hpp"
+
+#include "juce_core.h"
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -----------------------------------------------------------------------
 
+// how long to sleep when nothing needs polling and nobody wakes us, in milliseconds
+static const uint kIdleTimeout = 100;
+
+#ifndef BUILD_BRIDGE
+// how often plugin DSP load is reported, in milliseconds
+static const uint32_t kDspLoadInterval = 1000;
+#endif
+
+// last sent values of a plugin's output parameters
+struct ParameterOutputCache {
+    CarlaPlugin* plugin;
+    uint32_t count;
+    float* values;
+
+    ParameterOutputCache() noexcept
+        : plugin(nullptr),
+          count(0),
+          values(nullptr) {}
+
+    ~ParameterOutputCache() noexcept
+    {
+        clear();
+    }
+
+    void clear() noexcept
+    {
+        if (values != nullptr)
+        {
+            delete[] values;
+            values = nullptr;
+        }
+
+        plugin = nullptr;
+        count  = 0;
+    }
+
+    // returns true if the cache is new and everything must be sent
+    bool update(CarlaPlugin* const newPlugin, const uint32_t newCount) noexcept
+    {
+        if (plugin == newPlugin && count == newCount)
+            return false;
+
+        clear();
+
+        if (newCount > 0)
+        {
+            try {
+                values = new float[newCount];
+            } CARLA_SAFE_EXCEPTION_RETURN("ParameterOutputCache::update", true);
+        }
+
+        plugin = newPlugin;
+        count  = newCount;
+        return true;
+    }
+
+    CARLA_DECLARE_NON_COPY_STRUCT(ParameterOutputCache)
+};
+
+// -----------------------------------------------------------------------
+
 CarlaEngineThread::CarlaEngineThread(CarlaEngine* const engine) noexcept
     : CarlaThread("CarlaEngineThread"),
       kEngine(engine),
+      fSem(carla_sem_create()),
+      fWakeUpPending(false),
       leakDetector_CarlaEngineThread()
 {
     CARLA_SAFE_ASSERT(engine != nullptr);
+    CARLA_SAFE_ASSERT(fSem != nullptr);
     carla_debug("CarlaEngineThread::CarlaEngineThread(%p)", engine);
 }
 
 CarlaEngineThread::~CarlaEngineThread() noexcept
 {
     carla_debug("CarlaEngineThread::~CarlaEngineThread()");
+
+    if (fSem != nullptr)
+    {
+        carla_sem_destroy(fSem);
+        fSem = nullptr;
+    }
+}
+
+void CarlaEngineThread::wake() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fSem != nullptr,);
+
+    if (! __atomic_exchange_n(&fWakeUpPending, true, __ATOMIC_SEQ_CST))
+        carla_sem_post(fSem);
+}
+
+bool CarlaEngineThread::stopThread(const int timeOutMilliseconds) noexcept
+{
+    signalThreadShouldExit();
+
+    // always post, a pending wake-up might have been taken by the rate limit already
+    if (fSem != nullptr)
+        carla_sem_post(fSem);
+
+    return CarlaThread::stopThread(timeOutMilliseconds);
 }
 
 // -----------------------------------------------------------------------
@@ -50,27 +143,53 @@ void CarlaEngineThread::run() noexcept
 #ifdef HAVE_LIBLO
     const bool isPlugin(kEngine->getType() == kEngineTypePlugin);
 #endif
+    const uint maxPlugins(kEngine->getMaxPluginNumber());
+    ParameterOutputCache* outputCaches(nullptr);
     float value;
 
+    try {
+        outputCaches = new ParameterOutputCache[maxPlugins];
+    } CARLA_SAFE_EXCEPTION_RETURN("CarlaEngineThread::run() - output caches",);
+
+#ifndef BUILD_BRIDGE
+    uint32_t lastDspLoadTime = juce::Time::getMillisecondCounter();
+#endif
+
 #ifdef BUILD_BRIDGE
     for (; /*kEngine->isRunning() &&*/ ! shouldThreadExit();)
 #else
     for (; kEngine->isRunning() && ! shouldThreadExit();)
 #endif
     {
+        const uint32_t passStart(juce::Time::getMillisecondCounter());
+
+        // wake-ups from now on are handled on the next pass
+        __atomic_store_n(&fWakeUpPending, false, __ATOMIC_SEQ_CST);
+
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
         const bool oscRegisted = kEngine->isOscControlRegistered();
 #else
         const bool oscRegisted = false;
 #endif
+        bool needsPolling = oscRegisted;
 
 #ifdef HAVE_LIBLO
         if (isPlugin)
             kEngine->idleOsc();
 #endif
 
+#ifndef BUILD_BRIDGE
+        const uint32_t now(juce::Time::getMillisecondCounter());
+        const bool sendDspLoad(now - lastDspLoadTime >= kDspLoadInterval);
+
+        if (sendDspLoad)
+            lastDspLoadTime = now;
+#endif
+
         for (uint i=0, count = kEngine->getCurrentPluginCount(); i < count; ++i)
         {
+            CARLA_SAFE_ASSERT_BREAK(i < maxPlugins);
+
             CarlaPlugin* const plugin(kEngine->getPluginUnchecked(i));
 
             CARLA_SAFE_ASSERT_CONTINUE(plugin != nullptr && plugin->isEnabled());
@@ -79,6 +198,9 @@ void CarlaEngineThread::run() noexcept
             const uint hints(plugin->getHints());
             const bool updateUI((hints & PLUGIN_HAS_CUSTOM_UI) != 0 && (hints & PLUGIN_NEEDS_UI_MAIN_THREAD) == 0);
 
+            if (updateUI)
+                needsPolling = true;
+
             // -----------------------------------------------------------
             // DSP Idle
 
@@ -92,15 +214,27 @@ void CarlaEngineThread::run() noexcept
             if (oscRegisted || updateUI)
             {
                 // -------------------------------------------------------
-                // Update parameter outputs
+                // Update parameter outputs, only the ones that changed
+
+                const uint32_t pcount(plugin->getParameterCount());
+                ParameterOutputCache& cache(outputCaches[i]);
+                const bool sendAll(cache.update(plugin, pcount));
 
-                for (uint32_t j=0, pcount=plugin->getParameterCount(); j < pcount; ++j)
+                for (uint32_t j=0; j < pcount; ++j)
                 {
                     if (! plugin->isParameterOutput(j))
                         continue;
 
                     value = plugin->getParameterValue(j);
 
+                    if (cache.values != nullptr)
+                    {
+                        if (! sendAll && carla_compareFloats(cache.values[j], value))
+                            continue;
+
+                        cache.values[j] = value;
+                    }
+
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
                     // Update OSC engine client
                     if (oscRegisted)
@@ -126,10 +260,42 @@ void CarlaEngineThread::run() noexcept
             if (oscRegisted)
                 kEngine->oscSend_control_set_peaks(i);
 #endif
+
+#ifndef BUILD_BRIDGE
+            // -----------------------------------------------------------
+            // DSP load
+
+            if (sendDspLoad)
+            {
+                const EngineDspLoad load(kEngine->getPluginDspLoad(i));
+
+                kEngine->callback(ENGINE_CALLBACK_PLUGIN_DSP_LOAD, i, static_cast<int>(load.p99Usecs), static_cast<int>(load.overruns), load.periodPercent, nullptr);
+# ifdef HAVE_LIBLO
+                if (oscRegisted)
+                    kEngine->oscSend_control_set_dsp_load(i);
+# endif
+            }
+#endif
         }
 
-        carla_msleep(25);
+        // -----------------------------------------------------------------
+        // Wait for more work
+
+        if (shouldThreadExit())
+            break;
+
+        // without OSC or UIs to update only post-RT events, bridge messages and DSP load reports need us
+        carla_sem_timedwait_msecs(fSem, needsPolling ? 0 : kIdleTimeout);
+
+        // never run more often than the configured rate.
+        // wake-ups meanwhile are handled on the next pass, only stopThread() ends this early
+        const uint32_t period(1000 / (kEngine->getOptions().maxIdleRate > 0 ? kEngine->getOptions().maxIdleRate : 1));
+
+        for (uint32_t elapsed; ! shouldThreadExit() && (elapsed = juce::Time::getMillisecondCounter() - passStart) < period;)
+            carla_sem_timedwait_msecs(fSem, period - elapsed);
     }
+
+    delete[] outputCaches;
 }
 
 // -----------------------------------------------------------------------
@@ -19,6 +19,7 @@
 #define CARLA_ENGINE_THREAD_HPP_INCLUDED
 
 #include "CarlaBackend.h"
+#include "CarlaSemUtils.hpp"
 #include "CarlaThread.hpp"
 
 CARLA_BACKEND_START_NAMESPACE
@@ -32,12 +33,21 @@ public:
     CarlaEngineThread(CarlaEngine* const engine) noexcept;
     ~CarlaEngineThread() noexcept override;
 
+    // RT-safe, only the first call after the thread wakes up posts the semaphore
+    void wake() noexcept;
+
+    // same as CarlaThread::stopThread(), but wakes the thread up so it exits right away, even at low rates
+    bool stopThread(const int timeOutMilliseconds) noexcept;
+
 protected:
     void run() noexcept override;
 
 private:
     CarlaEngine* const kEngine;
 
+    sem_t* fSem;
+    bool fWakeUpPending;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineThread)
 };
 
@@ -0,0 +1,443 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineWorkers.hpp"
+
+#include <algorithm>
+
+#ifndef CARLA_OS_WIN
+# include <sched.h>
+#endif
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static inline
+void carla_spin_pause() noexcept
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// -----------------------------------------------------------------------
+// EngineWorkerSchedule
+
+EngineWorkerSchedule::EngineWorkerSchedule() noexcept
+    : fTaskCount(0),
+      fDepCounts(nullptr),
+      fDependents(nullptr),
+      fFirstDependent(nullptr),
+      fLinks(),
+      fPending(nullptr),
+      fReadySlots(nullptr),
+      fReadyWrite(0),
+      fReadyRead(0),
+      fDoneCount(0) {}
+
+EngineWorkerSchedule::~EngineWorkerSchedule() noexcept
+{
+    clear();
+}
+
+void EngineWorkerSchedule::clear() noexcept
+{
+    if (fDepCounts != nullptr)
+    {
+        delete[] fDepCounts;
+        fDepCounts = nullptr;
+    }
+
+    if (fDependents != nullptr)
+    {
+        delete[] fDependents;
+        fDependents = nullptr;
+    }
+
+    if (fFirstDependent != nullptr)
+    {
+        delete[] fFirstDependent;
+        fFirstDependent = nullptr;
+    }
+
+    if (fPending != nullptr)
+    {
+        delete[] fPending;
+        fPending = nullptr;
+    }
+
+    if (fReadySlots != nullptr)
+    {
+        delete[] fReadySlots;
+        fReadySlots = nullptr;
+    }
+
+    fTaskCount = 0;
+}
+
+bool EngineWorkerSchedule::init(const uint taskCount) noexcept
+{
+    clear();
+    fLinks.clearQuick();
+
+    CARLA_SAFE_ASSERT_RETURN(taskCount > 0, false);
+
+    try {
+        fDepCounts      = new uint[taskCount];
+        fFirstDependent = new uint[taskCount+1];
+        fPending        = new juce::Atomic<int>[taskCount];
+        fReadySlots     = new juce::Atomic<int>[taskCount];
+    }
+    catch(...) {
+        clear();
+        return false;
+    }
+
+    fTaskCount = taskCount;
+
+    carla_zeroStruct<uint>(fDepCounts, taskCount);
+    carla_zeroStruct<uint>(fFirstDependent, taskCount+1);
+    return true;
+}
+
+void EngineWorkerSchedule::addDependency(const uint taskId, const uint dependsOnTaskId)
+{
+    CARLA_SAFE_ASSERT_RETURN(taskId < fTaskCount,);
+    CARLA_SAFE_ASSERT_RETURN(dependsOnTaskId < fTaskCount,);
+    CARLA_SAFE_ASSERT_RETURN(taskId != dependsOnTaskId,);
+
+    // sorting by the high bits groups links by the task that must run first
+    fLinks.add((static_cast<uint64_t>(dependsOnTaskId) << 32) | taskId);
+}
+
+bool EngineWorkerSchedule::finalize()
+{
+    CARLA_SAFE_ASSERT_RETURN(fTaskCount > 0, false);
+
+    // sort and remove duplicate links
+    uint64_t* const links(fLinks.getRawDataPointer());
+    std::sort(links, links + fLinks.size());
+    const uint linkCount(static_cast<uint>(std::unique(links, links + fLinks.size()) - links));
+
+    if (linkCount > 0)
+    {
+        try {
+            fDependents = new uint[linkCount];
+        } CARLA_SAFE_EXCEPTION_RETURN("EngineWorkerSchedule::finalize", false);
+    }
+
+    for (uint i=0; i < linkCount; ++i)
+    {
+        const uint before(static_cast<uint>(links[i] >> 32));
+        const uint after(static_cast<uint>(links[i] & 0xffffffff));
+
+        fDependents[i] = after;
+        ++fDepCounts[after];
+        ++fFirstDependent[before+1];
+    }
+
+    for (uint i=0; i < fTaskCount; ++i)
+        fFirstDependent[i+1] += fFirstDependent[i];
+
+    fLinks.clear();
+
+    // make sure all tasks can run, by doing a full dry run
+    uint remaining[fTaskCount];
+    uint queue[fTaskCount];
+    uint queueSize = 0;
+
+    for (uint i=0; i < fTaskCount; ++i)
+    {
+        remaining[i] = fDepCounts[i];
+
+        if (remaining[i] == 0)
+            queue[queueSize++] = i;
+    }
+
+    for (uint i=0; i < queueSize; ++i)
+    {
+        const uint taskId(queue[i]);
+
+        for (uint j=fFirstDependent[taskId]; j < fFirstDependent[taskId+1]; ++j)
+        {
+            if (--remaining[fDependents[j]] == 0)
+                queue[queueSize++] = fDependents[j];
+        }
+    }
+
+    if (queueSize != fTaskCount)
+    {
+        carla_stderr("EngineWorkerSchedule::finalize() - tasks have circular dependencies");
+        return false;
+    }
+
+    return true;
+}
+
+void EngineWorkerSchedule::reset() noexcept
+{
+    fReadyWrite.set(0);
+    fReadyRead.set(0);
+    fDoneCount.set(0);
+
+    for (uint i=0; i < fTaskCount; ++i)
+    {
+        fPending[i].set(static_cast<int>(fDepCounts[i]));
+        fReadySlots[i].set(0);
+    }
+
+    for (uint i=0; i < fTaskCount; ++i)
+    {
+        if (fDepCounts[i] == 0)
+            pushReady(i);
+    }
+}
+
+void EngineWorkerSchedule::pushReady(const uint taskId) noexcept
+{
+    // each task is pushed exactly once per run, so this never overflows
+    const int slot((fReadyWrite += 1) - 1);
+    fReadySlots[slot].set(static_cast<int>(taskId)+1);
+}
+
+int EngineWorkerSchedule::popReady() noexcept
+{
+    for (;;)
+    {
+        const int slot(fReadyRead.get());
+
+        if (slot >= fReadyWrite.get())
+            return -1;
+
+        if (! fReadyRead.compareAndSetBool(slot+1, slot))
+            continue;
+
+        // slot was reserved by the writer but not published yet
+        int value;
+        while ((value = fReadySlots[slot].get()) == 0)
+            carla_spin_pause();
+
+        return value-1;
+    }
+}
+
+bool EngineWorkerSchedule::isDone() const noexcept
+{
+    return (fDoneCount.get() >= static_cast<int>(fTaskCount));
+}
+
+void EngineWorkerSchedule::taskFinished(const uint taskId) noexcept
+{
+    for (uint i=fFirstDependent[taskId]; i < fFirstDependent[taskId+1]; ++i)
+    {
+        const uint dependent(fDependents[i]);
+
+        if (--fPending[dependent] == 0)
+            pushReady(dependent);
+    }
+
+    ++fDoneCount;
+}
+
+// -----------------------------------------------------------------------
+// CarlaEngineWorkerPool::WorkerThread
+
+class CarlaEngineWorkerPool::WorkerThread : public CarlaThread
+{
+public:
+    WorkerThread(CarlaEngineWorkerPool* const pool)
+        : CarlaThread("CarlaEngineWorker"),
+          kPool(pool) {}
+
+protected:
+    void run() noexcept override
+    {
+#ifndef CARLA_OS_WIN
+        // same range as the realtime threads created by JACK
+        sched_param param;
+        carla_zeroStruct(param);
+        param.sched_priority = (sched_get_priority_min(SCHED_FIFO) + sched_get_priority_max(SCHED_FIFO)*3)/4;
+
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+            carla_stdout("CarlaEngineWorkerPool: could not set realtime priority for worker thread");
+#endif
+
+        for (; ! shouldThreadExit();)
+        {
+            if (carla_sem_timedwait(kPool->fSem, 1))
+                kPool->workerWakeUp();
+        }
+    }
+
+private:
+    CarlaEngineWorkerPool* const kPool;
+
+    CARLA_DECLARE_NON_COPY_CLASS(WorkerThread)
+};
+
+// -----------------------------------------------------------------------
+// CarlaEngineWorkerPool
+
+CarlaEngineWorkerPool::CarlaEngineWorkerPool() noexcept
+    : fThreads(nullptr),
+      fThreadCount(0),
+      fSem(nullptr),
+      fJob(nullptr),
+      fSchedule(nullptr),
+      fRunning(0),
+      fActiveWorkers(0) {}
+
+CarlaEngineWorkerPool::~CarlaEngineWorkerPool() noexcept
+{
+    stop();
+}
+
+bool CarlaEngineWorkerPool::start(const uint numThreads)
+{
+    CARLA_SAFE_ASSERT_RETURN(fThreads == nullptr, false);
+    carla_debug("CarlaEngineWorkerPool::start(%u)", numThreads);
+
+    if (numThreads == 0)
+        return true;
+
+    fSem = carla_sem_create();
+    CARLA_SAFE_ASSERT_RETURN(fSem != nullptr, false);
+
+    fThreads = new WorkerThread*[numThreads];
+
+    for (uint i=0; i < numThreads; ++i)
+    {
+        WorkerThread* const thread(new WorkerThread(this));
+
+        if (! thread->startThread())
+        {
+            carla_stderr("CarlaEngineWorkerPool::start(%u) - failed to start worker thread %u", numThreads, i);
+            delete thread;
+            break;
+        }
+
+        fThreads[fThreadCount++] = thread;
+    }
+
+    return (fThreadCount == numThreads);
+}
+
+void CarlaEngineWorkerPool::stop() noexcept
+{
+    if (fThreads == nullptr)
+        return;
+
+    carla_debug("CarlaEngineWorkerPool::stop()");
+
+    for (uint i=0; i < fThreadCount; ++i)
+        fThreads[i]->signalThreadShouldExit();
+
+    // wake up idle threads, nothing is running so they just leave
+    for (uint i=0; i < fThreadCount; ++i)
+        carla_sem_post(fSem);
+
+    for (uint i=0; i < fThreadCount; ++i)
+    {
+        fThreads[i]->stopThread(2000);
+        delete fThreads[i];
+    }
+
+    delete[] fThreads;
+    fThreads = nullptr;
+    fThreadCount = 0;
+
+    if (fSem != nullptr)
+    {
+        carla_sem_destroy(fSem);
+        fSem = nullptr;
+    }
+}
+
+uint CarlaEngineWorkerPool::getThreadCount() const noexcept
+{
+    return fThreadCount;
+}
+
+void CarlaEngineWorkerPool::run(EngineWorkerJob& job, EngineWorkerSchedule& schedule) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(schedule.getTaskCount() > 0,);
+
+    schedule.reset();
+
+    if (fThreadCount == 0)
+        return work(job, schedule);
+
+    fJob      = &job;
+    fSchedule = &schedule;
+    fRunning.set(1);
+
+    for (uint i=0; i < fThreadCount; ++i)
+        carla_sem_post(fSem);
+
+    work(job, schedule);
+
+    // late workers see this and leave without touching the schedule
+    fRunning.set(0);
+
+    // wait for workers which are still inside the schedule
+    while (fActiveWorkers.get() != 0)
+        carla_spin_pause();
+
+    fJob      = nullptr;
+    fSchedule = nullptr;
+}
+
+void CarlaEngineWorkerPool::work(EngineWorkerJob& job, EngineWorkerSchedule& schedule) noexcept
+{
+    for (;;)
+    {
+        const int taskId(schedule.popReady());
+
+        if (taskId >= 0)
+        {
+            job.runTask(static_cast<uint>(taskId));
+            schedule.taskFinished(static_cast<uint>(taskId));
+            continue;
+        }
+
+        if (schedule.isDone())
+            break;
+
+        carla_spin_pause();
+    }
+}
+
+void CarlaEngineWorkerPool::workerWakeUp() noexcept
+{
+    ++fActiveWorkers;
+
+    if (fRunning.get() != 0)
+    {
+        EngineWorkerJob*      const job(fJob);
+        EngineWorkerSchedule* const schedule(fSchedule);
+
+        if (job != nullptr && schedule != nullptr)
+            work(*job, *schedule);
+    }
+
+    --fActiveWorkers;
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,138 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_WORKERS_HPP_INCLUDED
+#define CARLA_ENGINE_WORKERS_HPP_INCLUDED
+
+#include "CarlaBackend.h"
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
+
+#include "juce_core.h"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// Work done by the pool, split into tasks identified by index
+
+class EngineWorkerJob
+{
+public:
+    virtual ~EngineWorkerJob() {}
+
+    // called from the audio thread or any of the worker threads
+    virtual void runTask(const uint taskId) noexcept = 0;
+};
+
+// -----------------------------------------------------------------------
+// Dependencies between the tasks of a job, plus their runtime state.
+// Built outside of the audio thread, a schedule must only run in 1 pool at a time.
+
+class EngineWorkerSchedule
+{
+public:
+    EngineWorkerSchedule() noexcept;
+    ~EngineWorkerSchedule() noexcept;
+
+    // non-RT, call before adding any dependency
+    bool init(const uint taskCount) noexcept;
+
+    // non-RT, @a taskId will only run after @a dependsOnTaskId is finished
+    void addDependency(const uint taskId, const uint dependsOnTaskId);
+
+    // non-RT, call after all dependencies are added, returns false on cycles
+    bool finalize();
+
+    uint getTaskCount() const noexcept
+    {
+        return fTaskCount;
+    }
+
+private:
+    uint fTaskCount;
+
+    // static data
+    uint* fDepCounts;     // number of tasks each task waits for
+    uint* fDependents;    // flat list of dependent tasks
+    uint* fFirstDependent; // offset into fDependents for each task, size is fTaskCount+1
+
+    // temporary data while building
+    juce::Array<uint64_t> fLinks;
+
+    // runtime data
+    juce::Atomic<int>* fPending;    // remaining dependencies for each task
+    juce::Atomic<int>* fReadySlots; // ready queue, task id + 1 (0 means not yet published)
+    juce::Atomic<int>  fReadyWrite;
+    juce::Atomic<int>  fReadyRead;
+    juce::Atomic<int>  fDoneCount;
+
+    void clear() noexcept;
+    void reset() noexcept;
+    void pushReady(const uint taskId) noexcept;
+    int  popReady() noexcept;
+    bool isDone() const noexcept;
+    void taskFinished(const uint taskId) noexcept;
+
+    friend class CarlaEngineWorkerPool;
+
+    CARLA_DECLARE_NON_COPY_CLASS(EngineWorkerSchedule)
+};
+
+// -----------------------------------------------------------------------
+// Pool of realtime threads that help the audio thread process a job
+
+class CarlaEngineWorkerPool
+{
+public:
+    CarlaEngineWorkerPool() noexcept;
+    ~CarlaEngineWorkerPool() noexcept;
+
+    // non-RT
+    bool start(const uint numThreads);
+    void stop() noexcept;
+
+    // number of extra threads (the caller of run() is not included)
+    uint getThreadCount() const noexcept;
+
+    // RT, runs all tasks of @a job and only returns when they are done.
+    // The calling thread takes part in the work.
+    void run(EngineWorkerJob& job, EngineWorkerSchedule& schedule) noexcept;
+
+private:
+    class WorkerThread;
+
+    WorkerThread** fThreads;
+    uint           fThreadCount;
+    sem_t*         fSem;
+
+    EngineWorkerJob*      fJob;
+    EngineWorkerSchedule* fSchedule;
+
+    juce::Atomic<int> fRunning;
+    juce::Atomic<int> fActiveWorkers;
+
+    void work(EngineWorkerJob& job, EngineWorkerSchedule& schedule) noexcept;
+    void workerWakeUp() noexcept;
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaEngineWorkerPool)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_WORKERS_HPP_INCLUDED
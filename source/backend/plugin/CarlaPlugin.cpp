@@ -165,6 +165,10 @@ uint32_t CarlaPlugin::getLatencyInFrames() const noexcept
     return 0;
 }
 
+void CarlaPlugin::getWorkerLoad(EngineDspLoad&) const noexcept
+{
+}
+
 // -------------------------------------------------------------------
 // Information (count)
 
@@ -514,6 +518,7 @@ const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
     pData->stateSave.balanceRight = pData->postProc.balanceRight;
     pData->stateSave.panning      = pData->postProc.panning;
     pData->stateSave.ctrlChannel  = pData->ctrlChannel;
+    pData->stateSave.rackLane     = pData->rackLane;
 #endif
 
     bool usingChunk = false;
@@ -860,6 +865,7 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
     setBalanceRight(stateSave.balanceRight, true, true);
     setPanning(stateSave.panning, true, true);
     setCtrlChannel(stateSave.ctrlChannel, true, true);
+    setRackLane(stateSave.rackLane);
     setActive(stateSave.active, true, true);
 #endif
 
@@ -1205,6 +1211,22 @@ void CarlaPlugin::setParameterValueByRealIndex(const int32_t rindex, const float
     }
 }
 
+void CarlaPlugin::queueParameterValue(const uint32_t parameterId, const float value, const bool sendGui, const bool sendOsc, const bool sendCallback) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
+
+    // the queue is only emptied while processing
+    if (! (pData->enabled && pData->active && pData->engine->isRunning()))
+        return setParameterValue(parameterId, value, sendGui, sendOsc, sendCallback);
+
+    const float fixedValue(pData->param.getFixedValue(parameterId, value));
+
+    if (! pData->param.queue.post(parameterId, fixedValue))
+        return setParameterValue(parameterId, value, sendGui, sendOsc, sendCallback);
+
+    CarlaPlugin::setParameterValue(parameterId, fixedValue, sendGui, sendOsc, sendCallback);
+}
+
 void CarlaPlugin::setParameterMidiChannel(const uint32_t parameterId, const uint8_t channel, const bool sendOsc, const bool sendCallback) noexcept
 {
 #ifndef BUILD_BRIDGE
@@ -1405,6 +1427,15 @@ void CarlaPlugin::offlineModeChanged(const bool)
 {
 }
 
+void CarlaPlugin::processParameterQueue() noexcept
+{
+    uint32_t parameterId;
+    float    value;
+
+    while (pData->param.queue.get(parameterId, value))
+        setParameterValue(parameterId, value, false, false, false);
+}
+
 // -------------------------------------------------------------------
 // Misc
 
@@ -1634,6 +1665,11 @@ void CarlaPlugin::clearBuffers() noexcept
     pData->clearBuffers();
 }
 
+float* CarlaPlugin::getAudioPortBuffer(const bool, const uint32_t) const noexcept
+{
+    return nullptr;
+}
+
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
 // -------------------------------------------------------------------
 // OSC stuff
@@ -1986,6 +2022,23 @@ void CarlaPlugin::setPatchbayNodeId(const uint32_t nodeId) noexcept
     pData->nodeId = nodeId;
 }
 
+uint CarlaPlugin::getRackLane() const noexcept
+{
+    return pData->rackLane;
+}
+
+void CarlaPlugin::setRackLane(const uint lane) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(lane < MAX_RACK_LANES,);
+
+    pData->rackLane = lane;
+}
+
+bool CarlaPlugin::hasExtraEventPorts() const noexcept
+{
+    return pData->event.hasExtraPorts;
+}
+
 // -------------------------------------------------------------------
 // Scoped Disabler
 
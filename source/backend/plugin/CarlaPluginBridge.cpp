@@ -22,7 +22,6 @@
 #include "CarlaPluginInternal.hpp"
 
 #include "CarlaBackendUtils.hpp"
-#include "CarlaBase64Utils.hpp"
 #include "CarlaBridgeUtils.hpp"
 #include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
@@ -36,7 +35,6 @@
 // -------------------------------------------------------------------------------------------------------------------
 
 using juce::ChildProcess;
-using juce::File;
 using juce::ScopedPointer;
 using juce::String;
 using juce::StringArray;
@@ -127,23 +125,136 @@ struct BridgeAudioPool {
 
 // -------------------------------------------------------------------------------------------------------------------
 
+struct BridgeChunkPool {
+    CarlaString filename;
+    std::size_t size;
+    uint8_t* data;
+    shm_t shm;
+
+    BridgeChunkPool() noexcept
+        : filename(),
+          size(0),
+          data(nullptr)
+#ifdef CARLA_PROPER_CPP11_SUPPORT
+        , shm(shm_t_INIT) {}
+#else
+    {
+        carla_shm_init(shm);
+    }
+#endif
+
+    ~BridgeChunkPool() noexcept
+    {
+        // should be cleared by now
+        CARLA_SAFE_ASSERT(data == nullptr);
+
+        clear();
+    }
+
+    // uses the same id as the audio pool, so the client can find it
+    bool initialize(const CarlaString& audioPoolFilename) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(audioPoolFilename.length() > 6, false);
+
+        char tmpFileBase[64];
+
+        std::sprintf(tmpFileBase, PLUGIN_BRIDGE_NAMEPREFIX_CHUNK_POOL "%s", audioPoolFilename.buffer() + (audioPoolFilename.length()-6));
+
+        shm = carla_shm_create(tmpFileBase);
+
+        CARLA_SAFE_ASSERT_RETURN(carla_is_shm_valid(shm), false);
+
+        if (! resize(kBridgeChunkPoolMinSize))
+        {
+            carla_shm_close(shm);
+            carla_shm_init(shm);
+            return false;
+        }
+
+        filename = tmpFileBase;
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        filename.clear();
+
+        if (! carla_is_shm_valid(shm))
+        {
+            CARLA_SAFE_ASSERT(data == nullptr);
+            return;
+        }
+
+        if (data != nullptr)
+        {
+            carla_shm_unmap(shm, data);
+            data = nullptr;
+        }
+
+        size = 0;
+        carla_shm_close(shm);
+        carla_shm_init(shm);
+    }
+
+    // grows the pool to at least 'minSize' bytes, the client must not have it mapped
+    bool resize(const std::size_t minSize) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(carla_is_shm_valid(shm), false);
+
+        if (minSize <= size)
+            return true;
+
+        std::size_t newSize = (size != 0) ? size : kBridgeChunkPoolMinSize;
+
+        while (newSize < minSize)
+            newSize *= 2;
+
+        if (data != nullptr)
+        {
+            carla_shm_unmap(shm, data);
+            data = nullptr;
+            size = 0;
+        }
+
+        data = (uint8_t*)carla_shm_map(shm, newSize);
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+
+        size = newSize;
+        return true;
+    }
+
+    CARLA_DECLARE_NON_COPY_STRUCT(BridgeChunkPool)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
 struct BridgeRtClientControl : public CarlaRingBufferControl<SmallStackBuffer> {
     BridgeRtClientData* data;
     CarlaString filename;
     bool needsSemDestroy;
+
+    // events waiting to be sent as a block, and how many did not fit in the ring buffer
+    BridgeRtEvent events[kBridgeRtEventBlockSize];
+    uint32_t eventCount;
+    juce::Atomic<uint32_t> eventsDropped;
+
     shm_t shm;
 
     BridgeRtClientControl()
         : data(nullptr),
           filename(),
-          needsSemDestroy(false)
+          needsSemDestroy(false),
+          eventCount(0),
+          eventsDropped(0)
 #ifdef CARLA_PROPER_CPP11_SUPPORT
-        , shm(shm_t_INIT) {}
-#else
+        , shm(shm_t_INIT)
+#endif
     {
+#ifndef CARLA_PROPER_CPP11_SUPPORT
         carla_shm_init(shm);
-    }
 #endif
+        carla_zeroStruct(events, kBridgeRtEventBlockSize);
+    }
 
     ~BridgeRtClientControl() noexcept override
     {
@@ -250,11 +361,69 @@ struct BridgeRtClientControl : public CarlaRingBufferControl<SmallStackBuffer> {
         return jackbridge_sem_timedwait(&data->sem.client, secs, timedOut);
     }
 
+    // split version of the above, used to let the client process while we do something else
+    void postServer() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
+
+        jackbridge_sem_post(&data->sem.server);
+    }
+
+    bool waitForClientPost(const uint secs, bool* const timedOut) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+
+        return jackbridge_sem_timedwait(&data->sem.client, secs, timedOut);
+    }
+
     void writeOpcode(const PluginBridgeRtClientOpcode opcode) noexcept
     {
         writeUInt(static_cast<uint32_t>(opcode));
     }
 
+    BridgeRtEvent& addEvent(const uint32_t time, const PluginBridgeRtEventType type, const uint8_t channel, const uint16_t param) noexcept
+    {
+        if (eventCount == kBridgeRtEventBlockSize)
+            writeEventBlock();
+
+        BridgeRtEvent& event(events[eventCount++]);
+        event.time    = time;
+        event.type    = static_cast<uint8_t>(type);
+        event.channel = channel;
+        event.param   = param;
+        event.value   = 0.0f;
+        return event;
+    }
+
+    // Sends all pending events in one block.
+    // If the ring buffer is too full, sends the ones that fit and counts the rest as dropped.
+    void writeEventBlock() noexcept
+    {
+        if (eventCount == 0)
+            return;
+
+        static const uint32_t kHeaderSize = 2*sizeof(uint32_t);
+        const uint32_t available(getAvailableDataSize());
+
+        uint32_t count = 0;
+
+        if (available > kHeaderSize)
+            count = std::min(eventCount, static_cast<uint32_t>((available - kHeaderSize - 1) / sizeof(BridgeRtEvent)));
+
+        if (count > 0)
+        {
+            writeOpcode(kPluginBridgeRtClientEventBlock);
+            writeUInt(count);
+            writeCustomData(events, static_cast<uint32_t>(count * sizeof(BridgeRtEvent)));
+            commitWrite();
+        }
+
+        if (count < eventCount)
+            eventsDropped += eventCount - count;
+
+        eventCount = 0;
+    }
+
     CARLA_DECLARE_NON_COPY_STRUCT(BridgeRtClientControl)
 };
 
@@ -471,6 +640,154 @@ struct BridgeNonRtServerControl : public CarlaRingBufferControl<HugeStackBuffer>
 
 // -------------------------------------------------------------------------------------------------------------------
 
+struct BridgeGroupControl : public CarlaRingBufferControl<SmallStackBuffer> {
+    BridgeGroupData* data;
+    CarlaString filename;
+    CarlaMutex mutex;
+    bool needsSemDestroy;
+    shm_t shm;
+
+    BridgeGroupControl() noexcept
+        : data(nullptr),
+          filename(),
+          mutex(),
+          needsSemDestroy(false)
+#ifdef CARLA_PROPER_CPP11_SUPPORT
+        , shm(shm_t_INIT) {}
+#else
+    {
+        carla_shm_init(shm);
+    }
+#endif
+
+    ~BridgeGroupControl() noexcept override
+    {
+        // should be cleared by now
+        CARLA_SAFE_ASSERT(data == nullptr);
+
+        clear();
+    }
+
+    bool initialize() noexcept
+    {
+        char tmpFileBase[64];
+
+        std::sprintf(tmpFileBase, PLUGIN_BRIDGE_NAMEPREFIX_GROUP "XXXXXX");
+
+        shm = carla_shm_create_temp(tmpFileBase);
+
+        CARLA_SAFE_ASSERT_RETURN(carla_is_shm_valid(shm), false);
+
+        if (! mapData())
+        {
+            carla_shm_close(shm);
+            carla_shm_init(shm);
+            return false;
+        }
+
+        CARLA_SAFE_ASSERT(data != nullptr);
+
+        if (! jackbridge_sem_init(&data->sem.server))
+        {
+            unmapData();
+            carla_shm_close(shm);
+            carla_shm_init(shm);
+            return false;
+        }
+
+        if (! jackbridge_sem_init(&data->sem.client))
+        {
+            jackbridge_sem_destroy(&data->sem.server);
+            unmapData();
+            carla_shm_close(shm);
+            carla_shm_init(shm);
+            return false;
+        }
+
+        filename = tmpFileBase;
+        needsSemDestroy = true;
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        filename.clear();
+
+        if (needsSemDestroy)
+        {
+            jackbridge_sem_destroy(&data->sem.client);
+            jackbridge_sem_destroy(&data->sem.server);
+            needsSemDestroy = false;
+        }
+
+        if (data != nullptr)
+            unmapData();
+
+        if (! carla_is_shm_valid(shm))
+            return;
+
+        carla_shm_close(shm);
+        carla_shm_init(shm);
+    }
+
+    bool mapData() noexcept
+    {
+        CARLA_SAFE_ASSERT(data == nullptr);
+
+        if (carla_shm_map<BridgeGroupData>(shm, data))
+        {
+            carla_zeroStruct(data->sem);
+            setRingBuffer(&data->ringBuffer, true);
+            return true;
+        }
+
+        return false;
+    }
+
+    void unmapData() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
+
+        carla_shm_unmap(shm, data);
+        data = nullptr;
+
+        setRingBuffer(nullptr, false);
+    }
+
+    void postServer() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
+
+        jackbridge_sem_post(&data->sem.server);
+    }
+
+    bool waitForClientPost(const uint secs, bool* const timedOut) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+
+        return jackbridge_sem_timedwait(&data->sem.client, secs, timedOut);
+    }
+
+    void writeOpcode(const PluginBridgeGroupOpcode opcode) noexcept
+    {
+        writeUInt(static_cast<uint32_t>(opcode));
+    }
+
+    void writeString(const char* const str) noexcept
+    {
+        const uint32_t size(static_cast<uint32_t>(str != nullptr ? std::strlen(str) : 0));
+
+        writeUInt(size);
+
+        if (size > 0)
+            writeCustomData(str, size);
+    }
+
+    CARLA_DECLARE_NON_COPY_STRUCT(BridgeGroupControl)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
 struct BridgeParamInfo {
     float value;
     CarlaString name;
@@ -488,6 +805,7 @@ struct BridgeParamInfo {
 
 // -------------------------------------------------------------------------------------------------------------------
 
+// runs a bridge process for a single plugin, or for a bridge group when plugin is null
 class CarlaPluginBridgeThread : public CarlaThread
 {
 public:
@@ -535,11 +853,7 @@ protected:
             carla_stderr("CarlaPluginBridgeThread::run() - already running, giving up...");
         }
 
-        String name(kPlugin->getName());
-        String filename(kPlugin->getFilename());
-
-        if (name.isEmpty())
-            name = "(none)";
+        String filename(kPlugin != nullptr ? kPlugin->getFilename() : "");
 
         if (filename.isEmpty())
             filename = "\"\"";
@@ -555,17 +869,25 @@ protected:
         // binary
         arguments.add(fBinary);
 
-        // plugin type
-        arguments.add(getPluginTypeAsString(kPlugin->getType()));
+        if (kPlugin != nullptr)
+        {
+            // plugin type
+            arguments.add(getPluginTypeAsString(kPlugin->getType()));
 
-        // filename
-        arguments.add(filename);
+            // filename
+            arguments.add(filename);
 
-        // label
-        arguments.add(fLabel);
+            // label
+            arguments.add(fLabel);
 
-        // uniqueId
-        arguments.add(String(static_cast<juce::int64>(kPlugin->getUniqueId())));
+            // uniqueId
+            arguments.add(String(static_cast<juce::int64>(kPlugin->getUniqueId())));
+        }
+        else
+        {
+            // plugins are added later, through the group shared memory
+            arguments.add("--group");
+        }
 
         bool started;
 
@@ -649,11 +971,15 @@ protected:
             std::snprintf(strBuf, STR_MAX, P_UINTPTR, options.frontendWinId);
             carla_setenv("ENGINE_OPTION_FRONTEND_WIN_ID", strBuf);
 
-            carla_setenv("ENGINE_BRIDGE_SHM_IDS", fShmIds.toRawUTF8());
+            carla_setenv("ENGINE_BRIDGE_SHM_IDS",      kPlugin != nullptr ? fShmIds.toRawUTF8() : "");
+            carla_setenv("ENGINE_BRIDGE_GROUP_SHM_ID", kPlugin != nullptr ? "" : fShmIds.toRawUTF8());
             carla_setenv("WINEDEBUG", "-all");
 
-            carla_stdout("starting plugin bridge, command is:\n%s \"%s\" \"%s\" \"%s\" " P_INT64,
-                         fBinary.toRawUTF8(), getPluginTypeAsString(kPlugin->getType()), filename.toRawUTF8(), fLabel.toRawUTF8(), kPlugin->getUniqueId());
+            if (kPlugin != nullptr)
+                carla_stdout("starting plugin bridge, command is:\n%s \"%s\" \"%s\" \"%s\" " P_INT64,
+                             fBinary.toRawUTF8(), getPluginTypeAsString(kPlugin->getType()), filename.toRawUTF8(), fLabel.toRawUTF8(), kPlugin->getUniqueId());
+            else
+                carla_stdout("starting plugin bridge group, command is:\n%s --group", fBinary.toRawUTF8());
 
             started = fProcess->start(arguments);
 
@@ -691,7 +1017,12 @@ protected:
         else
         {
             // forced quit, may have crashed
-            if (fProcess->getExitCode() != 0 /*|| fProcess->exitStatus() == QProcess::CrashExit*/)
+            if (fProcess->getExitCode() != 0 && kPlugin == nullptr)
+            {
+                // each plugin in the group reports itself as unavailable
+                carla_stderr("CarlaPluginBridgeThread::run() - bridge group crashed");
+            }
+            else if (fProcess->getExitCode() != 0 /*|| fProcess->exitStatus() == QProcess::CrashExit*/)
             {
                 carla_stderr("CarlaPluginBridgeThread::run() - bridge crashed");
 
@@ -704,21 +1035,217 @@ protected:
                 carla_stderr("CarlaPluginBridgeThread::run() - bridge closed cleanly");
         }
 
-        carla_stdout("plugin bridge finished");
-        fProcess = nullptr;
+        carla_stdout("plugin bridge finished");
+        fProcess = nullptr;
+    }
+
+private:
+    CarlaEngine* const kEngine;
+    CarlaPlugin* const kPlugin;
+
+    String fBinary;
+    String fLabel;
+    String fShmIds;
+
+    ScopedPointer<ChildProcess> fProcess;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginBridgeThread)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+// Several bridged plugins sharing one bridge process.
+// Each plugin keeps its own shared memory, but blocks only go through the group semaphores:
+// members queue their block, and the last active member to do so wakes up the process once for all of them.
+// Blocks are counted, so a member can always find out if the block it queued has been processed.
+
+class CarlaPluginBridgeGroup
+{
+public:
+    CarlaPluginBridgeGroup(CarlaEngine* const engine, const BinaryType btype, const char* const bridgeBinary) noexcept
+        : kBinaryType(btype),
+          fBridgeBinary(bridgeBinary),
+          fThread(engine, nullptr),
+          fControl(),
+          fSyncMutex(),
+          fMemberCount(0),
+          fActiveCount(0),
+          fQueuedCount(0),
+          fPostedBlocks(0),
+          fDoneBlocks(0),
+          leakDetector_CarlaPluginBridgeGroup() {}
+
+    ~CarlaPluginBridgeGroup()
+    {
+        CARLA_SAFE_ASSERT(fMemberCount == 0);
+
+        if (fThread.isThreadRunning())
+        {
+            const CarlaMutexLocker _cml(fControl.mutex);
+
+            fControl.writeOpcode(kPluginBridgeGroupQuit);
+            fControl.commitWrite();
+        }
+
+        fThread.stopThread(3000);
+        fControl.clear();
+    }
+
+    bool start()
+    {
+        if (! fControl.initialize())
+        {
+            carla_stdout("Failed to initialize bridge group control");
+            return false;
+        }
+
+        fThread.setData(fBridgeBinary, nullptr, &fControl.filename[fControl.filename.length()-6]);
+        fThread.startThread();
+        return true;
+    }
+
+    bool matches(const BinaryType btype, const char* const bridgeBinary) const noexcept
+    {
+        return kBinaryType == btype && fBridgeBinary == bridgeBinary && fThread.isThreadRunning();
+    }
+
+    bool isRunning() const noexcept
+    {
+        return fThread.isThreadRunning();
+    }
+
+    uintptr_t getProcessPID() const noexcept
+    {
+        return fThread.getProcessPID();
+    }
+
+    // -------------------------------------------------------------------
+    // Members, non-RT
+
+    // asks the bridge process to load a plugin, using the shared memory given by shmIds
+    void addMember(const char* const shmIds, const PluginType ptype,
+                   const char* const filename, const char* const name, const char* const label, const int64_t uniqueId) noexcept
+    {
+        ++fMemberCount;
+
+        const CarlaMutexLocker _cml(fControl.mutex);
+
+        fControl.writeOpcode(kPluginBridgeGroupAddMember);
+        fControl.writeString(shmIds);
+        fControl.writeUInt(static_cast<uint32_t>(ptype));
+        fControl.writeString(filename);
+        fControl.writeString(name);
+        fControl.writeString(label);
+        fControl.writeLong(uniqueId);
+        fControl.commitWrite();
+    }
+
+    // returns true when there are no members left
+    bool removeMember() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fMemberCount > 0, true);
+
+        return (--fMemberCount == 0);
+    }
+
+    void setMemberActive(const bool active) noexcept
+    {
+        const CarlaMutexLocker _cml(fSyncMutex);
+
+        if (active)
+            ++fActiveCount;
+        else if (fActiveCount > 0)
+            --fActiveCount;
+    }
+
+    // -------------------------------------------------------------------
+    // Blocks
+
+    // Called from the audio thread after a member wrote its block, returns the block to wait for later.
+    // Returns 0 if the group is busy with a non-RT sync, the block is then sent by the next post.
+    uint64_t queueBlock() noexcept
+    {
+        if (! fSyncMutex.tryLock())
+            return 0;
+
+        const uint64_t block(fPostedBlocks + 1);
+
+        if (++fQueuedCount >= fActiveCount && fDoneBlocks == fPostedBlocks)
+            postBlock();
+
+        fSyncMutex.unlock();
+        return block;
+    }
+
+    // Waits until the given block has been processed, posting it first if that did not happen yet.
+    // From the audio thread this gives up when the group is busy, with timedOut left untouched.
+    bool waitForBlock(uint64_t block, const uint secs, bool& timedOut, const bool fromRT) noexcept
+    {
+        if (fromRT)
+        {
+            if (! fSyncMutex.tryLock())
+                return false;
+        }
+        else
+        {
+            fSyncMutex.lock();
+        }
+
+        if (block == 0)
+            block = fPostedBlocks + 1;
+
+        bool ok = true;
+
+        for (; fDoneBlocks < block;)
+        {
+            // not everyone queued their block, send what we have
+            if (fDoneBlocks == fPostedBlocks)
+                postBlock();
+
+            if (! fControl.waitForClientPost(secs, &timedOut))
+            {
+                // give up on the blocks still in flight
+                fDoneBlocks = fPostedBlocks;
+                ok = false;
+                break;
+            }
+
+            ++fDoneBlocks;
+        }
+
+        fSyncMutex.unlock();
+        return ok;
+    }
+
+    // non-RT round trip, so the process handles everything written so far
+    bool sync(const uint secs, bool& timedOut) noexcept
+    {
+        return waitForBlock(0, secs, timedOut, false);
     }
 
 private:
-    CarlaEngine* const kEngine;
-    CarlaPlugin* const kPlugin;
+    const BinaryType kBinaryType;
+    const CarlaString fBridgeBinary;
 
-    String fBinary;
-    String fLabel;
-    String fShmIds;
+    CarlaPluginBridgeThread fThread;
+    BridgeGroupControl fControl;
 
-    ScopedPointer<ChildProcess> fProcess;
+    // protects everything below, the audio thread only uses tryLock
+    CarlaMutex fSyncMutex;
 
-    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginBridgeThread)
+    uint fMemberCount;
+    uint fActiveCount;
+    uint fQueuedCount;
+    uint64_t fPostedBlocks;
+    uint64_t fDoneBlocks;
+
+    void postBlock() noexcept
+    {
+        fQueuedCount = 0;
+        ++fPostedBlocks;
+        fControl.postServer();
+    }
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginBridgeGroup)
 };
 
 // -------------------------------------------------------------------------------------------------------------------
@@ -735,13 +1262,18 @@ public:
           fSaved(true),
           fTimedOut(false),
           fTimedError(false),
+          fPipelined(false),
+          fProcPending(false),
           fLastPongTime(-1),
           fBridgeBinary(),
           fBridgeThread(engine, this),
+          fGroup(nullptr),
+          fGroupBlock(0),
           fShmAudioPool(),
           fShmRtClientControl(),
           fShmNonRtClientControl(),
           fShmNonRtServerControl(),
+          fShmChunkPool(),
           fInfo(),
           fUniqueId(0),
           fParams(nullptr),
@@ -750,6 +1282,8 @@ public:
         carla_debug("CarlaPluginBridge::CarlaPluginBridge(%p, %i, %s, %s)", engine, id, BinaryType2Str(btype), PluginType2Str(ptype));
 
         pData->hints |= PLUGIN_IS_BRIDGE;
+
+        carla_zeroBytes(fPipelinedMidiOut, kBridgeRtClientDataMidiOutSize);
     }
 
     ~CarlaPluginBridge() override
@@ -772,7 +1306,7 @@ public:
             pData->active = false;
         }
 
-        if (fBridgeThread.isThreadRunning())
+        if (isBridgeRunning())
         {
             fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientQuit);
             fShmNonRtClientControl.commitWrite();
@@ -786,6 +1320,14 @@ public:
 
         fBridgeThread.stopThread(3000);
 
+        if (fGroup != nullptr)
+        {
+            if (fGroup->removeMember())
+                delete fGroup;
+            fGroup = nullptr;
+        }
+
+        fShmChunkPool.clear();
         fShmNonRtServerControl.clear();
         fShmNonRtClientControl.clear();
         fShmRtClientControl.clear();
@@ -819,6 +1361,12 @@ public:
         return fUniqueId;
     }
 
+    uint32_t getLatencyInFrames() const noexcept override
+    {
+        // pipelined bridges return the output of the previous block
+        return fPipelined ? pData->engine->getBufferSize() : 0;
+    }
+
     // -------------------------------------------------------------------
     // Information (count)
 
@@ -928,11 +1476,12 @@ public:
 
         // TODO: only wait 1 minute for NI plugins
         const uint32_t timeoutEnd(Time::getMillisecondCounter() + 60*1000); // 60 secs, 1 minute
-        const bool needsEngineIdle(pData->engine->getType() != kEngineTypePlugin);
+        // no engine idle while loading a project in another thread, this plugin is not part of it yet
+        const bool needsEngineIdle(pData->engine->getType() != kEngineTypePlugin && ! pData->engine->isPluginLoaderThread());
 
         carla_stdout("CarlaPluginBridge::waitForSaved() - now waiting...");
 
-        for (; Time::getMillisecondCounter() < timeoutEnd && fBridgeThread.isThreadRunning();)
+        for (; Time::getMillisecondCounter() < timeoutEnd && isBridgeRunning();)
         {
             pData->engine->callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
 
@@ -1126,37 +1675,30 @@ public:
         CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
         CARLA_SAFE_ASSERT_RETURN(dataSize > 0,);
 
-        carla_stdout("Carla bridge server side, setChunkData 001");
-
-        CarlaString dataBase64(CarlaString::asBase64(data, dataSize));
-        CARLA_SAFE_ASSERT_RETURN(dataBase64.length() > 0,);
-
-        String filePath(File::getSpecialLocation(File::tempDirectory).getFullPathName());
-
-        filePath += CARLA_OS_SEP_STR ".CarlaChunk_";
-        filePath += fShmAudioPool.filename.buffer() + 18;
-
-        if (File(filePath).replaceWithText(dataBase64.buffer()))
+        if (claimChunkPool())
         {
-            carla_stdout("Carla bridge server side, setChunkData 002");
-
-            const uint32_t ulength(static_cast<uint32_t>(filePath.length()));
+            BridgeChunkPoolState& chunkPool(fShmNonRtClientControl.data->chunkPool);
 
-            const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
+            if (fShmChunkPool.resize(dataSize))
+            {
+                std::memcpy(fShmChunkPool.data, data, dataSize);
+                chunkPool.size = fShmChunkPool.size;
 
-            fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientSetChunkDataFile);
-            fShmNonRtClientControl.writeUInt(ulength);
-            fShmNonRtClientControl.writeCustomData(filePath.toRawUTF8(), ulength);
-            fShmNonRtClientControl.commitWrite();
+                const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
 
-            carla_stdout("Carla bridge server side, setChunkData sent");
+                fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientSetChunkData);
+                fShmNonRtClientControl.writeULong(static_cast<uint64_t>(dataSize));
+                fShmNonRtClientControl.commitWrite();
+            }
+            else
+            {
+                carla_chunk_pool_release(chunkPool);
+            }
         }
 
         // save data internally as well
         fInfo.chunk.resize(dataSize);
         std::memcpy(fInfo.chunk.data(), data, dataSize);
-
-        carla_stdout("Carla bridge server side, setChunkData saved locally too");
     }
 
     // -------------------------------------------------------------------
@@ -1185,7 +1727,7 @@ public:
 
     void idle() override
     {
-        if (fBridgeThread.isThreadRunning())
+        if (isBridgeRunning())
         {
             if (fInitiated && fTimedOut && pData->active)
                 setActive(false, true, true);
@@ -1200,6 +1742,9 @@ public:
             try {
                 handleNonRtData();
             } CARLA_SAFE_EXCEPTION("handleNonRtData");
+
+            if (const uint32_t dropped = fShmRtClientControl.eventsDropped.exchange(0))
+                carla_stderr2("CarlaPluginBridge::idle() - %u events did not fit in the RT ring buffer and were dropped", dropped);
         }
         else if (fInitiated)
         {
@@ -1376,6 +1921,18 @@ public:
 
         fTimedOut = false;
 
+        // discard any block left over from before deactivation
+        waitForPendingProcess();
+
+        if (fGroup != nullptr)
+            fGroup->setMemberActive(true);
+
+        if (pData->latency.frames > 0)
+        {
+            for (uint32_t i=0; i < pData->latency.channels; ++i)
+                FloatVectorOperations::clear(pData->latency.buffers[i], static_cast<int>(pData->latency.frames));
+        }
+
         try {
             waitForClient("activate", 2);
         } CARLA_SAFE_EXCEPTION("activate - waitForClient");
@@ -1394,6 +1951,11 @@ public:
 
         fTimedOut = false;
 
+        waitForPendingProcess();
+
+        if (fGroup != nullptr)
+            fGroup->setMemberActive(false);
+
         try {
             waitForClient("deactivate", 2);
         } CARLA_SAFE_EXCEPTION("deactivate - waitForClient");
@@ -1424,6 +1986,24 @@ public:
             pData->needsReset = false;
         }
 
+        // --------------------------------------------------------------------------------------------------------
+        // Parameter changes from control threads, sent ahead of this block's events
+
+        {
+            uint32_t parameterId;
+            float    value;
+
+            while (pData->param.queue.get(parameterId, value))
+            {
+                CARLA_SAFE_ASSERT_CONTINUE(parameterId <= 0xFFFF);
+
+                fParams[parameterId].value = value;
+                fShmRtClientControl.addEvent(0, kPluginBridgeRtEventParameterValue, 0, static_cast<uint16_t>(parameterId)).value = value;
+            }
+
+            fShmRtClientControl.writeEventBlock();
+        }
+
         // --------------------------------------------------------------------------------------------------------
         // Event Input
 
@@ -1440,19 +2020,10 @@ public:
 
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
-                    uint8_t data1, data2, data3;
-                    data1 = uint8_t((note.velo > 0 ? MIDI_STATUS_NOTE_ON : MIDI_STATUS_NOTE_OFF) | (note.channel & MIDI_CHANNEL_BIT));
-                    data2 = note.note;
-                    data3 = note.velo;
-
-                    fShmRtClientControl.writeOpcode(kPluginBridgeRtClientMidiEvent);
-                    fShmRtClientControl.writeUInt(0); // time
-                    fShmRtClientControl.writeByte(0); // port
-                    fShmRtClientControl.writeByte(3); // size
-                    fShmRtClientControl.writeByte(data1);
-                    fShmRtClientControl.writeByte(data2);
-                    fShmRtClientControl.writeByte(data3);
-                    fShmRtClientControl.commitWrite();
+                    BridgeRtEvent& bridgeEvent(fShmRtClientControl.addEvent(0, kPluginBridgeRtEventMidi, 0, 3));
+                    bridgeEvent.midi[0] = uint8_t((note.velo > 0 ? MIDI_STATUS_NOTE_ON : MIDI_STATUS_NOTE_OFF) | (note.channel & MIDI_CHANNEL_BIT));
+                    bridgeEvent.midi[1] = note.note;
+                    bridgeEvent.midi[2] = note.velo;
                 }
 
                 pData->extNotes.data.clear();
@@ -1537,43 +2108,27 @@ public:
                             }
                         }
 #endif
-                        fShmRtClientControl.writeOpcode(kPluginBridgeRtClientControlEventParameter);
-                        fShmRtClientControl.writeUInt(event.time);
-                        fShmRtClientControl.writeByte(event.channel);
-                        fShmRtClientControl.writeUShort(event.ctrl.param);
-                        fShmRtClientControl.writeFloat(event.ctrl.value);
-                        fShmRtClientControl.commitWrite();
+                        fShmRtClientControl.addEvent(event.time, kPluginBridgeRtEventParameter, event.channel, event.ctrl.param).value = event.ctrl.value;
                         break;
 
                     case kEngineControlEventTypeMidiBank:
                         if (pData->options & PLUGIN_OPTION_MAP_PROGRAM_CHANGES)
                         {
-                            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientControlEventMidiBank);
-                            fShmRtClientControl.writeUInt(event.time);
-                            fShmRtClientControl.writeByte(event.channel);
-                            fShmRtClientControl.writeUShort(event.ctrl.param);
-                            fShmRtClientControl.commitWrite();
+                            fShmRtClientControl.addEvent(event.time, kPluginBridgeRtEventMidiBank, event.channel, event.ctrl.param);
                         }
                         break;
 
                     case kEngineControlEventTypeMidiProgram:
                         if (pData->options & PLUGIN_OPTION_MAP_PROGRAM_CHANGES)
                         {
-                            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientControlEventMidiProgram);
-                            fShmRtClientControl.writeUInt(event.time);
-                            fShmRtClientControl.writeByte(event.channel);
-                            fShmRtClientControl.writeUShort(event.ctrl.param);
-                            fShmRtClientControl.commitWrite();
+                            fShmRtClientControl.addEvent(event.time, kPluginBridgeRtEventMidiProgram, event.channel, event.ctrl.param);
                         }
                         break;
 
                     case kEngineControlEventTypeAllSoundOff:
                         if (pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF)
                         {
-                            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientControlEventAllSoundOff);
-                            fShmRtClientControl.writeUInt(event.time);
-                            fShmRtClientControl.writeByte(event.channel);
-                            fShmRtClientControl.commitWrite();
+                            fShmRtClientControl.addEvent(event.time, kPluginBridgeRtEventAllSoundOff, event.channel, 0);
                         }
                         break;
 
@@ -1588,10 +2143,7 @@ public:
                             }
 #endif
 
-                            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientControlEventAllNotesOff);
-                            fShmRtClientControl.writeUInt(event.time);
-                            fShmRtClientControl.writeByte(event.channel);
-                            fShmRtClientControl.commitWrite();
+                            fShmRtClientControl.addEvent(event.time, kPluginBridgeRtEventAllNotesOff, event.channel, 0);
                         }
                         break;
                     } // switch (ctrlEvent.type)
@@ -1621,17 +2173,32 @@ public:
                     if (status == MIDI_STATUS_NOTE_ON && midiData[2] == 0)
                         status = MIDI_STATUS_NOTE_OFF;
 
-                    fShmRtClientControl.writeOpcode(kPluginBridgeRtClientMidiEvent);
-                    fShmRtClientControl.writeUInt(event.time);
-                    fShmRtClientControl.writeByte(midiEvent.port);
-                    fShmRtClientControl.writeByte(midiEvent.size);
+                    if (midiEvent.size <= sizeof(BridgeRtEvent::midi))
+                    {
+                        BridgeRtEvent& bridgeEvent(fShmRtClientControl.addEvent(event.time, kPluginBridgeRtEventMidi, midiEvent.port, midiEvent.size));
+                        bridgeEvent.midi[0] = uint8_t(midiData[0] | (event.channel & MIDI_CHANNEL_BIT));
+
+                        for (uint8_t j=1; j < midiEvent.size; ++j)
+                            bridgeEvent.midi[j] = midiData[j];
+                    }
+                    else
+                    {
+                        // too big for a block event, send pending ones first to keep the order
+                        fShmRtClientControl.writeEventBlock();
+
+                        fShmRtClientControl.writeOpcode(kPluginBridgeRtClientMidiEvent);
+                        fShmRtClientControl.writeUInt(event.time);
+                        fShmRtClientControl.writeByte(midiEvent.port);
+                        fShmRtClientControl.writeByte(midiEvent.size);
 
-                    fShmRtClientControl.writeByte(uint8_t(midiData[0] | (event.channel & MIDI_CHANNEL_BIT)));
+                        fShmRtClientControl.writeByte(uint8_t(midiData[0] | (event.channel & MIDI_CHANNEL_BIT)));
 
-                    for (uint8_t j=1; j < midiEvent.size; ++j)
-                        fShmRtClientControl.writeByte(midiData[j]);
+                        for (uint8_t j=1; j < midiEvent.size; ++j)
+                            fShmRtClientControl.writeByte(midiData[j]);
 
-                    fShmRtClientControl.commitWrite();
+                        if (! fShmRtClientControl.commitWrite())
+                            ++fShmRtClientControl.eventsDropped;
+                    }
 
                     if (status == MIDI_STATUS_NOTE_ON)
                         pData->postponeRtEvent(kPluginPostRtEventNoteOn, event.channel, midiData[1], midiData[2]);
@@ -1641,6 +2208,8 @@ public:
                 }
             }
 
+            fShmRtClientControl.writeEventBlock();
+
             pData->postRtEvents.trySplice();
 
         } // End of Event Input
@@ -1669,7 +2238,8 @@ public:
 
             uint8_t size;
             uint32_t time;
-            const uint8_t* midiData(fShmRtClientControl.data->midiOut);
+            // in pipelined mode the client is already writing the next block's events
+            const uint8_t* midiData(fPipelined ? fPipelinedMidiOut : fShmRtClientControl.data->midiOut);
 
             for (std::size_t read=0; read<kBridgeRtClientDataMidiOutSize;)
             {
@@ -1699,6 +2269,10 @@ public:
             }
 
         } // End of Control and MIDI Output
+
+        // the bridge sent us non-RT data, let the engine thread handle it soon
+        if (fShmNonRtServerControl.isDataAvailableForReading())
+            pData->engine->wakeIdleThread();
     }
 
     bool processSingle(const float** const audioIn, float** const audioOut, const float** const cvIn, float** const cvOut, const uint32_t frames)
@@ -1739,11 +2313,33 @@ public:
             return false;
         }
 
+        // --------------------------------------------------------------------------------------------------------
+        // Get previous block (pipelined mode)
+
+        const bool hasPrevBlock(__atomic_load_n(&fProcPending, __ATOMIC_ACQUIRE));
+
+        if (fPipelined && ! waitForPendingProcess(true))
+        {
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+                FloatVectorOperations::clear(audioOut[i], static_cast<int>(frames));
+            for (uint32_t i=0; i < pData->cvOut.count; ++i)
+                FloatVectorOperations::clear(cvOut[i], static_cast<int>(frames));
+
+            pData->singleMutex.unlock();
+            return false;
+        }
+
         // --------------------------------------------------------------------------------------------------------
         // Reset audio buffers
 
+        // nothing to copy if the engine gave us our own pool buffers
         for (uint32_t i=0; i < fInfo.aIns; ++i)
-            FloatVectorOperations::copy(fShmAudioPool.data + (i * frames), audioIn[i], static_cast<int>(frames));
+        {
+            float* const poolBuf(getAudioPoolBuffer(i));
+
+            if (audioIn[i] != poolBuf)
+                FloatVectorOperations::copy(poolBuf, audioIn[i], static_cast<int>(frames));
+        }
 
         // --------------------------------------------------------------------------------------------------------
         // TimeInfo
@@ -1778,6 +2374,9 @@ public:
             fShmRtClientControl.commitWrite();
         }
 
+        if (fPipelined)
+            return processPipelined(audioIn, audioOut, frames, hasPrevBlock);
+
         waitForClient("process", 1);
 
         if (fTimedOut)
@@ -1787,75 +2386,74 @@ public:
         }
 
         for (uint32_t i=0; i < fInfo.aOuts; ++i)
-            FloatVectorOperations::copy(audioOut[i], fShmAudioPool.data + ((i + fInfo.aIns) * frames), static_cast<int>(frames));
+        {
+            const float* const poolBuf(getAudioPoolBuffer(i + fInfo.aIns));
+
+            if (audioOut[i] != poolBuf)
+                FloatVectorOperations::copy(audioOut[i], poolBuf, static_cast<int>(frames));
+        }
 
 #ifndef BUILD_BRIDGE
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (dry/wet, volume and balance)
 
-        {
-            const bool doVolume  = (pData->hints & PLUGIN_CAN_VOLUME) != 0 && ! carla_compareFloats(pData->postProc.volume, 1.0f);
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && ! carla_compareFloats(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_compareFloats(pData->postProc.balanceLeft, -1.0f) && carla_compareFloats(pData->postProc.balanceRight, 1.0f));
+        pData->postProc.process(pData->hints, audioIn, pData->audioIn.count, audioOut, pData->audioOut.count, 0, frames);
 
-            bool isPair;
-            float bufValue, oldBufLeft[doBalance ? frames : 1];
+#endif // BUILD_BRIDGE
 
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        bufValue        = audioIn[(pData->audioIn.count == 1) ? 0 : i][k];
-                        audioOut[i][k] = (audioOut[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
+        // --------------------------------------------------------------------------------------------------------
 
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
+        pData->singleMutex.unlock();
+        return true;
+    }
 
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        FloatVectorOperations::copy(oldBufLeft, audioOut[i], static_cast<int>(frames));
-                    }
+    bool processPipelined(const float** const audioIn, float** const audioOut, const uint32_t frames, const bool hasPrevBlock)
+    {
+        // take the previous block out of shared memory before the client starts writing over it
+        if (hasPrevBlock)
+        {
+            for (uint32_t i=0; i < fInfo.aOuts; ++i)
+                FloatVectorOperations::copy(audioOut[i], getAudioPoolBuffer(i + fInfo.aIns), static_cast<int>(frames));
 
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
+            std::memcpy(fPipelinedMidiOut, fShmRtClientControl.data->midiOut, kBridgeRtClientDataMidiOutSize);
+        }
+        else
+        {
+            for (uint32_t i=0; i < fInfo.aOuts; ++i)
+                FloatVectorOperations::clear(audioOut[i], static_cast<int>(frames));
 
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            audioOut[i][k]  = oldBufLeft[k]     * (1.0f - balRangeL);
-                            audioOut[i][k] += audioOut[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            audioOut[i][k]  = audioOut[i][k] * balRangeR;
-                            audioOut[i][k] += oldBufLeft[k]   * balRangeL;
-                        }
-                    }
-                }
+            carla_zeroBytes(fPipelinedMidiOut, kBridgeRtClientDataMidiOutSize);
+        }
 
-                // Volume (and buffer copy)
-                if (doVolume)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k] *= pData->postProc.volume;
-                }
-            }
+        if (fGroup != nullptr)
+            fGroupBlock = fGroup->queueBlock();
+        else
+            fShmRtClientControl.postServer();
+
+        __atomic_store_n(&fProcPending, true, __ATOMIC_RELEASE);
+
+        // dry signal is the input delayed by one buffer size, never shorter than this block,
+        // so its oldest frames are the delayed input as-is
+        const bool hasDelayedInput(pData->latency.frames >= frames && pData->latency.channels == fInfo.aIns);
 
-        } // End of Post-processing
+#ifndef BUILD_BRIDGE
+        // --------------------------------------------------------------------------------------------------------
+        // Post-processing (dry/wet, volume and balance)
+
+        pData->postProc.process(pData->hints, hasDelayedInput ? pData->latency.buffers : audioIn, pData->audioIn.count,
+                                audioOut, pData->audioOut.count, 0, frames);
 
 #endif // BUILD_BRIDGE
 
+        // --------------------------------------------------------------------------------------------------------
+        // Save latency values for next callback
+
+        if (hasDelayedInput)
+        {
+            for (uint32_t i=0; i < fInfo.aIns; ++i)
+                carla_updatePostProcDelay(pData->latency.buffers[i], pData->latency.frames, audioIn[i], frames);
+        }
+
         // --------------------------------------------------------------------------------------------------------
 
         pData->singleMutex.unlock();
@@ -1864,6 +2462,9 @@ public:
 
     void bufferSizeChanged(const uint32_t newBufferSize) override
     {
+        // the pending block is lost with the old audio pool
+        waitForPendingProcess();
+
         resizeAudioPool(newBufferSize);
 
         {
@@ -1874,6 +2475,16 @@ public:
         }
 
         waitForClient("buffersize", 1);
+
+        if (fPipelined)
+        {
+            // the latency is one block, follow the new size
+            if (pData->latency.channels != fInfo.aIns || pData->latency.frames != newBufferSize)
+                pData->latency.recreateBuffers(fInfo.aIns, newBufferSize);
+
+            if (pData->client != nullptr)
+                pData->client->setLatency(newBufferSize);
+        }
     }
 
     void sampleRateChanged(const double newSampleRate) override
@@ -1913,6 +2524,25 @@ public:
         CarlaPlugin::clearBuffers();
     }
 
+    float* getAudioPortBuffer(const bool isInput, const uint32_t index) const noexcept override
+    {
+        // in pipelined mode the client writes over the pool while we return the previous block
+        if (fPipelined || fShmAudioPool.data == nullptr)
+            return nullptr;
+
+        if (isInput)
+            return index < fInfo.aIns ? getAudioPoolBuffer(index) : nullptr;
+
+        return index < fInfo.aOuts ? getAudioPoolBuffer(index + fInfo.aIns) : nullptr;
+    }
+
+    // audio pool layout, same as in the bridge client: one engine buffer size per port, inputs first.
+    // blocks smaller than the buffer size use the start of each port buffer.
+    float* getAudioPoolBuffer(const uint32_t index) const noexcept
+    {
+        return fShmAudioPool.data + (index * pData->engine->getBufferSize());
+    }
+
     // -------------------------------------------------------------------
     // Post-poned UI Stuff
 
@@ -2315,50 +2945,15 @@ public:
                 CarlaPlugin::setCustomData(type, key, value, false);
             }   break;
 
-            case kPluginBridgeNonRtServerSetChunkDataFile: {
-                // uint/size, str[] (filename)
-
-                // chunkFilePath
-                const uint32_t chunkFilePathSize(fShmNonRtServerControl.readUInt());
-                char chunkFilePath[chunkFilePathSize+1];
-                carla_zeroChar(chunkFilePath, chunkFilePathSize+1);
-                fShmNonRtServerControl.readCustomData(chunkFilePath, chunkFilePathSize);
-
-                String realChunkFilePath(chunkFilePath);
-                carla_stdout("chunk save path BEFORE => %s", realChunkFilePath.toRawUTF8());
+            case kPluginBridgeNonRtServerSetChunkData: {
+                // ulong/total, ulong/offset, ulong/size
+                const uint64_t total(fShmNonRtServerControl.readULong());
+                const uint64_t offset(fShmNonRtServerControl.readULong());
+                const uint64_t size(fShmNonRtServerControl.readULong());
 
-#ifndef CARLA_OS_WIN
-                // Using Wine, fix temp dir
-                if (fBinaryType == BINARY_WIN32 || fBinaryType == BINARY_WIN64)
-                {
-                    // Get WINEPREFIX
-                    String wineDir;
-                    if (const char* const WINEPREFIX = getenv("WINEPREFIX"))
-                        wineDir = String(WINEPREFIX);
-                    else
-                        wineDir = File::getSpecialLocation(File::userHomeDirectory).getFullPathName() + "/.wine";
-
-                    const StringArray driveLetterSplit(StringArray::fromTokens(realChunkFilePath, ":/", ""));
-
-                    realChunkFilePath  = wineDir;
-                    realChunkFilePath += "/drive_";
-                    realChunkFilePath += driveLetterSplit[0].toLowerCase();
-                    realChunkFilePath += "/";
-                    realChunkFilePath += driveLetterSplit[1];
-
-                    realChunkFilePath  = realChunkFilePath.replace("\\", "/");
-                    carla_stdout("chunk save path AFTER => %s", realChunkFilePath.toRawUTF8());
-                }
-#endif
-
-                File chunkFile(realChunkFilePath);
-
-                if (chunkFile.existsAsFile())
-                {
-                    fInfo.chunk = carla_getChunkFromBase64String(chunkFile.loadFileAsString().toRawUTF8());
-                    chunkFile.deleteFile();
-                    carla_stderr("chunk data final");
-                }
+                // client waits for the pool to be free before sending the next piece
+                readChunkData(total, offset, size);
+                carla_chunk_pool_release(fShmNonRtClientControl.data->chunkPool);
             }   break;
 
             case kPluginBridgeNonRtServerSetLatency: {
@@ -2408,6 +3003,9 @@ public:
 
     uintptr_t getUiBridgeProcessId() const noexcept override
     {
+        if (fGroup != nullptr)
+            return fGroup->getProcessPID();
+
         return fBridgeThread.getProcessPID();
     }
 
@@ -2450,6 +3048,7 @@ public:
 
         fUniqueId     = uniqueId;
         fBridgeBinary = bridgeBinary;
+        fPipelined    = pData->engine->getOptions().pipelinedBridges;
 
         std::srand(static_cast<uint>(std::time(nullptr)));
 
@@ -2486,6 +3085,19 @@ public:
             return false;
         }
 
+        if (! fShmChunkPool.initialize(fShmAudioPool.filename))
+        {
+            carla_stdout("Failed to initialize shared memory chunk pool");
+            fShmNonRtServerControl.clear();
+            fShmNonRtClientControl.clear();
+            fShmRtClientControl.clear();
+            fShmAudioPool.clear();
+            return false;
+        }
+
+        fShmNonRtClientControl.data->chunkPool.size = fShmChunkPool.size;
+        fShmNonRtClientControl.data->chunkPool.busy = 0;
+
         // ---------------------------------------------------------------
 
         carla_stdout("Carla Server Info:");
@@ -2517,29 +3129,43 @@ public:
             std::strncpy(shmIdsStr+6*2, &fShmNonRtClientControl.filename[fShmNonRtClientControl.filename.length()-6], 6);
             std::strncpy(shmIdsStr+6*3, &fShmNonRtServerControl.filename[fShmNonRtServerControl.filename.length()-6], 6);
 
-            fBridgeThread.setData(bridgeBinary, label, shmIdsStr);
-            fBridgeThread.startThread();
+            if ((pData->engine->getOptions().groupedBridges & (1U << fBinaryType)) != 0)
+            {
+                if (! joinGroup(bridgeBinary))
+                {
+                    pData->engine->setLastError("Failed to start plugin bridge group");
+                    return false;
+                }
+
+                fGroup->addMember(shmIdsStr, fPluginType, filename, name, label, uniqueId);
+            }
+            else
+            {
+                fBridgeThread.setData(bridgeBinary, label, shmIdsStr);
+                fBridgeThread.startThread();
+            }
         }
 
         fInitiated = false;
         fLastPongTime = Time::currentTimeMillis();
         CARLA_SAFE_ASSERT(fLastPongTime > 0);
 
+        // project loader threads can start several bridges at once
         static bool sFirstInit = true;
 
         int64_t timeoutEnd = 5000;
 
-        if (sFirstInit)
+        if (__atomic_exchange_n(&sFirstInit, false, __ATOMIC_ACQ_REL))
             timeoutEnd *= 2;
 #ifndef CARLA_OS_WIN
          if (fBinaryType == BINARY_WIN32 || fBinaryType == BINARY_WIN64)
             timeoutEnd *= 2;
 #endif
-        sFirstInit = false;
 
-        const bool needsEngineIdle = pData->engine->getType() != kEngineTypePlugin;
+        // no engine idle while loading a project in another thread, this plugin is not part of it yet
+        const bool needsEngineIdle = pData->engine->getType() != kEngineTypePlugin && ! pData->engine->isPluginLoaderThread();
 
-        for (; Time::currentTimeMillis() < fLastPongTime + timeoutEnd && fBridgeThread.isThreadRunning();)
+        for (; Time::currentTimeMillis() < fLastPongTime + timeoutEnd && isBridgeRunning();)
         {
             pData->engine->callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
 
@@ -2598,15 +3224,25 @@ private:
     bool fTimedOut;
     bool fTimedError;
 
+    // pipelined mode, process() returns the previous block while the client runs the current one
+    bool fPipelined;
+    bool fProcPending; // also read from non-RT calls, use __atomic loads/stores
+    uint8_t fPipelinedMidiOut[kBridgeRtClientDataMidiOutSize];
+
     int64_t fLastPongTime;
 
     CarlaString             fBridgeBinary;
     CarlaPluginBridgeThread fBridgeThread;
 
+    // grouped mode, the bridge process is shared with other plugins and fBridgeThread is unused
+    CarlaPluginBridgeGroup* fGroup;
+    uint64_t fGroupBlock;
+
     BridgeAudioPool          fShmAudioPool;
     BridgeRtClientControl    fShmRtClientControl;
     BridgeNonRtClientControl fShmNonRtClientControl;
     BridgeNonRtServerControl fShmNonRtServerControl;
+    BridgeChunkPool          fShmChunkPool;
 
     struct Info {
         uint32_t aIns, aOuts;
@@ -2652,12 +3288,59 @@ private:
         waitForClient("resize-pool");
     }
 
+    bool isBridgeRunning() const noexcept
+    {
+        if (fGroup != nullptr)
+            return fGroup->isRunning();
+
+        return fBridgeThread.isThreadRunning();
+    }
+
+    // uses the group of another bridge with the same binary, or starts a new one
+    bool joinGroup(const char* const bridgeBinary)
+    {
+        CarlaEngine* const engine(pData->engine);
+
+        for (uint i=0, count=engine->getCurrentPluginCount(); i < count; ++i)
+        {
+            CarlaPlugin* const plugin(engine->getPlugin(i));
+
+            if (plugin == nullptr || plugin == this || (plugin->getHints() & PLUGIN_IS_BRIDGE) == 0)
+                continue;
+
+            CarlaPluginBridge* const bridge((CarlaPluginBridge*)plugin);
+
+            if (bridge->fGroup != nullptr && bridge->fGroup->matches(fBinaryType, bridgeBinary))
+            {
+                fGroup = bridge->fGroup;
+                break;
+            }
+        }
+
+        if (fGroup == nullptr)
+        {
+            CarlaPluginBridgeGroup* const group(new CarlaPluginBridgeGroup(engine, fBinaryType, bridgeBinary));
+
+            if (! group->start())
+            {
+                delete group;
+                return false;
+            }
+
+            fGroup = group;
+        }
+
+        // blocks are only sent once every member has queued its own
+        fPipelined = true;
+        return true;
+    }
+
     void waitForClient(const char* const action, const uint secs = 5)
     {
         CARLA_SAFE_ASSERT_RETURN(! fTimedOut,);
         CARLA_SAFE_ASSERT_RETURN(! fTimedError,);
 
-        if (fShmRtClientControl.waitForClient(secs, &fTimedOut))
+        if (fGroup != nullptr ? fGroup->sync(secs, fTimedOut) : fShmRtClientControl.waitForClient(secs, &fTimedOut))
             return;
 
         if (fTimedOut)
@@ -2671,6 +3354,107 @@ private:
         }
     }
 
+    // waits for the client to finish reading the last chunk we sent, or sending us one, then takes the pool
+    bool claimChunkPool() noexcept
+    {
+        BridgeChunkPoolState& chunkPool(fShmNonRtClientControl.data->chunkPool);
+
+        for (int i=500; --i >= 0;)
+        {
+            if (carla_chunk_pool_claim(chunkPool))
+                return true;
+            if (fTimedError || ! isBridgeRunning())
+                break;
+            carla_msleep(20);
+        }
+
+        carla_stderr("claimChunkPool() - timeout while waiting for client");
+        return false;
+    }
+
+    // receives a piece of the plugin chunk, and grows the pool if the rest does not fit
+    void readChunkData(const uint64_t total, const uint64_t offset, const uint64_t size)
+    {
+        CARLA_SAFE_ASSERT_RETURN(size > 0 && size <= fShmChunkPool.size,);
+        CARLA_SAFE_ASSERT_RETURN(offset + size <= total,);
+
+        if (offset == 0)
+            fInfo.chunk.resize(static_cast<std::size_t>(total));
+
+        CARLA_SAFE_ASSERT_RETURN(fInfo.chunk.size() == total,);
+
+        std::memcpy(fInfo.chunk.data() + offset, fShmChunkPool.data, static_cast<std::size_t>(size));
+
+        carla_debug("CarlaPluginBridge::readChunkData() - " P_UINT64 " of " P_UINT64 " bytes received", offset + size, total);
+
+        const uint64_t remaining(total - offset - size);
+
+        if (remaining > fShmChunkPool.size && fShmChunkPool.resize(static_cast<std::size_t>(remaining)))
+            fShmNonRtClientControl.data->chunkPool.size = fShmChunkPool.size;
+    }
+
+    // waits for the block started by the last processPipelined() call, if any.
+    // called from the audio thread, or with the process lock held.
+    // grouped bridges may be busy with a non-RT sync, the audio thread then gets false and the block stays pending.
+    bool waitForPendingProcess(const bool fromRT = false) noexcept
+    {
+        if (! __atomic_load_n(&fProcPending, __ATOMIC_ACQUIRE))
+            return true;
+
+        if (fTimedOut || fTimedError)
+        {
+            __atomic_store_n(&fProcPending, false, __ATOMIC_RELEASE);
+            return false;
+        }
+
+        if (fGroup != nullptr)
+        {
+            bool timedOut = false;
+
+            if (fGroup->waitForBlock(fGroupBlock, 1, timedOut, fromRT))
+            {
+                __atomic_store_n(&fProcPending, false, __ATOMIC_RELEASE);
+                return true;
+            }
+
+            // busy, try again on the next cycle
+            if (fromRT && ! timedOut)
+                return false;
+
+            __atomic_store_n(&fProcPending, false, __ATOMIC_RELEASE);
+
+            if (timedOut)
+            {
+                fTimedOut = true;
+                carla_stderr("waitForClient(process) timeout here");
+            }
+            else
+            {
+                fTimedError = true;
+                carla_stderr("waitForClient(process) error while waiting");
+            }
+
+            return false;
+        }
+
+        __atomic_store_n(&fProcPending, false, __ATOMIC_RELEASE);
+
+        if (fShmRtClientControl.waitForClientPost(1, &fTimedOut))
+            return true;
+
+        if (fTimedOut)
+        {
+            carla_stderr("waitForClient(process) timeout here");
+        }
+        else
+        {
+            fTimedError = true;
+            carla_stderr("waitForClient(process) error while waiting");
+        }
+
+        return false;
+    }
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginBridge)
 };
 
@@ -142,7 +142,8 @@ void PluginCVData::initBuffers() const noexcept
 
 PluginEventData::PluginEventData() noexcept
     : portIn(nullptr),
-      portOut(nullptr) {}
+      portOut(nullptr),
+      hasExtraPorts(false) {}
 
 PluginEventData::~PluginEventData() noexcept
 {
@@ -163,6 +164,8 @@ void PluginEventData::clear() noexcept
         delete portOut;
         portOut = nullptr;
     }
+
+    hasExtraPorts = false;
 }
 
 void PluginEventData::initBuffers() const noexcept
@@ -174,6 +177,115 @@ void PluginEventData::initBuffers() const noexcept
         portOut->initBuffer();
 }
 
+// -----------------------------------------------------------------------
+// PluginParameterQueue
+
+PluginParameterQueue::PluginParameterQueue() noexcept
+    : count(0),
+      mask(0),
+      values(nullptr),
+      pending(nullptr),
+      slots(nullptr),
+      readPos(0),
+      writePos(0) {}
+
+PluginParameterQueue::~PluginParameterQueue() noexcept
+{
+    CARLA_SAFE_ASSERT_INT(count == 0, count);
+    CARLA_SAFE_ASSERT(values == nullptr);
+    CARLA_SAFE_ASSERT(pending == nullptr);
+    CARLA_SAFE_ASSERT(slots == nullptr);
+}
+
+void PluginParameterQueue::createNew(const uint32_t newCount)
+{
+    CARLA_SAFE_ASSERT_INT(count == 0, count);
+    CARLA_SAFE_ASSERT_RETURN(values == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(pending == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(slots == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(newCount > 0,);
+
+    // every parameter fits at once, power of 2 so positions can wrap around
+    uint32_t size = 1;
+    while (size < newCount)
+        size *= 2;
+
+    values = new float[newCount];
+    carla_zeroStruct(values, newCount);
+
+    pending = new bool[newCount];
+    carla_zeroStruct(pending, newCount);
+
+    slots = new uint32_t[size];
+    carla_zeroStruct(slots, size);
+
+    readPos  = 0;
+    writePos = 0;
+    mask     = size-1;
+    count    = newCount;
+}
+
+void PluginParameterQueue::clear() noexcept
+{
+    if (values != nullptr)
+    {
+        delete[] values;
+        values = nullptr;
+    }
+
+    if (pending != nullptr)
+    {
+        delete[] pending;
+        pending = nullptr;
+    }
+
+    if (slots != nullptr)
+    {
+        delete[] slots;
+        slots = nullptr;
+    }
+
+    count = 0;
+    mask  = 0;
+}
+
+bool PluginParameterQueue::post(const uint32_t parameterId, const float value) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(parameterId < count, false);
+
+    __atomic_store(&values[parameterId], &value, __ATOMIC_SEQ_CST);
+
+    // already queued, the audio thread will read the new value
+    if (__atomic_exchange_n(&pending[parameterId], true, __ATOMIC_SEQ_CST))
+        return true;
+
+    // at most 'count' parameters are pending, so this slot is free
+    const uint32_t pos(__atomic_fetch_add(&writePos, 1, __ATOMIC_RELAXED));
+    __atomic_store_n(&slots[pos & mask], parameterId+1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool PluginParameterQueue::get(uint32_t& parameterId, float& value) noexcept
+{
+    if (count == 0)
+        return false;
+
+    uint32_t& slot(slots[readPos & mask]);
+    const uint32_t id(__atomic_load_n(&slot, __ATOMIC_ACQUIRE));
+
+    if (id == 0)
+        return false;
+
+    __atomic_store_n(&slot, 0U, __ATOMIC_RELAXED);
+    ++readPos;
+
+    // clear before reading, so a write from now on queues the parameter again
+    parameterId = id-1;
+    __atomic_store_n(&pending[parameterId], false, __ATOMIC_SEQ_CST);
+    __atomic_load(&values[parameterId], &value, __ATOMIC_SEQ_CST);
+    return true;
+}
+
 // -----------------------------------------------------------------------
 // PluginParameterData
 
@@ -181,7 +293,8 @@ PluginParameterData::PluginParameterData() noexcept
     : count(0),
       data(nullptr),
       ranges(nullptr),
-      special(nullptr) {}
+      special(nullptr),
+      queue() {}
 
 PluginParameterData::~PluginParameterData() noexcept
 {
@@ -218,6 +331,8 @@ void PluginParameterData::createNew(const uint32_t newCount, const bool withSpec
         carla_zeroStruct(special, newCount);
     }
 
+    queue.createNew(newCount);
+
     count = newCount;
 }
 
@@ -241,6 +356,8 @@ void PluginParameterData::clear() noexcept
         special = nullptr;
     }
 
+    queue.clear();
+
     count = 0;
 }
 
@@ -469,8 +586,9 @@ void CarlaPlugin::ProtectedData::Latency::recreateBuffers(const uint32_t newChan
 // -----------------------------------------------------------------------
 // ProtectedData::PostRtEvents
 
-CarlaPlugin::ProtectedData::PostRtEvents::PostRtEvents() noexcept
-    : mutex(),
+CarlaPlugin::ProtectedData::PostRtEvents::PostRtEvents(CarlaEngine* const eng) noexcept
+    : engine(eng),
+      mutex(),
       dataPool(128, 128),
       data(dataPool),
       dataPendingRT(dataPool) {}
@@ -489,9 +607,15 @@ void CarlaPlugin::ProtectedData::PostRtEvents::trySplice() noexcept
 {
     if (mutex.tryLock())
     {
-        if (dataPendingRT.count() > 0)
+        const bool hasEvents(dataPendingRT.count() > 0);
+
+        if (hasEvents)
             dataPendingRT.moveTo(data, true);
         mutex.unlock();
+
+        // let the engine thread handle them now instead of on its next timeout
+        if (hasEvents)
+            engine->wakeIdleThread();
     }
 }
 
@@ -538,7 +662,65 @@ CarlaPlugin::ProtectedData::PostProc::PostProc() noexcept
       volume(1.0f),
       balanceLeft(-1.0f),
       balanceRight(1.0f),
-      panning(0.0f) {}
+      panning(0.0f)
+{
+    last.dryWet       = 1.0f;
+    last.volume       = 1.0f;
+    last.balanceLeft  = -1.0f;
+    last.balanceRight = 1.0f;
+}
+
+void CarlaPlugin::ProtectedData::PostProc::process(const uint hints, const float* const* const inBuffers, const uint32_t inCount,
+                                                   float* const* const outBuffers, const uint32_t outCount, const uint32_t offset, const uint32_t frames,
+                                                   float* const* const copyBuffers, const uint32_t copyOffset) noexcept
+{
+    if (frames == 0 || outCount == 0)
+        return;
+
+    // read values once, they can change from other threads
+    CarlaPostProcValues target;
+    target.dryWet       = (hints & PLUGIN_CAN_DRYWET)  != 0 ? dryWet       :  1.0f;
+    target.volume       = (hints & PLUGIN_CAN_VOLUME)  != 0 ? volume       :  1.0f;
+    target.balanceLeft  = (hints & PLUGIN_CAN_BALANCE) != 0 ? balanceLeft  : -1.0f;
+    target.balanceRight = (hints & PLUGIN_CAN_BALANCE) != 0 ? balanceRight :  1.0f;
+
+    const CarlaPostProcValues from(last);
+    last = target;
+
+    if (carla_isPostProcNeutral(from) && carla_isPostProcNeutral(target))
+    {
+        if (copyBuffers != nullptr)
+        {
+            for (uint32_t i=0; i < outCount; ++i)
+                carla_copyFloat(copyBuffers[i]+copyOffset, outBuffers[i]+offset, frames);
+        }
+        return;
+    }
+
+    const bool doBalance = ! (carla_compareFloats(from.balanceLeft,   -1.0f) && carla_compareFloats(from.balanceRight,   1.0f) &&
+                              carla_compareFloats(target.balanceLeft, -1.0f) && carla_compareFloats(target.balanceRight, 1.0f));
+
+    for (uint32_t i=0; i < outCount; ++i)
+    {
+        const float* const wetL(outBuffers[i]+offset);
+        const float* const dryL(inCount == 1 ? inBuffers[0]+offset : (i < inCount ? inBuffers[i]+offset : wetL));
+        float* const outL(copyBuffers != nullptr ? copyBuffers[i]+copyOffset : outBuffers[i]+offset);
+
+        if (doBalance && i+1 < outCount)
+        {
+            const float* const wetR(outBuffers[i+1]+offset);
+            const float* const dryR(inCount == 1 ? inBuffers[0]+offset : (i+1 < inCount ? inBuffers[i+1]+offset : wetR));
+            float* const outR(copyBuffers != nullptr ? copyBuffers[i+1]+copyOffset : outBuffers[i+1]+offset);
+
+            carla_postProcessStereo(dryL, dryR, wetL, wetR, outL, outR, frames, from, target);
+            ++i;
+        }
+        else
+        {
+            carla_postProcessMono(dryL, wetL, outL, frames, from, target);
+        }
+    }
+}
 #endif
 
 // -----------------------------------------------------------------------
@@ -550,6 +732,7 @@ CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx
       hints(0x0),
       options(0x0),
       nodeId(0),
+      rackLane(0),
       active(false),
       enabled(false),
       needsReset(false),
@@ -575,7 +758,7 @@ CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx
       stateSave(),
       extNotes(),
       latency(),
-      postRtEvents(),
+      postRtEvents(eng),
       postUiEvents(),
 #ifndef BUILD_BRIDGE
       postProc(),
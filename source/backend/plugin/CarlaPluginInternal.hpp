@@ -25,6 +25,7 @@
 
 #include "CarlaMIDI.h"
 #include "CarlaMutex.hpp"
+#include "CarlaPostProcUtils.hpp"
 #include "CarlaString.hpp"
 #include "RtLinkedList.hpp"
 
@@ -151,6 +152,7 @@ struct PluginCVData {
 struct PluginEventData {
     CarlaEngineEventPort* portIn;
     CarlaEngineEventPort* portOut;
+    bool hasExtraPorts; // plugin uses event ports other than the 2 above
 
     PluginEventData() noexcept;
     ~PluginEventData() noexcept;
@@ -160,6 +162,30 @@ struct PluginEventData {
     CARLA_DECLARE_NON_COPY_STRUCT(PluginEventData)
 };
 
+// -----------------------------------------------------------------------
+// Parameter changes from control threads to the audio thread.
+// Any thread can post, only the audio thread gets. Each parameter is queued at most once,
+// a new value for a parameter that is still pending replaces the old one.
+
+struct PluginParameterQueue {
+    uint32_t count;
+    uint32_t mask;
+    float* values;
+    bool* pending;
+    uint32_t* slots; // parameter index + 1, 0 while empty or not yet published
+    uint32_t readPos;
+    uint32_t writePos;
+
+    PluginParameterQueue() noexcept;
+    ~PluginParameterQueue() noexcept;
+    void createNew(const uint32_t newCount);
+    void clear() noexcept;
+    bool post(const uint32_t parameterId, const float value) noexcept;
+    bool get(uint32_t& parameterId, float& value) noexcept;
+
+    CARLA_DECLARE_NON_COPY_STRUCT(PluginParameterQueue)
+};
+
 // -----------------------------------------------------------------------
 
 struct PluginParameterData {
@@ -167,6 +193,7 @@ struct PluginParameterData {
     ParameterData* data;
     ParameterRanges* ranges;
     SpecialParameterType* special;
+    PluginParameterQueue queue;
 
     PluginParameterData() noexcept;
     ~PluginParameterData() noexcept;
@@ -220,6 +247,7 @@ struct CarlaPlugin::ProtectedData {
     uint hints;
     uint options;
     uint32_t nodeId;
+    uint rackLane;
 
     bool active;
     bool enabled;
@@ -283,12 +311,13 @@ struct CarlaPlugin::ProtectedData {
     } latency;
 
     struct PostRtEvents {
+        CarlaEngine* const engine;
         CarlaMutex mutex;
         RtLinkedList<PluginPostRtEvent>::Pool dataPool;
         RtLinkedList<PluginPostRtEvent> data;
         RtLinkedList<PluginPostRtEvent> dataPendingRT;
 
-        PostRtEvents() noexcept;
+        PostRtEvents(CarlaEngine* const eng) noexcept;
         ~PostRtEvents() noexcept;
         void appendRT(const PluginPostRtEvent& event) noexcept;
         void trySplice() noexcept;
@@ -319,8 +348,18 @@ struct CarlaPlugin::ProtectedData {
         float balanceRight;
         float panning;
 
+        // values at the end of the last processed block, the next one ramps from these
+        CarlaPostProcValues last;
+
         PostProc() noexcept;
 
+        // RT, applies dry/wet, balance and volume to @a outBuffers (in place, or into @a copyBuffers if set).
+        // @a inBuffers is the dry signal, mono plugins use the 1st input for all outputs.
+        // @a offset applies to input and output buffers, @a copyOffset to the copy buffers.
+        void process(const uint hints, const float* const* const inBuffers, const uint32_t inCount,
+                     float* const* const outBuffers, const uint32_t outCount, const uint32_t offset, const uint32_t frames,
+                     float* const* const copyBuffers = nullptr, const uint32_t copyOffset = 0) noexcept;
+
         CARLA_DECLARE_NON_COPY_STRUCT(PostProc)
 
     } postProc;
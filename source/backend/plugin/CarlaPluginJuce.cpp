@@ -688,6 +688,11 @@ public:
             return;
         }
 
+        // --------------------------------------------------------------------------------------------------------
+        // Parameter changes from control threads
+
+        processParameterQueue();
+
         // --------------------------------------------------------------------------------------------------------
         // Check if needs reset
 
@@ -1012,11 +1017,18 @@ public:
 
         fInstance->processBlock(fAudioBuffer, fMidiBuffer);
 
+#ifndef BUILD_BRIDGE
+        // --------------------------------------------------------------------------------------------------------
+        // Post-processing (dry/wet, volume and balance), and set audio out buffers
+
+        pData->postProc.process(pData->hints, inBuffer, pData->audioIn.count, fAudioBuffer.getArrayOfWritePointers(), pData->audioOut.count, 0, frames, outBuffer, 0);
+#else
         // --------------------------------------------------------------------------------------------------------
         // Set audio out buffers
 
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
             FloatVectorOperations::copy(outBuffer[i], fAudioBuffer.getReadPointer(static_cast<int>(i)), static_cast<int>(frames));
+#endif
 
         // --------------------------------------------------------------------------------------------------------
         // Midi out
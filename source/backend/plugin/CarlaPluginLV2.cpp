@@ -29,6 +29,9 @@
 #include "CarlaPipeUtils.hpp"
 #include "CarlaPluginUI.hpp"
 #include "Lv2AtomRingBuffer.hpp"
+#include "Lv2RdfCache.hpp"
+#include "Lv2URIDMap.hpp"
+#include "Lv2Worker.hpp"
 
 #include "../engine/CarlaEngineOsc.hpp"
 
@@ -40,8 +43,6 @@ extern "C" {
 
 using juce::File;
 
-#define URI_CARLA_ATOM_WORKER "http://kxstudio.sf.net/ns/carla/atomWorker"
-
 CARLA_BACKEND_START_NAMESPACE
 
 // -----------------------------------------------------
@@ -49,6 +50,9 @@ CARLA_BACKEND_START_NAMESPACE
 // Maximum default buffer size
 const uint MAX_DEFAULT_BUFFER_SIZE = 8192; // 0x2000
 
+// Size of the worker request and response rings
+const uint32_t kWorkerBufferSize = 0x10000;
+
 // Extra Plugin Hints
 const uint PLUGIN_HAS_EXTENSION_OPTIONS  = 0x1000;
 const uint PLUGIN_HAS_EXTENSION_PROGRAMS = 0x2000;
@@ -67,56 +71,6 @@ const uint CARLA_EVENT_TYPE_MESSAGE = 0x10; // unused
 const uint CARLA_EVENT_TYPE_MIDI    = 0x20;
 const uint CARLA_EVENT_TYPE_TIME    = 0x40;
 
-// LV2 URI Map Ids
-const uint32_t CARLA_URI_MAP_ID_NULL                   =  0;
-const uint32_t CARLA_URI_MAP_ID_ATOM_BLANK             =  1;
-const uint32_t CARLA_URI_MAP_ID_ATOM_BOOL              =  2;
-const uint32_t CARLA_URI_MAP_ID_ATOM_CHUNK             =  3;
-const uint32_t CARLA_URI_MAP_ID_ATOM_DOUBLE            =  4;
-const uint32_t CARLA_URI_MAP_ID_ATOM_EVENT             =  5;
-const uint32_t CARLA_URI_MAP_ID_ATOM_FLOAT             =  6;
-const uint32_t CARLA_URI_MAP_ID_ATOM_INT               =  7;
-const uint32_t CARLA_URI_MAP_ID_ATOM_LITERAL           =  8;
-const uint32_t CARLA_URI_MAP_ID_ATOM_LONG              =  9;
-const uint32_t CARLA_URI_MAP_ID_ATOM_NUMBER            = 10;
-const uint32_t CARLA_URI_MAP_ID_ATOM_OBJECT            = 11;
-const uint32_t CARLA_URI_MAP_ID_ATOM_PATH              = 12;
-const uint32_t CARLA_URI_MAP_ID_ATOM_PROPERTY          = 13;
-const uint32_t CARLA_URI_MAP_ID_ATOM_RESOURCE          = 14;
-const uint32_t CARLA_URI_MAP_ID_ATOM_SEQUENCE          = 15;
-const uint32_t CARLA_URI_MAP_ID_ATOM_SOUND             = 16;
-const uint32_t CARLA_URI_MAP_ID_ATOM_STRING            = 17;
-const uint32_t CARLA_URI_MAP_ID_ATOM_TUPLE             = 18;
-const uint32_t CARLA_URI_MAP_ID_ATOM_URI               = 19;
-const uint32_t CARLA_URI_MAP_ID_ATOM_URID              = 20;
-const uint32_t CARLA_URI_MAP_ID_ATOM_VECTOR            = 21;
-const uint32_t CARLA_URI_MAP_ID_ATOM_TRANSFER_ATOM     = 22;
-const uint32_t CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT    = 23;
-const uint32_t CARLA_URI_MAP_ID_BUF_MAX_LENGTH         = 24;
-const uint32_t CARLA_URI_MAP_ID_BUF_MIN_LENGTH         = 25;
-const uint32_t CARLA_URI_MAP_ID_BUF_SEQUENCE_SIZE      = 26;
-const uint32_t CARLA_URI_MAP_ID_LOG_ERROR              = 27;
-const uint32_t CARLA_URI_MAP_ID_LOG_NOTE               = 28;
-const uint32_t CARLA_URI_MAP_ID_LOG_TRACE              = 29;
-const uint32_t CARLA_URI_MAP_ID_LOG_WARNING            = 30;
-const uint32_t CARLA_URI_MAP_ID_TIME_POSITION          = 31; // base type
-const uint32_t CARLA_URI_MAP_ID_TIME_BAR               = 32; // values
-const uint32_t CARLA_URI_MAP_ID_TIME_BAR_BEAT          = 33;
-const uint32_t CARLA_URI_MAP_ID_TIME_BEAT              = 34;
-const uint32_t CARLA_URI_MAP_ID_TIME_BEAT_UNIT         = 35;
-const uint32_t CARLA_URI_MAP_ID_TIME_BEATS_PER_BAR     = 36;
-const uint32_t CARLA_URI_MAP_ID_TIME_BEATS_PER_MINUTE  = 37;
-const uint32_t CARLA_URI_MAP_ID_TIME_FRAME             = 38;
-const uint32_t CARLA_URI_MAP_ID_TIME_FRAMES_PER_SECOND = 39;
-const uint32_t CARLA_URI_MAP_ID_TIME_SPEED             = 40;
-const uint32_t CARLA_URI_MAP_ID_TIME_TICKS_PER_BEAT    = 41;
-const uint32_t CARLA_URI_MAP_ID_MIDI_EVENT             = 42;
-const uint32_t CARLA_URI_MAP_ID_PARAM_SAMPLE_RATE      = 43;
-const uint32_t CARLA_URI_MAP_ID_UI_WINDOW_TITLE        = 44;
-const uint32_t CARLA_URI_MAP_ID_CARLA_ATOM_WORKER      = 45;
-const uint32_t CARLA_URI_MAP_ID_CARLA_TRANSIENT_WIN_ID = 46;
-const uint32_t CARLA_URI_MAP_ID_COUNT                  = 47;
-
 // LV2 Feature Ids
 const uint32_t kFeatureIdBufSizeBounded   =  0;
 const uint32_t kFeatureIdBufSizeFixed     =  1;
@@ -430,7 +384,12 @@ public:
         const ScopedEnvVar _sev2("LD_PRELOAD", nullptr);
 #endif
 
-        return CarlaPipeServer::startPipeServer(fFilename, fPluginURI, fUiURI);
+        if (! CarlaPipeServer::startPipeServer(fFilename, fPluginURI, fUiURI))
+            return false;
+
+        // falls back to text atoms if this fails or the UI doesn't know about it
+        offerLv2AtomRing();
+        return true;
     }
 
     void writeUiOptionsMessage(const double sampleRate, const bool useTheme, const bool useThemeColors, const char* const windowTitle, uintptr_t transientWindowId) const noexcept
@@ -477,6 +436,8 @@ protected:
     // returns true if msg was handled
     bool msgReceived(const char* const msg) noexcept override;
 
+    void lv2AtomReceived(const uint32_t index, const LV2_Atom* const atom) noexcept override;
+
 private:
     CarlaEngine*    const kEngine;
     CarlaPluginLV2* const kPlugin;
@@ -512,12 +473,13 @@ public:
           fLatencyIndex(-1),
           fAtomBufferIn(),
           fAtomBufferOut(),
+          fWorker(),
           fAtomForge(),
           fEventsIn(),
           fEventsOut(),
           fLv2Options(),
           fPipeServer(engine, this),
-          fCustomURIDs(),
+          fUiURIDsCount(CARLA_URI_MAP_ID_COUNT),
           fFirstActive(true),
           fLastStateChunk(nullptr),
           fLastTimeInfo(),
@@ -529,9 +491,6 @@ public:
 
         carla_zeroPointers(fFeatures, kFeatureCountAll+1);
 
-        for (uint32_t i=0; i < CARLA_URI_MAP_ID_COUNT; ++i)
-            fCustomURIDs.append(nullptr);
-
 #if defined(__clang__)
 # pragma clang diagnostic push
 # pragma clang diagnostic ignored "-Wdeprecated-declarations"
@@ -618,6 +577,9 @@ public:
             pData->active = false;
         }
 
+        // waits for work in progress
+        fWorker.stop();
+
         if (fDescriptor != nullptr)
         {
             if (fDescriptor->cleanup != nullptr)
@@ -684,16 +646,6 @@ public:
             }
         }
 
-        for (LinkedList<const char*>::Itenerator it = fCustomURIDs.begin(); it.valid(); it.next())
-        {
-            const char* const uri(it.getValue());
-
-            if (uri != nullptr)
-                delete[] uri;
-        }
-
-        fCustomURIDs.clear();
-
         if (fLastStateChunk != nullptr)
         {
             std::free(fLastStateChunk);
@@ -753,6 +705,19 @@ public:
         return static_cast<int64_t>(fRdfDescriptor->UniqueID);
     }
 
+    void getWorkerLoad(EngineDspLoad& load) const noexcept override
+    {
+        if (fExt.worker == nullptr)
+            return;
+
+        const Lv2WorkerStats stats(fWorker.getStats());
+
+        load.workerQueueDepth      = stats.queueDepth;
+        load.workerMaxQueueDepth   = stats.maxQueueDepth;
+        load.workerMaxLatencyUsecs = static_cast<float>(stats.maxLatency);
+        load.workerDropped         = stats.dropped;
+    }
+
     // -------------------------------------------------------------------
     // Information (count)
 
@@ -1267,8 +1232,8 @@ public:
                     return;
                 }
 
-                for (std::size_t i=CARLA_URI_MAP_ID_COUNT, count=fCustomURIDs.count(); i < count; ++i)
-                    fPipeServer.writeLv2UridMessage(static_cast<uint32_t>(i), fCustomURIDs.getAt(i, nullptr));
+                fUiURIDsCount = CARLA_URI_MAP_ID_COUNT;
+                writeNewURIDsToUi();
 
                 fPipeServer.writeUiOptionsMessage(pData->engine->getSampleRate(), true, true, fLv2Options.windowTitle, frontendWinId);
 
@@ -1471,6 +1436,10 @@ public:
 
     void uiIdle() override
     {
+        // atoms below might use URIDs the UI does not know yet
+        if (fUI.type == UI::TYPE_BRIDGE && fPipeServer.isPipeRunning())
+            writeNewURIDsToUi();
+
         if (fAtomBufferOut.isDataAvailableForReading())
         {
             uint8_t dumpBuf[fAtomBufferOut.getSize()];
@@ -1485,12 +1454,7 @@ public:
 
             for (; tmpRingBuffer.get(atom, portIndex);)
             {
-                if (atom->type == CARLA_URI_MAP_ID_CARLA_ATOM_WORKER)
-                {
-                    CARLA_SAFE_ASSERT_CONTINUE(fExt.worker != nullptr && fExt.worker->work != nullptr);
-                    fExt.worker->work(fHandle, carla_lv2_worker_respond, this, atom->size, LV2_ATOM_BODY_CONST(atom));
-                }
-                else if (fUI.type == UI::TYPE_BRIDGE)
+                if (fUI.type == UI::TYPE_BRIDGE)
                 {
                     if (fPipeServer.isPipeRunning())
                         fPipeServer.writeLv2AtomMessage(portIndex, atom);
@@ -2310,10 +2274,10 @@ public:
             pData->event.portOut = (CarlaEngineEventPort*)pData->client->addPort(kEnginePortTypeEvent, portName, false, 0);
         }
 
-        if (fExt.worker != nullptr || (fUI.type != UI::TYPE_NULL && fEventsIn.count > 0 && (fEventsIn.data[0].type & CARLA_EVENT_DATA_ATOM) != 0))
+        if (fUI.type != UI::TYPE_NULL && fEventsIn.count > 0 && (fEventsIn.data[0].type & CARLA_EVENT_DATA_ATOM) != 0)
             fAtomBufferIn.createBuffer(eventBufferSize);
 
-        if (fExt.worker != nullptr || (fUI.type != UI::TYPE_NULL && fEventsOut.count > 0 && (fEventsOut.data[0].type & CARLA_EVENT_DATA_ATOM) != 0))
+        if (fUI.type != UI::TYPE_NULL && fEventsOut.count > 0 && (fEventsOut.data[0].type & CARLA_EVENT_DATA_ATOM) != 0)
             fAtomBufferOut.createBuffer(eventBufferSize);
 
         if (fEventsIn.ctrl != nullptr && fEventsIn.ctrl->port == nullptr)
@@ -2322,6 +2286,18 @@ public:
         if (fEventsOut.ctrl != nullptr && fEventsOut.ctrl->port == nullptr)
             fEventsOut.ctrl->port = pData->event.portOut;
 
+        for (uint32_t i=0; i < fEventsIn.count; ++i)
+        {
+            if (fEventsIn.data[i].port != nullptr && fEventsIn.data[i].port != pData->event.portIn)
+                pData->event.hasExtraPorts = true;
+        }
+
+        for (uint32_t i=0; i < fEventsOut.count; ++i)
+        {
+            if (fEventsOut.data[i].port != nullptr && fEventsOut.data[i].port != pData->event.portOut)
+                pData->event.hasExtraPorts = true;
+        }
+
         if (fCanInit2 && (forcedStereoIn || forcedStereoOut))
             pData->options |= PLUGIN_OPTION_FORCE_STEREO;
         else
@@ -2637,6 +2613,11 @@ public:
             return;
         }
 
+        // --------------------------------------------------------------------------------------------------------
+        // Parameter changes from control threads
+
+        processParameterQueue();
+
         // --------------------------------------------------------------------------------------------------------
         // Event itenerators from different APIs (input)
 
@@ -2932,12 +2913,7 @@ public:
                     {
                         j = (portIndex < fEventsIn.count) ? portIndex : fEventsIn.ctrlIndex;
 
-                        if (atom->type == CARLA_URI_MAP_ID_CARLA_ATOM_WORKER)
-                        {
-                            CARLA_SAFE_ASSERT_CONTINUE(fExt.worker != nullptr && fExt.worker->work_response != nullptr);
-                            fExt.worker->work_response(fHandle, atom->size, LV2_ATOM_BODY_CONST(atom));
-                        }
-                        else if (! lv2_atom_buffer_write(&evInAtomIters[j], 0, 0, atom->type, atom->size, LV2_ATOM_BODY_CONST(atom)))
+                        if (! lv2_atom_buffer_write(&evInAtomIters[j], 0, 0, atom->type, atom->size, LV2_ATOM_BODY_CONST(atom)))
                         {
                             carla_stdout("Event input buffer full, at least 1 message lost");
                             continue;
@@ -3509,11 +3485,13 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Final work
 
-        if (fExt.worker != nullptr && fExt.worker->end_run != nullptr)
+        // responses that arrived during this cycle, then end_run
+        if (fExt.worker != nullptr)
         {
-            fExt.worker->end_run(fHandle);
+            fWorker.processResponses();
 
-            if (fHandle2 != nullptr)
+            // the worker only serves the first instance, the second one still needs its end_run
+            if (fHandle2 != nullptr && fExt.worker->end_run != nullptr)
                 fExt.worker->end_run(fHandle2);
         }
 
@@ -3616,72 +3594,7 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (dry/wet, volume and balance)
 
-        {
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && ! carla_compareFloats(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_compareFloats(pData->postProc.balanceLeft, -1.0f) && carla_compareFloats(pData->postProc.balanceRight, 1.0f));
-            const bool isMono    = (pData->audioIn.count == 1);
-
-            bool isPair;
-            float bufValue, oldBufLeft[doBalance ? frames : 1];
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-#if 0 // TODO
-                        if (k < pData->latency)
-                            bufValue = pData->latencyBuffers[isMono ? 0 : i][k];
-                        else if (pData->latency < frames)
-                            bufValue = fAudioInBuffers[isMono ? 0 : i][k-pData->latency];
-                        else
-#endif
-                            bufValue = fAudioInBuffers[isMono ? 0 : i][k];
-
-                        fAudioOutBuffers[i][k] = (fAudioOutBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        FloatVectorOperations::copy(oldBufLeft, fAudioOutBuffers[i], static_cast<int>(frames));
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            fAudioOutBuffers[i][k]  = oldBufLeft[k]            * (1.0f - balRangeL);
-                            fAudioOutBuffers[i][k] += fAudioOutBuffers[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            fAudioOutBuffers[i][k]  = fAudioOutBuffers[i][k] * balRangeR;
-                            fAudioOutBuffers[i][k] += oldBufLeft[k]          * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k+timeOffset] = fAudioOutBuffers[i][k] * pData->postProc.volume;
-                }
-            }
-        } // End of Post-processing
+        pData->postProc.process(pData->hints, fAudioInBuffers, pData->audioIn.count, fAudioOutBuffers, pData->audioOut.count, 0, frames, audioOut, timeOffset);
 
 #else // BUILD_BRIDGE
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
@@ -4206,6 +4119,9 @@ public:
                 fExt.worker = nullptr;
         }
 
+        if (fExt.worker != nullptr)
+            fWorker.start(fHandle, fExt.worker, kWorkerBufferSize);
+
         CARLA_SAFE_ASSERT_RETURN(fLatencyIndex == -1,);
 
         for (uint32_t i=0, count=fRdfDescriptor->PortCount, iCtrl=0; i<count; ++i)
@@ -4259,36 +4175,13 @@ public:
 
     // -------------------------------------------------------------------
 
-    LV2_URID getCustomURID(const char* const uri)
+    // sends the URIDs mapped since the last call, by any plugin in this process
+    void writeNewURIDsToUi() noexcept
     {
-        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', CARLA_URI_MAP_ID_NULL);
-        carla_debug("CarlaPluginLV2::getCustomURID(\"%s\")", uri);
+        const Lv2URIDMap& uridMap(Lv2URIDMap::getInstance());
 
-        for (size_t i=0; i < fCustomURIDs.count(); ++i)
-        {
-            const char* const thisUri(fCustomURIDs.getAt(i, nullptr));
-            if (thisUri != nullptr && std::strcmp(thisUri, uri) == 0)
-                return static_cast<LV2_URID>(i);
-        }
-
-        const LV2_URID urid(static_cast<LV2_URID>(fCustomURIDs.count()));
-
-        fCustomURIDs.append(carla_strdup(uri));
-
-        if (fUI.type == UI::TYPE_BRIDGE && fPipeServer.isPipeRunning())
-            fPipeServer.writeLv2UridMessage(urid, uri);
-
-        return urid;
-    }
-
-    const char* getCustomURIDString(const LV2_URID urid) const noexcept
-    {
-        static const char* const sFallback = "urn:null";
-        CARLA_SAFE_ASSERT_RETURN(urid != CARLA_URI_MAP_ID_NULL, sFallback);
-        CARLA_SAFE_ASSERT_RETURN(urid < fCustomURIDs.count(), sFallback);
-        carla_debug("CarlaPluginLV2::getCustomURIString(%i)", urid);
-
-        return fCustomURIDs.getAt(urid, sFallback);
+        for (const uint32_t count = uridMap.getCount(); fUiURIDsCount < count; ++fUiURIDsCount)
+            fPipeServer.writeLv2UridMessage(fUiURIDsCount, uridMap.unmap(fUiURIDsCount));
     }
 
     // -------------------------------------------------------------------
@@ -4451,31 +4344,12 @@ public:
     LV2_Worker_Status handleWorkerSchedule(const uint32_t size, const void* const data)
     {
         CARLA_SAFE_ASSERT_RETURN(fExt.worker != nullptr && fExt.worker->work != nullptr, LV2_WORKER_ERR_UNKNOWN);
-        CARLA_SAFE_ASSERT_RETURN(fEventsIn.ctrl != nullptr, LV2_WORKER_ERR_UNKNOWN);
         carla_debug("CarlaPluginLV2::handleWorkerSchedule(%i, %p)", size, data);
 
         if (pData->engine->isOffline())
-        {
-            fExt.worker->work(fHandle, carla_lv2_worker_respond, this, size, data);
-            return LV2_WORKER_SUCCESS;
-        }
-
-        LV2_Atom atom;
-        atom.size = size;
-        atom.type = CARLA_URI_MAP_ID_CARLA_ATOM_WORKER;
+            return fWorker.workNow(size, data);
 
-        return fAtomBufferOut.putChunk(&atom, data, fEventsOut.ctrlIndex) ? LV2_WORKER_SUCCESS : LV2_WORKER_ERR_NO_SPACE;
-    }
-
-    LV2_Worker_Status handleWorkerRespond(const uint32_t size, const void* const data)
-    {
-        carla_debug("CarlaPluginLV2::handleWorkerRespond(%i, %p)", size, data);
-
-        LV2_Atom atom;
-        atom.size = size;
-        atom.type = CARLA_URI_MAP_ID_CARLA_ATOM_WORKER;
-
-        return fAtomBufferIn.putChunk(&atom, data, fEventsIn.ctrlIndex) ? LV2_WORKER_SUCCESS : LV2_WORKER_ERR_NO_SPACE;
+        return fWorker.schedule(size, data);
     }
 
     // -------------------------------------------------------------------
@@ -4561,7 +4435,7 @@ public:
             const float value(*(const float*)buffer);
 
             //if (! carla_compareFloats(fParamBuffers[index], value))
-            setParameterValue(index, value, false, true, true);
+            queueParameterValue(index, value, false, true, true);
 
         } break;
 
@@ -4700,19 +4574,19 @@ public:
         }
 
         // ---------------------------------------------------------------
-        // Init LV2 World if needed, sets LV2_PATH for lilv
+        // get plugin from the cache or lv2_rdf (lilv), loads the LV2 world only if needed
 
-        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
-
-        if (pData->engine->getOptions().pathLV2 != nullptr && pData->engine->getOptions().pathLV2[0] != '\0')
-            lv2World.initIfNeeded(pData->engine->getOptions().pathLV2);
-        else
-            lv2World.initIfNeeded(std::getenv("LV2_PATH"));
+        const char* const pathLV2((pData->engine->getOptions().pathLV2 != nullptr && pData->engine->getOptions().pathLV2[0] != '\0')
+                                  ? pData->engine->getOptions().pathLV2
+                                  : std::getenv("LV2_PATH"));
 
-        // ---------------------------------------------------------------
-        // get plugin from lv2_rdf (lilv)
+        if (pathLV2 == nullptr)
+        {
+            pData->engine->setLastError("LV2_PATH is not set");
+            return false;
+        }
 
-        fRdfDescriptor = lv2_rdf_new(uri, true);
+        fRdfDescriptor = Lv2RdfCache::getInstance().getDescriptor(pathLV2, uri);
 
         if (fRdfDescriptor == nullptr)
         {
@@ -5480,23 +5354,40 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(urid != CARLA_URI_MAP_ID_NULL,);
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0',);
-        carla_debug("CarlaPluginLV2::handleUridMap(%i v " P_SIZE ", \"%s\")", urid, fCustomURIDs.count()-1, uri);
+        carla_debug("CarlaPluginLV2::handleUridMap(%i, \"%s\")", urid, uri);
 
-        if (urid < fCustomURIDs.count())
-        {
-            const char* const ourURI(carla_lv2_urid_unmap(this, urid));
-            CARLA_SAFE_ASSERT_RETURN(ourURI != nullptr,);
+        // only used by UIs that could not get an answer to "uridMap" in time,
+        // the id only matches if nothing else got mapped here meanwhile
+        if (! Lv2URIDMap::getInstance().mapWithId(urid, uri))
+            carla_stderr2("PLUGIN :: wrong URID %i for '%s'", urid, uri);
+    }
 
-            if (std::strcmp(ourURI, uri) != 0)
-            {
-                carla_stderr2("PLUGIN :: wrong URI '%s' vs '%s'", ourURI,  uri);
-            }
-        }
-        else
-        {
-            CARLA_SAFE_ASSERT_RETURN(urid == fCustomURIDs.count(),);
-            fCustomURIDs.append(carla_strdup(uri));
-        }
+    void handleUridMapRequest(const char* const uri, const uint32_t serial, const uint32_t firstUrid)
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0',);
+        CARLA_SAFE_ASSERT_RETURN(firstUrid != CARLA_URI_MAP_ID_NULL,);
+        carla_debug("CarlaPluginLV2::handleUridMapRequest(\"%s\", %u, %u)", uri, serial, firstUrid);
+
+        Lv2URIDMap& uridMap(Lv2URIDMap::getInstance());
+
+        // URIDs are only ever decided here, the UI gets all it does not know yet in order
+        uridMap.map(uri);
+
+        const uint32_t count(uridMap.getCount());
+
+        if (firstUrid >= count)
+            return fPipeServer.writeLv2UridMapAnswer(serial, nullptr, 0);
+
+        std::vector<const char*> uris;
+
+        try {
+            uris.reserve(count - firstUrid);
+        } CARLA_SAFE_EXCEPTION_RETURN("CarlaPluginLV2::handleUridMapRequest",);
+
+        for (uint32_t i=firstUrid; i < count; ++i)
+            uris.push_back(uridMap.unmap(i));
+
+        fPipeServer.writeLv2UridMapAnswer(serial, uris.data(), static_cast<uint32_t>(uris.size()));
     }
 
     // -------------------------------------------------------------------
@@ -5521,6 +5412,7 @@ private:
 
     Lv2AtomRingBuffer fAtomBufferIn;
     Lv2AtomRingBuffer fAtomBufferOut;
+    Lv2Worker         fWorker;
     LV2_Atom_Forge    fAtomForge;
 
     CarlaPluginLV2EventData fEventsIn;
@@ -5528,7 +5420,7 @@ private:
     CarlaPluginLV2Options   fLv2Options;
     CarlaPipeServerLV2      fPipeServer;
 
-    LinkedList<const char*> fCustomURIDs;
+    uint32_t fUiURIDsCount; // URIDs known to the bridged UI
 
     bool fFirstActive; // first process() call after activate()
     void* fLastStateChunk;
@@ -5787,112 +5679,7 @@ private:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', CARLA_URI_MAP_ID_NULL);
         carla_debug("carla_lv2_urid_map(%p, \"%s\")", handle, uri);
 
-        // Atom types
-        if (std::strcmp(uri, LV2_ATOM__Blank) == 0)
-            return CARLA_URI_MAP_ID_ATOM_BLANK;
-        if (std::strcmp(uri, LV2_ATOM__Bool) == 0)
-            return CARLA_URI_MAP_ID_ATOM_BOOL;
-        if (std::strcmp(uri, LV2_ATOM__Chunk) == 0)
-            return CARLA_URI_MAP_ID_ATOM_CHUNK;
-        if (std::strcmp(uri, LV2_ATOM__Double) == 0)
-            return CARLA_URI_MAP_ID_ATOM_DOUBLE;
-        if (std::strcmp(uri, LV2_ATOM__Event) == 0)
-            return CARLA_URI_MAP_ID_ATOM_EVENT;
-        if (std::strcmp(uri, LV2_ATOM__Float) == 0)
-            return CARLA_URI_MAP_ID_ATOM_FLOAT;
-        if (std::strcmp(uri, LV2_ATOM__Int) == 0)
-            return CARLA_URI_MAP_ID_ATOM_INT;
-        if (std::strcmp(uri, LV2_ATOM__Literal) == 0)
-            return CARLA_URI_MAP_ID_ATOM_LITERAL;
-        if (std::strcmp(uri, LV2_ATOM__Long) == 0)
-            return CARLA_URI_MAP_ID_ATOM_LONG;
-        if (std::strcmp(uri, LV2_ATOM__Number) == 0)
-            return CARLA_URI_MAP_ID_ATOM_NUMBER;
-        if (std::strcmp(uri, LV2_ATOM__Object) == 0)
-            return CARLA_URI_MAP_ID_ATOM_OBJECT;
-        if (std::strcmp(uri, LV2_ATOM__Path) == 0)
-            return CARLA_URI_MAP_ID_ATOM_PATH;
-        if (std::strcmp(uri, LV2_ATOM__Property) == 0)
-            return CARLA_URI_MAP_ID_ATOM_PROPERTY;
-        if (std::strcmp(uri, LV2_ATOM__Resource) == 0)
-            return CARLA_URI_MAP_ID_ATOM_RESOURCE;
-        if (std::strcmp(uri, LV2_ATOM__Sequence) == 0)
-            return CARLA_URI_MAP_ID_ATOM_SEQUENCE;
-        if (std::strcmp(uri, LV2_ATOM__Sound) == 0)
-            return CARLA_URI_MAP_ID_ATOM_SOUND;
-        if (std::strcmp(uri, LV2_ATOM__String) == 0)
-            return CARLA_URI_MAP_ID_ATOM_STRING;
-        if (std::strcmp(uri, LV2_ATOM__Tuple) == 0)
-            return CARLA_URI_MAP_ID_ATOM_TUPLE;
-        if (std::strcmp(uri, LV2_ATOM__URI) == 0)
-            return CARLA_URI_MAP_ID_ATOM_URI;
-        if (std::strcmp(uri, LV2_ATOM__URID) == 0)
-            return CARLA_URI_MAP_ID_ATOM_URID;
-        if (std::strcmp(uri, LV2_ATOM__Vector) == 0)
-            return CARLA_URI_MAP_ID_ATOM_VECTOR;
-        if (std::strcmp(uri, LV2_ATOM__atomTransfer) == 0)
-            return CARLA_URI_MAP_ID_ATOM_TRANSFER_ATOM;
-        if (std::strcmp(uri, LV2_ATOM__eventTransfer) == 0)
-            return CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT;
-
-        // BufSize types
-        if (std::strcmp(uri, LV2_BUF_SIZE__maxBlockLength) == 0)
-            return CARLA_URI_MAP_ID_BUF_MAX_LENGTH;
-        if (std::strcmp(uri, LV2_BUF_SIZE__minBlockLength) == 0)
-            return CARLA_URI_MAP_ID_BUF_MIN_LENGTH;
-        if (std::strcmp(uri, LV2_BUF_SIZE__sequenceSize) == 0)
-            return CARLA_URI_MAP_ID_BUF_SEQUENCE_SIZE;
-
-        // Log types
-        if (std::strcmp(uri, LV2_LOG__Error) == 0)
-            return CARLA_URI_MAP_ID_LOG_ERROR;
-        if (std::strcmp(uri, LV2_LOG__Note) == 0)
-            return CARLA_URI_MAP_ID_LOG_NOTE;
-        if (std::strcmp(uri, LV2_LOG__Trace) == 0)
-            return CARLA_URI_MAP_ID_LOG_TRACE;
-        if (std::strcmp(uri, LV2_LOG__Warning) == 0)
-            return CARLA_URI_MAP_ID_LOG_WARNING;
-
-        // Time types
-        if (std::strcmp(uri, LV2_TIME__Position) == 0)
-            return CARLA_URI_MAP_ID_TIME_POSITION;
-        if (std::strcmp(uri, LV2_TIME__bar) == 0)
-            return CARLA_URI_MAP_ID_TIME_BAR;
-        if (std::strcmp(uri, LV2_TIME__barBeat) == 0)
-            return CARLA_URI_MAP_ID_TIME_BAR_BEAT;
-        if (std::strcmp(uri, LV2_TIME__beat) == 0)
-            return CARLA_URI_MAP_ID_TIME_BEAT;
-        if (std::strcmp(uri, LV2_TIME__beatUnit) == 0)
-            return CARLA_URI_MAP_ID_TIME_BEAT_UNIT;
-        if (std::strcmp(uri, LV2_TIME__beatsPerBar) == 0)
-            return CARLA_URI_MAP_ID_TIME_BEATS_PER_BAR;
-        if (std::strcmp(uri, LV2_TIME__beatsPerMinute) == 0)
-            return CARLA_URI_MAP_ID_TIME_BEATS_PER_MINUTE;
-        if (std::strcmp(uri, LV2_TIME__frame) == 0)
-            return CARLA_URI_MAP_ID_TIME_FRAME;
-        if (std::strcmp(uri, LV2_TIME__framesPerSecond) == 0)
-            return CARLA_URI_MAP_ID_TIME_FRAMES_PER_SECOND;
-        if (std::strcmp(uri, LV2_TIME__speed) == 0)
-            return CARLA_URI_MAP_ID_TIME_SPEED;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat) == 0)
-            return CARLA_URI_MAP_ID_TIME_TICKS_PER_BEAT;
-
-        // Others
-        if (std::strcmp(uri, LV2_MIDI__MidiEvent) == 0)
-            return CARLA_URI_MAP_ID_MIDI_EVENT;
-        if (std::strcmp(uri, LV2_PARAMETERS__sampleRate) == 0)
-            return CARLA_URI_MAP_ID_PARAM_SAMPLE_RATE;
-        if (std::strcmp(uri, LV2_UI__windowTitle) == 0)
-            return CARLA_URI_MAP_ID_UI_WINDOW_TITLE;
-
-        // Custom
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TransientWindowId) == 0)
-            return CARLA_URI_MAP_ID_CARLA_TRANSIENT_WIN_ID;
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER) == 0)
-            return CARLA_URI_MAP_ID_CARLA_ATOM_WORKER;
-
-        // Custom types
-        return ((CarlaPluginLV2*)handle)->getCustomURID(uri);
+        return Lv2URIDMap::getInstance().map(uri);
     }
 
     static const char* carla_lv2_urid_unmap(LV2_URID_Map_Handle handle, LV2_URID urid)
@@ -5901,112 +5688,10 @@ private:
         CARLA_SAFE_ASSERT_RETURN(urid != CARLA_URI_MAP_ID_NULL, nullptr);
         carla_debug("carla_lv2_urid_unmap(%p, %i)", handle, urid);
 
-        // Atom types
-        if (urid == CARLA_URI_MAP_ID_ATOM_BLANK)
-            return LV2_ATOM__Blank;
-        if (urid == CARLA_URI_MAP_ID_ATOM_BOOL)
-            return LV2_ATOM__Bool;
-        if (urid == CARLA_URI_MAP_ID_ATOM_CHUNK)
-            return LV2_ATOM__Chunk;
-        if (urid == CARLA_URI_MAP_ID_ATOM_DOUBLE)
-            return LV2_ATOM__Double;
-        if (urid == CARLA_URI_MAP_ID_ATOM_EVENT)
-            return LV2_ATOM__Event;
-        if (urid == CARLA_URI_MAP_ID_ATOM_FLOAT)
-            return LV2_ATOM__Float;
-        if (urid == CARLA_URI_MAP_ID_ATOM_INT)
-            return LV2_ATOM__Int;
-        if (urid == CARLA_URI_MAP_ID_ATOM_LITERAL)
-            return LV2_ATOM__Literal;
-        if (urid == CARLA_URI_MAP_ID_ATOM_LONG)
-            return LV2_ATOM__Long;
-        if (urid == CARLA_URI_MAP_ID_ATOM_NUMBER)
-            return LV2_ATOM__Number;
-        if (urid == CARLA_URI_MAP_ID_ATOM_OBJECT)
-            return LV2_ATOM__Object;
-        if (urid == CARLA_URI_MAP_ID_ATOM_PATH)
-            return LV2_ATOM__Path;
-        if (urid == CARLA_URI_MAP_ID_ATOM_PROPERTY)
-            return LV2_ATOM__Property;
-        if (urid == CARLA_URI_MAP_ID_ATOM_RESOURCE)
-            return LV2_ATOM__Resource;
-        if (urid == CARLA_URI_MAP_ID_ATOM_SEQUENCE)
-            return LV2_ATOM__Sequence;
-        if (urid == CARLA_URI_MAP_ID_ATOM_SOUND)
-            return LV2_ATOM__Sound;
-        if (urid == CARLA_URI_MAP_ID_ATOM_STRING)
-            return LV2_ATOM__String;
-        if (urid == CARLA_URI_MAP_ID_ATOM_TUPLE)
-            return LV2_ATOM__Tuple;
-        if (urid == CARLA_URI_MAP_ID_ATOM_URI)
-            return LV2_ATOM__URI;
-        if (urid == CARLA_URI_MAP_ID_ATOM_URID)
-            return LV2_ATOM__URID;
-        if (urid == CARLA_URI_MAP_ID_ATOM_VECTOR)
-            return LV2_ATOM__Vector;
-        if (urid == CARLA_URI_MAP_ID_ATOM_TRANSFER_ATOM)
-            return LV2_ATOM__atomTransfer;
-        if (urid == CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT)
-            return LV2_ATOM__eventTransfer;
-
-        // BufSize types
-        if (urid == CARLA_URI_MAP_ID_BUF_MAX_LENGTH)
-            return LV2_BUF_SIZE__maxBlockLength;
-        if (urid == CARLA_URI_MAP_ID_BUF_MIN_LENGTH)
-            return LV2_BUF_SIZE__minBlockLength;
-        if (urid == CARLA_URI_MAP_ID_BUF_SEQUENCE_SIZE)
-            return LV2_BUF_SIZE__sequenceSize;
-
-        // Log types
-        if (urid == CARLA_URI_MAP_ID_LOG_ERROR)
-            return LV2_LOG__Error;
-        if (urid == CARLA_URI_MAP_ID_LOG_NOTE)
-            return LV2_LOG__Note;
-        if (urid == CARLA_URI_MAP_ID_LOG_TRACE)
-            return LV2_LOG__Trace;
-        if (urid == CARLA_URI_MAP_ID_LOG_WARNING)
-            return LV2_LOG__Warning;
-
-        // Time types
-        if (urid == CARLA_URI_MAP_ID_TIME_POSITION)
-            return LV2_TIME__Position;
-        if (urid == CARLA_URI_MAP_ID_TIME_BAR)
-            return LV2_TIME__bar;
-        if (urid == CARLA_URI_MAP_ID_TIME_BAR_BEAT)
-            return LV2_TIME__barBeat;
-        if (urid == CARLA_URI_MAP_ID_TIME_BEAT)
-            return LV2_TIME__beat;
-        if (urid == CARLA_URI_MAP_ID_TIME_BEAT_UNIT)
-            return LV2_TIME__beatUnit;
-        if (urid == CARLA_URI_MAP_ID_TIME_BEATS_PER_BAR)
-            return LV2_TIME__beatsPerBar;
-        if (urid == CARLA_URI_MAP_ID_TIME_BEATS_PER_MINUTE)
-            return LV2_TIME__beatsPerMinute;
-        if (urid == CARLA_URI_MAP_ID_TIME_FRAME)
-            return LV2_TIME__frame;
-        if (urid == CARLA_URI_MAP_ID_TIME_FRAMES_PER_SECOND)
-            return LV2_TIME__framesPerSecond;
-        if (urid == CARLA_URI_MAP_ID_TIME_SPEED)
-            return LV2_TIME__speed;
-        if (urid == CARLA_URI_MAP_ID_TIME_TICKS_PER_BEAT)
-            return LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat;
-
-        // Others
-        if (urid == CARLA_URI_MAP_ID_MIDI_EVENT)
-            return LV2_MIDI__MidiEvent;
-        if (urid == CARLA_URI_MAP_ID_PARAM_SAMPLE_RATE)
-            return LV2_PARAMETERS__sampleRate;
-        if (urid == CARLA_URI_MAP_ID_UI_WINDOW_TITLE)
-            return LV2_UI__windowTitle;
-
-        // Custom
-        if (urid == CARLA_URI_MAP_ID_CARLA_ATOM_WORKER)
-            return URI_CARLA_ATOM_WORKER;
-        if (urid == CARLA_URI_MAP_ID_CARLA_TRANSIENT_WIN_ID)
-            return LV2_KXSTUDIO_PROPERTIES__TransientWindowId;
-
-        // Custom types
-        return ((CarlaPluginLV2*)handle)->getCustomURIDString(urid);
+        if (const char* const uri = Lv2URIDMap::getInstance().unmap(urid))
+            return uri;
+
+        return "urn:null";
     }
 
     // -------------------------------------------------------------------
@@ -6020,14 +5705,6 @@ private:
         return ((CarlaPluginLV2*)handle)->handleWorkerSchedule(size, data);
     }
 
-    static LV2_Worker_Status carla_lv2_worker_respond(LV2_Worker_Respond_Handle handle, uint32_t size, const void* data)
-    {
-        CARLA_SAFE_ASSERT_RETURN(handle != nullptr, LV2_WORKER_ERR_UNKNOWN);
-        carla_debug("carla_lv2_worker_respond(%p, %i, %p)", handle, size, data);
-
-        return ((CarlaPluginLV2*)handle)->handleWorkerRespond(size, data);
-    }
-
     // -------------------------------------------------------------------
     // External UI Feature
 
@@ -6090,6 +5767,13 @@ private:
 
 // -------------------------------------------------------------------------------------------------------------------
 
+void CarlaPipeServerLV2::lv2AtomReceived(const uint32_t index, const LV2_Atom* const atom) noexcept
+{
+    try {
+        kPlugin->handleUIWrite(index, lv2_atom_total_size(atom), CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT, atom);
+    } CARLA_SAFE_EXCEPTION("lv2AtomReceived");
+}
+
 bool CarlaPipeServerLV2::msgReceived(const char* const msg) noexcept
 {
     if (std::strcmp(msg, "exiting") == 0)
@@ -6114,29 +5798,6 @@ bool CarlaPipeServerLV2::msgReceived(const char* const msg) noexcept
         return true;
     }
 
-    if (std::strcmp(msg, "atom") == 0)
-    {
-        uint32_t index, size;
-        const char* base64atom;
-
-        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(index), true);
-        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(size), true);
-        CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(base64atom), true);
-
-        std::vector<uint8_t> chunk(carla_getChunkFromBase64String(base64atom));
-        delete[] base64atom;
-        CARLA_SAFE_ASSERT_RETURN(chunk.size() >= sizeof(LV2_Atom), true);
-
-        const LV2_Atom* const atom((const LV2_Atom*)chunk.data());
-        CARLA_SAFE_ASSERT_RETURN(lv2_atom_total_size(atom) == chunk.size(), true);
-
-        try {
-            kPlugin->handleUIWrite(index, lv2_atom_total_size(atom), CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT, atom);
-        } CARLA_SAFE_EXCEPTION("magReceived atom");
-
-        return true;
-    }
-
     if (std::strcmp(msg, "program") == 0)
     {
         uint32_t index;
@@ -6169,6 +5830,23 @@ bool CarlaPipeServerLV2::msgReceived(const char* const msg) noexcept
         return true;
     }
 
+    if (std::strcmp(msg, "uridMap") == 0)
+    {
+        uint32_t serial, firstUrid;
+        const char* uri;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(serial), true);
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(firstUrid), true);
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(uri), true);
+
+        try {
+            kPlugin->handleUridMapRequest(uri, serial, firstUrid);
+        } CARLA_SAFE_EXCEPTION("msgReceived uridMap");
+
+        delete[] uri;
+        return true;
+    }
+
     return false;
 }
 
@@ -36,6 +36,7 @@ using juce::Timer;
 #endif
 
 using CarlaBackend::CarlaEngine;
+using CarlaBackend::CarlaEngineBridgeGroup;
 using CarlaBackend::EngineCallbackOpcode;
 using CarlaBackend::EngineCallbackOpcode2Str;
 
@@ -102,9 +103,17 @@ static void initSignalHandler()
 // -------------------------------------------------------------------------
 
 static String gProjectFilename;
+static CarlaEngineBridgeGroup* gGroup = nullptr;
 
 static void gIdle()
 {
+    if (gGroup != nullptr)
+    {
+        if (! gGroup->idle())
+            gCloseNow = true;
+        return;
+    }
+
     carla_engine_idle();
 
     if (gSaveNow)
@@ -285,8 +294,53 @@ private:
 
 // -------------------------------------------------------------------------
 
+static int execGroup(const char* const groupShmId, int argc, char* argv[])
+{
+    gGroup = CarlaEngineBridgeGroup::newGroup(groupShmId);
+
+    if (gGroup == nullptr)
+    {
+        carla_stderr("Failed to init bridge group");
+        return 1;
+    }
+
+    initSignalHandler();
+
+#if defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN)
+    JUCEApplicationBase::createInstance = &juce_CreateApplication;
+    JUCEApplicationBase::main(JUCE_MAIN_FUNCTION_ARGS);
+#else
+    for (; ! gCloseNow;)
+    {
+        gIdle();
+        carla_msleep(8);
+    }
+#endif
+
+    delete gGroup;
+    gGroup = nullptr;
+
+    return 0;
+
+    // may be unused
+    (void)argc; (void)argv;
+}
+
+// -------------------------------------------------------------------------
+
 int main(int argc, char* argv[])
 {
+    // ---------------------------------------------------------------------
+    // Several plugins in one process, added later by the server
+
+    if (argc == 2 && std::strcmp(argv[1], "--group") == 0)
+    {
+        const char* const groupShmId(std::getenv("ENGINE_BRIDGE_GROUP_SHM_ID"));
+        CARLA_SAFE_ASSERT_RETURN(groupShmId != nullptr && std::strlen(groupShmId) == 6, 1);
+
+        return execGroup(groupShmId, argc, argv);
+    }
+
     // ---------------------------------------------------------------------
     // Check argument count
 
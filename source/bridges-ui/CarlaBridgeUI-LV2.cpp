@@ -19,12 +19,11 @@
 #include "CarlaLibUtils.hpp"
 #include "CarlaLv2Utils.hpp"
 #include "CarlaMIDI.h"
-#include "LinkedList.hpp"
+#include "Lv2RdfCache.hpp"
+#include "Lv2URIDMap.hpp"
 
 #include "juce_core.h"
 
-#define URI_CARLA_ATOM_WORKER "http://kxstudio.sf.net/ns/carla/atomWorker"
-
 using juce::File;
 
 CARLA_BRIDGE_START_NAMESPACE
@@ -37,56 +36,6 @@ static double gSampleRate = 44100.0;
 // Maximum default buffer size
 const unsigned int MAX_DEFAULT_BUFFER_SIZE = 8192; // 0x2000
 
-// LV2 URI Map Ids
-const uint32_t CARLA_URI_MAP_ID_NULL                   =  0;
-const uint32_t CARLA_URI_MAP_ID_ATOM_BLANK             =  1;
-const uint32_t CARLA_URI_MAP_ID_ATOM_BOOL              =  2;
-const uint32_t CARLA_URI_MAP_ID_ATOM_CHUNK             =  3;
-const uint32_t CARLA_URI_MAP_ID_ATOM_DOUBLE            =  4;
-const uint32_t CARLA_URI_MAP_ID_ATOM_EVENT             =  5;
-const uint32_t CARLA_URI_MAP_ID_ATOM_FLOAT             =  6;
-const uint32_t CARLA_URI_MAP_ID_ATOM_INT               =  7;
-const uint32_t CARLA_URI_MAP_ID_ATOM_LITERAL           =  8;
-const uint32_t CARLA_URI_MAP_ID_ATOM_LONG              =  9;
-const uint32_t CARLA_URI_MAP_ID_ATOM_NUMBER            = 10;
-const uint32_t CARLA_URI_MAP_ID_ATOM_OBJECT            = 11;
-const uint32_t CARLA_URI_MAP_ID_ATOM_PATH              = 12;
-const uint32_t CARLA_URI_MAP_ID_ATOM_PROPERTY          = 13;
-const uint32_t CARLA_URI_MAP_ID_ATOM_RESOURCE          = 14;
-const uint32_t CARLA_URI_MAP_ID_ATOM_SEQUENCE          = 15;
-const uint32_t CARLA_URI_MAP_ID_ATOM_SOUND             = 16;
-const uint32_t CARLA_URI_MAP_ID_ATOM_STRING            = 17;
-const uint32_t CARLA_URI_MAP_ID_ATOM_TUPLE             = 18;
-const uint32_t CARLA_URI_MAP_ID_ATOM_URI               = 19;
-const uint32_t CARLA_URI_MAP_ID_ATOM_URID              = 20;
-const uint32_t CARLA_URI_MAP_ID_ATOM_VECTOR            = 21;
-const uint32_t CARLA_URI_MAP_ID_ATOM_TRANSFER_ATOM     = 22;
-const uint32_t CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT    = 23;
-const uint32_t CARLA_URI_MAP_ID_BUF_MAX_LENGTH         = 24;
-const uint32_t CARLA_URI_MAP_ID_BUF_MIN_LENGTH         = 25;
-const uint32_t CARLA_URI_MAP_ID_BUF_SEQUENCE_SIZE      = 26;
-const uint32_t CARLA_URI_MAP_ID_LOG_ERROR              = 27;
-const uint32_t CARLA_URI_MAP_ID_LOG_NOTE               = 28;
-const uint32_t CARLA_URI_MAP_ID_LOG_TRACE              = 29;
-const uint32_t CARLA_URI_MAP_ID_LOG_WARNING            = 30;
-const uint32_t CARLA_URI_MAP_ID_TIME_POSITION          = 31; // base type
-const uint32_t CARLA_URI_MAP_ID_TIME_BAR               = 32; // values
-const uint32_t CARLA_URI_MAP_ID_TIME_BAR_BEAT          = 33;
-const uint32_t CARLA_URI_MAP_ID_TIME_BEAT              = 34;
-const uint32_t CARLA_URI_MAP_ID_TIME_BEAT_UNIT         = 35;
-const uint32_t CARLA_URI_MAP_ID_TIME_BEATS_PER_BAR     = 36;
-const uint32_t CARLA_URI_MAP_ID_TIME_BEATS_PER_MINUTE  = 37;
-const uint32_t CARLA_URI_MAP_ID_TIME_FRAME             = 38;
-const uint32_t CARLA_URI_MAP_ID_TIME_FRAMES_PER_SECOND = 39;
-const uint32_t CARLA_URI_MAP_ID_TIME_SPEED             = 40;
-const uint32_t CARLA_URI_MAP_ID_TIME_TICKS_PER_BEAT    = 41;
-const uint32_t CARLA_URI_MAP_ID_MIDI_EVENT             = 42;
-const uint32_t CARLA_URI_MAP_ID_PARAM_SAMPLE_RATE      = 43;
-const uint32_t CARLA_URI_MAP_ID_UI_WINDOW_TITLE        = 44;
-const uint32_t CARLA_URI_MAP_ID_CARLA_ATOM_WORKER      = 45;
-const uint32_t CARLA_URI_MAP_ID_CARLA_TRANSIENT_WIN_ID = 46;
-const uint32_t CARLA_URI_MAP_ID_COUNT                  = 47;
-
 // LV2 Feature Ids
 const uint32_t kFeatureIdLogs             =  0;
 const uint32_t kFeatureIdOptions          =  1;
@@ -211,15 +160,11 @@ public:
           fRdfUiDescriptor(nullptr),
           fLv2Options(),
           fUiOptions(),
-          fCustomURIDs(),
           fExt(),
           leakDetector_CarlaLv2Client()
     {
         carla_zeroPointers(fFeatures, kFeatureCount+1);
 
-        for (uint32_t i=0; i < CARLA_URI_MAP_ID_COUNT; ++i)
-            fCustomURIDs.append(nullptr);
-
         // ---------------------------------------------------------------
         // initialize options
 
@@ -359,18 +304,7 @@ public:
                 delete fFeatures[i];
                 fFeatures[i] = nullptr;
             }
-        }
-
-        for (LinkedList<const char*>::Itenerator it = fCustomURIDs.begin(); it.valid(); it.next())
-        {
-            const char* const uri(it.getValue(nullptr));
-
-            if (uri != nullptr)
-                delete[] uri;
-        }
-
-        fCustomURIDs.clear();
-    }
+        }    }
 
     // ---------------------------------------------------------------------
     // UI initialization
@@ -383,8 +317,8 @@ public:
         // -----------------------------------------------------------------
         // load plugin
 
-        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
-        lv2World.initIfNeeded(std::getenv("LV2_PATH"));
+        const char* const pathLV2(std::getenv("LV2_PATH"));
+        CARLA_SAFE_ASSERT_RETURN(pathLV2 != nullptr, false);
 
         //Lilv::Node bundleNode(lv2World.new_file_uri(nullptr, uiBundle));
         //CARLA_SAFE_ASSERT_RETURN(bundleNode.is_uri(), false);
@@ -397,9 +331,9 @@ public:
         //lv2World.load_bundle(sBundle);
 
         // -----------------------------------------------------------------
-        // get plugin from lv2_rdf (lilv)
+        // get plugin from the cache or lv2_rdf (lilv)
 
-        fRdfDescriptor = lv2_rdf_new(pluginURI, true);
+        fRdfDescriptor = Lv2RdfCache::getInstance().getDescriptor(pathLV2, pluginURI);
         CARLA_SAFE_ASSERT_RETURN(fRdfDescriptor != nullptr, false);
 
         // -----------------------------------------------------------------
@@ -606,10 +540,11 @@ public:
 
     void dspURIDReceived(const LV2_URID urid, const char* const uri)
     {
-        CARLA_SAFE_ASSERT_RETURN(urid == fCustomURIDs.count(),);
+        CARLA_SAFE_ASSERT_RETURN(urid != CARLA_URI_MAP_ID_NULL,);
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0',);
 
-        fCustomURIDs.append(carla_strdup(uri));
+        if (! Lv2URIDMap::getInstance().mapWithId(urid, uri))
+            carla_stderr2("UI :: wrong URID %i for '%s'", urid, uri);
     }
 
     void uiOptionsChanged(const double sampleRate, const bool useTheme, const bool useThemeColors, const char* const windowTitle, uintptr_t transientWindowId) override
@@ -637,39 +572,55 @@ public:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', CARLA_URI_MAP_ID_NULL);
         carla_debug("CarlaLv2Client::getCustomURID(\"%s\")", uri);
 
-        LV2_URID urid = CARLA_URI_MAP_ID_NULL;
+        Lv2URIDMap& uridMap(Lv2URIDMap::getInstance());
+
+        if (const LV2_URID urid = uridMap.find(uri))
+            return urid;
+
+        if (! isPipeRunning())
+            return uridMap.map(uri);
+
+        // the host decides all URIDs, other plugins in its process might have taken the next one.
+        // its answer has all we don't know yet, in order, and only takes more than 1 request if many are missing.
+        CarlaStringList uris;
 
-        for (uint32_t i=0, count=static_cast<uint32_t>(fCustomURIDs.count()); i<count; ++i)
+        for (uint32_t firstUrid = uridMap.getCount(); writeLv2UridMapMessage(uri, firstUrid, uris, 1000);
+             firstUrid = uridMap.getCount())
         {
-            const char* const thisUri(fCustomURIDs.getAt(i, nullptr));
+            bool synced = true;
+            uint32_t hostUrid = firstUrid;
 
-            if (thisUri != nullptr && std::strcmp(thisUri, uri) == 0)
+            for (CarlaStringList::Itenerator it = uris.begin(); it.valid(); it.next(), ++hostUrid)
             {
-                urid = i;
-                break;
+                const char* const hostUri(it.getValue(nullptr));
+
+                if (! uridMap.mapWithId(hostUrid, hostUri))
+                {
+                    carla_stderr2("UI :: wrong URID %u from host for '%s'", hostUrid, hostUri);
+                    synced = false;
+                    break;
+                }
             }
-        }
 
-        if (urid == CARLA_URI_MAP_ID_NULL)
-        {
-            urid = static_cast<LV2_URID>(fCustomURIDs.count());
-            fCustomURIDs.append(carla_strdup(uri));
+            if (const LV2_URID urid = uridMap.find(uri))
+                return urid;
+
+            // asking again would not help
+            if (! synced || uris.count() == 0)
+                break;
         }
 
-        if (isPipeRunning())
-            writeLv2UridMessage(urid, uri);
+        carla_stderr2("UI :: could not get URID for '%s' from host", uri);
 
-        return urid;
-    }
+        // older hosts or no shared memory, best effort.
+        // matches if the host has not mapped anything else meanwhile
+        bool created;
+        const LV2_URID urid(uridMap.map(uri, &created));
 
-    const char* getCustomURIDString(const LV2_URID urid) const noexcept
-    {
-        static const char* const sFallback = "urn:null";
-        CARLA_SAFE_ASSERT_RETURN(urid != CARLA_URI_MAP_ID_NULL, sFallback);
-        CARLA_SAFE_ASSERT_RETURN(urid < fCustomURIDs.count(), sFallback);
-        carla_debug("CarlaLv2Client::getCustomURIDString(%i)", urid);
+        if (created && isPipeRunning())
+            writeLv2UridMessage(urid, uri);
 
-        return fCustomURIDs.getAt(urid, sFallback);
+        return urid;
     }
 
     // ---------------------------------------------------------------------
@@ -749,7 +700,6 @@ private:
     Lv2PluginOptions          fLv2Options;
 
     Options fUiOptions;
-    LinkedList<const char*> fCustomURIDs;
 
     struct Extensions {
         const LV2_Options_Interface* options;
@@ -909,111 +859,6 @@ private:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', CARLA_URI_MAP_ID_NULL);
         carla_debug("carla_lv2_urid_map(%p, \"%s\")", handle, uri);
 
-        // Atom types
-        if (std::strcmp(uri, LV2_ATOM__Blank) == 0)
-            return CARLA_URI_MAP_ID_ATOM_BLANK;
-        if (std::strcmp(uri, LV2_ATOM__Bool) == 0)
-            return CARLA_URI_MAP_ID_ATOM_BOOL;
-        if (std::strcmp(uri, LV2_ATOM__Chunk) == 0)
-            return CARLA_URI_MAP_ID_ATOM_CHUNK;
-        if (std::strcmp(uri, LV2_ATOM__Double) == 0)
-            return CARLA_URI_MAP_ID_ATOM_DOUBLE;
-        if (std::strcmp(uri, LV2_ATOM__Event) == 0)
-            return CARLA_URI_MAP_ID_ATOM_EVENT;
-        if (std::strcmp(uri, LV2_ATOM__Float) == 0)
-            return CARLA_URI_MAP_ID_ATOM_FLOAT;
-        if (std::strcmp(uri, LV2_ATOM__Int) == 0)
-            return CARLA_URI_MAP_ID_ATOM_INT;
-        if (std::strcmp(uri, LV2_ATOM__Literal) == 0)
-            return CARLA_URI_MAP_ID_ATOM_LITERAL;
-        if (std::strcmp(uri, LV2_ATOM__Long) == 0)
-            return CARLA_URI_MAP_ID_ATOM_LONG;
-        if (std::strcmp(uri, LV2_ATOM__Number) == 0)
-            return CARLA_URI_MAP_ID_ATOM_NUMBER;
-        if (std::strcmp(uri, LV2_ATOM__Object) == 0)
-            return CARLA_URI_MAP_ID_ATOM_OBJECT;
-        if (std::strcmp(uri, LV2_ATOM__Path) == 0)
-            return CARLA_URI_MAP_ID_ATOM_PATH;
-        if (std::strcmp(uri, LV2_ATOM__Property) == 0)
-            return CARLA_URI_MAP_ID_ATOM_PROPERTY;
-        if (std::strcmp(uri, LV2_ATOM__Resource) == 0)
-            return CARLA_URI_MAP_ID_ATOM_RESOURCE;
-        if (std::strcmp(uri, LV2_ATOM__Sequence) == 0)
-            return CARLA_URI_MAP_ID_ATOM_SEQUENCE;
-        if (std::strcmp(uri, LV2_ATOM__Sound) == 0)
-            return CARLA_URI_MAP_ID_ATOM_SOUND;
-        if (std::strcmp(uri, LV2_ATOM__String) == 0)
-            return CARLA_URI_MAP_ID_ATOM_STRING;
-        if (std::strcmp(uri, LV2_ATOM__Tuple) == 0)
-            return CARLA_URI_MAP_ID_ATOM_TUPLE;
-        if (std::strcmp(uri, LV2_ATOM__URI) == 0)
-            return CARLA_URI_MAP_ID_ATOM_URI;
-        if (std::strcmp(uri, LV2_ATOM__URID) == 0)
-            return CARLA_URI_MAP_ID_ATOM_URID;
-        if (std::strcmp(uri, LV2_ATOM__Vector) == 0)
-            return CARLA_URI_MAP_ID_ATOM_VECTOR;
-        if (std::strcmp(uri, LV2_ATOM__atomTransfer) == 0)
-            return CARLA_URI_MAP_ID_ATOM_TRANSFER_ATOM;
-        if (std::strcmp(uri, LV2_ATOM__eventTransfer) == 0)
-            return CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT;
-
-        // BufSize types
-        if (std::strcmp(uri, LV2_BUF_SIZE__maxBlockLength) == 0)
-            return CARLA_URI_MAP_ID_BUF_MAX_LENGTH;
-        if (std::strcmp(uri, LV2_BUF_SIZE__minBlockLength) == 0)
-            return CARLA_URI_MAP_ID_BUF_MIN_LENGTH;
-        if (std::strcmp(uri, LV2_BUF_SIZE__sequenceSize) == 0)
-            return CARLA_URI_MAP_ID_BUF_SEQUENCE_SIZE;
-
-        // Log types
-        if (std::strcmp(uri, LV2_LOG__Error) == 0)
-            return CARLA_URI_MAP_ID_LOG_ERROR;
-        if (std::strcmp(uri, LV2_LOG__Note) == 0)
-            return CARLA_URI_MAP_ID_LOG_NOTE;
-        if (std::strcmp(uri, LV2_LOG__Trace) == 0)
-            return CARLA_URI_MAP_ID_LOG_TRACE;
-        if (std::strcmp(uri, LV2_LOG__Warning) == 0)
-            return CARLA_URI_MAP_ID_LOG_WARNING;
-
-        // Time types
-        if (std::strcmp(uri, LV2_TIME__Position) == 0)
-            return CARLA_URI_MAP_ID_TIME_POSITION;
-        if (std::strcmp(uri, LV2_TIME__bar) == 0)
-            return CARLA_URI_MAP_ID_TIME_BAR;
-        if (std::strcmp(uri, LV2_TIME__barBeat) == 0)
-            return CARLA_URI_MAP_ID_TIME_BAR_BEAT;
-        if (std::strcmp(uri, LV2_TIME__beat) == 0)
-            return CARLA_URI_MAP_ID_TIME_BEAT;
-        if (std::strcmp(uri, LV2_TIME__beatUnit) == 0)
-            return CARLA_URI_MAP_ID_TIME_BEAT_UNIT;
-        if (std::strcmp(uri, LV2_TIME__beatsPerBar) == 0)
-            return CARLA_URI_MAP_ID_TIME_BEATS_PER_BAR;
-        if (std::strcmp(uri, LV2_TIME__beatsPerMinute) == 0)
-            return CARLA_URI_MAP_ID_TIME_BEATS_PER_MINUTE;
-        if (std::strcmp(uri, LV2_TIME__frame) == 0)
-            return CARLA_URI_MAP_ID_TIME_FRAME;
-        if (std::strcmp(uri, LV2_TIME__framesPerSecond) == 0)
-            return CARLA_URI_MAP_ID_TIME_FRAMES_PER_SECOND;
-        if (std::strcmp(uri, LV2_TIME__speed) == 0)
-            return CARLA_URI_MAP_ID_TIME_SPEED;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat) == 0)
-            return CARLA_URI_MAP_ID_TIME_TICKS_PER_BEAT;
-
-        // Others
-        if (std::strcmp(uri, LV2_MIDI__MidiEvent) == 0)
-            return CARLA_URI_MAP_ID_MIDI_EVENT;
-        if (std::strcmp(uri, LV2_PARAMETERS__sampleRate) == 0)
-            return CARLA_URI_MAP_ID_PARAM_SAMPLE_RATE;
-        if (std::strcmp(uri, LV2_UI__windowTitle) == 0)
-            return CARLA_URI_MAP_ID_UI_WINDOW_TITLE;
-
-        // Custom
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TransientWindowId) == 0)
-            return CARLA_URI_MAP_ID_CARLA_TRANSIENT_WIN_ID;
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER) == 0)
-            return CARLA_URI_MAP_ID_CARLA_ATOM_WORKER;
-
-        // Custom types
         return ((CarlaLv2Client*)handle)->getCustomURID(uri);
     }
 
@@ -1023,112 +868,10 @@ private:
         CARLA_SAFE_ASSERT_RETURN(urid != CARLA_URI_MAP_ID_NULL, nullptr);
         carla_debug("carla_lv2_urid_unmap(%p, %i)", handle, urid);
 
-        // Atom types
-        if (urid == CARLA_URI_MAP_ID_ATOM_BLANK)
-            return LV2_ATOM__Blank;
-        if (urid == CARLA_URI_MAP_ID_ATOM_BOOL)
-            return LV2_ATOM__Bool;
-        if (urid == CARLA_URI_MAP_ID_ATOM_CHUNK)
-            return LV2_ATOM__Chunk;
-        if (urid == CARLA_URI_MAP_ID_ATOM_DOUBLE)
-            return LV2_ATOM__Double;
-        if (urid == CARLA_URI_MAP_ID_ATOM_EVENT)
-            return LV2_ATOM__Event;
-        if (urid == CARLA_URI_MAP_ID_ATOM_FLOAT)
-            return LV2_ATOM__Float;
-        if (urid == CARLA_URI_MAP_ID_ATOM_INT)
-            return LV2_ATOM__Int;
-        if (urid == CARLA_URI_MAP_ID_ATOM_LITERAL)
-            return LV2_ATOM__Literal;
-        if (urid == CARLA_URI_MAP_ID_ATOM_LONG)
-            return LV2_ATOM__Long;
-        if (urid == CARLA_URI_MAP_ID_ATOM_NUMBER)
-            return LV2_ATOM__Number;
-        if (urid == CARLA_URI_MAP_ID_ATOM_OBJECT)
-            return LV2_ATOM__Object;
-        if (urid == CARLA_URI_MAP_ID_ATOM_PATH)
-            return LV2_ATOM__Path;
-        if (urid == CARLA_URI_MAP_ID_ATOM_PROPERTY)
-            return LV2_ATOM__Property;
-        if (urid == CARLA_URI_MAP_ID_ATOM_RESOURCE)
-            return LV2_ATOM__Resource;
-        if (urid == CARLA_URI_MAP_ID_ATOM_SEQUENCE)
-            return LV2_ATOM__Sequence;
-        if (urid == CARLA_URI_MAP_ID_ATOM_SOUND)
-            return LV2_ATOM__Sound;
-        if (urid == CARLA_URI_MAP_ID_ATOM_STRING)
-            return LV2_ATOM__String;
-        if (urid == CARLA_URI_MAP_ID_ATOM_TUPLE)
-            return LV2_ATOM__Tuple;
-        if (urid == CARLA_URI_MAP_ID_ATOM_URI)
-            return LV2_ATOM__URI;
-        if (urid == CARLA_URI_MAP_ID_ATOM_URID)
-            return LV2_ATOM__URID;
-        if (urid == CARLA_URI_MAP_ID_ATOM_VECTOR)
-            return LV2_ATOM__Vector;
-        if (urid == CARLA_URI_MAP_ID_ATOM_TRANSFER_ATOM)
-            return LV2_ATOM__atomTransfer;
-        if (urid == CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT)
-            return LV2_ATOM__eventTransfer;
-
-        // BufSize types
-        if (urid == CARLA_URI_MAP_ID_BUF_MAX_LENGTH)
-            return LV2_BUF_SIZE__maxBlockLength;
-        if (urid == CARLA_URI_MAP_ID_BUF_MIN_LENGTH)
-            return LV2_BUF_SIZE__minBlockLength;
-        if (urid == CARLA_URI_MAP_ID_BUF_SEQUENCE_SIZE)
-            return LV2_BUF_SIZE__sequenceSize;
-
-        // Log types
-        if (urid == CARLA_URI_MAP_ID_LOG_ERROR)
-            return LV2_LOG__Error;
-        if (urid == CARLA_URI_MAP_ID_LOG_NOTE)
-            return LV2_LOG__Note;
-        if (urid == CARLA_URI_MAP_ID_LOG_TRACE)
-            return LV2_LOG__Trace;
-        if (urid == CARLA_URI_MAP_ID_LOG_WARNING)
-            return LV2_LOG__Warning;
-
-        // Time types
-        if (urid == CARLA_URI_MAP_ID_TIME_POSITION)
-            return LV2_TIME__Position;
-        if (urid == CARLA_URI_MAP_ID_TIME_BAR)
-            return LV2_TIME__bar;
-        if (urid == CARLA_URI_MAP_ID_TIME_BAR_BEAT)
-            return LV2_TIME__barBeat;
-        if (urid == CARLA_URI_MAP_ID_TIME_BEAT)
-            return LV2_TIME__beat;
-        if (urid == CARLA_URI_MAP_ID_TIME_BEAT_UNIT)
-            return LV2_TIME__beatUnit;
-        if (urid == CARLA_URI_MAP_ID_TIME_BEATS_PER_BAR)
-            return LV2_TIME__beatsPerBar;
-        if (urid == CARLA_URI_MAP_ID_TIME_BEATS_PER_MINUTE)
-            return LV2_TIME__beatsPerMinute;
-        if (urid == CARLA_URI_MAP_ID_TIME_FRAME)
-            return LV2_TIME__frame;
-        if (urid == CARLA_URI_MAP_ID_TIME_FRAMES_PER_SECOND)
-            return LV2_TIME__framesPerSecond;
-        if (urid == CARLA_URI_MAP_ID_TIME_SPEED)
-            return LV2_TIME__speed;
-        if (urid == CARLA_URI_MAP_ID_TIME_TICKS_PER_BEAT)
-            return LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat;
-
-        // Others
-        if (urid == CARLA_URI_MAP_ID_MIDI_EVENT)
-            return LV2_MIDI__MidiEvent;
-        if (urid == CARLA_URI_MAP_ID_PARAM_SAMPLE_RATE)
-            return LV2_PARAMETERS__sampleRate;
-        if (urid == CARLA_URI_MAP_ID_UI_WINDOW_TITLE)
-            return LV2_UI__windowTitle;
-
-        // Custom
-        if (urid == CARLA_URI_MAP_ID_CARLA_ATOM_WORKER)
-            return URI_CARLA_ATOM_WORKER;
-        if (urid == CARLA_URI_MAP_ID_CARLA_TRANSIENT_WIN_ID)
-            return LV2_KXSTUDIO_PROPERTIES__TransientWindowId;
-
-        // Custom types
-        return ((CarlaLv2Client*)handle)->getCustomURIDString(urid);
+        if (const char* const uri = Lv2URIDMap::getInstance().unmap(urid))
+            return uri;
+
+        return "urn:null";
     }
 
     // -------------------------------------------------------------------
@@ -18,16 +18,6 @@
 #include "CarlaBridgeUI.hpp"
 #include "CarlaMIDI.h"
 
-#include "CarlaBase64Utils.hpp"
-
-// needed for atom-util
-#ifndef nullptr
-# undef NULL
-# define NULL nullptr
-#endif
-
-#include "lv2/atom-util.h"
-
 CARLA_BRIDGE_START_NAMESPACE
 
 // ---------------------------------------------------------------------
@@ -109,6 +99,13 @@ const char* CarlaBridgeUI::libError() const noexcept
 
 // ---------------------------------------------------------------------
 
+void CarlaBridgeUI::lv2AtomReceived(const uint32_t index, const LV2_Atom* const atom) noexcept
+{
+    carla_debug("CarlaBridgeUI::lv2AtomReceived(%i, %p)", index, atom);
+
+    dspAtomReceived(index, atom);
+}
+
 bool CarlaBridgeUI::msgReceived(const char* const msg) noexcept
 {
     carla_debug("CarlaBridgeUI::msgReceived(\"%s\")", msg);
@@ -181,26 +178,6 @@ bool CarlaBridgeUI::msgReceived(const char* const msg) noexcept
         dspNoteReceived(onOff, channel, note, velocity);
     }
 
-    if (std::strcmp(msg, "atom") == 0)
-    {
-        uint32_t index, size;
-        const char* base64atom;
-
-        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(index), true);
-        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(size), true);
-        CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(base64atom), true);
-
-        std::vector<uint8_t> chunk(carla_getChunkFromBase64String(base64atom));
-        delete[] base64atom;
-        CARLA_SAFE_ASSERT_RETURN(chunk.size() >= sizeof(LV2_Atom), true);
-
-        const LV2_Atom* const atom((const LV2_Atom*)chunk.data());
-        CARLA_SAFE_ASSERT_RETURN(lv2_atom_total_size(atom) == chunk.size(), true);
-
-        dspAtomReceived(index, atom);
-        return true;
-    }
-
     if (std::strcmp(msg, "urid") == 0)
     {
         uint32_t urid;
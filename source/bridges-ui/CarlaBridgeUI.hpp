@@ -153,6 +153,9 @@ protected:
     /*! @internal */
     bool msgReceived(const char* const msg) noexcept override;
 
+    /*! @internal */
+    void lv2AtomReceived(const uint32_t index, const LV2_Atom* const atom) noexcept override;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaBridgeUI)
 };
 
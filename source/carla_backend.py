@@ -151,6 +151,9 @@ MAX_RACK_PLUGINS = 16
 # Maximum number of loadable plugins in patchbay mode.
 MAX_PATCHBAY_PLUGINS = 255
 
+# Maximum number of parallel lanes in rack mode.
+MAX_RACK_LANES = 8
+
 # Maximum default number of parameters allowed.
 # @see ENGINE_OPTION_MAX_PARAMETERS
 MAX_DEFAULT_PARAMETERS = 200
@@ -699,6 +702,22 @@ ENGINE_CALLBACK_ERROR = 38
 # The engine has crashed or malfunctioned and will no longer work.
 ENGINE_CALLBACK_QUIT = 39
 
+# A plugin's DSP load has been updated, sent about once per second.
+# @a pluginId Plugin Id
+# @a value1   99th percentile of the process time, in microseconds
+# @a value2   Number of blocks that took longer than the buffer period
+# @a value3   Average process time as a percentage of the buffer period
+# @see carla_get_plugin_dsp_load()
+ENGINE_CALLBACK_PLUGIN_DSP_LOAD = 40
+
+# A plugin from the project being loaded has been added, or has failed to load.
+# @a pluginId Plugin Id, 0 if the plugin failed to load
+# @a value1   Number of plugins handled so far
+# @a value2   Total number of plugins in the project
+# @a valueStr Plugin name
+# @see ENGINE_OPTION_MAX_LOAD_THREADS
+ENGINE_CALLBACK_PROJECT_LOAD_PROGRESS = 41
+
 # ------------------------------------------------------------------------------------------------------------
 # Engine Option
 # Engine options.
@@ -757,6 +776,7 @@ ENGINE_OPTION_AUDIO_BUFFER_SIZE = 10
 ENGINE_OPTION_AUDIO_SAMPLE_RATE = 11
 
 # Audio device (within a driver).
+# For the "Dummy" driver this is the output file path, optionally prefixed by an input file path and '|'.
 # Default unset.
 ENGINE_OPTION_AUDIO_DEVICE = 12
 
@@ -782,6 +802,46 @@ ENGINE_OPTION_PREVENT_BAD_BEHAVIOUR = 16
 # Set frontend winId, used to define as parent window for plugin UIs.
 ENGINE_OPTION_FRONTEND_WIN_ID = 17
 
+# Number of extra audio threads used to process independent plugins in parallel.
+# Default is 0, which processes everything in the engine's audio thread.
+# @note Only used in rack and patchbay processing modes, cannot be changed while the engine is running
+ENGINE_OPTION_PROCESS_THREADS = 18
+
+# Compute 4x oversampled true-peak values for the plugin meters, as in ITU-R BS.1770.
+# Default is false, which only measures sample peaks and RMS.
+ENGINE_OPTION_TRUE_PEAK_METERS = 19
+
+# Run plugin bridges one block behind the engine, so they process in parallel with the rest of the audio thread.
+# Each bridged plugin then reports one block of latency.
+# Default is false.
+# @note Only applies to bridges started after this option is set
+ENGINE_OPTION_PIPELINED_BRIDGES = 20
+
+# Let plugin bridges use their shared memory audio pool as the engine port buffers, avoiding a copy on each side.
+# Default is false.
+# @note Only used in patchbay processing mode, cannot be changed while the engine is running
+# @see ENGINE_OPTION_PROCESS_THREADS
+ENGINE_OPTION_SHARED_BRIDGE_BUFFERS = 21
+
+# Host bridged plugins of the same binary type in a single bridge process, processed together with one round trip per block.
+# Value is a bitmask of binary types, as (1 << BinaryType). Binary types not in the mask keep one process per plugin,
+# so a crashing plugin only takes down its own group.
+# Grouped bridges always run pipelined, see ENGINE_OPTION_PIPELINED_BRIDGES.
+# Default is 0.
+# @note Only applies to bridges started after this option is set
+ENGINE_OPTION_GROUPED_BRIDGES = 22
+
+# Maximum rate of the engine idle thread, in Hz.
+# The thread runs when the audio thread has new plugin events, but never more often than this.
+# It also polls at this rate while plugin UIs or OSC clients need parameter output updates.
+# Default is 40.
+ENGINE_OPTION_MAX_IDLE_RATE = 23
+
+# Maximum number of threads used to create plugins and restore their state while loading a project.
+# Plugins are still added to the engine in project order. Only LADSPA, DSSI, LV2 and bridged plugins are created outside of the main thread.
+# Default is 0, which uses one thread per CPU core (up to 8). Set to 1 to load plugins one by one.
+ENGINE_OPTION_MAX_LOAD_THREADS = 24
+
 # ------------------------------------------------------------------------------------------------------------
 # Engine Process Mode
 # Engine process mode.
@@ -1133,6 +1193,55 @@ class CarlaTransportInfo(Structure):
         ("bpm", c_double)
     ]
 
+# Plugin DSP load information, measured around its process() call.
+# @see carla_get_plugin_dsp_load()
+class CarlaDspLoadInfo(Structure):
+    _fields_ = [
+        # Time used by the last processed block, in microseconds.
+        ("lastUsecs", c_float),
+
+        # Smoothed average time per block, in microseconds.
+        ("averageUsecs", c_float),
+
+        # 99th percentile of the recent blocks, in microseconds.
+        ("p99Usecs", c_float),
+
+        # Average time as a percentage of the buffer period.
+        ("periodPercent", c_float),
+
+        # Number of blocks that took longer than the buffer period.
+        ("overruns", c_uint32),
+
+        # Worker requests waiting or being worked on, for plugins with a worker (LV2 only).
+        ("workerQueueDepth", c_uint32),
+
+        # Largest worker queue depth seen.
+        ("workerMaxQueueDepth", c_uint32),
+
+        # Longest time from scheduling some work to the end of it, in microseconds.
+        ("workerMaxLatencyUsecs", c_float),
+
+        # Worker requests rejected because the queue was full.
+        ("workerDropped", c_uint32)
+    ]
+
+# Engine MIDI input timing information.
+# @see carla_get_midi_input_jitter()
+class CarlaMidiJitterInfo(Structure):
+    _fields_ = [
+        # Average delivery delay removed by timestamp correction, in microseconds.
+        ("averageUsecs", c_float),
+
+        # Largest delivery delay seen, in microseconds.
+        ("maxUsecs", c_float),
+
+        # Number of events received.
+        ("events", c_uint32),
+
+        # Events that arrived too late to be placed at their exact frame.
+        ("lateEvents", c_uint32)
+    ]
+
 # ------------------------------------------------------------------------------------------------------------
 # Carla Host API (Python compatible stuff)
 
@@ -1182,6 +1291,27 @@ PyCarlaTransportInfo = {
     "bpm": 0.0
 }
 
+# @see CarlaDspLoadInfo
+PyCarlaDspLoadInfo = {
+    'lastUsecs': 0.0,
+    'averageUsecs': 0.0,
+    'p99Usecs': 0.0,
+    'periodPercent': 0.0,
+    'overruns': 0,
+    'workerQueueDepth': 0,
+    'workerMaxQueueDepth': 0,
+    'workerMaxLatencyUsecs': 0.0,
+    'workerDropped': 0
+}
+
+# @see CarlaMidiJitterInfo
+PyCarlaMidiJitterInfo = {
+    'averageUsecs': 0.0,
+    'maxUsecs': 0.0,
+    'events': 0,
+    'lateEvents': 0
+}
+
 # ------------------------------------------------------------------------------------------------------------
 # Set BINARY_NATIVE
 
@@ -1636,6 +1766,19 @@ class CarlaHostMeta(object):
     def get_output_peak_value(self, pluginId, isLeft):
         raise NotImplementedError
 
+    # Get a plugin's DSP load.
+    # Use this to find which plugin is using most of the audio period.
+    # @param pluginId Plugin
+    @abstractmethod
+    def get_plugin_dsp_load(self, pluginId):
+        raise NotImplementedError
+
+    # Get the timing of incoming MIDI events.
+    # Only the RtAudio drivers timestamp MIDI input, other drivers report zeros.
+    @abstractmethod
+    def get_midi_input_jitter(self):
+        raise NotImplementedError
+
     # Enable a plugin's option.
     # @param pluginId Plugin
     # @param option   An option from PluginOptions
@@ -1693,7 +1836,17 @@ class CarlaHostMeta(object):
     def set_ctrl_channel(self, pluginId, channel):
         raise NotImplementedError
 
+    # Change a plugin's rack lane.
+    # Plugins in different lanes are processed in parallel, see ENGINE_OPTION_PROCESS_THREADS.
+    # @param pluginId Plugin
+    # @param lane     New lane, lower than MAX_RACK_LANES
+    @abstractmethod
+    def set_rack_lane(self, pluginId, lane):
+        raise NotImplementedError
+
     # Change a plugin's parameter value.
+    # While the engine is running the change is applied at the start of the next processed block,
+    # get_current_parameter_value() returns the previous value until then.
     # @param pluginId    Plugin
     # @param parameterId Parameter index
     # @param value       New value
@@ -2007,6 +2160,12 @@ class CarlaHostNull(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return 0.0
 
+    def get_plugin_dsp_load(self, pluginId):
+        return PyCarlaDspLoadInfo
+
+    def get_midi_input_jitter(self):
+        return PyCarlaMidiJitterInfo
+
     def set_option(self, pluginId, option, yesNo):
         return
 
@@ -2031,6 +2190,9 @@ class CarlaHostNull(CarlaHostMeta):
     def set_ctrl_channel(self, pluginId, channel):
         return
 
+    def set_rack_lane(self, pluginId, lane):
+        return
+
     def set_parameter_value(self, pluginId, parameterId, value):
         return
 
@@ -2274,6 +2436,12 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_get_output_peak_value.argtypes = [c_uint, c_bool]
         self.lib.carla_get_output_peak_value.restype = c_float
 
+        self.lib.carla_get_plugin_dsp_load.argtypes = [c_uint]
+        self.lib.carla_get_plugin_dsp_load.restype = POINTER(CarlaDspLoadInfo)
+
+        self.lib.carla_get_midi_input_jitter.argtypes = None
+        self.lib.carla_get_midi_input_jitter.restype = POINTER(CarlaMidiJitterInfo)
+
         self.lib.carla_set_option.argtypes = [c_uint, c_uint, c_bool]
         self.lib.carla_set_option.restype = None
 
@@ -2298,6 +2466,9 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_set_ctrl_channel.argtypes = [c_uint, c_int8]
         self.lib.carla_set_ctrl_channel.restype = None
 
+        self.lib.carla_set_rack_lane.argtypes = [c_uint, c_uint]
+        self.lib.carla_set_rack_lane.restype = None
+
         self.lib.carla_set_parameter_value.argtypes = [c_uint, c_uint32, c_float]
         self.lib.carla_set_parameter_value.restype = None
 
@@ -2542,6 +2713,12 @@ class CarlaHostDLL(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return float(self.lib.carla_get_output_peak_value(pluginId, isLeft))
 
+    def get_plugin_dsp_load(self, pluginId):
+        return structToDict(self.lib.carla_get_plugin_dsp_load(pluginId).contents)
+
+    def get_midi_input_jitter(self):
+        return structToDict(self.lib.carla_get_midi_input_jitter().contents)
+
     def set_option(self, pluginId, option, yesNo):
         self.lib.carla_set_option(pluginId, option, yesNo)
 
@@ -2566,6 +2743,9 @@ class CarlaHostDLL(CarlaHostMeta):
     def set_ctrl_channel(self, pluginId, channel):
         self.lib.carla_set_ctrl_channel(pluginId, channel)
 
+    def set_rack_lane(self, pluginId, lane):
+        self.lib.carla_set_rack_lane(pluginId, lane)
+
     def set_parameter_value(self, pluginId, parameterId, value):
         self.lib.carla_set_parameter_value(pluginId, parameterId, value)
 
@@ -2647,7 +2827,8 @@ class PluginStoreInfo(object):
         'midiProgramData',
         'customDataCount',
         'customData',
-        'peaks'
+        'peaks',
+        'dspLoad'
     ]
 
 # ------------------------------------------------------------------------------------------------------------
@@ -2877,6 +3058,12 @@ class CarlaHostPlugin(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return self.fPluginsInfo[pluginId].peaks[2 if isLeft else 3]
 
+    def get_plugin_dsp_load(self, pluginId):
+        return self.fPluginsInfo[pluginId].dspLoad
+
+    def get_midi_input_jitter(self):
+        return PyCarlaMidiJitterInfo
+
     def set_option(self, pluginId, option, yesNo):
         self.sendMsg(["set_option", pluginId, option, yesNo])
 
@@ -2908,6 +3095,9 @@ class CarlaHostPlugin(CarlaHostMeta):
         self.sendMsg(["set_ctrl_channel", pluginId, channel])
         self.fPluginsInfo[pluginId].internalValues[6] = float(channel)
 
+    def set_rack_lane(self, pluginId, lane):
+        self.sendMsg(["set_rack_lane", pluginId, lane])
+
     def set_parameter_value(self, pluginId, parameterId, value):
         self.sendMsg(["set_parameter_value", pluginId, parameterId, value])
         self.fPluginsInfo[pluginId].parameterValues[parameterId] = value
@@ -3009,6 +3199,7 @@ class CarlaHostPlugin(CarlaHostMeta):
         info.customDataCount = 0
         info.customData      = []
         info.peaks = [0.0, 0.0, 0.0, 0.0]
+        info.dspLoad = deepcopy(PyCarlaDspLoadInfo)
         self.fPluginsInfo.append(info)
 
     def _set_pluginInfo(self, pluginId, info):
@@ -3133,4 +3324,7 @@ class CarlaHostPlugin(CarlaHostMeta):
     def _set_peaks(self, pluginId, in1, in2, out1, out2):
         self.fPluginsInfo[pluginId].peaks = [in1, in2, out1, out2]
 
+    def _set_dspLoad(self, pluginId, info):
+        self.fPluginsInfo[pluginId].dspLoad.update(info)
+
 # ------------------------------------------------------------------------------------------------------------
@@ -84,6 +84,8 @@ class CarlaHostSignals(QObject):
     InfoCallback = pyqtSignal(str)
     ErrorCallback = pyqtSignal(str)
     QuitCallback = pyqtSignal()
+    PluginDspLoadCallback = pyqtSignal(int, int, int, float)
+    ProjectLoadProgressCallback = pyqtSignal(int, int, str)
 
 # ------------------------------------------------------------------------------------------------------------
 # Carla Host object (dummy/null, does nothing)
@@ -359,6 +359,13 @@ class CarlaControlServerThread(ServerThread):
         pluginId, in1, in2, out1, out2 = args
         self.host._set_peaks(pluginId, in1, in2, out1, out2)
 
+    @make_method('/carla-control/set_dsp_load', 'iffffi')
+    def set_dsp_load_callback(self, path, args):
+        pluginId, lastUsecs, averageUsecs, p99Usecs, periodPercent, overruns = args
+        self.host._set_dspLoad(pluginId, {'lastUsecs': lastUsecs, 'averageUsecs': averageUsecs, 'p99Usecs': p99Usecs,
+                                          'periodPercent': periodPercent, 'overruns': overruns})
+        self.host.PluginDspLoadCallback.emit(pluginId, int(p99Usecs), overruns, periodPercent)
+
     @make_method('/carla-control/exit', '')
     def set_exit_callback(self, path, args):
         print(path, args)
@@ -2109,6 +2109,10 @@ def engineCallback(host, action, pluginId, value1, value2, value3, valueStr):
         host.ErrorCallback.emit(valueStr)
     elif action == ENGINE_CALLBACK_QUIT:
         host.QuitCallback.emit()
+    elif action == ENGINE_CALLBACK_PLUGIN_DSP_LOAD:
+        host.PluginDspLoadCallback.emit(pluginId, value1, value2, value3)
+    elif action == ENGINE_CALLBACK_PROJECT_LOAD_PROGRESS:
+        host.ProjectLoadProgressCallback.emit(value1, value2, valueStr)
 
 # ------------------------------------------------------------------------------------------------------------
 # File callback
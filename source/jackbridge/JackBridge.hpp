@@ -400,5 +400,6 @@ __cdecl void  jackbridge_shm_init(void* shm) noexcept;
 __cdecl void  jackbridge_shm_attach(void* shm, const char* name) noexcept;
 __cdecl void  jackbridge_shm_close(void* shm) noexcept;
 __cdecl void* jackbridge_shm_map(void* shm, size_t size) noexcept;
+__cdecl void  jackbridge_shm_unmap(void* shm, void* ptr) noexcept;
 
 #endif // JACKBRIDGE_HPP_INCLUDED
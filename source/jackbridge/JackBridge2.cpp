@@ -28,8 +28,14 @@
 
 bool jackbridge_sem_init(void* sem) noexcept
 {
-#ifdef JACKBRIDGE_DUMMY
+#if defined(JACKBRIDGE_DUMMY)
     return false;
+#elif defined(CARLA_OS_LINUX)
+    // bridge semaphores have room for a sem_t, the futex version is smaller
+    static_assert(sizeof(carla_sem_futex_t) <= sizeof(sem_t), "futex semaphore does not fit");
+
+    carla_sem_futex_init((carla_sem_futex_t*)sem);
+    return true;
 #else
     sem_t* const sema(carla_sem_create());
     CARLA_SAFE_ASSERT_RETURN(sema != nullptr, false);
@@ -45,15 +51,20 @@ bool jackbridge_sem_init(void* sem) noexcept
 
 void jackbridge_sem_destroy(void* sem) noexcept
 {
-#ifndef JACKBRIDGE_DUMMY
+#if defined(CARLA_OS_LINUX)
+    // nothing to do
+    (void)sem;
+#elif ! defined(JACKBRIDGE_DUMMY)
     carla_sem_destroy((sem_t*)sem);
 #endif
 }
 
 bool jackbridge_sem_post(void* sem) noexcept
 {
-#ifdef JACKBRIDGE_DUMMY
+#if defined(JACKBRIDGE_DUMMY)
     return false;
+#elif defined(CARLA_OS_LINUX)
+    return carla_sem_futex_post((carla_sem_futex_t*)sem);
 #else
     return carla_sem_post((sem_t*)sem);
 #endif
@@ -63,10 +74,14 @@ bool jackbridge_sem_timedwait(void* sem, uint secs, bool* timedOut) noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(timedOut != nullptr, false);
 
-#ifdef JACKBRIDGE_DUMMY
+#if defined(JACKBRIDGE_DUMMY)
     return false;
 #else
+# ifdef CARLA_OS_LINUX
+    if (carla_sem_futex_timedwait((carla_sem_futex_t*)sem, secs))
+# else
     if (carla_sem_timedwait((sem_t*)sem, secs))
+# endif
     {
         *timedOut = false;
         return true;
@@ -127,4 +142,13 @@ void* jackbridge_shm_map(void* shm, size_t size) noexcept
 #endif
 }
 
+void jackbridge_shm_unmap(void* shm, void* ptr) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(shm != nullptr,);
+
+#ifndef JACKBRIDGE_DUMMY
+    carla_shm_unmap(*(shm_t*)shm, ptr);
+#endif
+}
+
 // -----------------------------------------------------------------------------
@@ -133,6 +133,7 @@ const JackBridgeExportedFunctions* jackbridge_get_exported_functions()
     funcs.shm_attach_ptr                       = jackbridge_shm_attach;
     funcs.shm_close_ptr                        = jackbridge_shm_close;
     funcs.shm_map_ptr                          = jackbridge_shm_map;
+    funcs.shm_unmap_ptr                        = jackbridge_shm_unmap;
 
     return &funcs;
 }
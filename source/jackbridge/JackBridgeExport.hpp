@@ -117,6 +117,7 @@ typedef void (__cdecl *jackbridgesym_shm_init)(void* shm);
 typedef void (__cdecl *jackbridgesym_shm_attach)(void* shm, const char* name);
 typedef void (__cdecl *jackbridgesym_shm_close)(void* shm);
 typedef void* (__cdecl *jackbridgesym_shm_map)(void* shm, size_t size);
+typedef void (__cdecl *jackbridgesym_shm_unmap)(void* shm, void* ptr);
 
 } // extern "C"
 
@@ -221,6 +222,7 @@ struct JackBridgeExportedFunctions {
     jackbridgesym_shm_attach shm_attach_ptr;
     jackbridgesym_shm_close shm_close_ptr;
     jackbridgesym_shm_map shm_map_ptr;
+    jackbridgesym_shm_unmap shm_unmap_ptr;
     ulong unique2;
 };
 
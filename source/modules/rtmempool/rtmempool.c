@@ -16,122 +16,209 @@
  * For a full copy of the GNU General Public License see the GPL.txt file
  */
 
-#include "list.h"
 #include "rtmempool.h"
 #include "rtmempool-lv2.h"
 
 #include <assert.h>
 #include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef _WIN32
+# include <sys/mman.h>
+#endif
+
 // ------------------------------------------------------------------------------------------------
+// Pool memory is a set of contiguous arenas, the first one holds maxPreallocated chunks.
+// Free chunks are kept in a lock-free stack of chunk indexes, the head is tagged to avoid ABA.
+// Arenas are only added by allocate_sleepy when the pool runs dry, and only freed on destroy.
 
-typedef struct list_head k_list_head;
+#define RTMEMPOOL_MAX_ARENAS 16
+#define RTMEMPOOL_NODE_NULL  UINT32_MAX
 
-// ------------------------------------------------------------------------------------------------
+typedef struct _RtMemPoolNode
+{
+    uint32_t index;
+    uint32_t next;
+
+} RtMemPoolNode;
+
+// keep chunk data aligned for any type
+#define RTMEMPOOL_HEADER_SIZE 16
+
+typedef struct _RtMemPoolArena
+{
+    char* memory;
+    size_t memorySize;
+    uint32_t firstIndex;
+    uint32_t count;
+
+} RtMemPoolArena;
 
 typedef struct _RtMemPool
 {
     char name[RTSAFE_MEMORY_POOL_NAME_MAX];
 
     size_t dataSize;
+    size_t nodeSize;
     size_t minPreallocated;
     size_t maxPreallocated;
 
-    k_list_head used;
-    unsigned int usedCount;
-
-    k_list_head unused;
-    unsigned int unusedCount;
-
-    bool enforceThreadSafety;
+    // tagged free-list head, low 32 bits are the node index
+    uint64_t freeHead;
+    uint32_t usedCount;
 
-    // next members are initialized/used only if enforceThreadSafety is true
-    pthread_mutex_t mutex;
-    unsigned int unusedCount2;
-    k_list_head pending;
-    size_t usedSize;
+    // arenas are published via arenaCount, new ones are added with growMutex held
+    RtMemPoolArena arenas[RTMEMPOOL_MAX_ARENAS];
+    uint32_t arenaCount;
+    uint32_t nodeCount;
+    pthread_mutex_t growMutex;
 
 } RtMemPool;
 
 // ------------------------------------------------------------------------------------------------
-// adjust unused list size
+// arena memory, locked and pre-faulted so the RT side never takes a page fault
 
-static void rtsafe_memory_pool_sleepy(RtMemPool* poolPtr)
+static char* rtsafe_memory_pool_arena_alloc(size_t size)
 {
-    k_list_head* nodePtr;
-    unsigned int count;
+    char* memory;
 
-    if (poolPtr->enforceThreadSafety)
+#ifdef _WIN32
+    memory = malloc(size);
+
+    if (memory == NULL)
     {
-        pthread_mutex_lock(&poolPtr->mutex);
+        return NULL;
+    }
+#else
+    memory = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
 
-        count = poolPtr->unusedCount2;
+    if (memory == MAP_FAILED)
+    {
+        return NULL;
+    }
 
-        assert(poolPtr->minPreallocated < poolPtr->maxPreallocated);
+    // may fail without enough RLIMIT_MEMLOCK, the memset below still faults the pages in
+    mlock(memory, size);
+#endif
 
-        while (count < poolPtr->minPreallocated)
-        {
-            nodePtr = malloc(sizeof(k_list_head) + poolPtr->dataSize);
+    memset(memory, 0, size);
+    return memory;
+}
 
-            if (nodePtr == NULL)
-            {
-                break;
-            }
+static void rtsafe_memory_pool_arena_free(char* memory, size_t size)
+{
+#ifdef _WIN32
+    free(memory);
+    (void)size;
+#else
+    munlock(memory, size);
+    munmap(memory, size);
+#endif
+}
 
-            list_add_tail(nodePtr, &poolPtr->pending);
+// ------------------------------------------------------------------------------------------------
+// lock-free free-list
 
-            count++;
+static RtMemPoolNode* rtsafe_memory_pool_get_node(RtMemPool* poolPtr, uint32_t index)
+{
+    const uint32_t arenaCount = __atomic_load_n(&poolPtr->arenaCount, __ATOMIC_ACQUIRE);
 
-            poolPtr->usedSize += poolPtr->dataSize;
-        }
+    for (uint32_t i = 0; i < arenaCount; ++i)
+    {
+        const RtMemPoolArena* const arena = &poolPtr->arenas[i];
 
-        while (count > poolPtr->maxPreallocated && ! list_empty(&poolPtr->pending))
+        if (index - arena->firstIndex < arena->count)
         {
-            nodePtr = poolPtr->pending.next;
+            return (RtMemPoolNode*)(arena->memory + (index - arena->firstIndex) * poolPtr->nodeSize);
+        }
+    }
 
-            list_del(nodePtr);
+    assert(0);
+    return NULL;
+}
 
-            free(nodePtr);
+static RtMemPoolNode* rtsafe_memory_pool_pop(RtMemPool* poolPtr)
+{
+    uint64_t head = __atomic_load_n(&poolPtr->freeHead, __ATOMIC_ACQUIRE);
+    uint64_t newHead;
+    RtMemPoolNode* nodePtr;
 
-            count--;
+    do {
+        const uint32_t index = (uint32_t)head;
 
-            poolPtr->usedSize -= poolPtr->dataSize;
+        if (index == RTMEMPOOL_NODE_NULL)
+        {
+            return NULL;
         }
 
-        pthread_mutex_unlock(&poolPtr->mutex);
+        // node memory is never released while the pool lives, a stale read just fails the CAS
+        nodePtr = rtsafe_memory_pool_get_node(poolPtr, index);
+        newHead = (((head >> 32) + 1) << 32) | __atomic_load_n(&nodePtr->next, __ATOMIC_RELAXED);
     }
-    else
-    {
-        while (poolPtr->unusedCount < poolPtr->minPreallocated)
-        {
-            nodePtr = malloc(sizeof(k_list_head) + poolPtr->dataSize);
+    while (! __atomic_compare_exchange_n(&poolPtr->freeHead, &head, newHead, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
 
-            if (nodePtr == NULL)
-            {
-                return;
-            }
+    __atomic_add_fetch(&poolPtr->usedCount, 1, __ATOMIC_RELAXED);
+    return nodePtr;
+}
 
-            list_add_tail(nodePtr, &poolPtr->unused);
-            poolPtr->unusedCount++;
-            poolPtr->usedSize += poolPtr->dataSize;
-        }
+static void rtsafe_memory_pool_push(RtMemPool* poolPtr, RtMemPoolNode* nodePtr)
+{
+    uint64_t head = __atomic_load_n(&poolPtr->freeHead, __ATOMIC_RELAXED);
+    uint64_t newHead;
 
-        while (poolPtr->unusedCount > poolPtr->maxPreallocated)
-        {
-            assert(! list_empty(&poolPtr->unused));
+    do {
+        __atomic_store_n(&nodePtr->next, (uint32_t)head, __ATOMIC_RELAXED);
+        newHead = (((head >> 32) + 1) << 32) | nodePtr->index;
+    }
+    while (! __atomic_compare_exchange_n(&poolPtr->freeHead, &head, newHead, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
 
-            nodePtr = poolPtr->unused.next;
+// ------------------------------------------------------------------------------------------------
+// add a new arena of 'count' chunks and push them all into the free-list
 
-            list_del(nodePtr);
-            poolPtr->unusedCount--;
+static bool rtsafe_memory_pool_grow(RtMemPool* poolPtr, size_t count)
+{
+    RtMemPoolArena* arena;
+    RtMemPoolNode* nodePtr;
+    bool ok = false;
 
-            free(nodePtr);
-            poolPtr->usedSize -= poolPtr->dataSize;
-        }
+    pthread_mutex_lock(&poolPtr->growMutex);
+
+    if (poolPtr->arenaCount == RTMEMPOOL_MAX_ARENAS || count == 0 || count >= RTMEMPOOL_NODE_NULL - poolPtr->nodeCount)
+    {
+        goto end;
+    }
+
+    arena = &poolPtr->arenas[poolPtr->arenaCount];
+    arena->memorySize = count * poolPtr->nodeSize;
+    arena->memory     = rtsafe_memory_pool_arena_alloc(arena->memorySize);
+
+    if (arena->memory == NULL)
+    {
+        goto end;
     }
+
+    arena->firstIndex = poolPtr->nodeCount;
+    arena->count      = (uint32_t)count;
+
+    __atomic_store_n(&poolPtr->nodeCount, poolPtr->nodeCount + (uint32_t)count, __ATOMIC_RELAXED);
+    __atomic_store_n(&poolPtr->arenaCount, poolPtr->arenaCount + 1, __ATOMIC_RELEASE);
+
+    for (uint32_t i = 0; i < arena->count; ++i)
+    {
+        nodePtr = (RtMemPoolNode*)(arena->memory + i * poolPtr->nodeSize);
+        nodePtr->index = arena->firstIndex + i;
+        rtsafe_memory_pool_push(poolPtr, nodePtr);
+    }
+
+    ok = true;
+
+end:
+    pthread_mutex_unlock(&poolPtr->growMutex);
+    return ok;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -140,8 +227,7 @@ static bool rtsafe_memory_pool_create2(RtMemPool_Handle* handlePtr,
                                        const char* poolName,
                                        size_t dataSize,
                                        size_t minPreallocated,
-                                       size_t maxPreallocated,
-                                       int enforceThreadSafety)
+                                       size_t maxPreallocated)
 {
     assert(minPreallocated <= maxPreallocated);
     assert(poolName == NULL || strlen(poolName) < RTSAFE_MEMORY_POOL_NAME_MAX);
@@ -155,6 +241,8 @@ static bool rtsafe_memory_pool_create2(RtMemPool_Handle* handlePtr,
         return false;
     }
 
+    memset(poolPtr, 0, sizeof(RtMemPool));
+
     if (poolName != NULL)
     {
         strcpy(poolPtr->name, poolName);
@@ -165,32 +253,25 @@ static bool rtsafe_memory_pool_create2(RtMemPool_Handle* handlePtr,
     }
 
     poolPtr->dataSize = dataSize;
+    poolPtr->nodeSize = (RTMEMPOOL_HEADER_SIZE + dataSize + RTMEMPOOL_HEADER_SIZE - 1) & ~(size_t)(RTMEMPOOL_HEADER_SIZE - 1);
     poolPtr->minPreallocated = minPreallocated;
     poolPtr->maxPreallocated = maxPreallocated;
+    poolPtr->freeHead = RTMEMPOOL_NODE_NULL;
 
-    INIT_LIST_HEAD(&poolPtr->used);
-    poolPtr->usedCount = 0;
-
-    INIT_LIST_HEAD(&poolPtr->unused);
-    poolPtr->unusedCount = 0;
-
-    poolPtr->enforceThreadSafety = (enforceThreadSafety != 0);
-
-    if (poolPtr->enforceThreadSafety)
+    if (pthread_mutex_init(&poolPtr->growMutex, NULL) != 0)
     {
-        if (pthread_mutex_init(&poolPtr->mutex, NULL) != 0)
-        {
-            free(poolPtr);
-            return false;
-        }
-
-        INIT_LIST_HEAD(&poolPtr->pending);
+        free(poolPtr);
+        return false;
     }
 
-    poolPtr->unusedCount2 = 0;
-    poolPtr->usedSize = 0;
+    // the whole working set is allocated up-front
+    if (! rtsafe_memory_pool_grow(poolPtr, maxPreallocated > 0 ? maxPreallocated : 1))
+    {
+        pthread_mutex_destroy(&poolPtr->growMutex);
+        free(poolPtr);
+        return false;
+    }
 
-    rtsafe_memory_pool_sleepy(poolPtr);
     *handlePtr = (RtMemPool_Handle)poolPtr;
 
     return true;
@@ -200,7 +281,7 @@ static bool rtsafe_memory_pool_create2(RtMemPool_Handle* handlePtr,
 
 static unsigned char rtsafe_memory_pool_create_old(const char* poolName, size_t dataSize, size_t minPreallocated, size_t maxPreallocated, RtMemPool_Handle* handlePtr)
 {
-    return rtsafe_memory_pool_create2(handlePtr, poolName, dataSize, minPreallocated, maxPreallocated, 0);
+    return rtsafe_memory_pool_create2(handlePtr, poolName, dataSize, minPreallocated, maxPreallocated);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -211,10 +292,11 @@ bool rtsafe_memory_pool_create(RtMemPool_Handle* handlePtr,
                                size_t minPreallocated,
                                size_t maxPreallocated)
 {
-    return rtsafe_memory_pool_create2(handlePtr, poolName, dataSize, minPreallocated, maxPreallocated, 0);
+    return rtsafe_memory_pool_create2(handlePtr, poolName, dataSize, minPreallocated, maxPreallocated);
 }
 
 // ------------------------------------------------------------------------------------------------
+// all pools are thread-safe now, kept for API compatibility
 
 bool rtsafe_memory_pool_create_safe(RtMemPool_Handle* handlePtr,
                                     const char* poolName,
@@ -222,7 +304,7 @@ bool rtsafe_memory_pool_create_safe(RtMemPool_Handle* handlePtr,
                                     size_t minPreallocated,
                                     size_t maxPreallocated)
 {
-    return rtsafe_memory_pool_create2(handlePtr, poolName, dataSize, minPreallocated, maxPreallocated, 1);
+    return rtsafe_memory_pool_create2(handlePtr, poolName, dataSize, minPreallocated, maxPreallocated);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -231,7 +313,6 @@ void rtsafe_memory_pool_destroy(RtMemPool_Handle handle)
 {
     assert(handle);
 
-    k_list_head* nodePtr;
     RtMemPool* poolPtr = (RtMemPool*)handle;
 
     // caller should deallocate all chunks prior releasing pool itself
@@ -240,88 +321,44 @@ void rtsafe_memory_pool_destroy(RtMemPool_Handle handle)
         assert(0);
     }
 
-    while (poolPtr->unusedCount != 0)
+    for (uint32_t i = 0; i < poolPtr->arenaCount; ++i)
     {
-        assert(! list_empty(&poolPtr->unused));
-
-        nodePtr = poolPtr->unused.next;
-
-        list_del(nodePtr);
-        poolPtr->unusedCount--;
-
-        free(nodePtr);
+        rtsafe_memory_pool_arena_free(poolPtr->arenas[i].memory, poolPtr->arenas[i].memorySize);
     }
 
-    assert(list_empty(&poolPtr->unused));
-
-    if (poolPtr->enforceThreadSafety)
-    {
-        while (! list_empty(&poolPtr->pending))
-        {
-            nodePtr = poolPtr->pending.next;
-
-            list_del(nodePtr);
-
-            free(nodePtr);
-        }
-
-        int ret = pthread_mutex_destroy(&poolPtr->mutex);
+    int ret = pthread_mutex_destroy(&poolPtr->growMutex);
 
 #ifdef DEBUG
-        assert(ret == 0);
+    assert(ret == 0);
 #else
-        // unused
-        (void)ret;
+    // unused
+    (void)ret;
 #endif
-    }
 
     free(poolPtr);
 }
 
 // ------------------------------------------------------------------------------------------------
-// find entry in unused list, fail if it is empty
+// pop from the free-list, fail if it is empty
 
 void* rtsafe_memory_pool_allocate_atomic(RtMemPool_Handle handle)
 {
     assert(handle);
 
-    k_list_head* nodePtr;
     RtMemPool* poolPtr = (RtMemPool*)handle;
+    RtMemPoolNode* nodePtr = rtsafe_memory_pool_pop(poolPtr);
 
-    if (list_empty(&poolPtr->unused))
+    if (nodePtr == NULL)
     {
         return NULL;
     }
 
-    nodePtr = poolPtr->unused.next;
-    list_del(nodePtr);
-
-    poolPtr->unusedCount--;
-    poolPtr->usedCount++;
-
-    list_add_tail(nodePtr, &poolPtr->used);
-
-    if (poolPtr->enforceThreadSafety && pthread_mutex_trylock(&poolPtr->mutex) == 0)
-    {
-        while (poolPtr->unusedCount < poolPtr->minPreallocated && ! list_empty(&poolPtr->pending))
-        {
-            nodePtr = poolPtr->pending.next;
-
-            list_del(nodePtr);
-            list_add_tail(nodePtr, &poolPtr->unused);
-
-            poolPtr->unusedCount++;
-        }
-
-        poolPtr->unusedCount2 = poolPtr->unusedCount;
-
-        pthread_mutex_unlock(&poolPtr->mutex);
-    }
-
-    return (nodePtr + 1);
+    return (char*)nodePtr + RTMEMPOOL_HEADER_SIZE;
 }
 
 // ------------------------------------------------------------------------------------------------
+// grow the pool when empty, each new arena doubles the pool size
+// fails when the pool can't grow anymore
 
 void* rtsafe_memory_pool_allocate_sleepy(RtMemPool_Handle handle)
 {
@@ -330,47 +367,29 @@ void* rtsafe_memory_pool_allocate_sleepy(RtMemPool_Handle handle)
     void* data;
     RtMemPool* poolPtr = (RtMemPool*)handle;
 
-    do {
-        rtsafe_memory_pool_sleepy(poolPtr);
-        data = rtsafe_memory_pool_allocate_atomic((RtMemPool_Handle)poolPtr);
+    while ((data = rtsafe_memory_pool_allocate_atomic(handle)) == NULL)
+    {
+        if (! rtsafe_memory_pool_grow(poolPtr, __atomic_load_n(&poolPtr->nodeCount, __ATOMIC_RELAXED)))
+        {
+            // another thread might have released a chunk in the meantime
+            return rtsafe_memory_pool_allocate_atomic(handle);
+        }
     }
-    while (data == NULL);
 
     return data;
 }
 
 // ------------------------------------------------------------------------------------------------
-// move from used to unused list
+// push back into the free-list
 
 void rtsafe_memory_pool_deallocate(RtMemPool_Handle handle, void* memoryPtr)
 {
     assert(handle);
 
-    k_list_head* nodePtr;
     RtMemPool* poolPtr = (RtMemPool*)handle;
 
-    list_del((k_list_head*)memoryPtr - 1);
-    list_add_tail((k_list_head*)memoryPtr - 1, &poolPtr->unused);
-    poolPtr->usedCount--;
-    poolPtr->unusedCount++;
-
-    if (poolPtr->enforceThreadSafety && pthread_mutex_trylock(&poolPtr->mutex) == 0)
-    {
-        while (poolPtr->unusedCount > poolPtr->maxPreallocated)
-        {
-            assert(! list_empty(&poolPtr->unused));
-
-            nodePtr = poolPtr->unused.next;
-
-            list_del(nodePtr);
-            list_add_tail(nodePtr, &poolPtr->pending);
-            poolPtr->unusedCount--;
-        }
-
-        poolPtr->unusedCount2 = poolPtr->unusedCount;
-
-        pthread_mutex_unlock(&poolPtr->mutex);
-    }
+    rtsafe_memory_pool_push(poolPtr, (RtMemPoolNode*)((char*)memoryPtr - RTMEMPOOL_HEADER_SIZE));
+    __atomic_sub_fetch(&poolPtr->usedCount, 1, __ATOMIC_RELAXED);
 }
 
 void lv2_rtmempool_init(LV2_RtMemPool_Pool* poolPtr)
@@ -42,7 +42,7 @@ typedef void* RtMemPool_Handle;
  * @param poolName pool name, for debug purposes, max RTSAFE_MEMORY_POOL_NAME_MAX chars, including terminating zero char. May be NULL.
  * @param dataSize memory chunk size
  * @param minPreallocated min chunks preallocated
- * @param maxPreallocated max chunks preallocated
+ * @param maxPreallocated max chunks preallocated, all of them are allocated up-front in one locked arena
  *
  * @return Success status, true if successful
  */
@@ -60,7 +60,7 @@ bool rtsafe_memory_pool_create(RtMemPool_Handle* handlePtr,
  * @param poolName pool name, for debug purposes, max RTSAFE_MEMORY_POOL_NAME_MAX chars, including terminating zero char. May be NULL.
  * @param dataSize memory chunk size
  * @param minPreallocated min chunks preallocated
- * @param maxPreallocated max chunks preallocated
+ * @param maxPreallocated max chunks preallocated, all of them are allocated up-front in one locked arena
  *
  * @return Success status, true if successful
  */
@@ -80,7 +80,7 @@ void rtsafe_memory_pool_destroy(RtMemPool_Handle handle);
 /**
  * Allocate memory in context where sleeping is not allowed
  *
- * <b>will not sleep</b>
+ * <b>will not sleep</b>, lock-free and safe to call from any thread
  *
  * @return Pointer to allocated memory or NULL if memory no memory is available
  */
@@ -89,7 +89,7 @@ void* rtsafe_memory_pool_allocate_atomic(RtMemPool_Handle handle);
 /**
  * Allocate memory in context where sleeping is allowed
  *
- * <b>may/will sleep</b>
+ * <b>may/will sleep</b>, grows the pool if it is empty
  *
  * @return Pointer to allocated memory or NULL if memory no memory is available (should not happen under normal conditions)
  */
@@ -98,7 +98,7 @@ void* rtsafe_memory_pool_allocate_sleepy(RtMemPool_Handle handle);
 /**
  * Deallocate previously allocated memory
  *
- * <b>will not sleep</b>
+ * <b>will not sleep</b>, lock-free and safe to call from any thread
  *
  * @param memoryPtr pointer to previously allocated memory chunk
  */
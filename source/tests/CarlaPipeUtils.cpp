@@ -1,6 +1,6 @@
 /*
- * Carla Utility Tests
- * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
  *
  * This program is free software; you can redistribute it and/or
  * modify it under the terms of the GNU General Public License as
@@ -15,7 +15,52 @@
  * For a full copy of the GNU General Public License see the doc/GPL.txt file.
  */
 
-#include "CarlaPipeUtils.hpp"
+// the test classes look into the atom ring, so they need the full implementation
+#include "../utils/CarlaPipeUtils.cpp"
+
+// -----------------------------------------------------------------------
+// The server starts this same binary as the client.
+// Atoms and text messages are sent interleaved, through the shared memory ring once negotiated,
+// and the client checks that everything arrives in order and intact.
+// Before that the client maps a URI like a bridged LV2 UI, the server has more URIDs than fit in 1 answer.
+
+static const uint32_t kAtomBodySize = 4096;
+static const uint32_t kEchoIndex    = 99;
+static const uint32_t kHostURIs     = 400;
+
+// URID n is gURIs[n-1], the last one is only mapped when the client asks for it
+static char gURIs[kHostURIs+1][64];
+
+struct TestAtom {
+    LV2_Atom atom;
+    uint8_t body[kAtomBodySize];
+};
+
+static void fillAtom(TestAtom& testAtom, const uint32_t value)
+{
+    testAtom.atom.size = kAtomBodySize;
+    testAtom.atom.type = 1;
+    std::memset(testAtom.body, static_cast<int>(value & 0xff), kAtomBodySize);
+    std::memcpy(testAtom.body, &value, sizeof(uint32_t));
+}
+
+static bool checkAtom(const LV2_Atom* const atom, const uint32_t value)
+{
+    CARLA_SAFE_ASSERT_RETURN(atom->size == kAtomBodySize, false);
+
+    const uint8_t* const body((const uint8_t*)LV2_ATOM_BODY_CONST(atom));
+
+    uint32_t atomValue;
+    std::memcpy(&atomValue, body, sizeof(uint32_t));
+    CARLA_SAFE_ASSERT_RETURN(atomValue == value, false);
+
+    for (uint32_t i=sizeof(uint32_t); i < kAtomBodySize; ++i)
+    {
+        CARLA_SAFE_ASSERT_RETURN(body[i] == (value & 0xff), false);
+    }
+
+    return true;
+}
 
 // -----------------------------------------------------------------------
 
@@ -23,79 +68,343 @@ class CarlaPipeClient2 : public CarlaPipeClient
 {
 public:
     CarlaPipeClient2()
-        : CarlaPipeClient() {}
+        : CarlaPipeClient(),
+          fNext(0),
+          fOk(true),
+          fDone(false),
+          fQuit(false) {}
+
+    bool isAtomRingReady() const noexcept
+    {
+        return pData->atomRing != nullptr && pData->atomRing->ready;
+    }
+
+    bool isDone() const noexcept
+    {
+        return fDone;
+    }
+
+    bool shouldQuit() const noexcept
+    {
+        return fQuit;
+    }
 
     bool msgReceived(const char* const msg) noexcept override
     {
+        if (std::strcmp(msg, "control") == 0)
+        {
+            uint32_t index;
+            float value;
+
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(index), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsFloat(value), true);
+
+            received(index == fNext && static_cast<uint32_t>(value) == index);
+            return true;
+        }
+
+        // stop reading for a while, so the server can fill the ring
+        if (std::strcmp(msg, "pause") == 0)
+        {
+            carla_msleep(300);
+            return true;
+        }
+
+        if (std::strcmp(msg, "done") == 0)
+        {
+            char tmpBuf[0xff+1];
+            std::snprintf(tmpBuf, 0xff, "%u\n", fNext);
+
+            lockPipe();
+            writeMessage("result\n");
+            writeMessage(tmpBuf);
+            writeMessage(fOk ? "true\n" : "false\n");
+            flushMessages();
+            unlockPipe();
+
+            fDone = true;
+            return true;
+        }
+
+        // keep the pipes open until the server is done with them
+        if (std::strcmp(msg, "quit") == 0)
+        {
+            fQuit = true;
+            return true;
+        }
+
         carla_stdout("CLIENT RECEIVED: \"%s\"", msg);
         return true;
     }
+
+    void lv2AtomReceived(const uint32_t index, const LV2_Atom* const atom) noexcept override
+    {
+        received(index == fNext && checkAtom(atom, fNext));
+    }
+
+private:
+    uint32_t fNext;
+    bool fOk, fDone, fQuit;
+
+    void received(const bool ok) noexcept
+    {
+        if (! ok)
+        {
+            carla_stderr2("CLIENT: message %u out of order or damaged", fNext);
+            fOk = false;
+        }
+
+        ++fNext;
+    }
 };
 
+// -----------------------------------------------------------------------
+
+static bool testUridMap(const CarlaPipeClient2& p)
+{
+    const char* const uri(gURIs[kHostURIs]);
+
+    CarlaStringList uris;
+    uint32_t nextUrid = 1;
+    int requests = 0;
+
+    // ask again until the new one arrives, like CarlaLv2Client::getCustomURID()
+    for (bool found = false; ! found; ++requests)
+    {
+        CARLA_SAFE_ASSERT_RETURN(requests < 10, false);
+        CARLA_SAFE_ASSERT_RETURN(p.writeLv2UridMapMessage(uri, nextUrid, uris, 2000), false);
+        CARLA_SAFE_ASSERT_RETURN(uris.count() != 0, false);
+
+        for (CarlaStringList::Itenerator it = uris.begin(); it.valid(); it.next(), ++nextUrid)
+        {
+            CARLA_SAFE_ASSERT_RETURN(nextUrid <= kHostURIs + 1, false);
+            CARLA_SAFE_ASSERT_RETURN(std::strcmp(it.getValue(nullptr), gURIs[nextUrid-1]) == 0, false);
+
+            found = (nextUrid == kHostURIs + 1);
+        }
+    }
+
+    CARLA_SAFE_ASSERT_RETURN(requests > 1, false);
+
+    // nothing missing anymore
+    CARLA_SAFE_ASSERT_RETURN(p.writeLv2UridMapMessage(uri, nextUrid, uris, 2000), false);
+    CARLA_SAFE_ASSERT_RETURN(uris.count() == 0, false);
+
+    carla_stdout("CLIENT: URID %u mapped in %i requests", nextUrid - 1, requests);
+    return true;
+}
+
+// -----------------------------------------------------------------------
+
 class CarlaPipeServer2 : public CarlaPipeServer
 {
 public:
     CarlaPipeServer2()
-        : CarlaPipeServer() {}
+        : CarlaPipeServer(),
+          fNewURIMapped(false),
+          fEchoReceived(false),
+          fGotResult(false),
+          fResultCount(0),
+          fResultOk(false) {}
+
+    bool isAtomRingReady() const noexcept
+    {
+        return pData->atomRing != nullptr && pData->atomRing->ready;
+    }
+
+    bool atomFitsInRing() const noexcept
+    {
+        return pData->atomRing->sendRing.getAvailableDataSize() > sizeof(uint32_t) + sizeof(TestAtom);
+    }
 
     bool msgReceived(const char* const msg) noexcept override
     {
+        if (std::strcmp(msg, "result") == 0)
+        {
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(fResultCount), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsBool(fResultOk), true);
+
+            fGotResult = true;
+            return true;
+        }
+
+        if (std::strcmp(msg, "uridMap") == 0)
+        {
+            uint32_t serial, firstUrid;
+            const char* uri;
+
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(serial), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(firstUrid), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(uri), true);
+
+            if (std::strcmp(uri, gURIs[kHostURIs]) == 0)
+                fNewURIMapped = true;
+            else
+                carla_stderr2("SERVER: unexpected URI '%s'", uri);
+
+            delete[] uri;
+
+            const uint32_t count(fNewURIMapped ? kHostURIs + 1 : kHostURIs);
+
+            const char* uris[kHostURIs+1];
+            uint32_t urisCount = 0;
+
+            for (uint32_t urid = firstUrid; urid != 0 && urid <= count; ++urid)
+                uris[urisCount++] = gURIs[urid-1];
+
+            writeLv2UridMapAnswer(serial, uris, urisCount);
+            return true;
+        }
+
         carla_stdout("SERVER RECEIVED: \"%s\"", msg);
         return true;
     }
+
+    void lv2AtomReceived(const uint32_t index, const LV2_Atom* const atom) noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(index == kEchoIndex,);
+        CARLA_SAFE_ASSERT_RETURN(checkAtom(atom, kEchoIndex),);
+
+        fEchoReceived = true;
+    }
+
+    bool fNewURIMapped;
+    bool fEchoReceived;
+    bool fGotResult;
+    uint32_t fResultCount;
+    bool fResultOk;
 };
 
 // -----------------------------------------------------------------------
 
-int main(int argc, const char* argv[])
+static int runClient(const char* argv[])
 {
-    if (argc != 1)
+    carla_stdout("CLIENT STARTED");
+
+    CarlaPipeClient2 p;
+    CARLA_SAFE_ASSERT_RETURN(p.initPipeClient(argv), 1);
+
+    bool echoSent = false;
+
+    for (int i=0; i < 2000 && ! p.shouldQuit(); ++i)
     {
-        carla_stdout("CLIENT STARTED %i", argc);
+        p.idlePipe();
 
-        CarlaPipeClient2 p;
-        const bool ok = p.initPipeClient(argv);
-        CARLA_SAFE_ASSERT_RETURN(ok,1);
+        // the ring also works the other way around
+        if (! echoSent && p.isAtomRingReady())
+        {
+            CARLA_SAFE_ASSERT_RETURN(testUridMap(p), 1);
+
+            TestAtom testAtom;
+            fillAtom(testAtom, kEchoIndex);
+            p.writeLv2AtomMessage(kEchoIndex, &testAtom.atom);
+            echoSent = true;
+        }
+
+        carla_msleep(5);
+    }
 
-        p.lockPipe();
-        p.writeMessage("CLIENT=>SERVER\n");
-        p.writeAndFixMessage("heheheheheh");
-        p.unlockPipe();
+    CARLA_SAFE_ASSERT_RETURN(p.isDone(), 1);
 
-        carla_msleep(500);
-        carla_stderr2("CLIENT idle start");
+    p.closePipeClient();
+    return 0;
+}
+
+static int runServer(const char* const filename)
+{
+    carla_stdout("SERVER STARTED");
+
+    CarlaPipeServer2 p;
+    CARLA_SAFE_ASSERT_RETURN(p.startPipeServer(filename, "client", "test"), 1);
+
+    // negotiation
+    CARLA_SAFE_ASSERT_RETURN(p.offerLv2AtomRing(), 1);
+
+    for (int i=0; i < 400 && ! (p.isAtomRingReady() && p.fEchoReceived); ++i)
+    {
         p.idlePipe();
-        carla_stderr2("CLIENT idle end");
-        carla_msleep(500);
+        carla_msleep(5);
     }
-    else
+
+    CARLA_SAFE_ASSERT_RETURN(p.isAtomRingReady(), 1);
+    CARLA_SAFE_ASSERT_RETURN(p.fNewURIMapped, 1);
+    CARLA_SAFE_ASSERT_RETURN(p.fEchoReceived, 1);
+
+    TestAtom testAtom;
+    uint32_t count = 0;
+
+    // ring atoms and text messages, in order
+    for (; count < 20; ++count)
     {
-        carla_stdout("SERVER STARTED %i", argc);
+        if (count % 2 == 0)
+        {
+            fillAtom(testAtom, count);
+            p.writeLv2AtomMessage(count, &testAtom.atom);
+        }
+        else
+        {
+            p.writeControlMessage(count, static_cast<float>(count));
+        }
+    }
 
-        CarlaPipeServer2 p;
-#ifdef CARLA_OS_WIN
-        const bool ok = p.startPipeServer("H:\\Source\\falkTX\\Carla\\source\\tests\\CarlaPipeUtils.exe", "/home/falktx/Videos", "/home/falktx");
-#else
-        const bool ok = p.startPipeServer("/home/falktx/Source/falkTX/Carla/source/tests/CarlaPipeUtils", "/home/falktx/Videos", "/home/falktx");
-#endif
-        CARLA_SAFE_ASSERT_RETURN(ok,1);
+    // fill the ring while the client is not reading, the rest must go as text
+    p.lockPipe();
+    p.writeMessage("pause\n");
+    p.flushMessages();
+    p.unlockPipe();
+
+    uint32_t textAtoms = 0;
+
+    for (; textAtoms < 2; ++count)
+    {
+        if (! p.atomFitsInRing())
+            ++textAtoms;
 
-        p.lockPipe();
-        p.writeMessage("SERVER=>CLIENT\n");
-        p.unlockPipe();
+        fillAtom(testAtom, count);
+        p.writeLv2AtomMessage(count, &testAtom.atom);
 
-        carla_msleep(500);
-        carla_stderr2("SERVER idle start");
+        // and a text message in between
+        if (textAtoms == 1)
+        {
+            ++count;
+            p.writeControlMessage(count, static_cast<float>(count));
+        }
+    }
+
+    p.lockPipe();
+    p.writeMessage("done\n");
+    p.flushMessages();
+    p.unlockPipe();
+
+    for (int i=0; i < 1000 && ! p.fGotResult; ++i)
+    {
         p.idlePipe();
-        carla_stderr2("SERVER idle end");
-        carla_msleep(500);
+        carla_msleep(5);
     }
 
+    p.stopPipeServer(2000);
+
+    carla_stdout("SERVER: %u messages sent, client got %u, %s", count, p.fResultCount, bool2str(p.fResultOk));
+
+    CARLA_SAFE_ASSERT_RETURN(p.fGotResult, 1);
+    CARLA_SAFE_ASSERT_RETURN(p.fResultOk, 1);
+    CARLA_SAFE_ASSERT_RETURN(p.fResultCount == count, 1);
     return 0;
 }
 
 // -----------------------------------------------------------------------
 
-#include "../utils/CarlaPipeUtils.cpp"
+int main(int argc, const char* argv[])
+{
+    for (uint32_t i=0; i < kHostURIs; ++i)
+        std::snprintf(gURIs[i], 64, "http://example.org/plugins/pipe-test#property%u", i);
+
+    std::strcpy(gURIs[kHostURIs], "http://example.org/plugins/pipe-test#new");
+
+    if (argc != 1)
+        return runClient(argv);
+
+    return runServer(argv[0]);
+}
 
 // -----------------------------------------------------------------------
@@ -21,7 +21,7 @@
 // simple types
 
 template <class BufferStruct>
-static void test_CarlaRingBuffer1(CarlaRingBuffer<BufferStruct>& b) noexcept
+static void test_CarlaRingBuffer1(CarlaRingBufferControl<BufferStruct>& b) noexcept
 {
     // start empty
     assert(b.isEmpty());
@@ -80,7 +80,7 @@ struct BufferTestStruct {
 };
 
 template <class BufferStruct>
-static void test_CarlaRingBuffer2(CarlaRingBuffer<BufferStruct>& b) noexcept
+static void test_CarlaRingBuffer2(CarlaRingBufferControl<BufferStruct>& b) noexcept
 {
     // start empty
     assert(b.isEmpty());
@@ -112,7 +112,7 @@ static void test_CarlaRingBuffer2(CarlaRingBuffer<BufferStruct>& b) noexcept
 // custom data
 
 template <class BufferStruct>
-static void test_CarlaRingBuffer3(CarlaRingBuffer<BufferStruct>& b) noexcept
+static void test_CarlaRingBuffer3(CarlaRingBufferControl<BufferStruct>& b) noexcept
 {
     static const char* const kLicense = ""
     "This program is free software; you can redistribute it and/or\n"
@@ -157,12 +157,59 @@ static void test_CarlaRingBuffer3(CarlaRingBuffer<BufferStruct>& b) noexcept
     assert(std::strcmp(license, kLicense) == 0);
 }
 
+// -----------------------------------------------------------------------
+// spans
+
+template <class BufferStruct>
+static void test_CarlaRingBuffer4(CarlaRingBufferControl<BufferStruct>& b) noexcept
+{
+    // start empty
+    assert(b.isEmpty());
+
+    const uint8_t* readData;
+    uint8_t* writeData;
+
+    // nothing to read
+    assert(b.getReadSpan(readData) == 0);
+
+    // write as much as fits before the end, one byte at a time
+    const uint32_t writeSize(b.getWriteSpan(writeData));
+    assert(writeSize > 0);
+
+    for (uint32_t i=0; i < writeSize; ++i)
+        writeData[i] = static_cast<uint8_t>(i);
+
+    b.advanceWrite(writeSize);
+
+    // still empty until commit
+    assert(b.isEmpty());
+    assert(b.commitWrite());
+
+    // read back in place
+    const uint32_t readSize(b.getReadSpan(readData));
+    assert(readSize == writeSize);
+
+    for (uint32_t i=0; i < readSize; ++i)
+        assert(readData[i] == static_cast<uint8_t>(i));
+
+    b.advanceRead(readSize);
+
+    // now empty again
+    assert(b.isEmpty());
+
+    // normal writes still work after spans
+    b.writeInt(99999123);
+    assert(b.commitWrite());
+    assert(b.readInt() == 99999123);
+    assert(b.isEmpty());
+}
+
 // -----------------------------------------------------------------------
 
 int main()
 {
     CarlaHeapRingBuffer heap;
-    CarlaStackRingBuffer stack;
+    CarlaSmallStackRingBuffer stack;
 
     // small test first
     heap.createBuffer(4096);
@@ -185,6 +232,15 @@ int main()
         test_CarlaRingBuffer3(stack);
     }
 
+    // spans, with the buffer at different positions
+    for (int i=0; i<4; ++i)
+    {
+        test_CarlaRingBuffer4(heap);
+        test_CarlaRingBuffer4(stack);
+        test_CarlaRingBuffer3(heap);
+        test_CarlaRingBuffer3(stack);
+    }
+
     return 0;
 }
 
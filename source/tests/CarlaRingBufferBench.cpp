@@ -0,0 +1,170 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaRingBuffer.hpp"
+
+#include <chrono>
+#include <thread>
+
+// -----------------------------------------------------------------------
+// Throughput of a writer and a reader thread passing bridge-like control events.
+// Per-field uses one write/read call per value, spans copy whole events in place.
+
+static const uint32_t kEvents = 2000000;
+
+// parameter change fields, padded to 16 bytes so events never wrap
+struct BenchEvent {
+    uint32_t opcode;
+    uint32_t time;
+    uint16_t param;
+    uint8_t  channel;
+    uint8_t  _pad;
+    float    value;
+};
+
+// -----------------------------------------------------------------------
+
+static void writePerField(CarlaHeapRingBuffer& rb)
+{
+    for (uint32_t i=0; i < kEvents;)
+    {
+        if (rb.getAvailableDataSize() <= sizeof(BenchEvent))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        rb.writeUInt(2);
+        rb.writeUInt(i);
+        rb.writeUShort(static_cast<uint16_t>(i));
+        rb.writeByte(0);
+        rb.writeByte(0);
+        rb.writeFloat(0.5f);
+        rb.commitWrite();
+        ++i;
+    }
+}
+
+static void readPerField(CarlaHeapRingBuffer& rb)
+{
+    for (uint32_t i=0; i < kEvents;)
+    {
+        if (! rb.isDataAvailableForReading())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const uint32_t opcode(rb.readUInt());
+        const uint32_t time(rb.readUInt());
+        rb.readUShort();
+        rb.readByte();
+        rb.readByte();
+        rb.readFloat();
+
+        CARLA_SAFE_ASSERT_RETURN(opcode == 2 && time == i,);
+        ++i;
+    }
+}
+
+static void writeSpans(CarlaHeapRingBuffer& rb)
+{
+    for (uint32_t i=0; i < kEvents;)
+    {
+        uint8_t* data;
+        const uint32_t count(rb.getWriteSpan(data) / sizeof(BenchEvent));
+
+        if (count == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        BenchEvent* const events((BenchEvent*)data);
+        uint32_t j = 0;
+
+        for (; j < count && i < kEvents; ++j, ++i)
+        {
+            events[j].opcode  = 2;
+            events[j].time    = i;
+            events[j].param   = static_cast<uint16_t>(i);
+            events[j].channel = 0;
+            events[j].value   = 0.5f;
+        }
+
+        rb.advanceWrite(j * sizeof(BenchEvent));
+        rb.commitWrite();
+    }
+}
+
+static void readSpans(CarlaHeapRingBuffer& rb)
+{
+    for (uint32_t i=0; i < kEvents;)
+    {
+        const uint8_t* data;
+        const uint32_t count(rb.getReadSpan(data) / sizeof(BenchEvent));
+
+        if (count == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const BenchEvent* const events((const BenchEvent*)data);
+
+        for (uint32_t j=0; j < count; ++j, ++i)
+            CARLA_SAFE_ASSERT_RETURN(events[j].opcode == 2 && events[j].time == i,);
+
+        rb.advanceRead(count * sizeof(BenchEvent));
+    }
+}
+
+// -----------------------------------------------------------------------
+
+static void benchmark(const char* const name, void (*writeFn)(CarlaHeapRingBuffer&), void (*readFn)(CarlaHeapRingBuffer&))
+{
+    CarlaHeapRingBuffer rb;
+    rb.createBuffer(16384);
+
+    const std::chrono::high_resolution_clock::time_point start(std::chrono::high_resolution_clock::now());
+
+    std::thread writer(writeFn, std::ref(rb));
+    readFn(rb);
+    writer.join();
+
+    const std::chrono::high_resolution_clock::time_point end(std::chrono::high_resolution_clock::now());
+    const double secs(std::chrono::duration<double>(end - start).count());
+
+    carla_stdout("%-9s: %5.1f M events/s, %6.1f MB/s", name,
+                 kEvents/secs/1000000.0, kEvents*sizeof(BenchEvent)/secs/1000000.0);
+
+    rb.deleteBuffer();
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    static_assert(16384 % sizeof(BenchEvent) == 0, "events must not wrap");
+
+    benchmark("per-field", writePerField, readPerField);
+    benchmark("spans", writeSpans, readSpans);
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
@@ -0,0 +1,101 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaBridgeUtils.hpp"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// -----------------------------------------------------------------------
+// Server and client racing for the chunk pool, in separate processes.
+// Whoever claims it owns the data until releasing, the other side must never see a partial write.
+
+static const uint kPoolSize = 4096;
+static const int  kRuns     = 100000;
+
+struct SharedData {
+    BridgeChunkPoolState state;
+    volatile uint32_t owners;
+    volatile uint32_t errors;
+    uint8_t pool[kPoolSize];
+};
+
+static void run(SharedData* const data, const uint8_t id)
+{
+    for (int i=0; i < kRuns;)
+    {
+        if (! carla_chunk_pool_claim(data->state))
+            continue;
+
+        if (__atomic_add_fetch(&data->owners, 1, __ATOMIC_RELAXED) != 1)
+            __atomic_add_fetch(&data->errors, 1, __ATOMIC_RELAXED);
+
+        std::memset(data->pool, id, kPoolSize);
+
+        for (uint j=0; j < kPoolSize; ++j)
+        {
+            if (data->pool[j] != id)
+            {
+                __atomic_add_fetch(&data->errors, 1, __ATOMIC_RELAXED);
+                break;
+            }
+        }
+
+        __atomic_sub_fetch(&data->owners, 1, __ATOMIC_RELAXED);
+        carla_chunk_pool_release(data->state);
+        ++i;
+    }
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    SharedData* const data((SharedData*)::mmap(nullptr, sizeof(SharedData), PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0));
+    CARLA_SAFE_ASSERT_RETURN(data != MAP_FAILED, 1);
+
+    carla_zeroStruct(*data);
+
+    // a claimed pool can't be claimed again until released
+    assert(carla_chunk_pool_claim(data->state));
+    assert(! carla_chunk_pool_claim(data->state));
+    carla_chunk_pool_release(data->state);
+    assert(data->state.busy == 0);
+
+    const pid_t pid(::fork());
+    CARLA_SAFE_ASSERT_RETURN(pid >= 0, 1);
+
+    if (pid == 0)
+    {
+        run(data, 1);
+        ::_exit(0);
+    }
+
+    run(data, 2);
+    ::waitpid(pid, nullptr, 0);
+
+    carla_stdout("chunk pool, %i claims per side, %u errors", kRuns, data->errors);
+    assert(data->errors == 0);
+    assert(data->owners == 0);
+    assert(data->state.busy == 0);
+
+    ::munmap(data, sizeof(SharedData));
+    return 0;
+}
+
+// -----------------------------------------------------------------------
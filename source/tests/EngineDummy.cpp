@@ -0,0 +1,442 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaHost.h"
+#include "CarlaString.hpp"
+#include "CarlaUtils.hpp"
+
+#include <chrono>
+#include <climits>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static const char* const kInFile  = "/tmp/carla-test-dummy-in.wav";
+static const char* const kOutFile = "/tmp/carla-test-dummy-out.wav";
+static const char* const kDevice  = "/tmp/carla-test-dummy-in.wav|/tmp/carla-test-dummy-out.wav";
+
+static const uint kBufferSize  = 256;
+static const uint kInputFrames = 1000;
+
+// the input ends in the middle of the 4th block, which is still rendered in full
+static const uint kOutputFrames = 1024;
+
+static uint gEngineStarted = 0;
+static uint gEngineStopped = 0;
+static uint gInputEnded    = 0;
+static uint gPluginsAdded  = 0;
+
+static void engineCallback(void*, EngineCallbackOpcode action, uint pluginId, int, int, float, const char* valueStr)
+{
+    switch (action)
+    {
+    case ENGINE_CALLBACK_PLUGIN_ADDED:
+        // plugins are added in order, with consecutive ids
+        assert(pluginId == gPluginsAdded);
+        assert(valueStr != nullptr && valueStr[0] != '\0');
+        ++gPluginsAdded;
+        break;
+    case ENGINE_CALLBACK_ENGINE_STARTED:
+        ++gEngineStarted;
+        gPluginsAdded = 0;
+        break;
+    case ENGINE_CALLBACK_ENGINE_STOPPED:
+        ++gEngineStopped;
+        break;
+    case ENGINE_CALLBACK_INFO:
+        ++gInputEnded;
+        break;
+    default:
+        break;
+    }
+}
+
+// -----------------------------------------------------------------------
+// minimal RIFF/WAVE helpers, 16-bit stereo in, any format out
+
+static void writeLE(std::FILE* const file, const uint32_t value, const uint bytes)
+{
+    for (uint i=0; i < bytes; ++i)
+        std::fputc(static_cast<int>((value >> (i*8)) & 0xff), file);
+}
+
+static void writeInputFile()
+{
+    std::FILE* const file(std::fopen(kInFile, "wb"));
+    assert(file != nullptr);
+
+    const uint32_t dataSize(kInputFrames*2*2);
+
+    std::fwrite("RIFF", 1, 4, file); writeLE(file, 36 + dataSize, 4);
+    std::fwrite("WAVE", 1, 4, file);
+    std::fwrite("fmt ", 1, 4, file); writeLE(file, 16, 4);
+    writeLE(file, 1, 2);         // PCM
+    writeLE(file, 2, 2);         // channels
+    writeLE(file, 44100, 4);     // sample rate
+    writeLE(file, 44100*2*2, 4); // byte rate
+    writeLE(file, 2*2, 2);       // block align
+    writeLE(file, 16, 2);        // bits per sample
+    std::fwrite("data", 1, 4, file); writeLE(file, dataSize, 4);
+
+    for (uint i=0; i < kInputFrames*2; ++i)
+        writeLE(file, 0x2000, 2);
+
+    std::fclose(file);
+}
+
+static uint32_t readLE(const uint8_t* const data, const uint bytes)
+{
+    uint32_t value = 0;
+
+    for (uint i=0; i < bytes; ++i)
+        value |= static_cast<uint32_t>(data[i]) << (i*8);
+
+    return value;
+}
+
+// reads up to @a maxSamples 32-bit samples of the output if @a samples is not null, returns the number of frames
+static uint readOutputFile(float* const samples = nullptr, const uint maxSamples = 0)
+{
+    std::FILE* const file(std::fopen(kOutFile, "rb"));
+    assert(file != nullptr);
+
+    static uint8_t data[65536];
+    const std::size_t size(std::fread(data, 1, sizeof(data), file));
+    std::fclose(file);
+
+    assert(size > 12);
+    assert(std::memcmp(data, "RIFF", 4) == 0);
+    assert(std::memcmp(data+8, "WAVE", 4) == 0);
+
+    uint format = 0;
+    uint blockAlign = 0;
+
+    for (std::size_t pos=12; pos+8 <= size;)
+    {
+        const uint32_t chunkSize(readLE(data+pos+4, 4));
+
+        if (std::memcmp(data+pos, "fmt ", 4) == 0)
+        {
+            format     = readLE(data+pos+8, 2);
+            blockAlign = readLE(data+pos+8+12, 2);
+        }
+        else if (std::memcmp(data+pos, "data", 4) == 0)
+        {
+            assert(blockAlign != 0);
+
+            for (uint i=0; samples != nullptr && i < maxSamples && pos+8+i*4+4 <= size; ++i)
+            {
+                const uint32_t value(readLE(data+pos+8+i*4, 4));
+
+                if (format == 3) // IEEE float
+                    std::memcpy(&samples[i], &value, sizeof(float));
+                else
+                    samples[i] = static_cast<float>(static_cast<int32_t>(value)) / 2147483648.0f;
+            }
+
+            return chunkSize / blockAlign;
+        }
+
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    assert(false);
+    return 0;
+}
+
+// -----------------------------------------------------------------------
+
+static void testInitFailure()
+{
+    // output file can't be created, nothing must be left behind
+    carla_set_engine_option(ENGINE_OPTION_AUDIO_DEVICE, 0, "/nonexistent-dir/out.wav");
+
+    assert(! carla_engine_init("Dummy", "Carla-Test"));
+    assert(! carla_is_engine_running());
+    assert(gEngineStarted == 0);
+    assert(gEngineStopped == 0);
+}
+
+static void testRender()
+{
+    writeInputFile();
+    carla_set_engine_option(ENGINE_OPTION_AUDIO_DEVICE, 0, kDevice);
+
+    assert(carla_engine_init("Dummy", "Carla-Test"));
+    assert(carla_is_engine_running());
+    assert(gEngineStarted == 1);
+
+    const CarlaTransportInfo* timeInfo(carla_get_transport_info());
+    assert(timeInfo != nullptr);
+    assert(! timeInfo->playing);
+
+    carla_transport_play();
+
+    // the render thread stops the transport once the input ends, which is reported in idle
+    for (int i=0; i < 1000 && gInputEnded == 0; ++i)
+    {
+        carla_engine_idle();
+        carla_msleep(5);
+    }
+
+    assert(gInputEnded == 1);
+
+    timeInfo = carla_get_transport_info();
+    assert(! timeInfo->playing);
+    assert(timeInfo->frame == kOutputFrames);
+
+    // only reported once
+    carla_engine_idle();
+    assert(gInputEnded == 1);
+
+    assert(carla_engine_close());
+    assert(gEngineStopped == 1);
+
+    assert(readOutputFile() == kOutputFrames);
+
+    std::remove(kInFile);
+    std::remove(kOutFile);
+}
+
+// renders the input through 2 plugins without audio ports, in the given rack lanes
+static void renderLanes(const uint lane1, const uint lane2, float* const samples, const uint maxSamples)
+{
+    gInputEnded = 0;
+
+    writeInputFile();
+    carla_set_engine_option(ENGINE_OPTION_AUDIO_DEVICE, 0, kDevice);
+
+    assert(carla_engine_init("Dummy", "Carla-Test"));
+
+    assert(carla_add_plugin(BINARY_NATIVE, PLUGIN_INTERNAL, nullptr, nullptr, "midithrough", 0, nullptr, 0x0));
+    assert(carla_add_plugin(BINARY_NATIVE, PLUGIN_INTERNAL, nullptr, nullptr, "midithrough", 0, nullptr, 0x0));
+    carla_set_rack_lane(0, lane1);
+    carla_set_rack_lane(1, lane2);
+
+    carla_transport_play();
+
+    for (int i=0; i < 1000 && gInputEnded == 0; ++i)
+    {
+        carla_engine_idle();
+        carla_msleep(5);
+    }
+
+    assert(gInputEnded == 1);
+    assert(carla_engine_close());
+
+    assert(readOutputFile(samples, maxSamples) == kOutputFrames);
+
+    std::remove(kInFile);
+    std::remove(kOutFile);
+}
+
+static void testRackLanes()
+{
+    static const uint kSampleCount = kInputFrames*2;
+
+    float serial[kSampleCount];
+    float parallel[kSampleCount];
+
+    renderLanes(0, 0, serial, kSampleCount);
+    renderLanes(0, 1, parallel, kSampleCount);
+
+    // the dry input passes through once, no matter how many lanes there are
+    for (uint i=0; i < kSampleCount; ++i)
+    {
+        assert(std::abs(serial[i] - 0.25f) < 0.0001f);
+        assert(std::abs(parallel[i] - serial[i]) < 0.0001f);
+    }
+}
+
+// at 1 Hz the engine thread waits almost a second between passes, stopping it must not wait for that
+static void testLowIdleRate()
+{
+    writeInputFile();
+    carla_set_engine_option(ENGINE_OPTION_AUDIO_DEVICE, 0, kDevice);
+    carla_set_engine_option(ENGINE_OPTION_MAX_IDLE_RATE, 1, nullptr);
+
+    assert(carla_engine_init("Dummy", "Carla-Test"));
+
+    // let the first pass finish
+    carla_msleep(100);
+
+    const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+    assert(carla_engine_close());
+
+    const long closeMsecs(static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()));
+    carla_stdout("engine closed in %li ms", closeMsecs);
+
+    // the thread is killed after 500 ms
+    assert(closeMsecs < 400);
+
+    carla_set_engine_option(ENGINE_OPTION_MAX_IDLE_RATE, 40, nullptr);
+
+    std::remove(kInFile);
+    std::remove(kOutFile);
+}
+
+// loads a project of LADSPA plugins which all want the same name, and take longer to create the earlier they start,
+// plugin 'missingIndex' has a wrong label and fails to load
+static const char* const kProjectFile = "/tmp/carla-test-dummy.carxp";
+static const char* const kLadspaFile  = "LadspaSlowGain.so";
+
+static void writeProjectFile(const char* const binary, const uint pluginCount, const uint missingIndex)
+{
+    std::FILE* const file(std::fopen(kProjectFile, "w"));
+    assert(file != nullptr);
+
+    std::fputs("<?xml version='1.0' encoding='UTF-8'?>\n", file);
+    std::fputs("<!DOCTYPE CARLA-PROJECT>\n", file);
+    std::fputs("<CARLA-PROJECT VERSION='2.0'>\n", file);
+
+    for (uint i=0; i < pluginCount; ++i)
+    {
+        std::fputs(" <Plugin>\n", file);
+        std::fputs("  <Info>\n", file);
+        std::fputs("   <Type>LADSPA</Type>\n", file);
+        std::fputs("   <Name>Slow Gain</Name>\n", file);
+        std::fprintf(file, "   <Binary>%s</Binary>\n", binary);
+        std::fprintf(file, "   <Label>%s</Label>\n", i == missingIndex ? "missing" : "slowgain");
+        std::fputs("  </Info>\n", file);
+        std::fputs("  <Data>\n", file);
+        std::fputs("   <Active>Yes</Active>\n", file);
+        std::fputs("   <Parameter>\n", file);
+        std::fputs("    <Index>0</Index>\n", file);
+        std::fprintf(file, "    <Value>%u</Value>\n", i+1);
+        std::fputs("   </Parameter>\n", file);
+        std::fputs("  </Data>\n", file);
+        std::fputs(" </Plugin>\n", file);
+    }
+
+    std::fputs("</CARLA-PROJECT>\n", file);
+    std::fclose(file);
+}
+
+static void testParallelLoad()
+{
+    static const uint kPluginCount  = 8;
+    static const uint kMissingIndex = 2;
+
+    char binary[PATH_MAX];
+    assert(realpath(kLadspaFile, binary) != nullptr);
+
+    writeInputFile();
+    writeProjectFile(binary, kPluginCount, kMissingIndex);
+
+    carla_set_engine_option(ENGINE_OPTION_AUDIO_DEVICE, 0, kDevice);
+    carla_set_engine_option(ENGINE_OPTION_MAX_LOAD_THREADS, 4, nullptr);
+
+    assert(carla_engine_init("Dummy", "Carla-Test"));
+
+    carla_load_project(kProjectFile);
+
+    assert(gPluginsAdded == kPluginCount-1);
+    assert(carla_get_current_plugin_count() == kPluginCount-1);
+
+    for (uint i=0; i < kPluginCount-1; ++i)
+    {
+        // project order, without the missing plugin
+        const uint projectIndex(i < kMissingIndex ? i : i+1);
+        assert(carla_get_current_parameter_value(i, 0) == static_cast<float>(projectIndex+1));
+
+        const CarlaPluginInfo* const info(carla_get_plugin_info(i));
+        assert(info != nullptr && info->name != nullptr);
+
+        const CarlaString name(info->name);
+        assert(name.startsWith("Slow Gain"));
+
+        for (uint j=0; j < i; ++j)
+            assert(name != carla_get_plugin_info(j)->name);
+    }
+
+    assert(carla_engine_close());
+
+    carla_set_engine_option(ENGINE_OPTION_MAX_LOAD_THREADS, 0, nullptr);
+
+    std::remove(kProjectFile);
+    std::remove(kInFile);
+    std::remove(kOutFile);
+}
+
+// changes are immediate while the plugin is inactive, otherwise they wait for the next processed block
+static void testQueuedParameters()
+{
+    gInputEnded = 0;
+
+    char binary[PATH_MAX];
+    assert(realpath(kLadspaFile, binary) != nullptr);
+
+    writeInputFile();
+    carla_set_engine_option(ENGINE_OPTION_AUDIO_DEVICE, 0, kDevice);
+
+    assert(carla_engine_init("Dummy", "Carla-Test"));
+    assert(carla_add_plugin(BINARY_NATIVE, PLUGIN_LADSPA, binary, "Slow Gain", "slowgain", 0, nullptr, 0x0));
+
+    carla_set_active(0, false);
+    carla_set_parameter_value(0, 0, 5.0f);
+    assert(carla_get_current_parameter_value(0, 0) == 5.0f);
+
+    // the transport is stopped, so nothing is processed yet
+    carla_set_active(0, true);
+    carla_set_parameter_value(0, 0, 6.0f);
+    carla_set_parameter_value(0, 0, 7.0f);
+    carla_msleep(50);
+    assert(carla_get_current_parameter_value(0, 0) == 5.0f);
+
+    carla_transport_play();
+
+    for (int i=0; i < 1000 && gInputEnded == 0; ++i)
+    {
+        carla_engine_idle();
+        carla_msleep(5);
+    }
+
+    assert(gInputEnded == 1);
+    assert(carla_get_current_parameter_value(0, 0) == 7.0f);
+
+    assert(carla_engine_close());
+
+    std::remove(kInFile);
+    std::remove(kOutFile);
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    carla_set_engine_callback(engineCallback, nullptr);
+    carla_set_engine_option(ENGINE_OPTION_PROCESS_MODE, ENGINE_PROCESS_MODE_CONTINUOUS_RACK, nullptr);
+    carla_set_engine_option(ENGINE_OPTION_AUDIO_BUFFER_SIZE, kBufferSize, nullptr);
+    carla_set_engine_option(ENGINE_OPTION_AUDIO_SAMPLE_RATE, 44100, nullptr);
+
+    testInitFailure();
+    testRender();
+    testParallelLoad();
+    testQueuedParameters();
+
+    // parallel rack lanes need worker threads
+    carla_set_engine_option(ENGINE_OPTION_PROCESS_THREADS, 2, nullptr);
+    testRackLanes();
+
+    // also checks idle worker threads don't delay closing the engine
+    testLowIdleRate();
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
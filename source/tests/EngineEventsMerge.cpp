@@ -0,0 +1,240 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifdef NDEBUG
+# error Build this file with debug ON please
+#endif
+
+#include "CarlaEngineUtils.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static void fillEvents(EngineEvent events[kMaxEngineEventInternalCount], const ushort count, const uint32_t maxTime, const uint8_t channel)
+{
+    uint32_t time = 0;
+
+    for (ushort i=0; i < count; ++i)
+    {
+        time += static_cast<uint32_t>(std::rand()) % (maxTime/count + 1);
+
+        EngineEvent& event(events[i]);
+        carla_zeroStruct(event);
+
+        event.type       = kEngineEventTypeControl;
+        event.time       = time;
+        event.channel    = channel;
+        event.ctrl.type  = kEngineControlEventTypeParameter;
+        event.ctrl.param = i;
+    }
+
+    terminateEngineEvents(events, count);
+}
+
+static void testMerge()
+{
+    EngineEvent a[kMaxEngineEventInternalCount];
+    EngineEvent b[kMaxEngineEventInternalCount];
+    EngineEvent out[kMaxEngineEventInternalCount];
+
+    // empty
+    clearEngineEvents(a);
+    clearEngineEvents(b);
+    {
+        const EngineEvent* const src[2] = { a, b };
+        assert(mergeEngineEvents(out, src, 2) == 0);
+        assert(out[0].type == kEngineEventTypeNull);
+    }
+
+    // sorted, with source order kept for the same time
+    fillEvents(a, 100, 256, 0);
+    fillEvents(b, 100, 256, 1);
+    {
+        const EngineEvent* const src[3] = { a, nullptr, b };
+        assert(mergeEngineEvents(out, src, 3) == 200);
+        assert(getEngineEventCount(out) == 200);
+
+        for (ushort i=1; i < 200; ++i)
+        {
+            assert(out[i-1].time <= out[i].time);
+
+            if (out[i-1].time == out[i].time)
+                assert(out[i-1].channel <= out[i].channel);
+        }
+    }
+
+    // full, extra events are dropped
+    fillEvents(a, kMaxEngineEventInternalCount, 1024, 0);
+    fillEvents(b, 10, 1024, 1);
+    {
+        const EngineEvent* const src[2] = { a, b };
+        assert(mergeEngineEvents(out, src, 2) == kMaxEngineEventInternalCount);
+    }
+}
+
+static void setEvent(EngineEvent& event, const uint32_t time, const uint8_t channel, const uint16_t param)
+{
+    carla_zeroStruct(event);
+
+    event.type       = kEngineEventTypeControl;
+    event.time       = time;
+    event.channel    = channel;
+    event.ctrl.type  = kEngineControlEventTypeParameter;
+    event.ctrl.param = param;
+}
+
+static void testMergeStable()
+{
+    EngineEvent src[4][kMaxEngineEventInternalCount];
+    EngineEvent out[kMaxEngineEventInternalCount];
+
+    // few distinct times, so most events share their time with others
+    const ushort counts[4] = { 7, 0, 64, 33 };
+
+    for (uint8_t s=0; s < 4; ++s)
+    {
+        uint32_t time = 0;
+
+        for (ushort i=0; i < counts[s]; ++i)
+        {
+            if (std::rand() % 4 == 0)
+                ++time;
+
+            setEvent(src[s][i], time, s, i);
+        }
+
+        terminateEngineEvents(src[s], counts[s]);
+    }
+
+    const EngineEvent* const srcPtrs[4] = { src[0], src[1], src[2], src[3] };
+    const ushort count(mergeEngineEvents(out, srcPtrs, 4));
+    assert(count == 7+64+33);
+    assert(getEngineEventCount(out) == count);
+
+    // all events are there once, each source in its own order
+    ushort next[4] = { 0, 0, 0, 0 };
+
+    for (ushort i=0; i < count; ++i)
+    {
+        const EngineEvent& event(out[i]);
+        assert(event.channel < 4);
+        assert(event.ctrl.param == next[event.channel]);
+        ++next[event.channel];
+
+        if (i == 0)
+            continue;
+
+        // by time, then by source
+        assert(out[i-1].time <= event.time);
+
+        if (out[i-1].time == event.time)
+            assert(out[i-1].channel <= event.channel);
+    }
+
+    for (uint8_t s=0; s < 4; ++s)
+        assert(next[s] == counts[s]);
+
+    // exact order for a small case with the same time everywhere
+    setEvent(src[0][0], 5, 0, 0);
+    setEvent(src[0][1], 5, 0, 1);
+    setEvent(src[0][2], 9, 0, 2);
+    terminateEngineEvents(src[0], 3);
+    setEvent(src[1][0], 1, 1, 0);
+    setEvent(src[1][1], 5, 1, 1);
+    setEvent(src[1][2], 5, 1, 2);
+    terminateEngineEvents(src[1], 3);
+    {
+        const EngineEvent* const pair[2] = { src[0], src[1] };
+        assert(mergeEngineEvents(out, pair, 2) == 6);
+
+        static const uint8_t kChannels[6] = { 1, 0, 0, 1, 1, 0 };
+        static const uint16_t kParams[6]  = { 0, 0, 1, 1, 2, 2 };
+
+        for (ushort i=0; i < 6; ++i)
+        {
+            assert(out[i].channel == kChannels[i]);
+            assert(out[i].ctrl.param == kParams[i]);
+        }
+    }
+
+    // overflow drops the latest events, not the last source
+    for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+        setEvent(src[0][i], i, 0, i);
+    setEvent(src[1][0], 0, 1, 0);
+    setEvent(src[1][1], kMaxEngineEventInternalCount, 1, 1);
+    terminateEngineEvents(src[1], 2);
+    {
+        const EngineEvent* const pair[2] = { src[0], src[1] };
+        assert(mergeEngineEvents(out, pair, 2) == kMaxEngineEventInternalCount);
+        assert(out[0].channel == 0 && out[1].channel == 1);
+        assert(out[kMaxEngineEventInternalCount-1].channel == 0);
+        assert(out[kMaxEngineEventInternalCount-1].time == kMaxEngineEventInternalCount-2);
+    }
+}
+
+// -----------------------------------------------------------------------
+
+static void benchmarkMerge(const uint srcCount)
+{
+    static const int kRuns = 20000;
+
+    EngineEvent src[MAX_RACK_LANES][kMaxEngineEventInternalCount];
+    const EngineEvent* srcPtrs[MAX_RACK_LANES];
+    EngineEvent out[kMaxEngineEventInternalCount];
+
+    // 512 events in total, split across all sources
+    for (uint i=0; i < srcCount; ++i)
+    {
+        fillEvents(src[i], static_cast<ushort>(kMaxEngineEventInternalCount/srcCount), 1024, static_cast<uint8_t>(i));
+        srcPtrs[i] = src[i];
+    }
+
+    const std::chrono::high_resolution_clock::time_point start(std::chrono::high_resolution_clock::now());
+
+    ushort count = 0;
+
+    for (int i=0; i < kRuns; ++i)
+        count = static_cast<ushort>(count + mergeEngineEvents(out, srcPtrs, srcCount));
+
+    const std::chrono::high_resolution_clock::time_point end(std::chrono::high_resolution_clock::now());
+    const double nsecs(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+
+    carla_stdout("merge of 512 events from %u sources: %.0f ns per merge, %.2f ns per event (%u)",
+                 srcCount, nsecs/kRuns, nsecs/kRuns/kMaxEngineEventInternalCount, count);
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    testMerge();
+    testMergeStable();
+
+    benchmarkMerge(1);
+    benchmarkMerge(2);
+    benchmarkMerge(4);
+    benchmarkMerge(8);
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
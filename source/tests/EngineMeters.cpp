@@ -0,0 +1,184 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifdef NDEBUG
+# error Build this file with debug ON please
+#endif
+
+#include "../backend/engine/CarlaEngineMeters.cpp"
+
+#include <cassert>
+#include <thread>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static bool isNear(const float a, const float b, const float maxDiff)
+{
+    return std::fabs(a - b) <= maxDiff;
+}
+
+static void fillSine(float* const buffer, const uint32_t frames, const double cycles, const double phase)
+{
+    for (uint32_t i=0; i < frames; ++i)
+        buffer[i] = static_cast<float>(std::sin(2.0 * M_PI * cycles * i + phase));
+}
+
+// 1 kHz at 48 kHz, whole cycles
+static void testSineRms()
+{
+    static const uint32_t kFrames = 4800;
+
+    float buffer[kFrames];
+    fillSine(buffer, kFrames, 1000.0/48000.0, 0.0);
+
+    float history[kEngineMeterHistorySize];
+    carla_zeroFloat(history, kEngineMeterHistorySize);
+
+    EngineMeterValue value;
+    carla_engine_meter_process(buffer, kFrames, history, true, value);
+
+    assert(isNear(value.peak, 1.0f, 1e-6f));
+    assert(isNear(value.rms, static_cast<float>(M_SQRT1_2), 1e-4f));
+    assert(isNear(value.truePeak, 1.0f, 0.02f));
+
+    // block sizes which are not multiples of 4, or shorter than the filter history, give the same peaks
+    static const uint32_t kBlockSizes[3] = { 37, 5, 1 };
+
+    for (uint b=0; b < 3; ++b)
+    {
+        float blockHistory[kEngineMeterHistorySize];
+        carla_zeroFloat(blockHistory, kEngineMeterHistorySize);
+
+        float peak = 0.0f, truePeak = 0.0f;
+
+        for (uint32_t i=0; i < kFrames; i += kBlockSizes[b])
+        {
+            const uint32_t frames(std::min(kBlockSizes[b], kFrames - i));
+
+            EngineMeterValue blockValue;
+            carla_engine_meter_process(buffer + i, frames, blockHistory, true, blockValue);
+
+            peak     = std::max(peak, blockValue.peak);
+            truePeak = std::max(truePeak, blockValue.truePeak);
+        }
+
+        assert(isNear(peak, value.peak, 1e-6f));
+        assert(isNear(truePeak, value.truePeak, 1e-5f));
+    }
+
+    // no true-peak unless asked for
+    carla_engine_meter_process(buffer, kFrames, history, false, value);
+    assert(value.truePeak == 0.0f);
+}
+
+// fs/4 at 45 degrees, every sample falls halfway up the sine
+static void testInterSamplePeak()
+{
+    static const uint32_t kFrames = 512;
+
+    float buffer[kFrames];
+    fillSine(buffer, kFrames, 0.25, M_PI/4.0);
+
+    float history[kEngineMeterHistorySize];
+    carla_zeroFloat(history, kEngineMeterHistorySize);
+
+    EngineMeterValue value;
+
+    // first block fills the filter history
+    carla_engine_meter_process(buffer, kFrames, history, true, value);
+    carla_engine_meter_process(buffer, kFrames, history, true, value);
+
+    assert(isNear(value.peak, static_cast<float>(M_SQRT1_2), 1e-5f));
+    assert(isNear(value.rms, static_cast<float>(M_SQRT1_2), 1e-4f));
+
+    // about 3 dB over the sample peak
+    assert(value.truePeak > 0.95f && value.truePeak < 1.05f);
+}
+
+// -----------------------------------------------------------------------
+
+// every block is constant, so peak and RMS of a consistent read are the same
+static const uint kSeqLockBlocks = 200000;
+static const uint32_t kSeqLockFrames = 64;
+
+static void seqLockWriter(EngineMeterSet* const meters)
+{
+    float buffer1[kSeqLockFrames];
+    float buffer2[kSeqLockFrames];
+    const float* const buffers[2] = { buffer1, buffer2 };
+
+    for (uint i=1; i <= kSeqLockBlocks; ++i)
+    {
+        // exact in float, and so is its RMS
+        const float level(static_cast<float>(i % 1024 + 1) / 1024.0f);
+
+        carla_fill<float>(buffer1, level, kSeqLockFrames);
+        carla_fill<float>(buffer2, -level, kSeqLockFrames);
+
+        meters->process(buffers, 2, kSeqLockFrames, false);
+    }
+}
+
+static void testSeqLock()
+{
+    EngineMeterSet meters;
+    std::thread writer(seqLockWriter, &meters);
+
+    uint reads = 0, consistent = 0;
+
+    for (; reads < kSeqLockBlocks*4; ++reads)
+    {
+        const EngineMeterValue value(meters.get(reads % 2));
+
+        // never a mix of 2 blocks
+        assert(value.peak == value.rms);
+        assert(value.truePeak == 0.0f);
+
+        if (value.peak != 0.0f)
+            ++consistent;
+    }
+
+    writer.join();
+
+    const EngineMeterValue last1(meters.get(0));
+    const EngineMeterValue last2(meters.get(1));
+    assert(last1.peak == static_cast<float>(kSeqLockBlocks % 1024 + 1) / 1024.0f);
+    assert(last2.peak == last1.peak && last2.rms == last1.rms);
+
+    // channels past the ones processed read as silence
+    assert(meters.get(2).peak == 0.0f);
+
+    meters.clear();
+    assert(meters.get(0).peak == 0.0f);
+
+    carla_stdout("seqlock: %u reads, %u with values", reads, consistent);
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    testSineRms();
+    testInterSamplePeak();
+    testSeqLock();
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
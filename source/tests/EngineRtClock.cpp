@@ -0,0 +1,137 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifdef NDEBUG
+# error Build this file with debug ON please
+#endif
+
+#include "../backend/engine/CarlaEngineRtClock.hpp"
+#include "CarlaUtils.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static bool isNear(const double a, const double b, const double maxDiff = 1e-9)
+{
+    return std::fabs(a - b) <= maxDiff;
+}
+
+// random delivery delay, up to @a maxDelay seconds
+static double getDelay(const double maxDelay)
+{
+    return maxDelay * static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+}
+
+// -----------------------------------------------------------------------
+
+static void testSteps()
+{
+    RtClockCorrelation clock;
+
+    // the first value is taken as is
+    assert(isNear(clock.process(10.0, 110.0), 110.0));
+    assert(clock.valid);
+    assert(isNear(clock.offset, 100.0));
+
+    // later than usual, barely moves the offset
+    assert(isNear(clock.process(11.0, 111.5), 11.0 + 100.0005));
+    assert(isNear(clock.offset, 100.0005));
+
+    // earlier than ever, followed right away
+    assert(isNear(clock.process(12.0, 111.9), 111.9));
+    assert(isNear(clock.offset, 99.9));
+
+    // more than a second late means the device clock jumped
+    assert(isNear(clock.process(13.0, 200.0), 200.0));
+    assert(isNear(clock.offset, 187.0));
+
+    // starts over after a reset, even with a larger offset
+    clock.reset();
+    assert(! clock.valid);
+    assert(isNear(clock.process(14.0, 200.5), 200.5));
+    assert(isNear(clock.offset, 186.5));
+}
+
+// events every ms, each one delivered up to 2 ms late.
+// the corrected times should be close to the real ones, without the delivery delay.
+static void testJitter()
+{
+    const double kOffset = 5.0, kMaxDelay = 0.002;
+
+    RtClockCorrelation clock;
+    double maxError = 0.0;
+
+    for (int i=0; i < 10000; ++i)
+    {
+        const double deviceTime(static_cast<double>(i) * 0.001);
+        const double eventTime(clock.process(deviceTime, deviceTime + kOffset + getDelay(kMaxDelay)));
+        const double error(eventTime - (deviceTime + kOffset));
+
+        // never earlier than the real time, never later than received
+        assert(error >= 0.0);
+        assert(error <= kMaxDelay);
+
+        if (i >= 1000)
+            maxError = std::fmax(maxError, error);
+    }
+
+    // once settled, much less than the delivery jitter
+    assert(maxError < kMaxDelay / 5);
+}
+
+// the device clock runs 100 ppm slower than the system one
+static void testDrift()
+{
+    const double kOffset = 5.0, kMaxDelay = 0.002, kDrift = 1.0001;
+
+    RtClockCorrelation clock;
+    double maxError = 0.0;
+
+    for (int i=0; i < 60000; ++i)
+    {
+        const double deviceTime(static_cast<double>(i) * 0.001);
+        const double realTime(deviceTime * kDrift + kOffset);
+        const double eventTime(clock.process(deviceTime, realTime + getDelay(kMaxDelay)));
+
+        if (i >= 1000)
+            maxError = std::fmax(maxError, std::fabs(eventTime - realTime));
+    }
+
+    // after a minute the clocks are 6 ms apart, only a small part of it shows up
+    assert(maxError < kMaxDelay / 4);
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    std::srand(1);
+
+    testSteps();
+    testJitter();
+    testDrift();
+
+    carla_stdout("RtClockCorrelation: ok");
+    return 0;
+}
+
+// -----------------------------------------------------------------------
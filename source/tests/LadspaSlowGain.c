@@ -0,0 +1,131 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+/* LADSPA gain which takes a while to instantiate, each instance less than the previous one,
+ * so plugins loaded in parallel finish out of order. */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "ladspa/ladspa.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+/* --------------------------------------------------------------------------------------------------------------------- */
+
+enum {
+    kPortIn = 0,
+    kPortOut,
+    kPortGain,
+    kPortCount
+};
+
+typedef struct {
+    LADSPA_Data* ports[kPortCount];
+} SlowGain;
+
+static int gInstanceCount = 0;
+
+static LADSPA_Handle slowgain_instantiate(const LADSPA_Descriptor* descriptor, unsigned long sampleRate)
+{
+    const int instance = __atomic_fetch_add(&gInstanceCount, 1, __ATOMIC_SEQ_CST);
+    struct timespec delay;
+
+    /* unused */
+    (void)descriptor;
+    (void)sampleRate;
+
+    delay.tv_sec  = 0;
+    delay.tv_nsec = instance < 10 ? (10 - instance) * 20 * 1000000L : 0;
+    nanosleep(&delay, NULL);
+
+    return calloc(1, sizeof(SlowGain));
+}
+
+static void slowgain_connect_port(LADSPA_Handle handle, unsigned long port, LADSPA_Data* data)
+{
+    if (port < kPortCount)
+        ((SlowGain*)handle)->ports[port] = data;
+}
+
+static void slowgain_run(LADSPA_Handle handle, unsigned long frames)
+{
+    SlowGain* const self = (SlowGain*)handle;
+    const LADSPA_Data gain = *self->ports[kPortGain];
+    unsigned long i;
+
+    for (i=0; i < frames; ++i)
+        self->ports[kPortOut][i] = self->ports[kPortIn][i] * gain;
+}
+
+static void slowgain_cleanup(LADSPA_Handle handle)
+{
+    free(handle);
+}
+
+/* --------------------------------------------------------------------------------------------------------------------- */
+
+static const LADSPA_PortDescriptor kPortDescriptors[kPortCount] = {
+    LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+    LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+    LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL
+};
+
+static const char* const kPortNames[kPortCount] = {
+    "In",
+    "Out",
+    "Gain"
+};
+
+static const LADSPA_PortRangeHint kPortRangeHints[kPortCount] = {
+    { 0, 0.0f, 0.0f },
+    { 0, 0.0f, 0.0f },
+    { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, 0.0f, 100.0f }
+};
+
+static const LADSPA_Descriptor kDescriptor = {
+    /* UniqueID        */ 0,
+    /* Label           */ "slowgain",
+    /* Properties      */ LADSPA_PROPERTY_HARD_RT_CAPABLE,
+    /* Name            */ "Slow Gain",
+    /* Maker           */ "Carla Tests",
+    /* Copyright       */ "GPL2+",
+    /* PortCount       */ kPortCount,
+    /* PortDescriptors */ kPortDescriptors,
+    /* PortNames       */ kPortNames,
+    /* PortRangeHints  */ kPortRangeHints,
+    /* ImplementationData */ NULL,
+    /* instantiate     */ slowgain_instantiate,
+    /* connect_port    */ slowgain_connect_port,
+    /* activate        */ NULL,
+    /* run             */ slowgain_run,
+    /* run_adding      */ NULL,
+    /* set_run_adding_gain */ NULL,
+    /* deactivate      */ NULL,
+    /* cleanup         */ slowgain_cleanup
+};
+
+/* --------------------------------------------------------------------------------------------------------------------- */
+
+const LADSPA_Descriptor* ladspa_descriptor(unsigned long index);
+
+const LADSPA_Descriptor* ladspa_descriptor(unsigned long index)
+{
+    return index == 0 ? &kDescriptor : NULL;
+}
+
+/* --------------------------------------------------------------------------------------------------------------------- */
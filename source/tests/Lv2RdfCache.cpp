@@ -0,0 +1,391 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifdef NDEBUG
+# error Build this file with debug ON please
+#endif
+
+#include "Lv2RdfCache.hpp"
+
+#include <cassert>
+
+using juce::File;
+using juce::MemoryBlock;
+using juce::String;
+
+// -----------------------------------------------------------------------
+// a bundle with 2 plugins, only described in data files
+
+static const char* const kTestDir   = "/tmp/carla-test-rdfcache";
+static const char* const kURI       = "urn:carla:test:rdfcache";
+static const char* const kURI2      = "urn:carla:test:rdfcache2";
+static const char* const kName      = "Cache Test";
+static const char* const kNameCache = "Cxche Test";
+
+static File getLv2Dir()
+{
+    return File(kTestDir).getChildFile("lv2");
+}
+
+static File getBundleDir()
+{
+    return getLv2Dir().getChildFile("rdfcache.lv2");
+}
+
+static File getCacheFile()
+{
+    return File(kTestDir).getChildFile("cache").getChildFile("carla").getChildFile("lv2-rdf.cache");
+}
+
+static void writeBundle()
+{
+    assert(getBundleDir().createDirectory().wasOk());
+
+    assert(getBundleDir().getChildFile("manifest.ttl").replaceWithText(
+        "@prefix lv2:  <http://lv2plug.in/ns/lv2core#> .\n"
+        "@prefix rdfs: <http://www.w3.org/2000/01/rdf-schema#> .\n"
+        "\n"
+        "<urn:carla:test:rdfcache>\n"
+        "    a lv2:Plugin ;\n"
+        "    lv2:binary <rdfcache.so> ;\n"
+        "    rdfs:seeAlso <rdfcache.ttl> .\n"
+        "\n"
+        "<urn:carla:test:rdfcache2>\n"
+        "    a lv2:Plugin ;\n"
+        "    lv2:binary <rdfcache.so> ;\n"
+        "    rdfs:seeAlso <rdfcache.ttl> .\n"));
+
+    assert(getBundleDir().getChildFile("rdfcache.ttl").replaceWithText(
+        "@prefix doap: <http://usefulinc.com/ns/doap#> .\n"
+        "@prefix lv2:  <http://lv2plug.in/ns/lv2core#> .\n"
+        "@prefix rdf:  <http://www.w3.org/1999/02/22-rdf-syntax-ns#> .\n"
+        "@prefix rdfs: <http://www.w3.org/2000/01/rdf-schema#> .\n"
+        "\n"
+        "<urn:carla:test:rdfcache>\n"
+        "    a lv2:Plugin, lv2:AmplifierPlugin ;\n"
+        "    doap:name \"Cache Test\" ;\n"
+        "    lv2:port [\n"
+        "        a lv2:InputPort, lv2:AudioPort ;\n"
+        "        lv2:index 0 ;\n"
+        "        lv2:symbol \"in\" ;\n"
+        "        lv2:name \"In\"\n"
+        "    ] , [\n"
+        "        a lv2:OutputPort, lv2:AudioPort ;\n"
+        "        lv2:index 1 ;\n"
+        "        lv2:symbol \"out\" ;\n"
+        "        lv2:name \"Out\"\n"
+        "    ] , [\n"
+        "        a lv2:InputPort, lv2:ControlPort ;\n"
+        "        lv2:index 2 ;\n"
+        "        lv2:symbol \"gain\" ;\n"
+        "        lv2:name \"Gain\" ;\n"
+        "        lv2:default 1.0 ;\n"
+        "        lv2:minimum 0.0 ;\n"
+        "        lv2:maximum 2.0 ;\n"
+        "        lv2:scalePoint [ rdfs:label \"Unity\" ; rdf:value 1.0 ]\n"
+        "    ] .\n"
+        "\n"
+        "<urn:carla:test:rdfcache2>\n"
+        "    a lv2:Plugin ;\n"
+        "    doap:name \"Second Test\" .\n"));
+}
+
+// -----------------------------------------------------------------------
+
+// a new cache every time, as if in a new process
+static String getName(const char* const LV2_PATH, const char* const uri = kURI)
+{
+    Lv2RdfCache cache;
+
+    const LV2_RDF_Descriptor* const rdfDescriptor(cache.getDescriptor(LV2_PATH, uri));
+    assert(rdfDescriptor != nullptr);
+    assert(std::strcmp(rdfDescriptor->URI, uri) == 0);
+
+    const String name(rdfDescriptor->Name);
+    delete rdfDescriptor;
+    return name;
+}
+
+static MemoryBlock readCache()
+{
+    MemoryBlock data;
+    assert(getCacheFile().loadFileAsData(data));
+    return data;
+}
+
+static void writeCache(const MemoryBlock& data)
+{
+    assert(getCacheFile().replaceWithData(data.getData(), data.getSize()));
+}
+
+// changes the plugin name stored in the cache, reading it back means the entry was used
+static MemoryBlock tamper(const MemoryBlock& data)
+{
+    MemoryBlock tampered(data);
+    char* const bytes(static_cast<char*>(tampered.getData()));
+    const std::size_t nameLen(std::strlen(kName));
+
+    for (std::size_t i=0; i + nameLen <= tampered.getSize(); ++i)
+    {
+        // might be left over from the last hit
+        if (std::memcmp(bytes + i, kName, nameLen) != 0 && std::memcmp(bytes + i, kNameCache, nameLen) != 0)
+            continue;
+
+        std::memcpy(bytes + i, kNameCache, nameLen);
+        return tampered;
+    }
+
+    assert(false);
+    return tampered;
+}
+
+static bool isCacheHit(const char* const LV2_PATH)
+{
+    writeCache(tamper(readCache()));
+
+    const String name(getName(LV2_PATH));
+    assert(name == kName || name == kNameCache);
+
+    return (name == kNameCache);
+}
+
+// every call is later than the one before, like real changes
+static void touch(const File& file)
+{
+    static double sSeconds = 0.0;
+    sSeconds += 10.0;
+
+    assert(file.setLastModificationTime(juce::Time::getCurrentTime() + juce::RelativeTime::seconds(sSeconds)));
+}
+
+// -----------------------------------------------------------------------
+
+static void testRoundTrip(const char* const LV2_PATH)
+{
+    getCacheFile().deleteFile();
+
+    // from lilv
+    Lv2RdfCache cache1;
+    const LV2_RDF_Descriptor* const desc1(cache1.getDescriptor(LV2_PATH, kURI));
+    assert(desc1 != nullptr);
+    assert(getCacheFile().existsAsFile());
+
+    // from the cache
+    Lv2RdfCache cache2;
+    const LV2_RDF_Descriptor* const desc2(cache2.getDescriptor(LV2_PATH, kURI));
+    assert(desc2 != nullptr);
+
+    assert(std::strcmp(desc1->Name, kName) == 0);
+    assert(std::strcmp(desc2->Name, kName) == 0);
+    assert(std::strcmp(desc2->Bundle, desc1->Bundle) == 0);
+    assert(std::strcmp(desc2->Binary, desc1->Binary) == 0);
+    assert(desc2->Type[0] == desc1->Type[0] && desc2->Type[1] == desc1->Type[1]);
+    assert(desc2->License == nullptr && desc1->License == nullptr);
+    assert(desc2->UICount == desc1->UICount);
+
+    assert(desc1->PortCount == 3);
+    assert(desc2->PortCount == desc1->PortCount);
+
+    for (uint32_t i=0; i < desc1->PortCount; ++i)
+    {
+        const LV2_RDF_Port& port1(desc1->Ports[i]);
+        const LV2_RDF_Port& port2(desc2->Ports[i]);
+
+        assert(port2.Types == port1.Types);
+        assert(port2.Properties == port1.Properties);
+        assert(std::strcmp(port2.Name, port1.Name) == 0);
+        assert(std::strcmp(port2.Symbol, port1.Symbol) == 0);
+        assert(port2.Points.Hints == port1.Points.Hints);
+        assert(port2.Points.Default == port1.Points.Default);
+        assert(port2.Points.Minimum == port1.Points.Minimum);
+        assert(port2.Points.Maximum == port1.Points.Maximum);
+        assert(port2.ScalePointCount == port1.ScalePointCount);
+
+        for (uint32_t j=0; j < port1.ScalePointCount; ++j)
+        {
+            assert(std::strcmp(port2.ScalePoints[j].Label, port1.ScalePoints[j].Label) == 0);
+            assert(port2.ScalePoints[j].Value == port1.ScalePoints[j].Value);
+        }
+    }
+
+    assert(desc2->Ports[2].Points.Maximum == 2.0f);
+    assert(desc2->Ports[2].ScalePointCount == 1);
+
+    delete desc1;
+    delete desc2;
+
+    assert(isCacheHit(LV2_PATH));
+
+    // a second plugin is added to the same file, and replacing one entry keeps the other
+    assert(getName(LV2_PATH, kURI2) == "Second Test");
+    assert(getName(LV2_PATH) == kNameCache);
+
+    touch(getBundleDir().getChildFile("rdfcache.ttl"));
+    assert(getName(LV2_PATH) == kName);
+    assert(getName(LV2_PATH, kURI2) == "Second Test");
+    assert(isCacheHit(LV2_PATH));
+}
+
+// -----------------------------------------------------------------------
+
+static void testInvalidation(const char* const LV2_PATH)
+{
+    assert(isCacheHit(LV2_PATH));
+
+    // a data file of the bundle changed
+    touch(getBundleDir().getChildFile("rdfcache.ttl"));
+    assert(! isCacheHit(LV2_PATH));
+    assert(isCacheHit(LV2_PATH));
+
+    // the bundle itself changed
+    touch(getBundleDir());
+    assert(! isCacheHit(LV2_PATH));
+    assert(isCacheHit(LV2_PATH));
+
+    // a bundle was installed or removed
+    touch(getLv2Dir());
+    assert(! isCacheHit(LV2_PATH));
+    assert(isCacheHit(LV2_PATH));
+
+    // a different LV2_PATH, and back
+    const String otherPath(String(LV2_PATH) + LV2_RDF_CACHE_PATH_SEP + kTestDir + "/nonexistent");
+    assert(! isCacheHit(otherPath.toRawUTF8()));
+    assert(isCacheHit(otherPath.toRawUTF8()));
+    assert(! isCacheHit(LV2_PATH));
+    assert(isCacheHit(LV2_PATH));
+}
+
+// -----------------------------------------------------------------------
+
+static const uint32_t kHeaderSize = sizeof(uint32_t)*3 + sizeof(uint64_t);
+
+static void setUInt(MemoryBlock& data, const std::size_t offset, const uint32_t value)
+{
+    assert(offset + sizeof(uint32_t) <= data.getSize());
+    std::memcpy(static_cast<uint8_t*>(data.getData()) + offset, &value, sizeof(uint32_t));
+}
+
+// the cache is replaced and used again after a damaged file is ignored
+static void testDamaged(const char* const LV2_PATH, const MemoryBlock& damaged)
+{
+    writeCache(damaged);
+    assert(getName(LV2_PATH) == kName);
+    assert(isCacheHit(LV2_PATH));
+}
+
+static void testCorruption(const char* const LV2_PATH)
+{
+    // a cache with a single entry, so the layout is known
+    getCacheFile().deleteFile();
+    assert(getName(LV2_PATH) == kName);
+
+    const MemoryBlock good(tamper(readCache()));
+    const std::size_t size(good.getSize());
+
+    writeCache(good);
+    assert(getName(LV2_PATH) == kNameCache);
+
+    // truncated anywhere
+    const std::size_t truncatedSizes[] = { 0, 3, kHeaderSize-1, kHeaderSize, kHeaderSize+2, kHeaderSize+4, size/2, size-1 };
+
+    for (std::size_t i=0; i < sizeof(truncatedSizes)/sizeof(std::size_t); ++i)
+    {
+        MemoryBlock truncated(good);
+        truncated.setSize(truncatedSizes[i]);
+        testDamaged(LV2_PATH, truncated);
+    }
+
+    // trailing garbage
+    {
+        MemoryBlock longer(good);
+        longer.append("abc", 3);
+        testDamaged(LV2_PATH, longer);
+    }
+
+    // wrong magic and version
+    {
+        MemoryBlock magic(good);
+        setUInt(magic, 0, 0x12345678);
+        testDamaged(LV2_PATH, magic);
+
+        MemoryBlock version(good);
+        setUInt(version, sizeof(uint32_t), 0);
+        testDamaged(LV2_PATH, version);
+    }
+
+    // entry count and size not matching the data
+    {
+        MemoryBlock count(good);
+        setUInt(count, kHeaderSize - sizeof(uint32_t), 2);
+        testDamaged(LV2_PATH, count);
+
+        MemoryBlock hugeCount(good);
+        setUInt(hugeCount, kHeaderSize - sizeof(uint32_t), 0xfffffff0);
+        testDamaged(LV2_PATH, hugeCount);
+
+        MemoryBlock entrySize(good);
+        setUInt(entrySize, kHeaderSize, 0xfffffff0);
+        testDamaged(LV2_PATH, entrySize);
+
+        MemoryBlock shortEntry(good);
+        setUInt(shortEntry, kHeaderSize, 4);
+        testDamaged(LV2_PATH, shortEntry);
+    }
+
+    // bad data inside a well formed entry, URI length and bundle count
+    {
+        const std::size_t uriOffset(kHeaderSize + sizeof(uint32_t));
+        const std::size_t bundleCountOffset(uriOffset + sizeof(uint32_t) + std::strlen(kURI));
+
+        MemoryBlock uriLen(good);
+        setUInt(uriLen, uriOffset, 0xfffffff0);
+        testDamaged(LV2_PATH, uriLen);
+
+        MemoryBlock bundleCount(good);
+        setUInt(bundleCount, bundleCountOffset, 0xfffffff0);
+        testDamaged(LV2_PATH, bundleCount);
+
+        // the entry is found but its descriptor is cut short
+        MemoryBlock descriptor(good);
+        setUInt(descriptor, bundleCountOffset, 0);
+        testDamaged(LV2_PATH, descriptor);
+    }
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    File(kTestDir).deleteRecursively();
+
+    // keeps the user's cache untouched
+    setenv("XDG_CACHE_HOME", File(kTestDir).getChildFile("cache").getFullPathName().toRawUTF8(), 1);
+
+    writeBundle();
+
+    const String LV2_PATH(getLv2Dir().getFullPathName());
+
+    testRoundTrip(LV2_PATH.toRawUTF8());
+    testInvalidation(LV2_PATH.toRawUTF8());
+    testCorruption(LV2_PATH.toRawUTF8());
+
+    File(kTestDir).deleteRecursively();
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
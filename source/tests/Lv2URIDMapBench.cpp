@@ -0,0 +1,164 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifdef NDEBUG
+# error Build this file with debug ON please
+#endif
+
+#include "Lv2URIDMap.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------
+// Cost of mapping 10k URIs, then looking all of them up again.
+// The linear map is what each plugin instance used to do with its custom URIDs.
+
+static const uint32_t kURIs    = 10000;
+static const uint     kThreads = 4;
+
+static char gURIs[kURIs][64];
+
+static double getTimeSecs(const std::chrono::high_resolution_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// -----------------------------------------------------------------------
+
+struct LinearMap {
+    std::vector<const char*> uris;
+
+    LV2_URID map(const char* const uri)
+    {
+        for (std::size_t i=0; i < uris.size(); ++i)
+        {
+            if (std::strcmp(uris[i], uri) == 0)
+                return static_cast<LV2_URID>(i + CARLA_URI_MAP_ID_COUNT);
+        }
+
+        uris.push_back(uri);
+        return static_cast<LV2_URID>(uris.size() - 1 + CARLA_URI_MAP_ID_COUNT);
+    }
+};
+
+static void benchmarkLinear()
+{
+    LinearMap linearMap;
+
+    std::chrono::high_resolution_clock::time_point start(std::chrono::high_resolution_clock::now());
+
+    for (uint32_t i=0; i < kURIs; ++i)
+        linearMap.map(gURIs[i]);
+
+    const double mapSecs(getTimeSecs(start));
+    start = std::chrono::high_resolution_clock::now();
+
+    for (uint32_t i=0; i < kURIs; ++i)
+        assert(linearMap.map(gURIs[i]) == i + CARLA_URI_MAP_ID_COUNT);
+
+    carla_stdout("linear  : map %8.1f ms, lookup %8.1f ms", mapSecs*1000.0, getTimeSecs(start)*1000.0);
+}
+
+// -----------------------------------------------------------------------
+
+static void lookupAll(Lv2URIDMap* const uridMap)
+{
+    for (uint32_t i=0; i < kURIs; ++i)
+        assert(uridMap->map(gURIs[i]) == i + CARLA_URI_MAP_ID_COUNT);
+}
+
+static void benchmarkHashed()
+{
+    Lv2URIDMap uridMap;
+
+    std::chrono::high_resolution_clock::time_point start(std::chrono::high_resolution_clock::now());
+
+    for (uint32_t i=0; i < kURIs; ++i)
+        uridMap.map(gURIs[i]);
+
+    const double mapSecs(getTimeSecs(start));
+    start = std::chrono::high_resolution_clock::now();
+
+    lookupAll(&uridMap);
+
+    const double lookupSecs(getTimeSecs(start));
+    start = std::chrono::high_resolution_clock::now();
+
+    for (uint32_t i=0; i < kURIs; ++i)
+        assert(std::strcmp(uridMap.unmap(i + CARLA_URI_MAP_ID_COUNT), gURIs[i]) == 0);
+
+    const double unmapSecs(getTimeSecs(start));
+    start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+
+    for (uint i=0; i < kThreads; ++i)
+        threads.push_back(std::thread(lookupAll, &uridMap));
+
+    for (uint i=0; i < kThreads; ++i)
+        threads[i].join();
+
+    carla_stdout("hashed  : map %8.1f ms, lookup %8.1f ms, unmap %6.2f ms, %u threads lookup %6.2f ms",
+                 mapSecs*1000.0, lookupSecs*1000.0, unmapSecs*1000.0, kThreads, getTimeSecs(start)*1000.0);
+}
+
+// -----------------------------------------------------------------------
+// A bridged UI never maps URIs itself, it gets all new host URIDs in order, like after a "uridMap" request.
+
+static void testRemoteMap()
+{
+    Lv2URIDMap hostMap, uiMap;
+
+    // other plugins in the host process take the next ids
+    hostMap.map(gURIs[0]);
+    hostMap.map(gURIs[1]);
+
+    assert(uiMap.find(gURIs[2]) == CARLA_URI_MAP_ID_NULL);
+
+    const LV2_URID urid(hostMap.map(gURIs[2]));
+
+    for (uint32_t i=CARLA_URI_MAP_ID_COUNT, count=hostMap.getCount(); i < count; ++i)
+        assert(uiMap.mapWithId(i, hostMap.unmap(i)));
+
+    assert(uiMap.find(gURIs[2]) == urid);
+    assert(uiMap.find(gURIs[0]) == hostMap.find(gURIs[0]));
+
+    // what an unsynced UI would get, a different id than the host
+    assert(! uiMap.mapWithId(urid, gURIs[3]));
+
+    carla_stdout("remote  : ok");
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    for (uint32_t i=0; i < kURIs; ++i)
+        std::snprintf(gURIs[i], 64, "http://example.org/plugins/urid-bench#property%u", i);
+
+    benchmarkLinear();
+    benchmarkHashed();
+    testRemoteMap();
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
@@ -0,0 +1,160 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifdef NDEBUG
+# error Build this file with debug ON please
+#endif
+
+#include "CarlaPluginInternal.hpp"
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static void testDrainOrder()
+{
+    PluginParameterQueue queue;
+    queue.createNew(10);
+
+    uint32_t id;
+    float value;
+
+    assert(! queue.get(id, value));
+
+    // drained in the order parameters were first queued
+    assert(queue.post(5, 0.1f));
+    assert(queue.post(2, 0.2f));
+    assert(queue.post(7, 0.3f));
+
+    // still pending, keeps its place and takes the new value
+    assert(queue.post(5, 0.4f));
+
+    assert(queue.get(id, value) && id == 5 && value == 0.4f);
+    assert(queue.get(id, value) && id == 2 && value == 0.2f);
+
+    // drained, queued again at the end
+    assert(queue.post(5, 0.5f));
+
+    assert(queue.get(id, value) && id == 7 && value == 0.3f);
+    assert(queue.get(id, value) && id == 5 && value == 0.5f);
+    assert(! queue.get(id, value));
+
+    // all parameters at once, many times, wrapping around the slots
+    for (int run=0; run < 100; ++run)
+    {
+        for (uint32_t i=0; i < 10; ++i)
+            assert(queue.post(9-i, static_cast<float>(run)));
+
+        for (uint32_t i=0; i < 10; ++i)
+            assert(queue.get(id, value) && id == 9-i && value == static_cast<float>(run));
+
+        assert(! queue.get(id, value));
+    }
+
+    // out of range
+    assert(! queue.post(10, 0.0f));
+
+    queue.clear();
+}
+
+// -----------------------------------------------------------------------
+
+static const uint32_t kProducerCount  = 4;
+static const uint32_t kParamsPerProducer = 8;
+static const uint32_t kPostsPerParam = 20000;
+
+// each producer owns a few parameters and sets them to increasing values
+static void producer(PluginParameterQueue* const queue, const uint32_t index)
+{
+    for (uint32_t v=1; v <= kPostsPerParam; ++v)
+    {
+        for (uint32_t i=0; i < kParamsPerProducer; ++i)
+            assert(queue->post(index*kParamsPerProducer + i, static_cast<float>(v)));
+
+        // let the others and the audio thread side run in between
+        std::this_thread::yield();
+    }
+}
+
+static void testProducers()
+{
+    static const uint32_t kParamCount = kProducerCount*kParamsPerProducer;
+
+    PluginParameterQueue queue;
+    queue.createNew(kParamCount);
+
+    std::vector<std::thread> threads;
+
+    for (uint32_t i=0; i < kProducerCount; ++i)
+        threads.push_back(std::thread(producer, &queue, i));
+
+    // the audio thread side, values applied to a parameter never go back
+    float applied[kParamCount];
+    carla_zeroFloat(applied, kParamCount);
+
+    uint32_t id, gets = 0;
+    float value;
+
+    for (bool running = true; running;)
+    {
+        // producers might be done, drain once more after checking
+        running = false;
+
+        for (uint32_t i=0; i < kProducerCount; ++i)
+        {
+            if (applied[i*kParamsPerProducer] != static_cast<float>(kPostsPerParam))
+                running = true;
+        }
+
+        for (; queue.get(id, value); ++gets)
+        {
+            assert(id < kParamCount);
+            assert(value >= applied[id]);
+            applied[id] = value;
+        }
+    }
+
+    for (uint32_t i=0; i < kProducerCount; ++i)
+        threads[i].join();
+
+    for (; queue.get(id, value); ++gets)
+        applied[id] = value;
+
+    // the last value of every parameter arrives
+    for (uint32_t i=0; i < kParamCount; ++i)
+        assert(applied[i] == static_cast<float>(kPostsPerParam));
+
+    carla_stdout("%u posts coalesced into %u gets", kParamCount*kPostsPerParam, gets);
+
+    queue.clear();
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    testDrainOrder();
+    testProducers();
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
@@ -0,0 +1,236 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaPostProcUtils.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+// -----------------------------------------------------------------------
+
+static const uint32_t kFrames = 512;
+
+// the per-plugin loops used before the shared kernel
+static void oldPostProcess(float* const inBuffers[2], float* const outBuffers[2], float* const copyBuffers[2], const CarlaPostProcValues& values)
+{
+    const uint32_t frames = kFrames;
+    const bool doDryWet  = ! carla_compareFloats(values.dryWet, 1.0f);
+    const bool doBalance = ! (carla_compareFloats(values.balanceLeft, -1.0f) && carla_compareFloats(values.balanceRight, 1.0f));
+
+    bool isPair;
+    float bufValue, oldBufLeft[doBalance ? frames : 1];
+
+    for (uint32_t i=0; i < 2; ++i)
+    {
+        if (doDryWet)
+        {
+            for (uint32_t k=0; k < frames; ++k)
+            {
+                bufValue = inBuffers[i][k];
+                outBuffers[i][k] = (outBuffers[i][k] * values.dryWet) + (bufValue * (1.0f - values.dryWet));
+            }
+        }
+
+        if (doBalance)
+        {
+            isPair = (i % 2 == 0);
+
+            if (isPair)
+                carla_copyFloat(oldBufLeft, outBuffers[i], frames);
+
+            float balRangeL = (values.balanceLeft  + 1.0f)/2.0f;
+            float balRangeR = (values.balanceRight + 1.0f)/2.0f;
+
+            for (uint32_t k=0; k < frames; ++k)
+            {
+                if (isPair)
+                {
+                    outBuffers[i][k]  = oldBufLeft[k]      * (1.0f - balRangeL);
+                    outBuffers[i][k] += outBuffers[i+1][k] * (1.0f - balRangeR);
+                }
+                else
+                {
+                    outBuffers[i][k]  = outBuffers[i][k] * balRangeR;
+                    outBuffers[i][k] += oldBufLeft[k]    * balRangeL;
+                }
+            }
+        }
+
+        for (uint32_t k=0; k < frames; ++k)
+            copyBuffers[i][k] = outBuffers[i][k] * values.volume;
+    }
+}
+
+static void fillBuffers(float* const buffers[2])
+{
+    for (uint32_t i=0; i < 2; ++i)
+    {
+        for (uint32_t k=0; k < kFrames; ++k)
+            buffers[i][k] = static_cast<float>(std::rand())/static_cast<float>(RAND_MAX)*2.0f - 1.0f;
+    }
+}
+
+// -----------------------------------------------------------------------
+
+static void testPostProc()
+{
+    float inL[kFrames], inR[kFrames], outL[kFrames], outR[kFrames];
+    float oldL[kFrames], oldR[kFrames], newL[kFrames], newR[kFrames];
+    float* const inBuffers[2]   = { inL, inR };
+    float* const outBuffers[2]  = { outL, outR };
+    float* const oldBuffers[2]  = { oldL, oldR };
+
+    CarlaPostProcValues values;
+    values.volume = 0.5f;
+
+    // same result as the old loops when values don't change.
+    // the old loops balanced the left side against the right one before its dry/wet, so test them separately
+    for (int i=0; i < 2; ++i)
+    {
+        values.dryWet       = (i == 0) ? 0.7f  : 1.0f;
+        values.balanceLeft  = (i == 0) ? -1.0f : -0.3f;
+        values.balanceRight = (i == 0) ? 1.0f  : 0.6f;
+
+        fillBuffers(inBuffers);
+        fillBuffers(outBuffers);
+        carla_postProcessStereo(inL, inR, outL, outR, newL, newR, kFrames, values, values);
+        oldPostProcess(inBuffers, outBuffers, oldBuffers, values);
+
+        for (uint32_t k=0; k < kFrames; ++k)
+        {
+            assert(std::abs(oldL[k] - newL[k]) < 0.0001f);
+            assert(std::abs(oldR[k] - newR[k]) < 0.0001f);
+        }
+    }
+
+    // ramps end on the new values
+    CarlaPostProcValues neutral;
+    neutral.dryWet       = 1.0f;
+    neutral.volume       = 1.0f;
+    neutral.balanceLeft  = -1.0f;
+    neutral.balanceRight = 1.0f;
+    assert(carla_isPostProcNeutral(neutral));
+    assert(! carla_isPostProcNeutral(values));
+
+    for (uint32_t k=0; k < kFrames; ++k)
+        inL[k] = outL[k] = 1.0f;
+
+    carla_postProcessMono(inL, outL, newL, kFrames, neutral, values);
+    assert(std::abs(newL[kFrames-1] - values.volume) < 0.0001f);
+    assert(newL[0] > newL[kFrames-1]);
+}
+
+// a plugin that only delays its input, dry/wet must not comb-filter it
+
+static void testPostProcLatency(const uint32_t latency)
+{
+    static const uint32_t kBlocks = 4;
+    static const uint32_t kTotal  = kFrames*kBlocks;
+
+    float signal[kTotal], dry[kFrames], wet[kFrames], out[kFrames];
+    float delayBuffer[kFrames*2];
+
+    for (uint32_t k=0; k < kTotal; ++k)
+        signal[k] = static_cast<float>(std::rand())/static_cast<float>(RAND_MAX)*2.0f - 1.0f;
+
+    assert(latency <= kFrames*2);
+    carla_zeroFloat(delayBuffer, kFrames*2);
+
+    CarlaPostProcValues values;
+    values.dryWet       = 0.5f;
+    values.volume       = 1.0f;
+    values.balanceLeft  = -1.0f;
+    values.balanceRight = 1.0f;
+
+    for (uint32_t b=0; b < kBlocks; ++b)
+    {
+        const float* const input(signal + b*kFrames);
+
+        for (uint32_t k=0; k < kFrames; ++k)
+        {
+            const uint32_t pos(b*kFrames + k);
+            wet[k] = pos >= latency ? signal[pos-latency] : 0.0f;
+        }
+
+        carla_copyFloat(dry, input, kFrames);
+        carla_delayPostProcDry(dry, delayBuffer, latency, kFrames);
+        carla_updatePostProcDelay(delayBuffer, latency, input, kFrames);
+
+        carla_postProcessMono(dry, wet, out, kFrames, values, values);
+
+        for (uint32_t k=0; k < kFrames; ++k)
+            assert(std::abs(out[k] - wet[k]) < 0.0001f);
+    }
+}
+
+// -----------------------------------------------------------------------
+
+static void benchmarkPostProc()
+{
+    static const int kRuns = 20000;
+
+    float inL[kFrames], inR[kFrames], outL[kFrames], outR[kFrames], copyL[kFrames], copyR[kFrames];
+    float* const inBuffers[2]   = { inL, inR };
+    float* const outBuffers[2]  = { outL, outR };
+    float* const copyBuffers[2] = { copyL, copyR };
+
+    CarlaPostProcValues values;
+    values.dryWet       = 0.7f;
+    values.volume       = 0.5f;
+    values.balanceLeft  = -0.3f;
+    values.balanceRight = 0.6f;
+
+    fillBuffers(inBuffers);
+    fillBuffers(outBuffers);
+
+    std::chrono::high_resolution_clock::time_point start(std::chrono::high_resolution_clock::now());
+
+    for (int i=0; i < kRuns; ++i)
+        oldPostProcess(inBuffers, outBuffers, copyBuffers, values);
+
+    std::chrono::high_resolution_clock::time_point end(std::chrono::high_resolution_clock::now());
+    const double oldNsecs(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+
+    fillBuffers(outBuffers);
+    start = std::chrono::high_resolution_clock::now();
+
+    for (int i=0; i < kRuns; ++i)
+        carla_postProcessStereo(inL, inR, outL, outR, copyL, copyR, kFrames, values, values);
+
+    end = std::chrono::high_resolution_clock::now();
+    const double newNsecs(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+
+    carla_stdout("stereo post-processing of %u frames: old loops %.0f ns, shared kernel %.0f ns (%.1fx)",
+                 kFrames, oldNsecs/kRuns, newNsecs/kRuns, oldNsecs/newNsecs);
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    testPostProc();
+    testPostProcLatency(0);
+    testPostProcLatency(64);
+    testPostProcLatency(kFrames);
+    testPostProcLatency(kFrames+100);
+    benchmarkPostProc();
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
@@ -17,22 +17,27 @@
 
 #include "RtLinkedList.hpp"
 
-#include "CarlaString.hpp"
 #include "CarlaMutex.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+#include <vector>
+
 const unsigned short MIN_RT_EVENTS = 5;
 const unsigned short MAX_RT_EVENTS = 10;
 
+// list nodes are raw pool memory, so keep this plain-old-data
 struct MyData {
-    CarlaString str;
+    char str[32];
     int id;
 
     MyData() noexcept
-        : id(-1) {}
+        : id(-1) { str[0] = '\0'; }
 
     MyData(int i) noexcept
-        : str(i),
-          id(i) {}
+        : id(i) { std::snprintf(str, 32, "%i", i); }
 };
 
 struct PostRtEvents {
@@ -43,8 +48,8 @@ struct PostRtEvents {
 
     PostRtEvents() noexcept
         : dataPool(MIN_RT_EVENTS, MAX_RT_EVENTS),
-          data(dataPool, true),
-          dataPendingRT(dataPool, true) {}
+          data(dataPool),
+          dataPendingRT(dataPool) {}
 
     ~PostRtEvents() noexcept
     {
@@ -68,14 +73,14 @@ struct PostRtEvents {
     {
         if (mutex.tryLock())
         {
-            dataPendingRT.spliceAppendTo(data);
+            dataPendingRT.moveTo(data, true);
             mutex.unlock();
         }
     }
 
 } postRtEvents;
 
-void run5Tests()
+static void run5Tests()
 {
     unsigned short k = 0;
     MyData allMyData[MAX_RT_EVENTS];
@@ -85,8 +90,8 @@ void run5Tests()
 
     while (! postRtEvents.data.isEmpty())
     {
-        MyData& my(postRtEvents.data.getFirst(true));
-        allMyData[k++] = my;
+        MyData fallback;
+        allMyData[k++] = postRtEvents.data.getFirst(fallback, true);
     }
 
     postRtEvents.mutex.unlock();
@@ -105,10 +110,94 @@ void run5Tests()
     {
         const MyData& my(allMyData[i]);
 
-        carla_stdout("Got data: %i %s", my.id, my.str.buffer());
+        carla_stdout("Got data: %i %s", my.id, my.str);
     }
 }
 
+// -----------------------------------------------------------------------
+// Allocation latency of the RT side, alone and while another thread uses the same pool.
+// Each sample is one append (allocate) or one removal (deallocate) of a list node.
+
+static const int kBenchRuns  = 200000;
+static const int kBenchBatch = 64;
+
+static double getTimeNsecs()
+{
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec)*1000000000.0 + static_cast<double>(ts.tv_nsec);
+}
+
+static void printLatency(const char* const name, std::vector<double>& times)
+{
+    std::sort(times.begin(), times.end());
+
+    double total = 0.0;
+    for (std::size_t i=0; i < times.size(); ++i)
+        total += times[i];
+
+    carla_stdout("%-20s: average %6.1f ns, median %6.1f ns, p99 %7.1f ns, max %9.1f ns", name,
+                 total/static_cast<double>(times.size()), times[times.size()/2],
+                 times[times.size() - times.size()/100], times.back());
+}
+
+static void benchmarkLatency(const char* const name, const bool contended)
+{
+    RtLinkedList<int>::Pool pool(kBenchBatch*2, kBenchBatch*4);
+    RtLinkedList<int> rtList(pool);
+
+    std::vector<double> allocTimes, freeTimes;
+    allocTimes.reserve(kBenchRuns);
+    freeTimes.reserve(kBenchRuns);
+
+    volatile bool running = true;
+
+    // non-RT user of the same pool, like ExternalNotes::appendNonRT()
+    std::thread other([&pool, &running, contended]() {
+        if (! contended)
+            return;
+
+        RtLinkedList<int> list(pool);
+
+        while (running)
+        {
+            for (int i=0; i < kBenchBatch; ++i)
+                list.append_sleepy(i);
+            list.clear();
+        }
+    });
+
+    for (int run=0; run < kBenchRuns; run += kBenchBatch)
+    {
+        for (int i=0; i < kBenchBatch; ++i)
+        {
+            const double start(getTimeNsecs());
+            const bool ok(rtList.append(i));
+            allocTimes.push_back(getTimeNsecs() - start);
+
+            CARLA_SAFE_ASSERT(ok);
+        }
+
+        int fallback = -1;
+
+        for (int i=0; i < kBenchBatch; ++i)
+        {
+            const double start(getTimeNsecs());
+            rtList.getFirst(fallback, true);
+            freeTimes.push_back(getTimeNsecs() - start);
+        }
+    }
+
+    running = false;
+    other.join();
+
+    carla_stdout("%s:", name);
+    printLatency("  allocate", allocTimes);
+    printLatency("  deallocate", freeTimes);
+}
+
+// -----------------------------------------------------------------------
+
 int main()
 {
     MyData m1(1);
@@ -143,12 +232,12 @@ int main()
     {
         const MyData& my(it.getValue());
 
-        carla_stdout("FOR DATA!!!: %i %s", my.id, my.str.buffer());
+        carla_stdout("FOR DATA!!!: %i %s", my.id, my.str);
 
         if (my.id == 1)
         {
-            // +1 append at
-            postRtEvents.dataPendingRT.insertAt(m5, it);
+            // +1 append
+            postRtEvents.dataPendingRT.append(m5);
             assert(postRtEvents.data.count() == 4);
             assert(postRtEvents.dataPendingRT.count() == 1);
             postRtEvents.trySplice();
@@ -179,7 +268,7 @@ int main()
     {
         for (size_t j=0, count=evIns.count(); j < count; ++j)
         {
-            const uint32_t& type(evIns.getAt(j));
+            const uint32_t type(evIns.getAt(j, 0U));
 
             if (type == CARLA_EVENT_DATA_ATOM)
                 pass();
@@ -191,5 +280,9 @@ int main()
     evIns.clear();
     evOuts.clear();
 
+    // benchmarks
+    benchmarkLatency("rt only", false);
+    benchmarkLatency("rt with non-rt user", true);
+
     return 0;
 }
@@ -0,0 +1,169 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaBridgeUtils.hpp"
+#include "CarlaSemUtils.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// -----------------------------------------------------------------------
+// Round-trip time of a bridge process call, server and client in separate processes.
+// Same layout as the real thing: semaphores inside BridgeRtClientData, audio in a separate pool.
+
+static const uint kChannels = 2;
+static const int  kRuns     = 20000;
+
+struct SharedData {
+    BridgeRtClientData rt;
+    volatile uint32_t frames;
+    volatile bool quit;
+    float audio[kChannels*2*1024];
+};
+
+struct Sem {
+    virtual ~Sem() {}
+    virtual void init(void* sem) = 0;
+    virtual void post(void* sem) = 0;
+    virtual bool wait(void* sem) = 0;
+};
+
+struct PosixSem : Sem {
+    void init(void* sem) override { ::sem_init((sem_t*)sem, 1, 0); }
+    void post(void* sem) override { carla_sem_post((sem_t*)sem); }
+    bool wait(void* sem) override { return carla_sem_timedwait((sem_t*)sem, 1); }
+};
+
+#ifdef CARLA_OS_LINUX
+struct FutexSem : Sem {
+    void init(void* sem) override { carla_sem_futex_init((carla_sem_futex_t*)sem); }
+    void post(void* sem) override { carla_sem_futex_post((carla_sem_futex_t*)sem); }
+    bool wait(void* sem) override { return carla_sem_futex_timedwait((carla_sem_futex_t*)sem, 1); }
+};
+#endif
+
+static double getTimeNsecs()
+{
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec)*1000000000.0 + static_cast<double>(ts.tv_nsec);
+}
+
+// the bridge side, applies a gain to the input, like a very cheap plugin
+static void runClient(SharedData* const data, Sem& sem)
+{
+    for (;;)
+    {
+        if (! sem.wait(&data->rt.sem.server))
+            continue;
+
+        if (data->quit)
+            break;
+
+        const uint32_t frames(data->frames);
+
+        for (uint i=0; i < kChannels; ++i)
+        {
+            const float* const in(data->audio + i*frames);
+            /* */ float* const out(data->audio + (kChannels+i)*frames);
+
+            for (uint32_t k=0; k < frames; ++k)
+                out[k] = in[k] * 0.5f;
+        }
+
+        sem.post(&data->rt.sem.client);
+    }
+
+    sem.post(&data->rt.sem.client);
+}
+
+static void benchmark(const char* const name, Sem& sem)
+{
+    SharedData* const data((SharedData*)::mmap(nullptr, sizeof(SharedData), PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0));
+    CARLA_SAFE_ASSERT_RETURN(data != MAP_FAILED,);
+
+    carla_zeroStruct(*data);
+    sem.init(&data->rt.sem.server);
+    sem.init(&data->rt.sem.client);
+
+    const pid_t pid(::fork());
+    CARLA_SAFE_ASSERT_RETURN(pid >= 0,);
+
+    if (pid == 0)
+    {
+        runClient(data, sem);
+        ::_exit(0);
+    }
+
+    std::vector<double> times(kRuns);
+
+    for (uint32_t frames = 32; frames <= 1024; frames *= 2)
+    {
+        data->frames = frames;
+
+        for (int i=0; i < kRuns; ++i)
+        {
+            const double start(getTimeNsecs());
+
+            for (uint j=0; j < kChannels; ++j)
+                carla_zeroFloat(data->audio + j*frames, frames);
+
+            sem.post(&data->rt.sem.server);
+            CARLA_SAFE_ASSERT_BREAK(sem.wait(&data->rt.sem.client));
+
+            times[static_cast<std::size_t>(i)] = getTimeNsecs() - start;
+        }
+
+        std::sort(times.begin(), times.end());
+
+        double total = 0.0;
+        for (int i=0; i < kRuns; ++i)
+            total += times[static_cast<std::size_t>(i)];
+
+        carla_stdout("%s, %4u frames: average %6.1f us, median %6.1f us, p99 %6.1f us", name, frames,
+                     total/kRuns/1000.0, times[kRuns/2]/1000.0, times[kRuns - kRuns/100]/1000.0);
+    }
+
+    data->quit = true;
+    sem.post(&data->rt.sem.server);
+    sem.wait(&data->rt.sem.client);
+
+    ::waitpid(pid, nullptr, 0);
+    ::munmap(data, sizeof(SharedData));
+}
+
+// -----------------------------------------------------------------------
+
+int main()
+{
+    PosixSem posixSem;
+    benchmark("posix sem", posixSem);
+
+#ifdef CARLA_OS_LINUX
+    FutexSem futexSem;
+    benchmark("futex sem", futexSem);
+#endif
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
@@ -280,6 +280,10 @@ const char* EngineCallbackOpcode2Str(const EngineCallbackOpcode opcode) noexcept
         return "ENGINE_CALLBACK_ERROR";
     case ENGINE_CALLBACK_QUIT:
         return "ENGINE_CALLBACK_QUIT";
+    case ENGINE_CALLBACK_PLUGIN_DSP_LOAD:
+        return "ENGINE_CALLBACK_PLUGIN_DSP_LOAD";
+    case ENGINE_CALLBACK_PROJECT_LOAD_PROGRESS:
+        return "ENGINE_CALLBACK_PROJECT_LOAD_PROGRESS";
     }
 
     carla_stderr("CarlaBackend::EngineCallbackOpcode2Str(%i) - invalid opcode", opcode);
@@ -327,6 +331,20 @@ const char* EngineOption2Str(const EngineOption option) noexcept
         return "ENGINE_OPTION_PREVENT_BAD_BEHAVIOUR";
     case ENGINE_OPTION_FRONTEND_WIN_ID:
         return "ENGINE_OPTION_FRONTEND_WIN_ID";
+    case ENGINE_OPTION_PROCESS_THREADS:
+        return "ENGINE_OPTION_PROCESS_THREADS";
+    case ENGINE_OPTION_TRUE_PEAK_METERS:
+        return "ENGINE_OPTION_TRUE_PEAK_METERS";
+    case ENGINE_OPTION_PIPELINED_BRIDGES:
+        return "ENGINE_OPTION_PIPELINED_BRIDGES";
+    case ENGINE_OPTION_SHARED_BRIDGE_BUFFERS:
+        return "ENGINE_OPTION_SHARED_BRIDGE_BUFFERS";
+    case ENGINE_OPTION_GROUPED_BRIDGES:
+        return "ENGINE_OPTION_GROUPED_BRIDGES";
+    case ENGINE_OPTION_MAX_IDLE_RATE:
+        return "ENGINE_OPTION_MAX_IDLE_RATE";
+    case ENGINE_OPTION_MAX_LOAD_THREADS:
+        return "ENGINE_OPTION_MAX_LOAD_THREADS";
     }
 
     carla_stderr("CarlaBackend::EngineOption2Str(%i) - invalid option", option);
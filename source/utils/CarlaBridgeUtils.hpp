@@ -25,11 +25,15 @@
 # define PLUGIN_BRIDGE_NAMEPREFIX_RT_CLIENT     "Global\\carla-bridge_shm_rtC_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_NON_RT_CLIENT "Global\\carla-bridge_shm_nonrtC_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_NON_RT_SERVER "Global\\carla-bridge_shm_nonrtS_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_CHUNK_POOL    "Global\\carla-bridge_shm_chunk_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_GROUP         "Global\\carla-bridge_shm_grp_"
 #else
 # define PLUGIN_BRIDGE_NAMEPREFIX_AUDIO_POOL    "/carla-bridge_shm_ap_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_RT_CLIENT     "/carla-bridge_shm_rtC_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_NON_RT_CLIENT "/carla-bridge_shm_nonrtC_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_NON_RT_SERVER "/carla-bridge_shm_nonrtS_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_CHUNK_POOL    "/carla-bridge_shm_chunk_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_GROUP         "/carla-bridge_shm_grp_"
 #endif
 
 // -----------------------------------------------------------------------
@@ -38,16 +42,24 @@
 enum PluginBridgeRtClientOpcode {
     kPluginBridgeRtClientNull = 0,
     kPluginBridgeRtClientSetAudioPool,            // ulong/ptr
-    kPluginBridgeRtClientControlEventParameter,   // uint/frame, byte/chan, ushort, float
-    kPluginBridgeRtClientControlEventMidiBank,    // uint/frame, byte/chan, ushort
-    kPluginBridgeRtClientControlEventMidiProgram, // uint/frame, byte/chan, ushort
-    kPluginBridgeRtClientControlEventAllSoundOff, // uint/frame, byte/chan
-    kPluginBridgeRtClientControlEventAllNotesOff, // uint/frame, byte/chan
-    kPluginBridgeRtClientMidiEvent,               // uint/frame, byte/port, byte/size, byte[]/data
+    kPluginBridgeRtClientEventBlock,              // uint/count, BridgeRtEvent[]
+    kPluginBridgeRtClientMidiEvent,               // uint/frame, byte/port, byte/size, byte[]/data (MIDI bigger than 4 bytes)
     kPluginBridgeRtClientProcess,
     kPluginBridgeRtClientQuit
 };
 
+// Event types inside kPluginBridgeRtClientEventBlock
+enum PluginBridgeRtEventType {
+    kPluginBridgeRtEventNull = 0,
+    kPluginBridgeRtEventParameter,   // param, value
+    kPluginBridgeRtEventMidiBank,    // param/index
+    kPluginBridgeRtEventMidiProgram, // param/index
+    kPluginBridgeRtEventAllSoundOff,
+    kPluginBridgeRtEventAllNotesOff,
+    kPluginBridgeRtEventMidi,        // channel is port, param is size, midi data
+    kPluginBridgeRtEventParameterValue // param/index, value; plugin parameter, not a MIDI CC
+};
+
 // Server sends these to client during non-RT
 enum PluginBridgeNonRtClientOpcode {
     kPluginBridgeNonRtClientNull = 0,
@@ -65,7 +77,7 @@ enum PluginBridgeNonRtClientOpcode {
     kPluginBridgeNonRtClientSetProgram,              // int
     kPluginBridgeNonRtClientSetMidiProgram,          // int
     kPluginBridgeNonRtClientSetCustomData,           // uint/size, str[], uint/size, str[], uint/size, str[]
-    kPluginBridgeNonRtClientSetChunkDataFile,        // uint/size, str[] (filename, base64 content)
+    kPluginBridgeNonRtClientSetChunkData,            // ulong/size (data in chunk pool)
     kPluginBridgeNonRtClientSetCtrlChannel,          // short
     kPluginBridgeNonRtClientSetOption,               // uint/option, bool
     kPluginBridgeNonRtClientPrepareForSave,
@@ -101,7 +113,7 @@ enum PluginBridgeNonRtServerOpcode {
     kPluginBridgeNonRtServerProgramName,        // uint/index, uint/size, str[] (name)
     kPluginBridgeNonRtServerMidiProgramData,    // uint/index, uint/bank, uint/program, uint/size, str[] (name)
     kPluginBridgeNonRtServerSetCustomData,      // uint/size, str[], uint/size, str[], uint/size, str[]
-    kPluginBridgeNonRtServerSetChunkDataFile,   // uint/size, str[] (filename, base64 content)
+    kPluginBridgeNonRtServerSetChunkData,       // ulong/total, ulong/offset, ulong/size (data in chunk pool)
     kPluginBridgeNonRtServerSetLatency,         // uint
     kPluginBridgeNonRtServerReady,
     kPluginBridgeNonRtServerSaved,
@@ -109,6 +121,13 @@ enum PluginBridgeNonRtServerOpcode {
     kPluginBridgeNonRtServerError               // uint/size, str[]
 };
 
+// Server sends these to a bridge group process during non-RT
+enum PluginBridgeGroupOpcode {
+    kPluginBridgeGroupNull = 0,
+    kPluginBridgeGroupAddMember, // uint/size, str[] (shm ids), uint/type, uint/size, str[] (filename), uint/size, str[] (name), uint/size, str[] (label), long/uniqueId
+    kPluginBridgeGroupQuit
+};
+
 // -----------------------------------------------------------------------
 
 struct BridgeSemaphore {
@@ -138,6 +157,48 @@ struct BridgeTimeInfo {
 
 static const std::size_t kBridgeRtClientDataMidiOutSize = 512*4;
 
+// Max number of events in a single kPluginBridgeRtClientEventBlock
+static const uint32_t kBridgeRtEventBlockSize = 64;
+
+// Fixed-size event, sent in blocks so both sides copy them in one go
+struct BridgeRtEvent {
+    uint32_t time;
+    uint8_t  type;
+    uint8_t  channel;
+    uint16_t param;
+    union {
+        float   value;
+        uint8_t midi[4];
+    };
+};
+
+// Chunk pool starts at this size, and grows in powers of 2
+static const std::size_t kBridgeChunkPoolMinSize = 64*1024;
+
+// Plugin chunks are passed as-is in a separate shm segment, the chunk pool.
+// The server creates and resizes it, both sides write to it.
+// Only one transfer can be pending at a time, the writing side claims 'busy' before touching the pool,
+// the reading side releases it when done. Always use the helpers below, both processes race for it.
+struct BridgeChunkPoolState {
+    uint64_t size;
+    uint32_t busy;
+};
+
+// try to take the chunk pool for writing, fails if a transfer is still pending
+static inline
+bool carla_chunk_pool_claim(BridgeChunkPoolState& state) noexcept
+{
+    uint32_t expected = 0;
+    return __atomic_compare_exchange_n(&state.busy, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+// give the chunk pool back, after reading its data (or giving up on writing it)
+static inline
+void carla_chunk_pool_release(BridgeChunkPoolState& state) noexcept
+{
+    __atomic_store_n(&state.busy, 0, __ATOMIC_RELEASE);
+}
+
 // Server => Client RT
 struct BridgeRtClientData {
     BridgeSemaphore sem;
@@ -149,6 +210,7 @@ struct BridgeRtClientData {
 // Server => Client Non-RT
 struct BridgeNonRtClientData {
     BigStackBuffer ringBuffer;
+    BridgeChunkPoolState chunkPool;
 };
 
 // Client => Server Non-RT
@@ -156,6 +218,14 @@ struct BridgeNonRtServerData {
     HugeStackBuffer ringBuffer;
 };
 
+// Server => Client, one per bridge group process.
+// Grouped plugins keep their own segments, but only these semaphores are used to run a block.
+// The ring buffer is non-RT only, it is read by the client idle thread.
+struct BridgeGroupData {
+    BridgeSemaphore sem;
+    SmallStackBuffer ringBuffer;
+};
+
 // -----------------------------------------------------------------------
 
 static inline
@@ -167,16 +237,8 @@ const char* PluginBridgeRtClientOpcode2str(const PluginBridgeRtClientOpcode opco
         return "kPluginBridgeRtClientNull";
     case kPluginBridgeRtClientSetAudioPool:
         return "kPluginBridgeRtClientSetAudioPool";
-    case kPluginBridgeRtClientControlEventParameter:
-        return "kPluginBridgeRtClientControlEventParameter";
-    case kPluginBridgeRtClientControlEventMidiBank:
-        return "kPluginBridgeRtClientControlEventMidiBank";
-    case kPluginBridgeRtClientControlEventMidiProgram:
-        return "kPluginBridgeRtClientControlEventMidiProgram";
-    case kPluginBridgeRtClientControlEventAllSoundOff:
-        return "kPluginBridgeRtClientControlEventAllSoundOff";
-    case kPluginBridgeRtClientControlEventAllNotesOff:
-        return "kPluginBridgeRtClientControlEventAllNotesOff";
+    case kPluginBridgeRtClientEventBlock:
+        return "kPluginBridgeRtClientEventBlock";
     case kPluginBridgeRtClientMidiEvent:
         return "kPluginBridgeRtClientMidiEvent";
     case kPluginBridgeRtClientProcess:
@@ -224,8 +286,8 @@ const char* PluginBridgeNonRtClientOpcode2str(const PluginBridgeNonRtClientOpcod
         return "kPluginBridgeNonRtClientSetMidiProgram";
     case kPluginBridgeNonRtClientSetCustomData:
         return "kPluginBridgeNonRtClientSetCustomData";
-    case kPluginBridgeNonRtClientSetChunkDataFile:
-        return "kPluginBridgeNonRtClientSetChunkDataFile";
+    case kPluginBridgeNonRtClientSetChunkData:
+        return "kPluginBridgeNonRtClientSetChunkData";
     case kPluginBridgeNonRtClientSetCtrlChannel:
         return "kPluginBridgeNonRtClientSetCtrlChannel";
     case kPluginBridgeNonRtClientSetOption:
@@ -299,8 +361,8 @@ const char* PluginBridgeNonRtServerOpcode2str(const PluginBridgeNonRtServerOpcod
         return "kPluginBridgeNonRtServerMidiProgramData";
     case kPluginBridgeNonRtServerSetCustomData:
         return "kPluginBridgeNonRtServerSetCustomData";
-    case kPluginBridgeNonRtServerSetChunkDataFile:
-        return "kPluginBridgeNonRtServerSetChunkDataFile";
+    case kPluginBridgeNonRtServerSetChunkData:
+        return "kPluginBridgeNonRtServerSetChunkData";
     case kPluginBridgeNonRtServerSetLatency:
         return "kPluginBridgeNonRtServerSetLatency";
     case kPluginBridgeNonRtServerReady:
@@ -317,6 +379,23 @@ const char* PluginBridgeNonRtServerOpcode2str(const PluginBridgeNonRtServerOpcod
     return nullptr;
 }
 
+static inline
+const char* PluginBridgeGroupOpcode2str(const PluginBridgeGroupOpcode opcode) noexcept
+{
+    switch (opcode)
+    {
+    case kPluginBridgeGroupNull:
+        return "kPluginBridgeGroupNull";
+    case kPluginBridgeGroupAddMember:
+        return "kPluginBridgeGroupAddMember";
+    case kPluginBridgeGroupQuit:
+        return "kPluginBridgeGroupQuit";
+    }
+
+    carla_stderr("CarlaBackend::PluginBridgeGroupOpcode2str(%i) - invalid opcode", opcode);
+    return nullptr;
+}
+
 // -----------------------------------------------------------------------
 
 #endif // CARLA_BRIDGE_UTILS_HPP_INCLUDED
@@ -51,6 +51,8 @@ const char* EngineType2Str(const EngineType type) noexcept
         return "kEngineTypePlugin";
     case kEngineTypeBridge:
         return "kEngineTypeBridge";
+    case kEngineTypeDummy:
+        return "kEngineTypeDummy";
     }
 
     carla_stderr("CarlaBackend::EngineType2Str(%i) - invalid type", type);
@@ -117,26 +119,129 @@ const char* EngineControlEventType2Str(const EngineControlEventType type) noexce
 }
 
 // -----------------------------------------------------------------------
+// Engine event buffers
+// Used events are followed by one of type kEngineEventTypeNull, unless the buffer is full.
+// Nothing after that event is ever read, so clearing and copying only touch the used events.
 
 static inline
-void fillEngineEventsFromJuceMidiBuffer(EngineEvent engineEvents[kMaxEngineEventInternalCount], const juce::MidiBuffer& midiBuffer)
+void clearEngineEvents(EngineEvent engineEvents[kMaxEngineEventInternalCount]) noexcept
 {
-    const uint8_t* midiData;
-    int numBytes, sampleNumber;
-    ushort engineEventIndex = 0;
+    engineEvents[0].type = kEngineEventTypeNull;
+}
 
-    for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+static inline
+void terminateEngineEvents(EngineEvent engineEvents[kMaxEngineEventInternalCount], const ushort count) noexcept
+{
+    if (count < kMaxEngineEventInternalCount)
+        engineEvents[count].type = kEngineEventTypeNull;
+}
+
+static inline
+ushort getEngineEventCount(const EngineEvent engineEvents[kMaxEngineEventInternalCount]) noexcept
+{
+    ushort i=0;
+
+    for (; i < kMaxEngineEventInternalCount; ++i)
     {
-        const EngineEvent& engineEvent(engineEvents[i]);
+        if (engineEvents[i].type == kEngineEventTypeNull)
+            break;
+    }
 
-        if (engineEvent.type != kEngineEventTypeNull)
+    return i;
+}
+
+static inline
+ushort copyEngineEvents(EngineEvent dstEvents[kMaxEngineEventInternalCount], const EngineEvent srcEvents[kMaxEngineEventInternalCount]) noexcept
+{
+    const ushort count(getEngineEventCount(srcEvents));
+
+    if (count > 0)
+        carla_copyStruct<EngineEvent>(dstEvents, srcEvents, count);
+
+    terminateEngineEvents(dstEvents, count);
+    return count;
+}
+
+/*
+ * Merge several time-sorted event buffers into @a dstEvents, which must not be one of the sources.
+ * Events with the same time keep the order of their sources, events that do not fit are dropped.
+ * Null sources are skipped.
+ */
+static inline
+ushort mergeEngineEvents(EngineEvent dstEvents[kMaxEngineEventInternalCount], const EngineEvent* const srcEvents[], const uint srcCount) noexcept
+{
+    if (srcCount == 1 && srcEvents[0] != nullptr)
+        return copyEngineEvents(dstEvents, srcEvents[0]);
+
+    // non-empty sources, kept in their original order
+    const EngineEvent* heads[srcCount+1];
+    ushort remaining[srcCount+1];
+    uint active = 0;
+
+    for (uint i=0; i < srcCount; ++i)
+    {
+        if (srcEvents[i] == nullptr)
             continue;
 
-        engineEventIndex = i;
-        break;
+        if (const ushort srcEventCount = getEngineEventCount(srcEvents[i]))
+        {
+            heads[active] = srcEvents[i];
+            remaining[active++] = srcEventCount;
+        }
+    }
+
+    ushort count = 0;
+
+    for (; active > 1 && count < kMaxEngineEventInternalCount; ++count)
+    {
+        uint next = 0;
+
+        // strictly lower, so earlier sources win on the same time
+        for (uint i=1; i < active; ++i)
+        {
+            if (heads[i]->time < heads[next]->time)
+                next = i;
+        }
+
+        dstEvents[count] = *heads[next]++;
+
+        if (--remaining[next] != 0)
+            continue;
+
+        // source is done
+        for (uint i=next+1; i < active; ++i)
+        {
+            heads[i-1]     = heads[i];
+            remaining[i-1] = remaining[i];
+        }
+
+        --active;
     }
 
-    for (juce::MidiBuffer::Iterator midiBufferIterator(midiBuffer); midiBufferIterator.getNextEvent(midiData, numBytes, sampleNumber) && engineEventIndex < kMaxEngineEventInternalCount;)
+    // only 1 source left, copy the rest in one go
+    if (active == 1 && count < kMaxEngineEventInternalCount)
+    {
+        const ushort space(static_cast<ushort>(kMaxEngineEventInternalCount-count));
+        const ushort rest(remaining[0] < space ? remaining[0] : space);
+
+        carla_copyStruct<EngineEvent>(dstEvents+count, heads[0], rest);
+        count = static_cast<ushort>(count+rest);
+    }
+
+    terminateEngineEvents(dstEvents, count);
+    return count;
+}
+
+// -----------------------------------------------------------------------
+
+static inline
+void fillEngineEventsFromJuceMidiBuffer(EngineEvent engineEvents[kMaxEngineEventInternalCount], const juce::MidiBuffer& midiBuffer)
+{
+    const uint8_t* midiData;
+    int numBytes, sampleNumber;
+    ushort engineEventIndex(getEngineEventCount(engineEvents));
+
+    for (juce::MidiBuffer::Iterator midiBufferIterator(midiBuffer); engineEventIndex < kMaxEngineEventInternalCount && midiBufferIterator.getNextEvent(midiData, numBytes, sampleNumber);)
     {
         CARLA_SAFE_ASSERT_CONTINUE(numBytes > 0);
         CARLA_SAFE_ASSERT_CONTINUE(sampleNumber >= 0);
@@ -147,6 +252,8 @@ void fillEngineEventsFromJuceMidiBuffer(EngineEvent engineEvents[kMaxEngineEvent
         engineEvent.time = static_cast<uint32_t>(sampleNumber);
         engineEvent.fillFromMidiData(static_cast<uint8_t>(numBytes), midiData, 0);
     }
+
+    terminateEngineEvents(engineEvents, engineEventIndex);
 }
 
 // -----------------------------------------------------------------------
@@ -18,6 +18,7 @@
 #ifndef CARLA_LV2_UTILS_HPP_INCLUDED
 #define CARLA_LV2_UTILS_HPP_INCLUDED
 
+#include "CarlaMutex.hpp"
 #include "CarlaUtils.hpp"
 
 #ifndef nullptr
@@ -244,8 +245,14 @@ public:
     Lilv::Node doap_license;
     Lilv::Node rdf_type;
     Lilv::Node rdfs_label;
+    Lilv::Node rdfs_seeAlso;
 
     bool needsInit;
+    bool loadedAll;
+    juce::StringArray loadedBundles;
+
+    // lilv is not thread-safe, hold this when plugins may be loading on other threads
+    CarlaMutex mutex;
 
     // -------------------------------------------------------------------
 
@@ -363,8 +370,12 @@ public:
           doap_license       (new_uri(NS_doap "license")),
           rdf_type           (new_uri(NS_rdf "type")),
           rdfs_label         (new_uri(NS_rdfs "label")),
+          rdfs_seeAlso       (new_uri(NS_rdfs "seeAlso")),
 
-          needsInit(true)    {}
+          needsInit(true),
+          loadedAll(false),
+          loadedBundles(),
+          mutex()            {}
 
     static Lv2WorldClass& getInstance()
     {
@@ -376,14 +387,52 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(LV2_PATH != nullptr,);
 
-        if (! needsInit)
+        if (loadedAll)
             return;
 
+        // bundles loaded on their own before this will be reported as duplicates by lilv, which keeps the first
         needsInit = false;
+        loadedAll = true;
 
         Lilv::World::load_all(LV2_PATH);
     }
 
+    // load a single bundle by path, unless it (or everything) is already loaded
+    void loadBundleIfNeeded(const char* const bundlePath)
+    {
+        CARLA_SAFE_ASSERT_RETURN(bundlePath != nullptr && bundlePath[0] != '\0',);
+
+        if (loadedAll || loadedBundles.contains(bundlePath))
+            return;
+
+        loadedBundles.add(bundlePath);
+
+        Lilv::Node bundleNode(new_file_uri(nullptr, bundlePath));
+        CARLA_SAFE_ASSERT_RETURN(bundleNode.is_uri(),);
+
+        juce::String bundleURI(bundleNode.as_uri());
+
+        if (! bundleURI.endsWithChar('/'))
+            bundleURI += "/";
+
+        load_bundle(bundleURI.toRawUTF8());
+    }
+
+    void loadResourceFromURI(const LV2_URI uri)
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0',);
+
+        Lilv::Node uriNode(new_uri(uri));
+        CARLA_SAFE_ASSERT_RETURN(uriNode.is_uri(),);
+
+        load_resource(uriNode);
+    }
+
+    bool hasLoadedAll() const noexcept
+    {
+        return loadedAll;
+    }
+
     void load_bundle(const char* const bundle)
     {
         CARLA_SAFE_ASSERT_RETURN(bundle != nullptr && bundle[0] != '\0',);
@@ -444,6 +493,8 @@ public:
         CARLA_SAFE_ASSERT_RETURN(uridMap != nullptr, nullptr);
         CARLA_SAFE_ASSERT_RETURN(! needsInit, nullptr);
 
+        const CarlaMutexLocker cml(mutex);
+
         LilvNode* const uriNode(lilv_new_uri(this->me, uri));
         CARLA_SAFE_ASSERT_RETURN(uriNode != nullptr, nullptr);
 
@@ -16,6 +16,9 @@
  */
 
 #include "CarlaPipeUtils.hpp"
+#include "CarlaBase64Utils.hpp"
+#include "CarlaRingBuffer.hpp"
+#include "CarlaShmUtils.hpp"
 #include "CarlaString.hpp"
 #include "CarlaMIDI.h"
 
@@ -40,8 +43,10 @@
 
 #ifdef CARLA_OS_WIN
 # define INVALID_PIPE_VALUE INVALID_HANDLE_VALUE
+# define PIPE_ATOM_RING_NAMEPREFIX "Global\\carla-pipe_shm_atoms_"
 #else
 # define INVALID_PIPE_VALUE -1
+# define PIPE_ATOM_RING_NAMEPREFIX "/carla-pipe_shm_atoms_"
 #endif
 
 #ifdef CARLA_OS_WIN
@@ -455,6 +460,141 @@ void waitForChildToStopOrKillIt(pid_t& pid, const uint32_t timeOutMilliseconds)
 }
 #endif
 
+// -----------------------------------------------------------------------
+// lv2 atoms over shared memory
+//
+// Each atom is written to the ring as its port index followed by the full atom,
+// then a single "atomRingData" line goes through the pipe so it stays in order with all other messages.
+//
+// The same memory has the answer to "uridMap" requests, which the client waits for without reading the pipe.
+
+struct CarlaPipeUridMapAnswer {
+    static const uint32_t size = 16384;
+
+    // the request being answered, written last
+    uint32_t serial;
+
+    // number of URIs in data, each one nul-terminated
+    uint32_t count;
+
+    char data[size];
+};
+
+struct CarlaPipeAtomRingData {
+    HugeStackBuffer serverToClient;
+    HugeStackBuffer clientToServer;
+    CarlaPipeUridMapAnswer uridMapAnswer;
+};
+
+struct CarlaPipeAtomRingControl : public CarlaRingBufferControl<HugeStackBuffer> {
+    CarlaPipeAtomRingControl() noexcept {}
+
+    void setRingBuffer(HugeStackBuffer* const ringBuf, const bool resetBuffer) noexcept
+    {
+        CarlaRingBufferControl<HugeStackBuffer>::setRingBuffer(ringBuf, resetBuffer);
+    }
+
+    // returns false if there is not enough space, the atom should be sent as text then
+    bool writeAtom(const uint32_t index, const LV2_Atom* const atom) noexcept
+    {
+        const uint32_t atomSize(lv2_atom_total_size(atom));
+
+        if (sizeof(uint32_t) + atomSize >= getAvailableDataSize())
+            return false;
+
+        tryWrite(&index, sizeof(uint32_t));
+        tryWrite(atom, atomSize);
+        return commitWrite();
+    }
+
+    // @a atomBuf needs HugeStackBuffer::size bytes
+    bool readAtom(uint32_t& index, LV2_Atom* const atomBuf) noexcept
+    {
+        if (! tryRead(&index, sizeof(uint32_t)))
+            return false;
+        if (! tryRead(atomBuf, sizeof(LV2_Atom)))
+            return false;
+
+        CARLA_SAFE_ASSERT_RETURN(atomBuf->size <= HugeStackBuffer::size - sizeof(LV2_Atom), false);
+
+        if (atomBuf->size == 0)
+            return true;
+
+        return tryRead(atomBuf + 1, atomBuf->size);
+    }
+
+    CARLA_DECLARE_NON_COPY_STRUCT(CarlaPipeAtomRingControl)
+};
+
+struct CarlaPipeAtomRing {
+    CarlaPipeAtomRingData* data;
+    CarlaPipeAtomRingControl sendRing;
+    CarlaPipeAtomRingControl recvRing;
+
+    // the other side has the ring mapped, atoms can be written to it
+    bool ready;
+
+    // the atom being read, aligned for LV2_Atom access
+    uint64_t recvBuf[HugeStackBuffer::size / sizeof(uint64_t)];
+
+    shm_t shm;
+
+    CarlaPipeAtomRing() noexcept
+        : data(nullptr),
+          sendRing(),
+          recvRing(),
+          ready(false),
+          recvBuf()
+#ifdef CARLA_PROPER_CPP11_SUPPORT
+        , shm(shm_t_INIT) {}
+#else
+    {
+        carla_shm_init(shm);
+    }
+#endif
+
+    ~CarlaPipeAtomRing() noexcept
+    {
+        if (data != nullptr)
+        {
+            sendRing.setRingBuffer(nullptr, false);
+            recvRing.setRingBuffer(nullptr, false);
+
+            carla_shm_unmap(shm, data);
+            data = nullptr;
+        }
+
+        if (carla_is_shm_valid(shm))
+            carla_shm_close(shm);
+    }
+
+    // server side, @a fileBase gets the name to send to the client
+    bool create(char* const fileBase) noexcept
+    {
+        shm = carla_shm_create_temp(fileBase);
+        CARLA_SAFE_ASSERT_RETURN(carla_is_shm_valid(shm), false);
+        CARLA_SAFE_ASSERT_RETURN(carla_shm_map<CarlaPipeAtomRingData>(shm, data), false);
+
+        sendRing.setRingBuffer(&data->serverToClient, true);
+        recvRing.setRingBuffer(&data->clientToServer, true);
+        return true;
+    }
+
+    // client side, the server has already cleared the buffers
+    bool attach(const char* const filename) noexcept
+    {
+        shm = carla_shm_attach(filename);
+        CARLA_SAFE_ASSERT_RETURN(carla_is_shm_valid(shm), false);
+        CARLA_SAFE_ASSERT_RETURN(carla_shm_map<CarlaPipeAtomRingData>(shm, data), false);
+
+        sendRing.setRingBuffer(&data->clientToServer, false);
+        recvRing.setRingBuffer(&data->serverToClient, false);
+        return true;
+    }
+
+    CARLA_DECLARE_NON_COPY_STRUCT(CarlaPipeAtomRing)
+};
+
 // -----------------------------------------------------------------------
 
 struct CarlaPipeCommon::PrivateData {
@@ -470,12 +610,19 @@ struct CarlaPipeCommon::PrivateData {
     int pipeSend;
 #endif
 
-    // read functions must only be called in context of idlePipe()
-    bool isReading;
+    // read functions must only be called in context of idlePipe().
+    // more than 1 while a message handler waits for a reply, which nests idlePipe() calls
+    uint32_t readDepth;
 
     // common write lock
     CarlaMutex writeLock;
 
+    // shared memory for lv2 atoms, set once offered (server) or accepted (client)
+    CarlaPipeAtomRing* atomRing;
+
+    // last "uridMap" request sent, client side
+    uint32_t uridMapSerial;
+
     // temporary buffers for _readline()
     mutable char        tmpBuf[0xff+1];
     mutable CarlaString tmpStr;
@@ -489,8 +636,10 @@ struct CarlaPipeCommon::PrivateData {
 #endif
           pipeRecv(INVALID_PIPE_VALUE),
           pipeSend(INVALID_PIPE_VALUE),
-          isReading(false),
+          readDepth(0),
           writeLock(),
+          atomRing(nullptr),
+          uridMapSerial(0),
           tmpBuf(),
           tmpStr()
     {
@@ -509,6 +658,9 @@ struct CarlaPipeCommon::PrivateData {
 
     ~PrivateData() noexcept
     {
+        // should be closed by now
+        CARLA_SAFE_ASSERT(atomRing == nullptr);
+
 #ifdef CARLA_OS_WIN
         if (cancelEvent != INVALID_HANDLE_VALUE)
         {
@@ -561,13 +713,14 @@ void CarlaPipeCommon::idlePipe(const bool onlyOnce) noexcept
             ::setlocale(LC_NUMERIC, "C");
         }
 
-        pData->isReading = true;
+        ++pData->readDepth;
 
         try {
-            msgReceived(msg);
+            if (! _handleInternalMessage(msg))
+                msgReceived(msg);
         } CARLA_SAFE_EXCEPTION("msgReceived");
 
-        pData->isReading = false;
+        --pData->readDepth;
 
         delete[] msg;
 
@@ -608,7 +761,7 @@ CarlaMutex& CarlaPipeCommon::getPipeLock() const noexcept
 
 bool CarlaPipeCommon::readNextLineAsBool(bool& value) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->isReading, false);
+    CARLA_SAFE_ASSERT_RETURN(pData->readDepth > 0, false);
 
     if (const char* const msg = _readlineblock())
     {
@@ -622,7 +775,7 @@ bool CarlaPipeCommon::readNextLineAsBool(bool& value) const noexcept
 
 bool CarlaPipeCommon::readNextLineAsByte(uint8_t& value) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->isReading, false);
+    CARLA_SAFE_ASSERT_RETURN(pData->readDepth > 0, false);
 
     if (const char* const msg = _readlineblock())
     {
@@ -641,7 +794,7 @@ bool CarlaPipeCommon::readNextLineAsByte(uint8_t& value) const noexcept
 
 bool CarlaPipeCommon::readNextLineAsInt(int32_t& value) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->isReading, false);
+    CARLA_SAFE_ASSERT_RETURN(pData->readDepth > 0, false);
 
     if (const char* const msg = _readlineblock())
     {
@@ -655,7 +808,7 @@ bool CarlaPipeCommon::readNextLineAsInt(int32_t& value) const noexcept
 
 bool CarlaPipeCommon::readNextLineAsUInt(uint32_t& value) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->isReading, false);
+    CARLA_SAFE_ASSERT_RETURN(pData->readDepth > 0, false);
 
     if (const char* const msg = _readlineblock())
     {
@@ -674,7 +827,7 @@ bool CarlaPipeCommon::readNextLineAsUInt(uint32_t& value) const noexcept
 
 bool CarlaPipeCommon::readNextLineAsLong(int64_t& value) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->isReading, false);
+    CARLA_SAFE_ASSERT_RETURN(pData->readDepth > 0, false);
 
     if (const char* const msg = _readlineblock())
     {
@@ -688,7 +841,7 @@ bool CarlaPipeCommon::readNextLineAsLong(int64_t& value) const noexcept
 
 bool CarlaPipeCommon::readNextLineAsULong(uint64_t& value) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->isReading, false);
+    CARLA_SAFE_ASSERT_RETURN(pData->readDepth > 0, false);
 
     if (const char* const msg = _readlineblock())
     {
@@ -707,7 +860,7 @@ bool CarlaPipeCommon::readNextLineAsULong(uint64_t& value) const noexcept
 
 bool CarlaPipeCommon::readNextLineAsFloat(float& value) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->isReading, false);
+    CARLA_SAFE_ASSERT_RETURN(pData->readDepth > 0, false);
 
     if (const char* const msg = _readlineblock())
     {
@@ -721,7 +874,7 @@ bool CarlaPipeCommon::readNextLineAsFloat(float& value) const noexcept
 
 bool CarlaPipeCommon::readNextLineAsDouble(double& value) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->isReading, false);
+    CARLA_SAFE_ASSERT_RETURN(pData->readDepth > 0, false);
 
     if (const char* const msg = _readlineblock())
     {
@@ -735,7 +888,7 @@ bool CarlaPipeCommon::readNextLineAsDouble(double& value) const noexcept
 
 bool CarlaPipeCommon::readNextLineAsString(const char*& value) const noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->isReading, false);
+    CARLA_SAFE_ASSERT_RETURN(pData->readDepth > 0, false);
 
     if (const char* const msg = _readlineblock())
     {
@@ -953,10 +1106,17 @@ void CarlaPipeCommon::writeLv2AtomMessage(const uint32_t index, const LV2_Atom*
     char tmpBuf[0xff+1];
     tmpBuf[0xff] = '\0';
 
-    CarlaString base64atom(CarlaString::asBase64(atom, lv2_atom_total_size(atom)));
-
     const CarlaMutexLocker cml(pData->writeLock);
 
+    if (pData->atomRing != nullptr && pData->atomRing->ready && pData->atomRing->sendRing.writeAtom(index, atom))
+    {
+        _writeMsgBuffer("atomRingData\n", 13);
+        flushMessages();
+        return;
+    }
+
+    CarlaString base64atom(CarlaString::asBase64(atom, lv2_atom_total_size(atom)));
+
     _writeMsgBuffer("atom\n", 5);
 
     {
@@ -994,6 +1154,104 @@ void CarlaPipeCommon::writeLv2UridMessage(const uint32_t urid, const char* const
     flushMessages();
 }
 
+bool CarlaPipeCommon::writeLv2UridMapMessage(const char* const uri, const uint32_t firstUrid, CarlaStringList& uris,
+                                             const uint32_t timeOutMilliseconds) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(firstUrid != 0, false);
+
+    char tmpBuf[0xff+1];
+    tmpBuf[0xff] = '\0';
+
+    // also keeps the ring alive, and other requests out of the answer
+    const CarlaMutexLocker cml(pData->writeLock);
+
+    CarlaPipeAtomRing* const atomRing(pData->atomRing);
+
+    if (atomRing == nullptr || ! atomRing->ready)
+        return false;
+
+    CarlaPipeUridMapAnswer& answer(atomRing->data->uridMapAnswer);
+
+    if (++pData->uridMapSerial == 0)
+        pData->uridMapSerial = 1;
+
+    const uint32_t serial(pData->uridMapSerial);
+
+    _writeMsgBuffer("uridMap\n", 8);
+
+    {
+        std::snprintf(tmpBuf, 0xff, "%u\n", serial);
+        _writeMsgBuffer(tmpBuf, std::strlen(tmpBuf));
+
+        std::snprintf(tmpBuf, 0xff, "%u\n", firstUrid);
+        _writeMsgBuffer(tmpBuf, std::strlen(tmpBuf));
+
+        writeAndFixMessage(uri);
+    }
+
+    flushMessages();
+
+    for (uint32_t i=0;; ++i)
+    {
+        if (__atomic_load_n(&answer.serial, __ATOMIC_ACQUIRE) == serial)
+            break;
+
+        if (i >= timeOutMilliseconds)
+            return false;
+
+        carla_msleep(1);
+    }
+
+    uris.clear();
+
+    for (uint32_t i=0, pos=0; i < answer.count; ++i)
+    {
+        CARLA_SAFE_ASSERT_RETURN(pos < CarlaPipeUridMapAnswer::size, false);
+
+        const char* const answerUri(answer.data + pos);
+        const std::size_t answerUriLen(strnlen(answerUri, CarlaPipeUridMapAnswer::size - pos));
+
+        CARLA_SAFE_ASSERT_RETURN(answerUriLen != 0 && pos + answerUriLen < CarlaPipeUridMapAnswer::size, false);
+
+        uris.append(answerUri);
+        pos += static_cast<uint32_t>(answerUriLen) + 1;
+    }
+
+    return true;
+}
+
+void CarlaPipeCommon::writeLv2UridMapAnswer(const uint32_t serial, const char* const* const uris, const uint32_t count) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(serial != 0,);
+    CARLA_SAFE_ASSERT_RETURN(uris != nullptr || count == 0,);
+
+    const CarlaMutexLocker cml(pData->writeLock);
+
+    // the client only asks after attaching the ring
+    CARLA_SAFE_ASSERT_RETURN(pData->atomRing != nullptr,);
+
+    CarlaPipeUridMapAnswer& answer(pData->atomRing->data->uridMapAnswer);
+
+    uint32_t i = 0, pos = 0;
+
+    for (; i < count; ++i)
+    {
+        CARLA_SAFE_ASSERT_BREAK(uris[i] != nullptr && uris[i][0] != '\0');
+
+        const std::size_t uriSize(std::strlen(uris[i]) + 1);
+
+        if (pos + uriSize > CarlaPipeUridMapAnswer::size)
+            break;
+
+        std::memcpy(answer.data + pos, uris[i], uriSize);
+        pos += static_cast<uint32_t>(uriSize);
+    }
+
+    answer.count = i;
+    __atomic_store_n(&answer.serial, serial, __ATOMIC_RELEASE);
+}
+
 // -------------------------------------------------------------------
 
 // internal
@@ -1027,7 +1285,8 @@ const char* CarlaPipeCommon::_readline() const noexcept
 
             if (i+1 == 0xff)
             {
-                i = 0;
+                // start over, the loop increment brings this back to 0
+                i = -1;
                 ptr = pData->tmpBuf;
                 pData->tmpStr += pData->tmpBuf;
             }
@@ -1099,6 +1358,115 @@ bool CarlaPipeCommon::_writeMsgBuffer(const char* const msg, const std::size_t s
      return (ret == static_cast<ssize_t>(size));
 }
 
+bool CarlaPipeCommon::_handleInternalMessage(const char* const msg) noexcept
+{
+    if (std::strcmp(msg, "atom") == 0)
+    {
+        uint32_t index, size;
+        const char* base64atom;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(index), true);
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(size), true);
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(base64atom), true);
+
+        std::vector<uint8_t> chunk(carla_getChunkFromBase64String(base64atom));
+        delete[] base64atom;
+        CARLA_SAFE_ASSERT_RETURN(chunk.size() >= sizeof(LV2_Atom), true);
+
+        const LV2_Atom* const atom((const LV2_Atom*)chunk.data());
+        CARLA_SAFE_ASSERT_RETURN(lv2_atom_total_size(atom) == chunk.size(), true);
+
+        lv2AtomReceived(index, atom);
+        return true;
+    }
+
+    if (std::strcmp(msg, "atomRingData") == 0)
+    {
+        CarlaPipeAtomRing* const atomRing(pData->atomRing);
+        CARLA_SAFE_ASSERT_RETURN(atomRing != nullptr, true);
+
+        uint32_t index;
+        LV2_Atom* atom((LV2_Atom*)atomRing->recvBuf);
+
+        // an outer message handler might still be using recvBuf
+        std::vector<uint64_t> nestedBuf;
+
+        if (pData->readDepth > 1)
+        {
+            try {
+                nestedBuf.resize(HugeStackBuffer::size / sizeof(uint64_t));
+            } CARLA_SAFE_EXCEPTION_RETURN("CarlaPipeCommon::_handleInternalMessage atomRingData", true);
+
+            atom = (LV2_Atom*)nestedBuf.data();
+        }
+
+        CARLA_SAFE_ASSERT_RETURN(atomRing->recvRing.readAtom(index, atom), true);
+
+        lv2AtomReceived(index, atom);
+        return true;
+    }
+
+    // client side, the server offers a shared memory ring
+    if (std::strcmp(msg, "atomRing") == 0)
+    {
+        const char* filename;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(filename), true);
+
+        CarlaPipeAtomRing* atomRing = nullptr;
+
+        try {
+            atomRing = new CarlaPipeAtomRing();
+
+            if (! atomRing->attach(filename))
+            {
+                delete atomRing;
+                atomRing = nullptr;
+            }
+        } CARLA_SAFE_EXCEPTION("CarlaPipeCommon::_handleInternalMessage atomRing");
+
+        delete[] filename;
+
+        // keep using text
+        if (atomRing == nullptr)
+            return true;
+
+        // both sides have it mapped now, no need to wait for anything else
+        atomRing->ready = true;
+
+        const CarlaMutexLocker cml(pData->writeLock);
+
+        _closeLv2AtomRing();
+        pData->atomRing = atomRing;
+
+        _writeMsgBuffer("atomRingAck\n", 12);
+        flushMessages();
+        return true;
+    }
+
+    // server side, the client has attached to our ring
+    if (std::strcmp(msg, "atomRingAck") == 0)
+    {
+        const CarlaMutexLocker cml(pData->writeLock);
+
+        CARLA_SAFE_ASSERT_RETURN(pData->atomRing != nullptr, true);
+
+        pData->atomRing->ready = true;
+        return true;
+    }
+
+    return false;
+}
+
+void CarlaPipeCommon::_closeLv2AtomRing() noexcept
+{
+    if (pData->atomRing == nullptr)
+        return;
+
+    delete pData->atomRing;
+    pData->atomRing = nullptr;
+}
+
 // -----------------------------------------------------------------------
 
 CarlaPipeServer::CarlaPipeServer() noexcept
@@ -1430,6 +1798,8 @@ void CarlaPipeServer::closePipeServer() noexcept
 
     const CarlaMutexLocker cml(pData->writeLock);
 
+    _closeLv2AtomRing();
+
     if (pData->pipeRecv != INVALID_PIPE_VALUE)
     {
 #ifdef CARLA_OS_WIN
@@ -1451,6 +1821,39 @@ void CarlaPipeServer::closePipeServer() noexcept
     }
 }
 
+bool CarlaPipeServer::offerLv2AtomRing() noexcept
+{
+    carla_debug("CarlaPipeServer::offerLv2AtomRing()");
+
+    char tmpFileBase[64];
+    std::sprintf(tmpFileBase, PIPE_ATOM_RING_NAMEPREFIX "XXXXXX");
+
+    CarlaPipeAtomRing* atomRing = nullptr;
+
+    try {
+        atomRing = new CarlaPipeAtomRing();
+
+        if (! atomRing->create(tmpFileBase))
+        {
+            delete atomRing;
+            atomRing = nullptr;
+        }
+    } CARLA_SAFE_EXCEPTION("CarlaPipeServer::offerLv2AtomRing");
+
+    if (atomRing == nullptr)
+        return false;
+
+    const CarlaMutexLocker cml(pData->writeLock);
+
+    _closeLv2AtomRing();
+    pData->atomRing = atomRing;
+
+    // flushMessages() can't tell us anything useful here, fsync fails on pipes
+    const bool ok(_writeMsgBuffer("atomRing\n", 9) && writeAndFixMessage(tmpFileBase));
+    flushMessages();
+    return ok;
+}
+
 void CarlaPipeServer::writeShowMessage() const noexcept
 {
     const CarlaMutexLocker cml(pData->writeLock);
@@ -1565,6 +1968,8 @@ void CarlaPipeClient::closePipeClient() noexcept
 
     const CarlaMutexLocker cml(pData->writeLock);
 
+    _closeLv2AtomRing();
+
     if (pData->pipeRecv != INVALID_PIPE_VALUE)
     {
 #ifdef CARLA_OS_WIN
@@ -20,6 +20,7 @@
 
 #include "CarlaJuceUtils.hpp"
 #include "CarlaMutex.hpp"
+#include "CarlaStringList.hpp"
 
 #include "lv2/atom.h"
 
@@ -56,6 +57,13 @@ protected:
         carla_stderr2(error);
     }
 
+    /*!
+     * An lv2 atom has been received (in the context of idlePipe()).
+     * Atoms are decoded internally, both from text and shared memory, and never reach msgReceived().
+     * By default they are ignored.
+     */
+    virtual void lv2AtomReceived(const uint32_t /*index*/, const LV2_Atom* const /*atom*/) noexcept {}
+
 public:
     /*!
      * Check if the pipe is running.
@@ -200,6 +208,8 @@ public:
 
     /*!
      * Write an lv2 "atom" message.
+     * Uses the shared memory ring if one has been negotiated and has enough space, text otherwise.
+     * @see CarlaPipeServer::offerLv2AtomRing()
      */
     void writeLv2AtomMessage(const uint32_t index, const LV2_Atom* const atom) const noexcept;
 
@@ -208,6 +218,23 @@ public:
      */
     void writeLv2UridMessage(const uint32_t urid, const char* const uri) const noexcept;
 
+    /*!
+     * Write an lv2 "uridMap" message, asking the server to map @a uri, and wait for its answer.
+     * @a firstUrid is the first URID this side does not know yet, @a uris gets the URIs from there up to the new one, in order.
+     * The answer comes through the shared memory ring and nothing is read from the pipe meanwhile,
+     * so it is safe to call from any thread, message handlers included.
+     * Returns false if there is no ring or no answer arrives in time.
+     * @note: if too many URIDs are missing the answer only has the first ones, ask again with a higher @a firstUrid then.
+     */
+    bool writeLv2UridMapMessage(const char* const uri, const uint32_t firstUrid, CarlaStringList& uris,
+                                const uint32_t timeOutMilliseconds) const noexcept;
+
+    /*!
+     * Answer an lv2 "uridMap" message, server side.
+     * @a uris are the URIs of all URIDs from the requested first one on, as many as fit are sent.
+     */
+    void writeLv2UridMapAnswer(const uint32_t serial, const char* const* const uris, const uint32_t count) const noexcept;
+
     // -------------------------------------------------------------------
 
 protected:
@@ -225,6 +252,12 @@ protected:
     /*! @internal */
     bool _writeMsgBuffer(const char* const msg, const std::size_t size) const noexcept;
 
+    /*! @internal */
+    bool _handleInternalMessage(const char* const msg) noexcept;
+
+    /*! @internal */
+    void _closeLv2AtomRing() noexcept;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPipeCommon)
 };
 
@@ -268,6 +301,14 @@ public:
      */
     void closePipeServer() noexcept;
 
+    /*!
+     * Offer the client a shared memory ring for lv2 atoms, so they don't need to be sent as base64 text.
+     * The client accepts it while idling, atoms keep going as text until then, or when the ring is full.
+     * Must be called after startPipeServer(), and only for clients that know about it:
+     * older clients pass "atomRing" to msgReceived() as an unknown message, then take the shm filename line for another one.
+     */
+    bool offerLv2AtomRing() noexcept;
+
     // -------------------------------------------------------------------
     // write prepared messages, no lock or flush needed (done internally)
 
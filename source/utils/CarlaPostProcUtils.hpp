@@ -0,0 +1,229 @@
+/*
+ * Carla Post-processing utils
+ * Copyright (C) 2011-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_POST_PROC_UTILS_HPP_INCLUDED
+#define CARLA_POST_PROC_UTILS_HPP_INCLUDED
+
+#include "CarlaMathUtils.hpp"
+
+#ifdef __SSE2_MATH__
+# include <xmmintrin.h>
+#endif
+
+// -----------------------------------------------------------------------
+// Post-processing values, in the same ranges as the plugin parameters
+
+struct CarlaPostProcValues {
+    float dryWet;       // 0.0 dry, 1.0 wet
+    float volume;       // 0.0 to 1.27
+    float balanceLeft;  // -1.0 to 1.0
+    float balanceRight; // -1.0 to 1.0
+};
+
+/*
+ * Check if post-processing values don't change the signal.
+ */
+static inline
+bool carla_isPostProcNeutral(const CarlaPostProcValues& values) noexcept
+{
+    return carla_compareFloats(values.dryWet, 1.0f) && carla_compareFloats(values.volume, 1.0f) &&
+           carla_compareFloats(values.balanceLeft, -1.0f) && carla_compareFloats(values.balanceRight, 1.0f);
+}
+
+// -----------------------------------------------------------------------
+// Post-processing kernels.
+// Apply dry/wet, balance and volume in a single pass, ramping linearly from @a from to @a to over the block.
+// @a wet is the plugin output and @a dry its input, which can be the same buffer to skip dry/wet.
+// @a out can be the same as @a wet for in-place processing.
+
+struct CarlaPostProcGains {
+    float dryWet, balanceLeft, balanceRight, volume;
+
+    CarlaPostProcGains(const CarlaPostProcValues& values) noexcept
+        : dryWet(values.dryWet),
+          balanceLeft((values.balanceLeft + 1.0f)/2.0f),
+          balanceRight((values.balanceRight + 1.0f)/2.0f),
+          volume(values.volume) {}
+};
+
+static inline
+void carla_postProcessStereo(const float* const dryL, const float* const dryR,
+                             const float* const wetL, const float* const wetR,
+                             float* const outL, float* const outR, const uint32_t frames,
+                             const CarlaPostProcValues& from, const CarlaPostProcValues& to) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(frames > 0,);
+
+    const CarlaPostProcGains a(from), b(to);
+    const float inv(1.0f/static_cast<float>(frames));
+
+    const float stepW((b.dryWet       - a.dryWet)      *inv);
+    const float stepL((b.balanceLeft  - a.balanceLeft) *inv);
+    const float stepR((b.balanceRight - a.balanceRight)*inv);
+    const float stepV((b.volume       - a.volume)      *inv);
+
+    uint32_t k = 0;
+
+#ifdef __SSE2_MATH__
+    const __m128 one(_mm_set1_ps(1.0f));
+    const __m128 idx(_mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f));
+
+    __m128 w4(_mm_add_ps(_mm_set1_ps(a.dryWet),       _mm_mul_ps(_mm_set1_ps(stepW), idx)));
+    __m128 l4(_mm_add_ps(_mm_set1_ps(a.balanceLeft),  _mm_mul_ps(_mm_set1_ps(stepL), idx)));
+    __m128 r4(_mm_add_ps(_mm_set1_ps(a.balanceRight), _mm_mul_ps(_mm_set1_ps(stepR), idx)));
+    __m128 v4(_mm_add_ps(_mm_set1_ps(a.volume),       _mm_mul_ps(_mm_set1_ps(stepV), idx)));
+
+    const __m128 stepW4(_mm_set1_ps(stepW*4.0f));
+    const __m128 stepL4(_mm_set1_ps(stepL*4.0f));
+    const __m128 stepR4(_mm_set1_ps(stepR*4.0f));
+    const __m128 stepV4(_mm_set1_ps(stepV*4.0f));
+
+    for (; k+4 <= frames; k += 4)
+    {
+        const __m128 dl(_mm_loadu_ps(dryL + k));
+        const __m128 dr(_mm_loadu_ps(dryR + k));
+
+        // dry/wet
+        const __m128 sl(_mm_add_ps(dl, _mm_mul_ps(w4, _mm_sub_ps(_mm_loadu_ps(wetL + k), dl))));
+        const __m128 sr(_mm_add_ps(dr, _mm_mul_ps(w4, _mm_sub_ps(_mm_loadu_ps(wetR + k), dr))));
+
+        // balance
+        const __m128 bl(_mm_add_ps(_mm_mul_ps(sl, _mm_sub_ps(one, l4)), _mm_mul_ps(sr, _mm_sub_ps(one, r4))));
+        const __m128 br(_mm_add_ps(_mm_mul_ps(sr, r4), _mm_mul_ps(sl, l4)));
+
+        // volume
+        _mm_storeu_ps(outL + k, _mm_mul_ps(bl, v4));
+        _mm_storeu_ps(outR + k, _mm_mul_ps(br, v4));
+
+        w4 = _mm_add_ps(w4, stepW4);
+        l4 = _mm_add_ps(l4, stepL4);
+        r4 = _mm_add_ps(r4, stepR4);
+        v4 = _mm_add_ps(v4, stepV4);
+    }
+#endif
+
+    for (; k < frames; ++k)
+    {
+        const float pos(static_cast<float>(k+1));
+        const float w(a.dryWet       + stepW*pos);
+        const float l(a.balanceLeft  + stepL*pos);
+        const float r(a.balanceRight + stepR*pos);
+        const float v(a.volume       + stepV*pos);
+
+        const float sl(dryL[k] + w*(wetL[k] - dryL[k]));
+        const float sr(dryR[k] + w*(wetR[k] - dryR[k]));
+
+        outL[k] = (sl*(1.0f - l) + sr*(1.0f - r)) * v;
+        outR[k] = (sr*r + sl*l) * v;
+    }
+}
+
+// Same as above for a channel without a balance pair
+static inline
+void carla_postProcessMono(const float* const dry, const float* const wet, float* const out, const uint32_t frames,
+                           const CarlaPostProcValues& from, const CarlaPostProcValues& to) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(frames > 0,);
+
+    const float inv(1.0f/static_cast<float>(frames));
+    const float stepW((to.dryWet - from.dryWet)*inv);
+    const float stepV((to.volume - from.volume)*inv);
+
+    uint32_t k = 0;
+
+#ifdef __SSE2_MATH__
+    const __m128 idx(_mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f));
+
+    __m128 w4(_mm_add_ps(_mm_set1_ps(from.dryWet), _mm_mul_ps(_mm_set1_ps(stepW), idx)));
+    __m128 v4(_mm_add_ps(_mm_set1_ps(from.volume), _mm_mul_ps(_mm_set1_ps(stepV), idx)));
+
+    const __m128 stepW4(_mm_set1_ps(stepW*4.0f));
+    const __m128 stepV4(_mm_set1_ps(stepV*4.0f));
+
+    for (; k+4 <= frames; k += 4)
+    {
+        const __m128 d(_mm_loadu_ps(dry + k));
+        const __m128 s(_mm_add_ps(d, _mm_mul_ps(w4, _mm_sub_ps(_mm_loadu_ps(wet + k), d))));
+
+        _mm_storeu_ps(out + k, _mm_mul_ps(s, v4));
+
+        w4 = _mm_add_ps(w4, stepW4);
+        v4 = _mm_add_ps(v4, stepV4);
+    }
+#endif
+
+    for (; k < frames; ++k)
+    {
+        const float pos(static_cast<float>(k+1));
+        const float w(from.dryWet + stepW*pos);
+        const float v(from.volume + stepV*pos);
+
+        out[k] = (dry[k] + w*(wet[k] - dry[k])) * v;
+    }
+}
+
+// -----------------------------------------------------------------------
+// Latency compensation for the dry signal.
+// @a delayBuffer keeps the last @a delayFrames input frames of the previous blocks.
+
+/*
+ * Delay @a buffer, a copy of the current input, by @a delayFrames.
+ * Call before carla_updatePostProcDelay() for the same block.
+ */
+static inline
+void carla_delayPostProcDry(float* const buffer, const float* const delayBuffer, const uint32_t delayFrames, const uint32_t frames) noexcept
+{
+    if (delayFrames == 0 || frames == 0)
+        return;
+
+    if (delayFrames < frames)
+    {
+        std::memmove(buffer+delayFrames, buffer, sizeof(float)*(frames-delayFrames));
+        carla_copyFloat(buffer, delayBuffer, delayFrames);
+    }
+    else
+    {
+        carla_copyFloat(buffer, delayBuffer, frames);
+    }
+}
+
+/*
+ * Push the current input into @a delayBuffer, for the next block.
+ */
+static inline
+void carla_updatePostProcDelay(float* const delayBuffer, const uint32_t delayFrames, const float* const input, const uint32_t frames) noexcept
+{
+    if (delayFrames == 0 || frames == 0)
+        return;
+
+    if (delayFrames <= frames)
+    {
+        carla_copyFloat(delayBuffer, input+(frames-delayFrames), delayFrames);
+    }
+    else
+    {
+        const uint32_t diff(delayFrames-frames);
+
+        // push back buffer by 'frames', then put current input at the end
+        std::memmove(delayBuffer, delayBuffer+frames, sizeof(float)*diff);
+        carla_copyFloat(delayBuffer+diff, input, frames);
+    }
+}
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_POST_PROC_UTILS_HPP_INCLUDED
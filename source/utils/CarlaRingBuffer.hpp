@@ -41,13 +41,25 @@
    invalidateCommit:
     boolean used to check if a write operation failed.
     this ensures we don't get incomplete writes.
+
+   There is a single writer and a single reader, possibly in different threads or processes.
+   head, wrtn and invalidateCommit belong to the writer, tail belongs to the reader.
+   Each side has its own cache line, so they don't keep invalidating each other's.
   */
 
+static const std::size_t kRingBufferCacheLineSize = 64;
+static const std::size_t kRingBufferWriterPadding = kRingBufferCacheLineSize - 2*sizeof(uint32_t) - sizeof(bool);
+static const std::size_t kRingBufferReaderPadding = kRingBufferCacheLineSize - sizeof(uint32_t);
+
 struct HeapBuffer {
     uint32_t size;
-    uint32_t head, tail, wrtn;
-    bool     invalidateCommit;
     uint8_t* buf;
+    char     _padInfo[kRingBufferCacheLineSize - sizeof(uint32_t) - sizeof(uint8_t*)];
+    uint32_t head, wrtn;
+    bool     invalidateCommit;
+    char     _padWriter[kRingBufferWriterPadding];
+    uint32_t tail;
+    char     _padReader[kRingBufferReaderPadding];
 
     void copyDataFrom(const HeapBuffer& rb) noexcept
     {
@@ -63,33 +75,59 @@ struct HeapBuffer {
 
 struct SmallStackBuffer {
     static const uint32_t size = 4096;
-    uint32_t head, tail, wrtn;
+    uint32_t head, wrtn;
     bool     invalidateCommit;
+    char     _padWriter[kRingBufferWriterPadding];
+    uint32_t tail;
+    char     _padReader[kRingBufferReaderPadding];
     uint8_t  buf[size];
 };
 
 struct BigStackBuffer {
     static const uint32_t size = 16384;
-    uint32_t head, tail, wrtn;
+    uint32_t head, wrtn;
     bool     invalidateCommit;
+    char     _padWriter[kRingBufferWriterPadding];
+    uint32_t tail;
+    char     _padReader[kRingBufferReaderPadding];
     uint8_t  buf[size];
 };
 
 struct HugeStackBuffer {
     static const uint32_t size = 65536;
-    uint32_t head, tail, wrtn;
+    uint32_t head, wrtn;
     bool     invalidateCommit;
+    char     _padWriter[kRingBufferWriterPadding];
+    uint32_t tail;
+    char     _padReader[kRingBufferReaderPadding];
     uint8_t  buf[size];
 };
 
 #ifdef CARLA_PROPER_CPP11_SUPPORT
-# define HeapBuffer_INIT  {0, 0, 0, 0, false, nullptr}
-# define StackBuffer_INIT {0, 0, 0, false, {0}}
+# define HeapBuffer_INIT  {0, nullptr, {0}, 0, 0, false, {0}, 0, {0}}
+# define StackBuffer_INIT {0, 0, false, {0}, 0, {0}, {0}}
 #else
 # define HeapBuffer_INIT
 # define StackBuffer_INIT
 #endif
 
+// -----------------------------------------------------------------------
+// Index access.
+// An index is published with release semantics after the data it covers is written (or read),
+// and loaded with acquire semantics before touching that data.
+
+static inline
+uint32_t carla_ringBufferLoadIndex(const uint32_t& index) noexcept
+{
+    return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+}
+
+static inline
+void carla_ringBufferStoreIndex(uint32_t& index, const uint32_t value) noexcept
+{
+    __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+}
+
 // -----------------------------------------------------------------------
 // CarlaRingBufferControl templated class
 
@@ -99,6 +137,8 @@ class CarlaRingBufferControl
 public:
     CarlaRingBufferControl() noexcept
         : fBuffer(nullptr),
+          fCachedHead(0),
+          fCachedTail(0),
           fErrorReading(false),
           fErrorWriting(false) {}
 
@@ -115,6 +155,9 @@ public:
         fBuffer->wrtn = 0;
         fBuffer->invalidateCommit = false;
 
+        fCachedHead = 0;
+        fCachedTail = 0;
+
         carla_zeroBytes(fBuffer->buf, fBuffer->size);
     }
 
@@ -134,30 +177,97 @@ public:
         // nothing to commit?
         CARLA_SAFE_ASSERT_RETURN(fBuffer->head != fBuffer->wrtn, false);
 
-        // all ok
-        fBuffer->head = fBuffer->wrtn;
+        // all ok, makes the written data visible to the reader
+        carla_ringBufferStoreIndex(fBuffer->head, fBuffer->wrtn);
         return true;
     }
 
     bool isDataAvailableForReading() const noexcept
     {
-        return (fBuffer != nullptr && fBuffer->buf != nullptr && fBuffer->head != fBuffer->tail);
+        return (fBuffer != nullptr && fBuffer->buf != nullptr && carla_ringBufferLoadIndex(fBuffer->head) != fBuffer->tail);
     }
 
     bool isEmpty() const noexcept
     {
         CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, false);
 
-        return (fBuffer->buf == nullptr || fBuffer->head == fBuffer->tail);
+        return (fBuffer->buf == nullptr || carla_ringBufferLoadIndex(fBuffer->head) == fBuffer->tail);
     }
 
+    // free space for writing
     uint32_t getAvailableDataSize() const noexcept
     {
         CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, 0);
 
-        const uint32_t wrap((fBuffer->tail > fBuffer->wrtn) ? 0 : fBuffer->size);
+        return fBuffer->size - getDistance(carla_ringBufferLoadIndex(fBuffer->tail), fBuffer->wrtn);
+    }
+
+    // -------------------------------------------------------------------
+    // Bulk access, reads or writes several values in place instead of copying each one.
+    // Spans stop at the end of the buffer, when data wraps call these again after advancing.
 
-        return wrap + fBuffer->tail - fBuffer->wrtn;
+    // readable data at the current read position
+    uint32_t getReadSpan(const uint8_t*& data) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, 0);
+
+        const uint32_t tail(fBuffer->tail);
+        const uint32_t head(carla_ringBufferLoadIndex(fBuffer->head));
+
+        fCachedHead = head;
+        data = fBuffer->buf + tail;
+
+        return (head >= tail) ? head - tail : fBuffer->size - tail;
+    }
+
+    // marks data from getReadSpan() as read
+    void advanceRead(const uint32_t size) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr,);
+
+        const uint32_t tail(fBuffer->tail);
+        CARLA_SAFE_ASSERT_RETURN(size <= getDistance(tail, fCachedHead),);
+
+        uint32_t readto(tail + size);
+
+        if (readto >= fBuffer->size)
+            readto -= fBuffer->size;
+
+        carla_ringBufferStoreIndex(fBuffer->tail, readto);
+    }
+
+    // free space at the current write position
+    uint32_t getWriteSpan(uint8_t*& data) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, 0);
+
+        const uint32_t wrtn(fBuffer->wrtn);
+        const uint32_t tail(carla_ringBufferLoadIndex(fBuffer->tail));
+
+        fCachedTail = tail;
+        data = fBuffer->buf + wrtn;
+
+        // one byte always stays free, otherwise a full buffer would look empty
+        const uint32_t space(fBuffer->size - getDistance(tail, wrtn) - 1);
+        const uint32_t untilEnd(fBuffer->size - wrtn);
+
+        return (space < untilEnd) ? space : untilEnd;
+    }
+
+    // marks data from getWriteSpan() as written, still needs a commitWrite()
+    void advanceWrite(const uint32_t size) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr,);
+
+        const uint32_t wrtn(fBuffer->wrtn);
+        CARLA_SAFE_ASSERT_RETURN(size < fBuffer->size - getDistance(fCachedTail, wrtn),);
+
+        uint32_t writeto(wrtn + size);
+
+        if (writeto >= fBuffer->size)
+            writeto -= fBuffer->size;
+
+        fBuffer->wrtn = writeto;
     }
 
     // -------------------------------------------------------------------
@@ -313,8 +423,17 @@ protected:
 
         fBuffer = ringBuf;
 
-        if (resetBuffer && ringBuf != nullptr)
+        if (ringBuf == nullptr)
+            return;
+
+        if (resetBuffer)
+        {
             clear();
+            return;
+        }
+
+        fCachedHead = carla_ringBufferLoadIndex(ringBuf->head);
+        fCachedTail = carla_ringBufferLoadIndex(ringBuf->tail);
     }
 
     // -------------------------------------------------------------------
@@ -326,17 +445,20 @@ protected:
         CARLA_SAFE_ASSERT_RETURN(size > 0, false);
         CARLA_SAFE_ASSERT_RETURN(size < fBuffer->size, false);
 
+        const uint32_t tail(fBuffer->tail);
+        uint32_t head(fCachedHead);
+
+        // only look at the writer's index if what we saw last time is not enough
+        if (getDistance(tail, head) < size)
+            fCachedHead = head = carla_ringBufferLoadIndex(fBuffer->head);
+
         // empty
-        if (fBuffer->head == fBuffer->tail)
+        if (head == tail)
             return false;
 
         uint8_t* const bytebuf(static_cast<uint8_t*>(buf));
 
-        const uint32_t head(fBuffer->head);
-        const uint32_t tail(fBuffer->tail);
-        const uint32_t wrap((head > tail) ? 0 : fBuffer->size);
-
-        if (size > wrap + head - tail)
+        if (size > getDistance(tail, head))
         {
             if (! fErrorReading)
             {
@@ -363,7 +485,7 @@ protected:
                 readto = 0;
         }
 
-        fBuffer->tail = readto;
+        carla_ringBufferStoreIndex(fBuffer->tail, readto);
         fErrorReading = false;
         return true;
     }
@@ -377,11 +499,14 @@ protected:
 
         const uint8_t* const bytebuf(static_cast<const uint8_t*>(buf));
 
-        const uint32_t tail(fBuffer->tail);
         const uint32_t wrtn(fBuffer->wrtn);
-        const uint32_t wrap((tail > wrtn) ? 0 : fBuffer->size);
+        uint32_t tail(fCachedTail);
+
+        // only look at the reader's index if what we saw last time is not enough
+        if (size >= fBuffer->size - getDistance(tail, wrtn))
+            fCachedTail = tail = carla_ringBufferLoadIndex(fBuffer->tail);
 
-        if (size >= wrap + tail - wrtn)
+        if (size >= fBuffer->size - getDistance(tail, wrtn))
         {
             if (! fErrorWriting)
             {
@@ -414,9 +539,19 @@ protected:
         return true;
     }
 
+    // bytes from 'from' until 'to', going forward
+    uint32_t getDistance(const uint32_t from, const uint32_t to) const noexcept
+    {
+        return (to >= from) ? to - from : fBuffer->size - from + to;
+    }
+
 private:
     BufferStruct* fBuffer;
 
+    // last seen index of the other side, so we only touch its cache line when needed
+    uint32_t fCachedHead;
+    uint32_t fCachedTail;
+
     // wherever read/write errors have been printed to terminal
     bool fErrorReading;
     bool fErrorWriting;
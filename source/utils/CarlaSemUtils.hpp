@@ -34,6 +34,13 @@ extern "C" {
 #  include "osx_sem_timedwait.c"
 };
 # endif
+# ifdef CARLA_OS_LINUX
+#  include <cerrno>
+#  include <climits>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+# endif
 #endif
 
 /*
@@ -131,16 +138,16 @@ bool carla_sem_post(sem_t* const sem) noexcept
 }
 
 /*
- * Wait for a semaphore (lock).
+ * Wait for a semaphore (lock), with a timeout in milliseconds.
+ * A timeout of 0 only takes a pending post, without waiting.
  */
 static inline
-bool carla_sem_timedwait(sem_t* const sem, const uint secs) noexcept
+bool carla_sem_timedwait_msecs(sem_t* const sem, const uint msecs) noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(sem != nullptr, false);
-    CARLA_SAFE_ASSERT_RETURN(secs > 0, false);
 
 #if defined(CARLA_OS_WIN)
-    const DWORD result = ::WaitForSingleObject(sem->handle, secs*1000);
+    const DWORD result = ::WaitForSingleObject(sem->handle, msecs);
 
     switch (result)
     {
@@ -163,7 +170,14 @@ bool carla_sem_timedwait(sem_t* const sem, const uint secs) noexcept
     timeout.tv_sec  = now.tv_sec;
     timeout.tv_nsec = now.tv_usec * 1000;
 # endif
-    timeout.tv_sec += static_cast<time_t>(secs);
+    timeout.tv_sec  += static_cast<time_t>(msecs / 1000);
+    timeout.tv_nsec += static_cast<long>(msecs % 1000) * 1000000L;
+
+    if (timeout.tv_nsec >= 1000000000L)
+    {
+        timeout.tv_sec  += 1;
+        timeout.tv_nsec -= 1000000000L;
+    }
 
     try {
         return (::sem_timedwait(sem, &timeout) == 0);
@@ -171,6 +185,168 @@ bool carla_sem_timedwait(sem_t* const sem, const uint secs) noexcept
 #endif
 }
 
+/*
+ * Wait for a semaphore (lock).
+ */
+static inline
+bool carla_sem_timedwait(sem_t* const sem, const uint secs) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(secs > 0, false);
+
+    return carla_sem_timedwait_msecs(sem, secs*1000);
+}
+
+#ifdef CARLA_OS_LINUX
+// -----------------------------------------------------------------------
+// Futex based semaphore, can be placed in shared memory between processes.
+// Waiting spins for a short while before going to sleep, the spin length
+// adapts to how long the other side usually takes to post.
+
+struct carla_sem_futex_t {
+    int count;     // pending posts
+    int waiters;   // threads sleeping in the kernel
+    int spinLimit; // spin iterations before sleeping
+};
+
+// spin limits, in iterations of a cpu pause (a few nanoseconds each)
+static const int kCarlaSemSpinMin     = 64;
+static const int kCarlaSemSpinMax     = 16384;
+static const int kCarlaSemSpinDefault = 1024;
+
+static inline
+void carla_sem_cpu_relax() noexcept
+{
+# if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+# elif defined(__arm__) || defined(__aarch64__)
+    __asm__ __volatile__("yield");
+# endif
+}
+
+/*
+ * Initialize a futex semaphore in-place.
+ */
+static inline
+void carla_sem_futex_init(carla_sem_futex_t* const sem) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(sem != nullptr,);
+
+    // spinning only makes sense if the other side can run at the same time
+    static const bool kCanSpin(::sysconf(_SC_NPROCESSORS_ONLN) > 1);
+
+    sem->count     = 0;
+    sem->waiters   = 0;
+    sem->spinLimit = kCanSpin ? kCarlaSemSpinDefault : 0;
+    __sync_synchronize();
+}
+
+/*
+ * Take one post if available, without waiting.
+ */
+static inline
+bool carla_sem_futex_trywait(carla_sem_futex_t* const sem) noexcept
+{
+    for (int count = sem->count; count > 0; count = sem->count)
+    {
+        if (__sync_bool_compare_and_swap(&sem->count, count, count-1))
+            return true;
+    }
+
+    return false;
+}
+
+/*
+ * Post futex semaphore (unlock).
+ * Only goes into the kernel if someone is sleeping.
+ */
+static inline
+bool carla_sem_futex_post(carla_sem_futex_t* const sem) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(sem != nullptr, false);
+
+    __sync_add_and_fetch(&sem->count, 1);
+
+    if (__sync_add_and_fetch(&sem->waiters, 0) > 0)
+        ::syscall(__NR_futex, &sem->count, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+
+    return true;
+}
+
+/*
+ * Wait for a futex semaphore (lock).
+ * Sets errno to ETIMEDOUT on timeout, like carla_sem_timedwait().
+ */
+static inline
+bool carla_sem_futex_timedwait(carla_sem_futex_t* const sem, const uint secs) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(sem != nullptr, false);
+    CARLA_SAFE_ASSERT_RETURN(secs > 0, false);
+
+    // spin first, the other side is likely to post soon
+    const int spinLimit(sem->spinLimit);
+
+    for (int i=0; i < spinLimit; ++i)
+    {
+        if (carla_sem_futex_trywait(sem))
+        {
+            // got it while spinning, allow spinning a bit longer next time
+            if (spinLimit < kCarlaSemSpinMax)
+                sem->spinLimit = spinLimit + spinLimit/8 + 1;
+            return true;
+        }
+
+        carla_sem_cpu_relax();
+    }
+
+    // spinning did not help, spin less next time
+    if (spinLimit > kCarlaSemSpinMin)
+    {
+        const int newSpinLimit(spinLimit - spinLimit/4);
+        sem->spinLimit = newSpinLimit > kCarlaSemSpinMin ? newSpinLimit : kCarlaSemSpinMin;
+    }
+
+    timespec now, end;
+    ::clock_gettime(CLOCK_MONOTONIC, &end);
+    end.tv_sec += static_cast<time_t>(secs);
+
+    for (;;)
+    {
+        if (carla_sem_futex_trywait(sem))
+            return true;
+
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+        timespec timeout;
+        timeout.tv_sec  = end.tv_sec  - now.tv_sec;
+        timeout.tv_nsec = end.tv_nsec - now.tv_nsec;
+
+        if (timeout.tv_nsec < 0)
+        {
+            timeout.tv_nsec += 1000000000L;
+            --timeout.tv_sec;
+        }
+
+        if (timeout.tv_sec < 0)
+        {
+            errno = ETIMEDOUT;
+            return false;
+        }
+
+        // sleeps only if count is still 0
+        __sync_add_and_fetch(&sem->waiters, 1);
+        const long ret(::syscall(__NR_futex, &sem->count, FUTEX_WAIT, 0, &timeout, nullptr, 0));
+        const int err(errno);
+        __sync_sub_and_fetch(&sem->waiters, 1);
+
+        if (ret != 0 && err != EAGAIN && err != EINTR && err != ETIMEDOUT)
+        {
+            errno = err;
+            return false;
+        }
+    }
+}
+#endif // CARLA_OS_LINUX
+
 // -----------------------------------------------------------------------
 
 #endif // CARLA_SEM_UTILS_HPP_INCLUDED
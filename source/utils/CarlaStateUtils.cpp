@@ -194,6 +194,7 @@ CarlaStateSave::CarlaStateSave() noexcept
       balanceRight(1.0f),
       panning(0.0f),
       ctrlChannel(-1),
+      rackLane(0),
 #endif
       currentProgramIndex(-1),
       currentProgramName(nullptr),
@@ -252,6 +253,7 @@ void CarlaStateSave::clear() noexcept
     balanceRight = 1.0f;
     panning      = 0.0f;
     ctrlChannel  = -1;
+    rackLane     = 0;
 #endif
 
     currentProgramIndex = -1;
@@ -357,6 +359,12 @@ bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
                             ctrlChannel = static_cast<int8_t>(value-1);
                     }
                 }
+                else if (tag.equalsIgnoreCase("racklane") || tag.equalsIgnoreCase("rack-lane"))
+                {
+                    const int value(text.getIntValue());
+                    if (value >= 0 && value < static_cast<int>(MAX_RACK_LANES))
+                        rackLane = static_cast<uint>(value);
+                }
                 else if (tag.equalsIgnoreCase("options"))
                 {
                     const int value(text.getHexValue32());
@@ -568,6 +576,9 @@ void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
         else
             dataXml << "   <ControlChannel>" << int(ctrlChannel+1) << "</ControlChannel>\n";
 
+        if (rackLane != 0)
+            dataXml << "   <RackLane>" << int(rackLane) << "</RackLane>\n";
+
         dataXml << "   <Options>0x" << String::toHexString(static_cast<int>(options)) << "</Options>\n";
 
         content << dataXml;
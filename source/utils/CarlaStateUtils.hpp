@@ -78,6 +78,7 @@ struct CarlaStateSave {
     float  balanceRight;
     float  panning;
     int8_t ctrlChannel;
+    uint   rackLane;
 #endif
 
     int32_t     currentProgramIndex;
@@ -74,6 +74,17 @@ public:
 #endif
     }
 
+    /*
+     * Check if the caller is running in this thread.
+     */
+    bool isCurrentThread() const noexcept
+    {
+        pthread_t handle;
+        _copyTo(handle);
+
+        return pthread_equal(handle, pthread_self()) != 0;
+    }
+
     /*
      * Check if the thread should exit.
      */
@@ -0,0 +1,819 @@
+/*
+ * LV2 RDF Cache
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef LV2_RDF_CACHE_HPP_INCLUDED
+#define LV2_RDF_CACHE_HPP_INCLUDED
+
+#include "CarlaLv2Utils.hpp"
+#include "CarlaMutex.hpp"
+
+#ifdef CARLA_OS_WIN
+# define LV2_RDF_CACHE_PATH_SEP ";"
+#else
+# define LV2_RDF_CACHE_PATH_SEP ":"
+#endif
+
+// -----------------------------------------------------------------------
+// Persistent, memory-mapped cache of LV2_RDF_Descriptor data.
+//
+// Describing a single plugin through lilv requires the whole world to be loaded first,
+// which means reading the manifest of every bundle in LV2_PATH plus all specification data.
+// Each cache entry stores a serialized descriptor together with the bundles it was built from
+// (plugin, UI and preset bundles) and their modification stamps.
+// A fresh entry only needs those bundles loaded into lilv, which is still required for states.
+// The whole cache is dropped when LV2_PATH or one of its directories changes,
+// as that is how newly installed or removed bundles show up.
+//
+// All data is written in native byte order:
+//   header: magic, version, LV2_PATH stamp, entry count
+//   entry:  size, URI, bundle count, [bundle path, bundle stamp], descriptor
+
+class Lv2RdfCache
+{
+public:
+    Lv2RdfCache()
+        : fFile(getCacheFile()),
+          // mapped early so juce's leak detector outlives this singleton, validated later
+          fMappedFile(new juce::MemoryMappedFile(fFile, juce::MemoryMappedFile::readOnly)),
+          fData(nullptr),
+          fDataSize(0),
+          fPath(),
+          fPathStamp(0) {}
+
+    static Lv2RdfCache& getInstance()
+    {
+        static Lv2RdfCache cache;
+        return cache;
+    }
+
+    // Get a new descriptor for a plugin URI, with presets.
+    // Only falls back to loading the full lilv world if not cached or out of date,
+    // in which case the result is written back to the cache.
+    const LV2_RDF_Descriptor* getDescriptor(const char* const LV2_PATH, const LV2_URI uri)
+    {
+        CARLA_SAFE_ASSERT_RETURN(LV2_PATH != nullptr, nullptr);
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', nullptr);
+
+        // cache hits also load bundles into the lilv world, so share its lock
+        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+        const CarlaMutexLocker cml(lv2World.mutex);
+
+        openIfNeeded(LV2_PATH);
+
+        if (const LV2_RDF_Descriptor* const rdfDescriptor = readEntry(uri))
+            return rdfDescriptor;
+
+        lv2World.initIfNeeded(LV2_PATH);
+
+        const LV2_RDF_Descriptor* const rdfDescriptor(lv2_rdf_new(uri, true));
+
+        if (rdfDescriptor != nullptr)
+            writeEntry(uri, rdfDescriptor);
+
+        return rdfDescriptor;
+    }
+
+private:
+    static const uint32_t kMagic      = 0x46445243; // "CRDF"
+    static const uint32_t kVersion    = 1;
+    static const uint32_t kHeaderSize = sizeof(uint32_t)*3 + sizeof(uint64_t);
+    static const uint32_t kNullString = 0xffffffff;
+
+    const juce::File fFile;
+    juce::ScopedPointer<juce::MemoryMappedFile> fMappedFile;
+
+    // valid cache data after the header, if any
+    const uint8_t* fData;
+    std::size_t    fDataSize;
+
+    juce::String fPath;
+    uint64_t fPathStamp;
+
+    // -------------------------------------------------------------------
+
+    class Writer
+    {
+    public:
+        Writer() noexcept
+            : fBlock() {}
+
+        void write(const void* const data, const std::size_t size)
+        {
+            fBlock.append(data, size);
+        }
+
+        void writeUInt(const uint32_t value)
+        {
+            write(&value, sizeof(uint32_t));
+        }
+
+        void writeUInt64(const uint64_t value)
+        {
+            write(&value, sizeof(uint64_t));
+        }
+
+        void writeFloat(const float value)
+        {
+            write(&value, sizeof(float));
+        }
+
+        void writeString(const char* const str)
+        {
+            if (str == nullptr)
+            {
+                writeUInt(kNullString);
+                return;
+            }
+
+            const std::size_t len(std::strlen(str));
+
+            writeUInt(static_cast<uint32_t>(len));
+            write(str, len);
+        }
+
+        juce::MemoryBlock fBlock;
+    };
+
+    // Reads from untrusted data, any overflow makes the reader fail and return empty values.
+    class Reader
+    {
+    public:
+        Reader(const uint8_t* const data, const std::size_t size) noexcept
+            : fData(data),
+              fSize(size),
+              fPos(0),
+              fFailed(false) {}
+
+        bool read(void* const data, const std::size_t size) noexcept
+        {
+            if (fFailed || size > fSize - fPos)
+            {
+                fFailed = true;
+                std::memset(data, 0, size);
+                return false;
+            }
+
+            std::memcpy(data, fData + fPos, size);
+            fPos += size;
+            return true;
+        }
+
+        uint32_t readUInt() noexcept
+        {
+            uint32_t value;
+            read(&value, sizeof(uint32_t));
+            return value;
+        }
+
+        uint64_t readUInt64() noexcept
+        {
+            uint64_t value;
+            read(&value, sizeof(uint64_t));
+            return value;
+        }
+
+        float readFloat() noexcept
+        {
+            float value;
+            read(&value, sizeof(float));
+            return value;
+        }
+
+        // array sizes, every array item is at least 4 bytes long
+        uint32_t readCount() noexcept
+        {
+            const uint32_t count(readUInt());
+
+            if (count > (fSize - fPos) / sizeof(uint32_t))
+            {
+                fFailed = true;
+                return 0;
+            }
+
+            return count;
+        }
+
+        // string inside the data, not null terminated
+        const char* peekString(uint32_t& len) noexcept
+        {
+            len = readUInt();
+
+            if (len == kNullString || fFailed || len > fSize - fPos)
+            {
+                if (len != kNullString)
+                    fFailed = true;
+                len = 0;
+                return nullptr;
+            }
+
+            const char* const str(reinterpret_cast<const char*>(fData + fPos));
+            fPos += len;
+            return str;
+        }
+
+        const char* readString()
+        {
+            uint32_t len;
+            const char* const str(peekString(len));
+
+            if (str == nullptr)
+                return nullptr;
+
+            char* const newStr(new char[len+1]);
+            std::memcpy(newStr, str, len);
+            newStr[len] = '\0';
+            return newStr;
+        }
+
+        void skip(const std::size_t size) noexcept
+        {
+            if (fFailed || size > fSize - fPos)
+                fFailed = true;
+            else
+                fPos += size;
+        }
+
+        std::size_t getPosition() const noexcept
+        {
+            return fPos;
+        }
+
+        bool hasFailed() const noexcept
+        {
+            return fFailed;
+        }
+
+    private:
+        const uint8_t* const fData;
+        const std::size_t fSize;
+        std::size_t fPos;
+        bool fFailed;
+    };
+
+    // -------------------------------------------------------------------
+
+    static juce::File getCacheFile()
+    {
+        using juce::File;
+
+#if defined(CARLA_OS_MAC)
+        const File dir(File("~/Library/Caches/Carla"));
+#elif defined(CARLA_OS_WIN)
+        const File dir(File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("Carla"));
+#else
+        const char* const xdgCacheHome(std::getenv("XDG_CACHE_HOME"));
+
+        const File dir((xdgCacheHome != nullptr && xdgCacheHome[0] == '/') ? File(xdgCacheHome).getChildFile("carla")
+                                                                           : File("~/.cache/carla"));
+#endif
+        return dir.getChildFile("lv2-rdf.cache");
+    }
+
+    static uint64_t mixStamp(uint64_t stamp, const void* const data, const std::size_t size) noexcept
+    {
+        const uint8_t* const bytes(static_cast<const uint8_t*>(data));
+
+        // 64-bit FNV-1a
+        for (std::size_t i=0; i < size; ++i)
+        {
+            stamp ^= bytes[i];
+            stamp *= 1099511628211ULL;
+        }
+
+        return stamp;
+    }
+
+    static uint64_t getPathStamp(const char* const LV2_PATH)
+    {
+        uint64_t stamp(mixStamp(14695981039346656037ULL, LV2_PATH, std::strlen(LV2_PATH)));
+
+        const juce::StringArray dirs(juce::StringArray::fromTokens(LV2_PATH, LV2_RDF_CACHE_PATH_SEP, ""));
+
+        for (int i=0, count=dirs.size(); i < count; ++i)
+        {
+            const juce::File dir(dirs[i]);
+
+            const juce::int64 modTime(dir.isDirectory() ? dir.getLastModificationTime().toMilliseconds() : -1);
+            stamp = mixStamp(stamp, &modTime, sizeof(juce::int64));
+        }
+
+        return stamp;
+    }
+
+    // editing a file inside a bundle does not change the directory itself, so check the data files too
+    static uint64_t getBundleStamp(const char* const bundlePath)
+    {
+        const juce::File dir(bundlePath);
+
+        if (! dir.isDirectory())
+            return 0;
+
+        juce::int64 modTime(dir.getLastModificationTime().toMilliseconds());
+
+        juce::Array<juce::File> files;
+        dir.findChildFiles(files, juce::File::findFiles, false, "*.ttl");
+
+        for (int i=0, count=files.size(); i < count; ++i)
+            modTime = juce::jmax(modTime, files.getReference(i).getLastModificationTime().toMilliseconds());
+
+        return static_cast<uint64_t>(modTime);
+    }
+
+    // -------------------------------------------------------------------
+
+    void openIfNeeded(const char* const LV2_PATH)
+    {
+        if (fPath == LV2_PATH)
+            return;
+
+        fPath      = LV2_PATH;
+        fPathStamp = getPathStamp(LV2_PATH);
+
+        validateMappedFile();
+    }
+
+    void validateMappedFile()
+    {
+        fData     = nullptr;
+        fDataSize = 0;
+
+        if (fMappedFile == nullptr)
+            fMappedFile = new juce::MemoryMappedFile(fFile, juce::MemoryMappedFile::readOnly);
+
+        const uint8_t* const data(static_cast<const uint8_t*>(fMappedFile->getData()));
+        const std::size_t    size(fMappedFile->getSize());
+
+        Reader reader(data, size);
+
+        if (data == nullptr || reader.readUInt() != kMagic || reader.readUInt() != kVersion || reader.readUInt64() != fPathStamp)
+        {
+            carla_debug("Lv2RdfCache::validateMappedFile() - cache is missing or out of date");
+            return;
+        }
+
+        // entries must fill the rest of the file exactly, a truncated or damaged file is replaced as a whole
+        for (uint32_t i=0, count=reader.readUInt(); i < count && ! reader.hasFailed(); ++i)
+            reader.skip(reader.readUInt());
+
+        if (reader.hasFailed() || reader.getPosition() != size)
+        {
+            carla_stderr2("Lv2RdfCache::validateMappedFile() - cache file is damaged, ignoring it");
+            return;
+        }
+
+        fData     = data + kHeaderSize;
+        fDataSize = size - kHeaderSize;
+    }
+
+    // find an entry by URI, returns its full range
+    bool findEntry(const LV2_URI uri, std::size_t& entryStart, std::size_t& entrySize) const noexcept
+    {
+        const std::size_t uriLen(std::strlen(uri));
+
+        Reader reader(fData, fDataSize);
+
+        for (;;)
+        {
+            const uint32_t size(reader.readUInt());
+            const std::size_t start(reader.getPosition());
+
+            if (reader.hasFailed() || size > fDataSize - start)
+                return false;
+
+            // a damaged entry must not hide the ones after it
+            Reader entryReader(fData + start, size);
+
+            uint32_t len;
+            const char* const entryURI(entryReader.peekString(len));
+
+            if (entryURI != nullptr && len == uriLen && std::strncmp(entryURI, uri, uriLen) == 0)
+            {
+                entryStart = start - sizeof(uint32_t);
+                entrySize  = size + sizeof(uint32_t);
+                return true;
+            }
+
+            reader.skip(size);
+        }
+    }
+
+    const LV2_RDF_Descriptor* readEntry(const LV2_URI uri)
+    {
+        std::size_t entryStart, entrySize;
+
+        if (fData == nullptr || ! findEntry(uri, entryStart, entrySize))
+            return nullptr;
+
+        Reader reader(fData + entryStart, entrySize);
+        reader.readUInt(); // size
+
+        uint32_t len;
+        reader.peekString(len); // uri
+
+        juce::StringArray bundles;
+
+        for (uint32_t i=0, count=reader.readCount(); i < count; ++i)
+        {
+            const char* const bundleStr(reader.peekString(len));
+            const uint64_t stamp(reader.readUInt64());
+
+            CARLA_SAFE_ASSERT_RETURN(bundleStr != nullptr, nullptr);
+
+            const juce::String bundle(juce::String::fromUTF8(bundleStr, static_cast<int>(len)));
+
+            if (getBundleStamp(bundle.toRawUTF8()) != stamp)
+            {
+                carla_debug("Lv2RdfCache::readEntry(\"%s\") - bundle '%s' has changed", uri, bundle.toRawUTF8());
+                return nullptr;
+            }
+
+            bundles.add(bundle);
+        }
+
+        LV2_RDF_Descriptor* const rdfDescriptor(new LV2_RDF_Descriptor());
+        readDescriptor(reader, rdfDescriptor);
+
+        if (reader.hasFailed() || rdfDescriptor->URI == nullptr || std::strcmp(rdfDescriptor->URI, uri) != 0)
+        {
+            carla_stderr2("Lv2RdfCache::readEntry(\"%s\") - invalid cache data", uri);
+            delete rdfDescriptor;
+            return nullptr;
+        }
+
+        // states and presets are still read through lilv, make their data available
+        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+
+        for (int i=0, count=bundles.size(); i < count; ++i)
+            lv2World.loadBundleIfNeeded(bundles[i].toRawUTF8());
+
+        lv2World.loadResourceFromURI(uri);
+
+        for (uint32_t i=0; i < rdfDescriptor->PresetCount; ++i)
+        {
+            if (rdfDescriptor->Presets[i].URI != nullptr)
+                lv2World.loadResourceFromURI(rdfDescriptor->Presets[i].URI);
+        }
+
+        return rdfDescriptor;
+    }
+
+    void writeEntry(const LV2_URI uri, const LV2_RDF_Descriptor* const rdfDescriptor)
+    {
+        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+
+        juce::StringArray bundles;
+
+        if (rdfDescriptor->Bundle != nullptr)
+            bundles.add(rdfDescriptor->Bundle);
+
+        for (uint32_t i=0; i < rdfDescriptor->UICount; ++i)
+        {
+            if (rdfDescriptor->UIs[i].Bundle != nullptr)
+                bundles.addIfNotAlreadyThere(rdfDescriptor->UIs[i].Bundle);
+        }
+
+        // presets may live in other bundles, found through their data files
+        for (uint32_t i=0; i < rdfDescriptor->PresetCount; ++i)
+        {
+            if (rdfDescriptor->Presets[i].URI == nullptr)
+                continue;
+
+            Lilv::Node presetNode(lv2World.new_uri(rdfDescriptor->Presets[i].URI));
+            Lilv::Nodes seeAlsoNodes(lv2World.find_nodes(presetNode, lv2World.rdfs_seeAlso, nullptr));
+
+            LILV_FOREACH(nodes, it, seeAlsoNodes)
+            {
+                Lilv::Node seeAlsoNode(seeAlsoNodes.get(it));
+
+                if (! seeAlsoNode.is_uri())
+                    continue;
+
+                if (const char* const path = lilv_uri_to_path(seeAlsoNode.as_uri()))
+                    bundles.addIfNotAlreadyThere(juce::File(path).getParentDirectory().getFullPathName() + CARLA_OS_SEP_STR);
+            }
+
+            lilv_nodes_free(const_cast<LilvNodes*>(seeAlsoNodes.me));
+        }
+
+        Writer entry;
+        entry.writeString(uri);
+        entry.writeUInt(static_cast<uint32_t>(bundles.size()));
+
+        for (int i=0, count=bundles.size(); i < count; ++i)
+        {
+            entry.writeString(bundles[i].toRawUTF8());
+            entry.writeUInt64(getBundleStamp(bundles[i].toRawUTF8()));
+        }
+
+        writeDescriptor(entry, rdfDescriptor);
+
+        // copy over all other entries, dropping damaged ones
+        const std::size_t uriLen(std::strlen(uri));
+        uint32_t entryCount = 1;
+        Writer entries;
+
+        if (fData != nullptr)
+        {
+            Reader reader(fData, fDataSize);
+
+            for (;;)
+            {
+                const uint32_t size(reader.readUInt());
+                const std::size_t start(reader.getPosition());
+
+                if (reader.hasFailed() || size > fDataSize - start)
+                    break;
+
+                reader.skip(size);
+
+                Reader entryReader(fData + start, size);
+
+                uint32_t len;
+                const char* const entryURI(entryReader.peekString(len));
+
+                if (entryURI == nullptr || (len == uriLen && std::strncmp(entryURI, uri, uriLen) == 0))
+                    continue;
+
+                entries.writeUInt(size);
+                entries.write(fData + start, size);
+                ++entryCount;
+            }
+        }
+
+        entries.writeUInt(static_cast<uint32_t>(entry.fBlock.getSize()));
+        entries.write(entry.fBlock.getData(), entry.fBlock.getSize());
+
+        Writer header;
+        header.writeUInt(kMagic);
+        header.writeUInt(kVersion);
+        header.writeUInt64(fPathStamp);
+        header.writeUInt(entryCount);
+
+        // write to a temporary file and move it into place, other processes might be reading the old one
+        const juce::Result result(fFile.getParentDirectory().createDirectory());
+
+        if (result.failed())
+        {
+            carla_stderr2("Lv2RdfCache::writeEntry(\"%s\") - failed to create cache dir: %s", uri, result.getErrorMessage().toRawUTF8());
+            return;
+        }
+
+        const juce::TemporaryFile tmpFile(fFile);
+
+        {
+            juce::FileOutputStream stream(tmpFile.getFile());
+
+            if (! (stream.openedOk()
+                && stream.write(header.fBlock.getData(), header.fBlock.getSize())
+                && stream.write(entries.fBlock.getData(), entries.fBlock.getSize())))
+            {
+                carla_stderr2("Lv2RdfCache::writeEntry(\"%s\") - failed to write cache file", uri);
+                return;
+            }
+        }
+
+        // the old file must not be mapped while replacing it
+        fMappedFile = nullptr;
+
+        if (! tmpFile.overwriteTargetFileWithTemporary())
+            carla_stderr2("Lv2RdfCache::writeEntry(\"%s\") - failed to replace cache file", uri);
+
+        validateMappedFile();
+    }
+
+    // -------------------------------------------------------------------
+
+    static void writeFeatures(Writer& writer, const uint32_t count, const LV2_RDF_Feature* const features)
+    {
+        writer.writeUInt(count);
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            writer.writeUInt(features[i].Type);
+            writer.writeString(features[i].URI);
+        }
+    }
+
+    static void writeExtensions(Writer& writer, const uint32_t count, const LV2_URI* const extensions)
+    {
+        writer.writeUInt(count);
+
+        for (uint32_t i=0; i < count; ++i)
+            writer.writeString(extensions[i]);
+    }
+
+    static void writeDescriptor(Writer& writer, const LV2_RDF_Descriptor* const desc)
+    {
+        writer.writeUInt(desc->Type[0]);
+        writer.writeUInt(desc->Type[1]);
+        writer.writeString(desc->URI);
+        writer.writeString(desc->Name);
+        writer.writeString(desc->Author);
+        writer.writeString(desc->License);
+        writer.writeString(desc->Binary);
+        writer.writeString(desc->Bundle);
+        writer.writeUInt64(desc->UniqueID);
+
+        writer.writeUInt(desc->PortCount);
+
+        for (uint32_t i=0; i < desc->PortCount; ++i)
+        {
+            const LV2_RDF_Port& port(desc->Ports[i]);
+
+            writer.writeUInt(port.Types);
+            writer.writeUInt(port.Properties);
+            writer.writeUInt(port.Designation);
+            writer.writeString(port.Name);
+            writer.writeString(port.Symbol);
+
+            writer.writeUInt(port.MidiMap.Type);
+            writer.writeUInt(port.MidiMap.Number);
+
+            writer.writeUInt(port.Points.Hints);
+            writer.writeFloat(port.Points.Default);
+            writer.writeFloat(port.Points.Minimum);
+            writer.writeFloat(port.Points.Maximum);
+
+            writer.writeUInt(port.Unit.Hints);
+            writer.writeString(port.Unit.Name);
+            writer.writeString(port.Unit.Render);
+            writer.writeString(port.Unit.Symbol);
+            writer.writeUInt(port.Unit.Unit);
+
+            writer.writeUInt(port.MinimumSize);
+
+            writer.writeUInt(port.ScalePointCount);
+
+            for (uint32_t j=0; j < port.ScalePointCount; ++j)
+            {
+                writer.writeString(port.ScalePoints[j].Label);
+                writer.writeFloat(port.ScalePoints[j].Value);
+            }
+        }
+
+        writer.writeUInt(desc->PresetCount);
+
+        for (uint32_t i=0; i < desc->PresetCount; ++i)
+        {
+            writer.writeString(desc->Presets[i].URI);
+            writer.writeString(desc->Presets[i].Label);
+        }
+
+        writeFeatures(writer, desc->FeatureCount, desc->Features);
+        writeExtensions(writer, desc->ExtensionCount, desc->Extensions);
+
+        writer.writeUInt(desc->UICount);
+
+        for (uint32_t i=0; i < desc->UICount; ++i)
+        {
+            const LV2_RDF_UI& ui(desc->UIs[i]);
+
+            writer.writeUInt(ui.Type);
+            writer.writeString(ui.URI);
+            writer.writeString(ui.Binary);
+            writer.writeString(ui.Bundle);
+
+            writeFeatures(writer, ui.FeatureCount, ui.Features);
+            writeExtensions(writer, ui.ExtensionCount, ui.Extensions);
+        }
+    }
+
+    // counts are set before allocating, so partially read data is cleaned up by the destructors
+
+    static void readFeatures(Reader& reader, uint32_t& count, LV2_RDF_Feature*& features)
+    {
+        count = reader.readCount();
+
+        if (count == 0)
+            return;
+
+        features = new LV2_RDF_Feature[count];
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            features[i].Type = reader.readUInt();
+            features[i].URI  = reader.readString();
+        }
+    }
+
+    static void readExtensions(Reader& reader, uint32_t& count, LV2_URI*& extensions)
+    {
+        count = reader.readCount();
+
+        if (count == 0)
+            return;
+
+        extensions = new LV2_URI[count];
+
+        for (uint32_t i=0; i < count; ++i)
+            extensions[i] = reader.readString();
+    }
+
+    static void readDescriptor(Reader& reader, LV2_RDF_Descriptor* const desc)
+    {
+        desc->Type[0]   = reader.readUInt();
+        desc->Type[1]   = reader.readUInt();
+        desc->URI       = reader.readString();
+        desc->Name      = reader.readString();
+        desc->Author    = reader.readString();
+        desc->License   = reader.readString();
+        desc->Binary    = reader.readString();
+        desc->Bundle    = reader.readString();
+        desc->UniqueID  = static_cast<ulong>(reader.readUInt64());
+
+        if ((desc->PortCount = reader.readCount()) > 0)
+        {
+            desc->Ports = new LV2_RDF_Port[desc->PortCount];
+
+            for (uint32_t i=0; i < desc->PortCount; ++i)
+            {
+                LV2_RDF_Port& port(desc->Ports[i]);
+
+                port.Types       = reader.readUInt();
+                port.Properties  = reader.readUInt();
+                port.Designation = reader.readUInt();
+                port.Name        = reader.readString();
+                port.Symbol      = reader.readString();
+
+                port.MidiMap.Type   = reader.readUInt();
+                port.MidiMap.Number = reader.readUInt();
+
+                port.Points.Hints   = reader.readUInt();
+                port.Points.Default = reader.readFloat();
+                port.Points.Minimum = reader.readFloat();
+                port.Points.Maximum = reader.readFloat();
+
+                port.Unit.Hints  = reader.readUInt();
+                port.Unit.Name   = reader.readString();
+                port.Unit.Render = reader.readString();
+                port.Unit.Symbol = reader.readString();
+                port.Unit.Unit   = reader.readUInt();
+
+                port.MinimumSize = reader.readUInt();
+
+                if ((port.ScalePointCount = reader.readCount()) > 0)
+                {
+                    port.ScalePoints = new LV2_RDF_PortScalePoint[port.ScalePointCount];
+
+                    for (uint32_t j=0; j < port.ScalePointCount; ++j)
+                    {
+                        port.ScalePoints[j].Label = reader.readString();
+                        port.ScalePoints[j].Value = reader.readFloat();
+                    }
+                }
+            }
+        }
+
+        if ((desc->PresetCount = reader.readCount()) > 0)
+        {
+            desc->Presets = new LV2_RDF_Preset[desc->PresetCount];
+
+            for (uint32_t i=0; i < desc->PresetCount; ++i)
+            {
+                desc->Presets[i].URI   = reader.readString();
+                desc->Presets[i].Label = reader.readString();
+            }
+        }
+
+        readFeatures(reader, desc->FeatureCount, desc->Features);
+        readExtensions(reader, desc->ExtensionCount, desc->Extensions);
+
+        if ((desc->UICount = reader.readCount()) > 0)
+        {
+            desc->UIs = new LV2_RDF_UI[desc->UICount];
+
+            for (uint32_t i=0; i < desc->UICount; ++i)
+            {
+                LV2_RDF_UI& ui(desc->UIs[i]);
+
+                ui.Type   = reader.readUInt();
+                ui.URI    = reader.readString();
+                ui.Binary = reader.readString();
+                ui.Bundle = reader.readString();
+
+                readFeatures(reader, ui.FeatureCount, ui.Features);
+                readExtensions(reader, ui.ExtensionCount, ui.Extensions);
+            }
+        }
+    }
+
+    CARLA_DECLARE_NON_COPY_CLASS(Lv2RdfCache)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // LV2_RDF_CACHE_HPP_INCLUDED
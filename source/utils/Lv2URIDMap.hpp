@@ -0,0 +1,406 @@
+/*
+ * LV2 URID Map
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef LV2_URID_MAP_HPP_INCLUDED
+#define LV2_URID_MAP_HPP_INCLUDED
+
+#include "CarlaMutex.hpp"
+
+#include "lv2/atom.h"
+#include "lv2/buf-size.h"
+#include "lv2/log.h"
+#include "lv2/midi.h"
+#include "lv2/parameters.h"
+#include "lv2/time.h"
+#include "lv2/ui.h"
+#include "lv2/urid.h"
+#include "lv2/lv2_kxstudio_properties.h"
+
+#define URI_CARLA_ATOM_WORKER "http://kxstudio.sf.net/ns/carla/atomWorker"
+
+// -----------------------------------------------------------------------
+// LV2 URI Map Ids, always mapped in this order
+
+const uint32_t CARLA_URI_MAP_ID_NULL                   =  0;
+const uint32_t CARLA_URI_MAP_ID_ATOM_BLANK             =  1;
+const uint32_t CARLA_URI_MAP_ID_ATOM_BOOL              =  2;
+const uint32_t CARLA_URI_MAP_ID_ATOM_CHUNK             =  3;
+const uint32_t CARLA_URI_MAP_ID_ATOM_DOUBLE            =  4;
+const uint32_t CARLA_URI_MAP_ID_ATOM_EVENT             =  5;
+const uint32_t CARLA_URI_MAP_ID_ATOM_FLOAT             =  6;
+const uint32_t CARLA_URI_MAP_ID_ATOM_INT               =  7;
+const uint32_t CARLA_URI_MAP_ID_ATOM_LITERAL           =  8;
+const uint32_t CARLA_URI_MAP_ID_ATOM_LONG              =  9;
+const uint32_t CARLA_URI_MAP_ID_ATOM_NUMBER            = 10;
+const uint32_t CARLA_URI_MAP_ID_ATOM_OBJECT            = 11;
+const uint32_t CARLA_URI_MAP_ID_ATOM_PATH              = 12;
+const uint32_t CARLA_URI_MAP_ID_ATOM_PROPERTY          = 13;
+const uint32_t CARLA_URI_MAP_ID_ATOM_RESOURCE          = 14;
+const uint32_t CARLA_URI_MAP_ID_ATOM_SEQUENCE          = 15;
+const uint32_t CARLA_URI_MAP_ID_ATOM_SOUND             = 16;
+const uint32_t CARLA_URI_MAP_ID_ATOM_STRING            = 17;
+const uint32_t CARLA_URI_MAP_ID_ATOM_TUPLE             = 18;
+const uint32_t CARLA_URI_MAP_ID_ATOM_URI               = 19;
+const uint32_t CARLA_URI_MAP_ID_ATOM_URID              = 20;
+const uint32_t CARLA_URI_MAP_ID_ATOM_VECTOR            = 21;
+const uint32_t CARLA_URI_MAP_ID_ATOM_TRANSFER_ATOM     = 22;
+const uint32_t CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT    = 23;
+const uint32_t CARLA_URI_MAP_ID_BUF_MAX_LENGTH         = 24;
+const uint32_t CARLA_URI_MAP_ID_BUF_MIN_LENGTH         = 25;
+const uint32_t CARLA_URI_MAP_ID_BUF_SEQUENCE_SIZE      = 26;
+const uint32_t CARLA_URI_MAP_ID_LOG_ERROR              = 27;
+const uint32_t CARLA_URI_MAP_ID_LOG_NOTE               = 28;
+const uint32_t CARLA_URI_MAP_ID_LOG_TRACE              = 29;
+const uint32_t CARLA_URI_MAP_ID_LOG_WARNING            = 30;
+const uint32_t CARLA_URI_MAP_ID_TIME_POSITION          = 31; // base type
+const uint32_t CARLA_URI_MAP_ID_TIME_BAR               = 32; // values
+const uint32_t CARLA_URI_MAP_ID_TIME_BAR_BEAT          = 33;
+const uint32_t CARLA_URI_MAP_ID_TIME_BEAT              = 34;
+const uint32_t CARLA_URI_MAP_ID_TIME_BEAT_UNIT         = 35;
+const uint32_t CARLA_URI_MAP_ID_TIME_BEATS_PER_BAR     = 36;
+const uint32_t CARLA_URI_MAP_ID_TIME_BEATS_PER_MINUTE  = 37;
+const uint32_t CARLA_URI_MAP_ID_TIME_FRAME             = 38;
+const uint32_t CARLA_URI_MAP_ID_TIME_FRAMES_PER_SECOND = 39;
+const uint32_t CARLA_URI_MAP_ID_TIME_SPEED             = 40;
+const uint32_t CARLA_URI_MAP_ID_TIME_TICKS_PER_BEAT    = 41;
+const uint32_t CARLA_URI_MAP_ID_MIDI_EVENT             = 42;
+const uint32_t CARLA_URI_MAP_ID_PARAM_SAMPLE_RATE      = 43;
+const uint32_t CARLA_URI_MAP_ID_UI_WINDOW_TITLE        = 44;
+const uint32_t CARLA_URI_MAP_ID_CARLA_ATOM_WORKER      = 45;
+const uint32_t CARLA_URI_MAP_ID_CARLA_TRANSIENT_WIN_ID = 46;
+const uint32_t CARLA_URI_MAP_ID_COUNT                  = 47;
+
+// -----------------------------------------------------------------------
+// Process-wide URID registry.
+// Lookups and unmaps are lock-free, only mapping a new URI takes the mutex.
+// URIDs are never removed, so strings returned by unmap() stay valid.
+
+class Lv2URIDMap
+{
+public:
+    // preloads the built-in URIs so they get their CARLA_URI_MAP_ID_* values
+    Lv2URIDMap() noexcept
+        : fMutex(),
+          fTable(nullptr),
+          fCount(1)
+    {
+        carla_zeroPointers(fChunks, kMaxChunks);
+
+        try {
+            fTable = new Table(kInitialTableSize);
+        } CARLA_SAFE_EXCEPTION_RETURN("Lv2URIDMap::Lv2URIDMap",);
+
+        static const char* const kBuiltinURIs[CARLA_URI_MAP_ID_COUNT-1] = {
+            LV2_ATOM__Blank,
+            LV2_ATOM__Bool,
+            LV2_ATOM__Chunk,
+            LV2_ATOM__Double,
+            LV2_ATOM__Event,
+            LV2_ATOM__Float,
+            LV2_ATOM__Int,
+            LV2_ATOM__Literal,
+            LV2_ATOM__Long,
+            LV2_ATOM__Number,
+            LV2_ATOM__Object,
+            LV2_ATOM__Path,
+            LV2_ATOM__Property,
+            LV2_ATOM__Resource,
+            LV2_ATOM__Sequence,
+            LV2_ATOM__Sound,
+            LV2_ATOM__String,
+            LV2_ATOM__Tuple,
+            LV2_ATOM__URI,
+            LV2_ATOM__URID,
+            LV2_ATOM__Vector,
+            LV2_ATOM__atomTransfer,
+            LV2_ATOM__eventTransfer,
+            LV2_BUF_SIZE__maxBlockLength,
+            LV2_BUF_SIZE__minBlockLength,
+            LV2_BUF_SIZE__sequenceSize,
+            LV2_LOG__Error,
+            LV2_LOG__Note,
+            LV2_LOG__Trace,
+            LV2_LOG__Warning,
+            LV2_TIME__Position,
+            LV2_TIME__bar,
+            LV2_TIME__barBeat,
+            LV2_TIME__beat,
+            LV2_TIME__beatUnit,
+            LV2_TIME__beatsPerBar,
+            LV2_TIME__beatsPerMinute,
+            LV2_TIME__frame,
+            LV2_TIME__framesPerSecond,
+            LV2_TIME__speed,
+            LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat,
+            LV2_MIDI__MidiEvent,
+            LV2_PARAMETERS__sampleRate,
+            LV2_UI__windowTitle,
+            URI_CARLA_ATOM_WORKER,
+            LV2_KXSTUDIO_PROPERTIES__TransientWindowId
+        };
+
+        for (uint32_t i=0; i < CARLA_URI_MAP_ID_COUNT-1; ++i)
+        {
+            const LV2_URID urid(map(kBuiltinURIs[i]));
+            CARLA_SAFE_ASSERT_UINT2(urid == i+1, urid, i+1);
+        }
+    }
+
+    ~Lv2URIDMap() noexcept
+    {
+        for (uint32_t i=0; i < kMaxChunks; ++i)
+        {
+            const char** const chunk(fChunks[i]);
+
+            if (chunk == nullptr)
+                break;
+
+            for (uint32_t j=0; j < kChunkSize; ++j)
+            {
+                if (chunk[j] != nullptr)
+                    delete[] chunk[j];
+            }
+
+            delete[] chunk;
+        }
+
+        for (Table* table = fTable; table != nullptr;)
+        {
+            Table* const retired(table->retired);
+            delete table;
+            table = retired;
+        }
+    }
+
+    // shared by all plugin instances and UIs in this process
+    static Lv2URIDMap& getInstance() noexcept
+    {
+        static Lv2URIDMap sInstance;
+        return sInstance;
+    }
+
+    // -------------------------------------------------------------------
+
+    // returns CARLA_URI_MAP_ID_NULL on error, created is set if the URI was not mapped before
+    LV2_URID map(const char* const uri, bool* const created = nullptr) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', CARLA_URI_MAP_ID_NULL);
+
+        if (created != nullptr)
+            *created = false;
+
+        const uint32_t hash(getHash(uri));
+
+        if (const LV2_URID urid = lookup(hash, uri))
+            return urid;
+
+        const CarlaMutexLocker cml(fMutex);
+
+        // someone else might have mapped it in the meantime
+        if (const LV2_URID urid = lookup(hash, uri))
+            return urid;
+
+        const LV2_URID urid(insert(hash, uri));
+
+        if (created != nullptr && urid != CARLA_URI_MAP_ID_NULL)
+            *created = true;
+
+        return urid;
+    }
+
+    // lock-free, returns CARLA_URI_MAP_ID_NULL if the URI was never mapped
+    LV2_URID find(const char* const uri) const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', CARLA_URI_MAP_ID_NULL);
+
+        return lookup(getHash(uri), uri);
+    }
+
+    // returns nullptr for unknown URIDs
+    const char* unmap(const LV2_URID urid) const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(urid != CARLA_URI_MAP_ID_NULL, nullptr);
+
+        if (urid >= __atomic_load_n(&fCount, __ATOMIC_ACQUIRE))
+            return nullptr;
+
+        return fChunks[urid / kChunkSize][urid % kChunkSize];
+    }
+
+    // map a URI with an id decided elsewhere, like a remote host, returns false if the ids do not match
+    bool mapWithId(const LV2_URID urid, const char* const uri) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(urid != CARLA_URI_MAP_ID_NULL, false);
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', false);
+
+        const uint32_t hash(getHash(uri));
+        const CarlaMutexLocker cml(fMutex);
+
+        if (const LV2_URID ourUrid = lookup(hash, uri))
+            return (ourUrid == urid);
+
+        if (urid != fCount)
+            return false;
+
+        return (insert(hash, uri) == urid);
+    }
+
+    // next URID to be mapped, all below it are valid
+    uint32_t getCount() const noexcept
+    {
+        return __atomic_load_n(&fCount, __ATOMIC_ACQUIRE);
+    }
+
+    // -------------------------------------------------------------------
+
+private:
+    static const uint32_t kChunkSize = 1024;
+    static const uint32_t kMaxChunks = 1024;
+    static const uint32_t kInitialTableSize = 256;
+
+    struct Slot {
+        uint32_t hash;
+        LV2_URID urid;
+    };
+
+    // open addressing with linear probing, kept at most half full
+    struct Table {
+        uint32_t mask;
+        Slot* slots;
+        Table* retired;
+
+        Table(const uint32_t size)
+            : mask(size-1),
+              slots(new Slot[size]),
+              retired(nullptr)
+        {
+            carla_zeroStruct(slots, size);
+        }
+
+        ~Table() noexcept
+        {
+            delete[] slots;
+        }
+
+        CARLA_DECLARE_NON_COPY_STRUCT(Table)
+    };
+
+    CarlaMutex fMutex;
+    Table* fTable;
+    const char** fChunks[kMaxChunks];
+    uint32_t fCount;
+
+    // FNV-1a
+    static uint32_t getHash(const char* uri) noexcept
+    {
+        uint32_t hash = 2166136261U;
+
+        for (; *uri != '\0'; ++uri)
+        {
+            hash ^= static_cast<uint8_t>(*uri);
+            hash *= 16777619U;
+        }
+
+        return hash;
+    }
+
+    // lock-free, returns CARLA_URI_MAP_ID_NULL if not found
+    LV2_URID lookup(const uint32_t hash, const char* const uri) const noexcept
+    {
+        const Table* const table(__atomic_load_n(&fTable, __ATOMIC_ACQUIRE));
+        CARLA_SAFE_ASSERT_RETURN(table != nullptr, CARLA_URI_MAP_ID_NULL);
+
+        for (uint32_t i = hash & table->mask;; i = (i+1) & table->mask)
+        {
+            const Slot& slot(table->slots[i]);
+            const LV2_URID urid(__atomic_load_n(&slot.urid, __ATOMIC_ACQUIRE));
+
+            if (urid == CARLA_URI_MAP_ID_NULL)
+                return CARLA_URI_MAP_ID_NULL;
+
+            if (slot.hash == hash && std::strcmp(fChunks[urid / kChunkSize][urid % kChunkSize], uri) == 0)
+                return urid;
+        }
+    }
+
+    // must be called with the mutex locked
+    static void insertSlot(Table* const table, const uint32_t hash, const LV2_URID urid) noexcept
+    {
+        uint32_t i = hash & table->mask;
+
+        for (; table->slots[i].urid != CARLA_URI_MAP_ID_NULL; i = (i+1) & table->mask) {}
+
+        table->slots[i].hash = hash;
+        __atomic_store_n(&table->slots[i].urid, urid, __ATOMIC_RELEASE);
+    }
+
+    // must be called with the mutex locked, the URI must not be mapped yet
+    LV2_URID insert(const uint32_t hash, const char* const uri) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fTable != nullptr, CARLA_URI_MAP_ID_NULL);
+
+        const LV2_URID urid(fCount);
+        const uint32_t chunkIndex(urid / kChunkSize);
+        CARLA_SAFE_ASSERT_RETURN(chunkIndex < kMaxChunks, CARLA_URI_MAP_ID_NULL);
+
+        if (fChunks[chunkIndex] == nullptr)
+        {
+            const char** chunk;
+
+            try {
+                chunk = new const char*[kChunkSize];
+            } CARLA_SAFE_EXCEPTION_RETURN("Lv2URIDMap::insert", CARLA_URI_MAP_ID_NULL);
+
+            carla_zeroPointers(chunk, kChunkSize);
+            fChunks[chunkIndex] = chunk;
+        }
+
+        // grow before going over half full, readers keep using the old table until the new one is published
+        if ((urid+1)*2 > fTable->mask+1)
+        {
+            Table* newTable;
+
+            try {
+                newTable = new Table((fTable->mask+1)*2);
+            } CARLA_SAFE_EXCEPTION_RETURN("Lv2URIDMap::insert", CARLA_URI_MAP_ID_NULL);
+
+            for (uint32_t i=0; i <= fTable->mask; ++i)
+            {
+                if (fTable->slots[i].urid != CARLA_URI_MAP_ID_NULL)
+                    insertSlot(newTable, fTable->slots[i].hash, fTable->slots[i].urid);
+            }
+
+            // old tables might still be in use by readers, free them only on destruction
+            newTable->retired = fTable;
+            __atomic_store_n(&fTable, newTable, __ATOMIC_RELEASE);
+        }
+
+        fChunks[chunkIndex][urid % kChunkSize] = carla_strdup_safe(uri);
+        CARLA_SAFE_ASSERT_RETURN(fChunks[chunkIndex][urid % kChunkSize] != nullptr, CARLA_URI_MAP_ID_NULL);
+
+        insertSlot(fTable, hash, urid);
+        __atomic_store_n(&fCount, urid+1, __ATOMIC_RELEASE);
+
+        return urid;
+    }
+
+    CARLA_DECLARE_NON_COPY_CLASS(Lv2URIDMap)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // LV2_URID_MAP_HPP_INCLUDED
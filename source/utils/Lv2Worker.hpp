@@ -0,0 +1,508 @@
+/*
+ * LV2 Worker
+ * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef LV2_WORKER_HPP_INCLUDED
+#define LV2_WORKER_HPP_INCLUDED
+
+#include "CarlaMutex.hpp"
+#include "CarlaRingBuffer.hpp"
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
+#include "LinkedList.hpp"
+
+#include "lv2/worker.h"
+
+#include "juce_core.h"
+
+class Lv2Worker;
+
+// -----------------------------------------------------------------------
+// Lv2WorkerStats
+
+struct Lv2WorkerStats {
+    uint32_t requests;       // total scheduled
+    uint32_t dropped;        // rejected because the request ring was full
+    uint32_t queueDepth;     // waiting or being worked on
+    uint32_t maxQueueDepth;
+    uint32_t lastLatency;    // from schedule to the end of work(), in microseconds
+    uint32_t maxLatency;
+};
+
+// -----------------------------------------------------------------------
+// Lv2WorkerThread, runs the work of several plugins, one request at a time
+
+class Lv2WorkerThread : public CarlaThread
+{
+public:
+    Lv2WorkerThread() noexcept
+        : CarlaThread("Lv2WorkerThread"),
+          fSem(carla_sem_create()),
+          fWakeUpPending(false),
+          fMutex(),
+          fWorkers()
+    {
+        CARLA_SAFE_ASSERT(fSem != nullptr);
+    }
+
+    ~Lv2WorkerThread() noexcept override
+    {
+        CARLA_SAFE_ASSERT(fWorkers.count() == 0);
+
+        stop();
+
+        if (fSem != nullptr)
+        {
+            carla_sem_destroy(fSem);
+            fSem = nullptr;
+        }
+    }
+
+    // RT-safe, only the first call after the thread wakes up posts the semaphore
+    void wake() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fSem != nullptr,);
+
+        if (! __atomic_exchange_n(&fWakeUpPending, true, __ATOMIC_SEQ_CST))
+            carla_sem_post(fSem);
+    }
+
+    std::size_t getWorkerCount() const noexcept
+    {
+        return fWorkers.count();
+    }
+
+    void addWorker(Lv2Worker* const worker) noexcept
+    {
+        {
+            const CarlaMutexLocker cml(fMutex);
+            fWorkers.append(worker);
+        }
+
+        if (! isThreadRunning())
+            startThread();
+    }
+
+    void removeWorker(Lv2Worker* const worker) noexcept
+    {
+        bool isEmpty;
+
+        {
+            const CarlaMutexLocker cml(fMutex);
+            fWorkers.removeOne(worker);
+            isEmpty = (fWorkers.count() == 0);
+        }
+
+        if (isEmpty)
+            stop();
+    }
+
+protected:
+    void run() noexcept override;
+
+private:
+    sem_t* fSem;
+    bool fWakeUpPending;
+
+    CarlaMutex fMutex; // protects the worker list, never held while running work
+    LinkedList<Lv2Worker*> fWorkers;
+
+    // locks the worker's own mutex if it was not removed meanwhile
+    bool lockWorker(Lv2Worker* const worker) noexcept;
+
+    void stop() noexcept
+    {
+        signalThreadShouldExit();
+        wake();
+        stopThread(1000);
+    }
+
+    CARLA_DECLARE_NON_COPY_CLASS(Lv2WorkerThread)
+};
+
+// -----------------------------------------------------------------------
+// Lv2WorkerPool, process-wide set of worker threads
+
+class Lv2WorkerPool
+{
+public:
+    Lv2WorkerPool() noexcept
+        : fMutex(),
+          fThreads(),
+          fThreadCount(1)
+    {
+        const int cpus(juce::SystemStats::getNumCpus());
+
+        if (cpus > 2)
+            fThreadCount = static_cast<uint>(cpus/2) < kMaxThreads ? static_cast<uint>(cpus/2) : kMaxThreads;
+    }
+
+    static Lv2WorkerPool& getInstance() noexcept
+    {
+        static Lv2WorkerPool sInstance;
+        return sInstance;
+    }
+
+    // picks the thread with the least plugins
+    Lv2WorkerThread* add(Lv2Worker* const worker) noexcept
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        Lv2WorkerThread* thread(&fThreads[0]);
+
+        for (uint i=1; i < fThreadCount; ++i)
+        {
+            if (fThreads[i].getWorkerCount() < thread->getWorkerCount())
+                thread = &fThreads[i];
+        }
+
+        thread->addWorker(worker);
+        return thread;
+    }
+
+    void remove(Lv2WorkerThread* const thread, Lv2Worker* const worker) noexcept
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        thread->removeWorker(worker);
+    }
+
+private:
+    static const uint kMaxThreads = 4;
+
+    CarlaMutex fMutex;
+    Lv2WorkerThread fThreads[kMaxThreads];
+    uint fThreadCount;
+
+    CARLA_DECLARE_NON_COPY_CLASS(Lv2WorkerPool)
+};
+
+// -----------------------------------------------------------------------
+// Lv2Worker, the worker of a single plugin instance.
+// Requests go from run() to a worker thread and responses come back through lock-free rings,
+// each with a single reader and a single writer.
+
+class Lv2Worker
+{
+public:
+    Lv2Worker() noexcept
+        : fHandle(nullptr),
+          fInterface(nullptr),
+          fThread(nullptr),
+          fRequests(),
+          fResponses(),
+          fRequestData(nullptr),
+          fResponseData(nullptr),
+          fDataSize(0),
+          fWorkMutex(),
+          fStats()
+    {
+        carla_zeroStruct(fStats);
+    }
+
+    ~Lv2Worker() noexcept
+    {
+        CARLA_SAFE_ASSERT(fThread == nullptr);
+
+        stop();
+    }
+
+    // -------------------------------------------------------------------
+    // non-RT
+
+    void start(const LV2_Handle handle, const LV2_Worker_Interface* const iface, const uint32_t bufferSize) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fThread == nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(handle != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(iface != nullptr && iface->work != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(bufferSize > 0,);
+
+        fRequests.createBuffer(bufferSize);
+        fResponses.createBuffer(bufferSize);
+
+        try {
+            fRequestData  = new uint8_t[bufferSize];
+            fResponseData = new uint8_t[bufferSize];
+        } CARLA_SAFE_EXCEPTION_RETURN("Lv2Worker::start",);
+
+        fHandle    = handle;
+        fInterface = iface;
+        fDataSize  = bufferSize;
+        carla_zeroStruct(fStats);
+
+        fThread = Lv2WorkerPool::getInstance().add(this);
+    }
+
+    // waits for work in progress to finish
+    void stop() noexcept
+    {
+        if (fThread != nullptr)
+        {
+            Lv2WorkerPool::getInstance().remove(fThread, this);
+            fThread = nullptr;
+
+            // the thread can't pick this worker anymore, wait for the current request
+            const CarlaMutexLocker cml(fWorkMutex);
+
+            carla_debug("Lv2Worker::stop() - %u requests, %u dropped, max queue depth %u, max latency %u us",
+                        fStats.requests, fStats.dropped, fStats.maxQueueDepth, fStats.maxLatency);
+        }
+
+        if (fRequestData != nullptr)
+        {
+            delete[] fRequestData;
+            fRequestData = nullptr;
+        }
+
+        if (fResponseData != nullptr)
+        {
+            delete[] fResponseData;
+            fResponseData = nullptr;
+        }
+
+        if (fDataSize != 0)
+        {
+            fRequests.deleteBuffer();
+            fResponses.deleteBuffer();
+        }
+
+        fHandle    = nullptr;
+        fInterface = nullptr;
+        fDataSize  = 0;
+    }
+
+    // runs the work on the calling thread instead, for offline rendering
+    LV2_Worker_Status workNow(const uint32_t size, const void* const data) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fThread != nullptr, LV2_WORKER_ERR_UNKNOWN);
+
+        const CarlaMutexLocker cml(fWorkMutex);
+
+        try {
+            return fInterface->work(fHandle, _respond, this, size, data);
+        } CARLA_SAFE_EXCEPTION_RETURN("Lv2Worker::workNow", LV2_WORKER_ERR_UNKNOWN);
+    }
+
+    Lv2WorkerStats getStats() const noexcept
+    {
+        // each field has a single writer, relaxed loads are enough
+        Lv2WorkerStats stats;
+        stats.requests      = __atomic_load_n(&fStats.requests,      __ATOMIC_RELAXED);
+        stats.dropped       = __atomic_load_n(&fStats.dropped,       __ATOMIC_RELAXED);
+        stats.queueDepth    = __atomic_load_n(&fStats.queueDepth,    __ATOMIC_RELAXED);
+        stats.maxQueueDepth = __atomic_load_n(&fStats.maxQueueDepth, __ATOMIC_RELAXED);
+        stats.lastLatency   = __atomic_load_n(&fStats.lastLatency,   __ATOMIC_RELAXED);
+        stats.maxLatency    = __atomic_load_n(&fStats.maxLatency,    __ATOMIC_RELAXED);
+        return stats;
+    }
+
+    // -------------------------------------------------------------------
+    // RT
+
+    LV2_Worker_Status schedule(const uint32_t size, const void* const data) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fThread != nullptr, LV2_WORKER_ERR_UNKNOWN);
+        CARLA_SAFE_ASSERT_RETURN(size > 0 && size <= fDataSize, LV2_WORKER_ERR_NO_SPACE);
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr, LV2_WORKER_ERR_UNKNOWN);
+
+        __atomic_add_fetch(&fStats.requests, 1, __ATOMIC_RELAXED);
+
+        if (fRequests.getAvailableDataSize() <= sizeof(uint32_t) + sizeof(int64_t) + size)
+        {
+            __atomic_add_fetch(&fStats.dropped, 1, __ATOMIC_RELAXED);
+            return LV2_WORKER_ERR_NO_SPACE;
+        }
+
+        fRequests.writeUInt(size);
+        fRequests.writeLong(juce::Time::getHighResolutionTicks());
+        fRequests.writeCustomData(data, size);
+
+        if (! fRequests.commitWrite())
+        {
+            __atomic_add_fetch(&fStats.dropped, 1, __ATOMIC_RELAXED);
+            return LV2_WORKER_ERR_NO_SPACE;
+        }
+
+        const uint32_t depth(__atomic_add_fetch(&fStats.queueDepth, 1, __ATOMIC_SEQ_CST));
+
+        if (depth > fStats.maxQueueDepth)
+            __atomic_store_n(&fStats.maxQueueDepth, depth, __ATOMIC_RELAXED);
+
+        fThread->wake();
+        return LV2_WORKER_SUCCESS;
+    }
+
+    // hands responses to the plugin and finishes the cycle, call after run()
+    void processResponses() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fInterface != nullptr,);
+
+        if (fInterface->work_response != nullptr)
+        {
+            for (uint32_t size; fResponses.isDataAvailableForReading();)
+            {
+                size = fResponses.readUInt();
+                CARLA_SAFE_ASSERT_BREAK(size > 0 && size <= fDataSize);
+
+                fResponses.readCustomData(fResponseData, size);
+                fInterface->work_response(fHandle, size, fResponseData);
+            }
+        }
+
+        if (fInterface->end_run != nullptr)
+            fInterface->end_run(fHandle);
+    }
+
+    // -------------------------------------------------------------------
+    // worker thread, called with fWorkMutex locked
+
+    bool processRequests() noexcept
+    {
+        if (! fRequests.isDataAvailableForReading())
+            return false;
+
+        for (uint32_t size; fRequests.isDataAvailableForReading();)
+        {
+            size = fRequests.readUInt();
+            const int64_t scheduleTime(fRequests.readLong());
+            CARLA_SAFE_ASSERT_BREAK(size > 0 && size <= fDataSize);
+
+            fRequests.readCustomData(fRequestData, size);
+
+            try {
+                fInterface->work(fHandle, _respond, this, size, fRequestData);
+            } CARLA_SAFE_EXCEPTION("Lv2Worker::processRequests");
+
+            const double secs(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - scheduleTime));
+            const uint32_t latency(static_cast<uint32_t>(secs * 1000000.0));
+
+            __atomic_store_n(&fStats.lastLatency, latency, __ATOMIC_RELAXED);
+
+            if (latency > fStats.maxLatency)
+                __atomic_store_n(&fStats.maxLatency, latency, __ATOMIC_RELAXED);
+
+            __atomic_sub_fetch(&fStats.queueDepth, 1, __ATOMIC_SEQ_CST);
+        }
+
+        return true;
+    }
+
+private:
+    LV2_Handle fHandle;
+    const LV2_Worker_Interface* fInterface;
+    Lv2WorkerThread* fThread;
+
+    CarlaHeapRingBuffer fRequests;  // run() -> worker thread
+    CarlaHeapRingBuffer fResponses; // worker thread -> run()
+
+    uint8_t* fRequestData;  // used by the worker thread
+    uint8_t* fResponseData; // used by run()
+    uint32_t fDataSize;
+
+    // held while running work, so a plugin never runs work() twice at once
+    CarlaMutex fWorkMutex;
+
+    Lv2WorkerStats fStats;
+
+    static LV2_Worker_Status _respond(LV2_Worker_Respond_Handle handle, uint32_t size, const void* data)
+    {
+        CARLA_SAFE_ASSERT_RETURN(handle != nullptr, LV2_WORKER_ERR_UNKNOWN);
+        CARLA_SAFE_ASSERT_RETURN(size > 0 && data != nullptr, LV2_WORKER_ERR_UNKNOWN);
+
+        Lv2Worker* const self((Lv2Worker*)handle);
+        CARLA_SAFE_ASSERT_RETURN(size <= self->fDataSize, LV2_WORKER_ERR_NO_SPACE);
+
+        if (self->fResponses.getAvailableDataSize() <= sizeof(uint32_t) + size)
+            return LV2_WORKER_ERR_NO_SPACE;
+
+        self->fResponses.writeUInt(size);
+        self->fResponses.writeCustomData(data, size);
+
+        return self->fResponses.commitWrite() ? LV2_WORKER_SUCCESS : LV2_WORKER_ERR_NO_SPACE;
+    }
+
+    friend class Lv2WorkerThread;
+    CARLA_DECLARE_NON_COPY_CLASS(Lv2Worker)
+};
+
+// -----------------------------------------------------------------------
+
+inline bool Lv2WorkerThread::lockWorker(Lv2Worker* const worker) noexcept
+{
+    const CarlaMutexLocker cml(fMutex);
+
+    for (LinkedList<Lv2Worker*>::Itenerator it = fWorkers.begin(); it.valid(); it.next())
+    {
+        if (it.getValue(nullptr) != worker)
+            continue;
+
+        // taken before releasing the list, so Lv2Worker::stop() waits for it
+        worker->fWorkMutex.lock();
+        return true;
+    }
+
+    return false;
+}
+
+inline void Lv2WorkerThread::run() noexcept
+{
+    LinkedList<Lv2Worker*> workers;
+
+    for (; ! shouldThreadExit();)
+    {
+        carla_sem_timedwait_msecs(fSem, 1000);
+
+        // wake-ups from now on are handled on the next pass
+        __atomic_store_n(&fWakeUpPending, false, __ATOMIC_SEQ_CST);
+
+        // keep going until every plugin's queue is empty
+        for (bool hadWork = true; hadWork && ! shouldThreadExit();)
+        {
+            hadWork = false;
+
+            // work() can take long, don't block adding and removing plugins meanwhile
+            {
+                const CarlaMutexLocker cml(fMutex);
+
+                workers.clear();
+
+                for (LinkedList<Lv2Worker*>::Itenerator it = fWorkers.begin(); it.valid(); it.next())
+                    workers.append(it.getValue(nullptr));
+            }
+
+            for (LinkedList<Lv2Worker*>::Itenerator it = workers.begin(); it.valid(); it.next())
+            {
+                Lv2Worker* const worker(it.getValue(nullptr));
+                CARLA_SAFE_ASSERT_CONTINUE(worker != nullptr);
+
+                // removed since the copy
+                if (! lockWorker(worker))
+                    continue;
+
+                if (worker->processRequests())
+                    hadWork = true;
+
+                worker->fWorkMutex.unlock();
+            }
+        }
+    }
+
+    workers.clear();
+}
+
+// -----------------------------------------------------------------------
+
+#endif // LV2_WORKER_HPP_INCLUDED